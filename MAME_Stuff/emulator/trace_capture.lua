@@ -0,0 +1,79 @@
+---@diagnostic disable: lowercase-global
+-- trace_capture.lua
+-- MAME Lua script that captures a reference trace for trace_lockstep
+-- Usage: mame apple2ee -debug -debugger none -flop1 EDASM_SRC.2mg -video none -sound none
+--            -nothrottle -autoboot_script trace_capture.lua
+--
+-- After EDASM_TRACE_DELAY seconds of emulated time it saves the 64KB memory
+-- image and starts the debugger trace, whose log gets one line per
+-- instruction ("S pc a x y sp p") followed by one line per memory write
+-- ("W address value"). After EDASM_TRACE_SECONDS it stops and exits MAME.
+-- Convert the pair once, then compare as often as needed:
+--   trace_lockstep --convert mame_trace.log mame_memory.bin edasm.edtr
+--   trace_lockstep edasm.edtr
+
+local machine = manager.machine
+local cpu = machine.devices[":maincpu"]
+local mem = cpu.spaces["program"]
+local debugger = machine.debugger
+
+local TRACE_LOG = os.getenv("EDASM_TRACE_LOG") or "mame_trace.log"
+local MEMORY_IMAGE = os.getenv("EDASM_TRACE_MEMORY") or "mame_memory.bin"
+local DELAY_SECONDS = tonumber(os.getenv("EDASM_TRACE_DELAY") or "10")
+local TRACE_SECONDS = tonumber(os.getenv("EDASM_TRACE_SECONDS") or "1")
+
+-- Soft switches: reading them has side effects, so they are saved as zero
+local IO_START = 0xC000
+local IO_END = 0xC0FF
+
+-- Save $0000-$FFFF as currently mapped (main RAM, ROM or language card)
+function save_memory_image(path)
+    local bytes = {}
+    for addr = 0x0000, 0xFFFF do
+        if addr >= IO_START and addr <= IO_END then
+            bytes[#bytes + 1] = string.char(0)
+        else
+            bytes[#bytes + 1] = string.char(mem:read_u8(addr))
+        end
+    end
+    local file = assert(io.open(path, "wb"))
+    file:write(table.concat(bytes))
+    file:close()
+    print("Memory image saved: " .. path)
+end
+
+-- Registers before every instruction, then a line per write from a
+-- watchpoint on the whole address space (logged into the same trace file)
+function start_trace(path)
+    debugger:command(string.format(
+        'trace %s,maincpu,noloop,{tracelog "S %%04X %%02X %%02X %%02X %%02X %%02X\\n",pc,a,x,y,sp,p}',
+        path))
+    debugger:command('wpset 0,10000,w,1,{tracelog "W %04X %02X\\n",wpaddr,wpdata; g}')
+    print("Tracing to: " .. path)
+end
+
+function stop_trace()
+    debugger:command("wpclear")
+    debugger:command("trace off")
+    print("Trace stopped")
+end
+
+function on_start()
+    if not debugger then
+        print("trace_capture.lua needs the debugger: run MAME with -debug -debugger none")
+        machine:exit()
+        return
+    end
+    print("=== EDASM Trace Capture ===")
+    emu.wait(emu.attotime.from_double(DELAY_SECONDS))
+
+    -- The image and the first traced instruction must see the same memory
+    save_memory_image(MEMORY_IMAGE)
+    start_trace(TRACE_LOG)
+    emu.wait(emu.attotime.from_double(TRACE_SECONDS))
+    stop_trace()
+    machine:exit()
+end
+
+-- Run immediately (register_start is not available on this MAME build)
+on_start()
@@ -240,9 +240,10 @@ class App {
     using CommandHandler = std::function<void(const std::vector<std::string> &)>;
     std::unordered_map<std::string, CommandHandler> commands_; ///< Command name to handler mapping
 
-    bool running_{true};          ///< Application running state
-    std::string current_prefix_;  ///< Current directory (PREFIX command)
-    std::string last_list_range_; ///< Last LIST range for Ctrl-R repeat
+    bool running_{true};           ///< Application running state
+    bool profile_assembly_{false}; ///< Profile every ASM (--profile)
+    std::string current_prefix_;   ///< Current directory (PREFIX command)
+    std::string last_list_range_;  ///< Last LIST range for Ctrl-R repeat
 
     // EXEC command state (from EDASMINT.S ExecMode, RdExeRN)
     std::unique_ptr<std::ifstream> exec_file_; ///< File handle for EXEC file
@@ -6,9 +6,9 @@
  * - Two-pass assembly (symbol table building and code generation)
  * - Expression evaluation with EDASM-specific operators
  * - All 6502 opcodes and addressing modes
- * - Directives: ORG, EQU, DA, DW, DB, ASC, DCI, DS, END, LST, MSB
+ * - Directives: ORG, EQU, DA, DW, DB, ASC, DCI, DS, END, LST, MSB, ALIGN
  * - REL file format with ENT/EXT directives
- * - INCLUDE file preprocessing
+ * - INCLUDE file preprocessing (with optional precompiled symbol snapshots)
  * - Conditional assembly (DO/ELSE/FIN)
  *
  * Reference: ASM2.S, ASM3.S from EDASM.SRC
@@ -17,13 +17,21 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "edasm/assembler/assembly_profile.hpp"
 #include "edasm/assembler/expression.hpp"
 #include "edasm/assembler/listing.hpp"
 #include "edasm/assembler/opcode_table.hpp"
+#include "edasm/assembler/peephole.hpp"
 #include "edasm/assembler/rel_file.hpp"
+#include "edasm/assembler/symbol_snapshot.hpp"
 #include "edasm/assembler/symbol_table.hpp"
 #include "edasm/assembler/tokenizer.hpp"
 
@@ -34,6 +42,12 @@ namespace edasm {
  *
  * Provides complete 6502 assembly with all addressing modes, directives,
  * and EDASM-specific features including REL file format and conditional assembly.
+ *
+ * Memory: all transient data for one assembly (source lines, symbol table,
+ * listing lines, RLD/ESD lists) is allocated from a monotonic arena owned by
+ * the assembler. The arena is released in one shot by reset(), i.e. at the
+ * start of the next assemble() call, so symbols() stays valid until then.
+ * Everything in Result is ordinary heap storage owned by the caller.
  */
 class Assembler {
   public:
@@ -44,6 +58,8 @@ class Assembler {
         bool success{false};               ///< True if assembly succeeded
         std::vector<std::string> errors;   ///< Error messages
         std::vector<std::string> warnings; ///< Warning messages
+        std::vector<std::string> optimizations; ///< Peephole report, one line per change
+        std::vector<std::string> page_crossings; ///< Branches/indexed reads crossing a page
         std::vector<uint8_t> code;         ///< Generated machine code
         uint16_t org_address{0x0800};      ///< ORG address (default $0800)
         uint16_t code_length{0};           ///< Length of generated code
@@ -52,6 +68,10 @@ class Assembler {
         // REL file format data (only populated if rel_mode is true)
         bool is_rel_file{false};            ///< True if REL directive used
         std::vector<uint8_t> rel_file_data; ///< Complete REL format with RLD/ESD
+
+        std::vector<uint8_t> symbol_database; ///< SymbolDatabase bytes (if requested)
+
+        AssemblyProfile profile; ///< Phase instrumentation (if collect_profile)
     };
 
     /**
@@ -62,12 +82,39 @@ class Assembler {
         bool list_symbols = true;           ///< Include symbol table in listing
         bool sort_symbols_by_value = false; ///< Sort symbols by value vs name
         int symbol_columns = 4;             ///< Symbol table columns (2, 4, or 6)
+        bool collect_profile = false;       ///< Record per-phase timing/allocations
+        bool build_rel_image = true;        ///< Fill rel_file_data (else use write_rel_file())
+        unsigned sort_threads = 1;          ///< Threads for sorting large symbol tables
+
+        /// Fill Result::symbol_database with every label and equate and its
+        /// source line (BIN output only; REL addresses are final once linked)
+        bool build_symbol_database = false;
+        std::string module_name;            ///< Module name recorded in the database
+
+        /// Repeat pass 1 until instruction sizes reach a fixed point, so
+        /// absolute operands whose value (including forward references)
+        /// fits in zero page use the 2-byte zero-page opcodes; the listing
+        /// marks each shrunk operand with "[ZP]"
+        bool shrink_zero_page = false;
+
+        /// Run the peephole optimizer (see peephole.hpp) on the generated
+        /// code and reassemble with its rewrites; each change is reported
+        /// in Result::optimizations and marked "[PEEPHOLE]" in the listing
+        bool peephole = false;
+
+        /// Precompiled equate files; an INCLUDE whose contents match one by
+        /// hash imports its symbols instead of assembling the file's text
+        std::vector<const SymbolSnapshot *> symbol_snapshots;
     };
 
     /**
      * @brief Construct a new Assembler object
+     * @param upstream Resource the per-assembly arena obtains its blocks from
      */
-    Assembler();
+    explicit Assembler(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+    Assembler(const Assembler &) = delete;
+    Assembler &operator=(const Assembler &) = delete;
 
     /**
      * @brief Assemble source code with default options
@@ -88,9 +135,25 @@ class Assembler {
 
     /**
      * @brief Reset assembler state for new assembly
+     *
+     * Drops all arena-backed state and releases the arena's blocks back to
+     * the upstream resource.
      */
     void reset();
 
+    /**
+     * @brief Stream the REL image of the last assembly without building it in memory
+     *
+     * Writes the same bytes as Result::rel_file_data directly from
+     * result.code and the assembler's RLD/ESD lists, which stay valid until
+     * the next assemble()/reset().
+     *
+     * @param out Destination stream (opened in binary mode)
+     * @param result Result of the last assemble() call
+     * @return bool False if the result is not a REL file or the write failed
+     */
+    bool write_rel_file(std::ostream &out, const Result &result) const;
+
     /**
      * @brief Get symbol table for debugging/listing
      * @return const SymbolTable& Reference to symbol table
@@ -100,11 +163,56 @@ class Assembler {
     }
 
   private:
+    // Per-assembly arena; declared first so it outlives everything allocated from it
+    std::pmr::monotonic_buffer_resource arena_;
+    // Counting view of arena_ used by all containers (feeds Result::profile)
+    CountingMemoryResource memory_;
+    uint64_t expression_evaluations_{0};
+
     SymbolTable symbols_;
     OpcodeTable opcodes_;
     uint16_t program_counter_{0x0800}; // PC tracking
     uint16_t org_address_{0x0800};     // ORG directive value
     int current_line_{0};
+    size_t current_line_index_{0};  // Index into the preprocessed lines
+    uint32_t code_size_estimate_{0}; // Bytes pass 1 expects pass 2 to emit
+
+    // Zero-page shrinking (Options::shrink_zero_page): per-line flag set once
+    // an absolute operand is sized as zero page; never cleared, so the
+    // sizing passes converge. previous_symbols_ holds the last pass 1's
+    // values for resolving forward references.
+    static constexpr int kMaxSizingPasses = 16;
+    std::pmr::vector<uint8_t> zero_page_lines_;
+    SymbolTable previous_symbols_;
+    size_t zero_page_forward_refs_{0}; // Candidates pass 1 could not resolve yet
+
+    // Peephole optimization (Options::peephole): instructions recorded by
+    // pass 2, and per-line state of applied rewrites (kPeephole*)
+    static constexpr int kMaxPeepholePasses = 4;
+    static constexpr uint8_t kPeepholeRewritten = 1;
+    static constexpr uint8_t kPeepholeRemoved = 2;
+    std::pmr::vector<PeepholeOptimizer::Instruction> instructions_;
+    std::pmr::vector<uint8_t> peephole_lines_;
+    bool pending_label_{false}; // Label defined since the last recorded instruction
+
+    // Page crossings: runs of data lines (DB, DW, DS, ...) starting at a
+    // label, found by pass 1 and sorted by address; an indexed read whose
+    // base lies in one may be indexed up to the end of the run
+    struct DataBlock {
+        uint16_t start;
+        uint16_t size;
+    };
+    std::pmr::vector<DataBlock> data_blocks_;
+    bool data_block_open_{false};
+
+    // Address runs of the emitted code, recorded by emit_byte() when a
+    // symbol database is requested; ORG starts a new run. Each becomes one
+    // module of the symbol database
+    struct CodeSegment {
+        uint16_t start;
+        uint16_t length;
+    };
+    std::pmr::vector<CodeSegment> code_segments_;
     Options options_;
 
     // REL file state (from ASM3.S RelCodeF)
@@ -121,6 +229,17 @@ class Assembler {
     bool in_include_file_{false}; // IDskSrcF - true when reading from INCLUDE file
     std::string base_path_;       // Base path for resolving relative include paths
 
+    // INCLUDEs satisfied by a symbol snapshot: imported by pass 1 and
+    // listed by pass 2 just before the line at line_index of the
+    // preprocessed source
+    struct SnapshotImport {
+        size_t line_index;
+        const SymbolSnapshot *snapshot;
+        int line_number;       // Line of the INCLUDE directive
+        std::string_view text; // INCLUDE line as written, for the listing
+    };
+    std::pmr::vector<SnapshotImport> snapshot_imports_;
+
     // Conditional assembly state (from ASM3.S CondAsmF at $BA)
     // Values: 0x00=assemble (normal or condition true), 0x40=skip (condition false)
     // Note: Original EDASM also uses 0x80 via ASL for internal state, but we
@@ -128,39 +247,55 @@ class Assembler {
     uint8_t cond_asm_flag_{0x00}; // CondAsmF
 
     // Assembly passes (from ASM2.S and ASM3.S)
-    bool pass1(const std::vector<SourceLine> &lines, Result &result);
-    bool pass2(const std::vector<SourceLine> &lines, Result &result, ListingGenerator *listing);
+    // Lines are tokenized on demand; false conditional blocks are only scanned
+    bool pass1(LazySourceLines &lines, Result &result);
+    bool pass2(LazySourceLines &lines, Result &result, ListingGenerator *listing);
+    bool generate_code(LazySourceLines &lines, Result &result,
+                       std::unique_ptr<ListingGenerator> &listing);
+    bool optimize_peephole(LazySourceLines &lines, Result &result,
+                           std::unique_ptr<ListingGenerator> &listing);
 
     // Pass 1: Build symbol table
     void process_label_pass1(const SourceLine &line);
     void process_directive_pass1(const SourceLine &line, Result &result);
     void update_pc_pass1(const SourceLine &line);
+    bool shrink_zero_page(LazySourceLines &lines, Result &result);
+    AddressingMode instruction_mode(const SourceLine &line, int pass);
 
     // Pass 2: Generate code
     bool process_line_pass2(const SourceLine &line, Result &result, ListingGenerator *listing);
     bool process_directive_pass2(const SourceLine &line, Result &result, ListingGenerator *listing);
     bool encode_instruction(const SourceLine &line, Result &result, ListingGenerator *listing);
 
+    // ALIGN directive and page-crossing checks
+    uint16_t align_padding(const SourceLine &line, uint32_t position, int pass, Result &result);
+    void track_data_block(const SourceLine &line, uint16_t start);
+    void check_page_crossing(const SourceLine &line, const Opcode &opcode, uint16_t address,
+                             uint16_t operand, bool relocated, Result &result);
+
     // Code emission
     void emit_byte(uint8_t byte, Result &result);
     void emit_word(uint16_t word, Result &result);
-    void emit_word_with_relocation(uint16_t word, const std::string &operand, Result &result);
+    void emit_word_with_relocation(uint16_t word, std::string_view operand, Result &result);
 
     // Helpers
     void add_error(Result &result, const std::string &msg, int line_num = -1);
     void add_warning(Result &result, const std::string &msg, int line_num = -1);
-    bool is_directive(const std::string &mnemonic) const;
-    uint16_t evaluate_operand(const std::string &operand);
+    bool is_directive(std::string_view mnemonic) const;
+    uint16_t evaluate_operand(std::string_view operand);
 
     // Include file preprocessing (from ASM3.S L9348)
-    std::vector<SourceLine> preprocess_includes(const std::vector<SourceLine> &lines,
-                                                Result &result, int nesting_level = 0);
-    std::string resolve_include_path(const std::string &include_path) const;
+    LazySourceLines preprocess_includes(LazySourceLines &lines, Result &result,
+                                        int nesting_level = 0);
+    std::string resolve_include_path(std::string_view include_path) const;
+    // Read a whole file into the arena (views into it stay valid until reset())
+    std::optional<std::string_view> load_source_file(const std::string &path);
+    const SymbolSnapshot *find_symbol_snapshot(std::string_view text) const;
 
     // Conditional assembly (from ASM3.S L90B7-L9122)
     bool should_assemble_line() const; // Check if current line should be assembled
     bool
-    is_conditional_directive(const std::string &mnemonic) const; // Check if mnemonic is conditional
+    is_conditional_directive(std::string_view mnemonic) const; // Check if mnemonic is conditional
     bool process_conditional_directive_pass1(const SourceLine &line, Result &result);
     bool process_conditional_directive_pass2(const SourceLine &line, Result &result);
 };
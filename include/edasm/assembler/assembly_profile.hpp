@@ -0,0 +1,110 @@
+/**
+ * @file assembly_profile.hpp
+ * @brief Optional per-phase instrumentation for the assembler
+ *
+ * When Assembler::Options::collect_profile is set, assemble() records wall
+ * time and allocation activity for each phase (tokenize, INCLUDE/CHN
+ * preprocessing, pass 1, pass 2, REL build, listing) together with line,
+ * symbol and expression-evaluation counts. The result is returned in
+ * Assembler::Result::profile and can be printed by the CLI.
+ *
+ * Allocation figures count requests made through the assembler's memory
+ * resource, which carries all transient assembly state (source lines,
+ * symbol table, listing lines, RLD/ESD lists). Growth of the caller-owned
+ * Result buffers is not included.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace edasm {
+
+/**
+ * @brief Measurements for a single assembly phase
+ */
+struct PhaseProfile {
+    double wall_ms{0.0};          ///< Elapsed wall-clock time in milliseconds
+    uint64_t allocations{0};      ///< Allocation requests during the phase
+    uint64_t bytes_allocated{0};  ///< Bytes requested during the phase
+};
+
+/**
+ * @brief Instrumentation gathered by one Assembler::assemble() call
+ */
+struct AssemblyProfile {
+    bool enabled{false}; ///< True if profiling was requested
+
+    PhaseProfile tokenize;  ///< Splitting and tokenizing the source text
+    PhaseProfile includes;  ///< INCLUDE/CHN preprocessing
+    PhaseProfile pass1;     ///< Pass 1 (symbol table construction)
+    PhaseProfile pass2;     ///< Pass 2 (code generation)
+    PhaseProfile rel_build; ///< ESD collection and REL image build
+    PhaseProfile listing;   ///< Listing text generation
+
+    size_t lines{0};                    ///< Source lines after preprocessing
+    size_t tokenized_lines{0};          ///< Lines actually tokenized (rest were skipped)
+    size_t symbols{0};                  ///< Symbols in the table at the end
+    uint64_t expression_evaluations{0}; ///< ExpressionEvaluator::evaluate() calls
+
+    /**
+     * @brief Sum of all phase measurements
+     * @return PhaseProfile Totals
+     */
+    PhaseProfile total() const;
+
+    /**
+     * @brief Format as a small table, one entry per output line
+     * @return std::vector<std::string> Report lines (no trailing newlines)
+     */
+    std::vector<std::string> format_lines() const;
+
+    /**
+     * @brief Format as newline-terminated text
+     * @return std::string Report text
+     */
+    std::string to_string() const;
+};
+
+/**
+ * @brief Memory resource adaptor that counts requests forwarded upstream
+ *
+ * Single-threaded, like the assembler that owns it. Deallocations are
+ * forwarded without being counted.
+ */
+class CountingMemoryResource : public std::pmr::memory_resource {
+  public:
+    explicit CountingMemoryResource(std::pmr::memory_resource *upstream) : upstream_(upstream) {}
+
+    uint64_t allocations() const {
+        return allocations_;
+    }
+    uint64_t bytes_allocated() const {
+        return bytes_allocated_;
+    }
+
+  private:
+    std::pmr::memory_resource *upstream_;
+    uint64_t allocations_{0};
+    uint64_t bytes_allocated_{0};
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations_;
+        bytes_allocated_ += bytes;
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace edasm
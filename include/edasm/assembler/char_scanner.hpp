@@ -0,0 +1,77 @@
+/**
+ * @file char_scanner.hpp
+ * @brief Block-wise character-class scanning for the tokenizer
+ *
+ * Finds the field boundaries parse_line() needs (blanks, label characters,
+ * ';' comments) and line ends in 16-byte blocks. On x86 the blocks are
+ * classified with SSE2 compares and a movemask, so a whole block is
+ * accepted or the first match located with one bit scan; elsewhere, and for
+ * the tail of every string, a scalar loop with identical results is used.
+ *
+ * All functions return text.size() when nothing matches, which lets callers
+ * use the result directly as a field end.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace edasm {
+
+/**
+ * @brief Character-class searches used by Tokenizer and line splitting
+ */
+class CharScanner {
+  public:
+    /// Bytes classified per block
+    static constexpr size_t kBlockSize = 16;
+
+    /**
+     * @brief Whether the vectorized block path is compiled in
+     * @return bool True if SSE2 blocks are used
+     */
+    static bool vectorized();
+
+    /**
+     * @brief Find the next '\n'
+     * @param text Text to scan
+     * @param pos Start offset
+     * @return size_t Offset of the newline, or text.size()
+     */
+    static size_t find_newline(std::string_view text, size_t pos = 0);
+
+    /**
+     * @brief Find the next ';' (start of a comment)
+     * @param text Text to scan
+     * @param pos Start offset
+     * @return size_t Offset of the semicolon, or text.size()
+     */
+    static size_t find_semicolon(std::string_view text, size_t pos = 0);
+
+    /**
+     * @brief Find the end of a field: the next blank (space/tab) or ';'
+     * @param text Text to scan
+     * @param pos Start offset
+     * @return size_t Offset of the delimiter, or text.size()
+     */
+    static size_t find_blank_or_semicolon(std::string_view text, size_t pos = 0);
+
+    /**
+     * @brief Skip blanks (space/tab)
+     * @param text Text to scan
+     * @param pos Start offset
+     * @return size_t Offset of the first non-blank, or text.size()
+     */
+    static size_t skip_blanks(std::string_view text, size_t pos = 0);
+
+    /**
+     * @brief Skip label characters (letters, digits, '_' and '@')
+     * @param text Text to scan
+     * @param pos Start offset
+     * @return size_t Offset of the first non-label character, or text.size()
+     */
+    static size_t skip_label_chars(std::string_view text, size_t pos = 0);
+};
+
+} // namespace edasm
@@ -0,0 +1,403 @@
+/**
+ * @file constexpr_assembler.hpp
+ * @brief Compile-time 6502 assembler for embedded test fixtures
+ *
+ * Assembles a source string during constant evaluation into a
+ * std::array<uint8_t, N>, so tests and emulator fixtures can be written as
+ * EDASM source instead of hand-coded opcode bytes:
+ *
+ *   constexpr auto kCode = ct::assemble<R"(
+ *            ORG $2000
+ *   LOOP     DEX
+ *            BNE LOOP
+ *            RTS
+ *   )">();
+ *
+ * The subset runs the runtime Assembler's own constexpr code: lines are
+ * split by Tokenizer::split_fields, addressing modes come from
+ * AddressingModeDetector, encodings from kOpcodeSpecs, and operands are
+ * evaluated by ExpressionEvaluator::evaluate_with. Both passes size an
+ * instruction from its detected mode, so label addresses cannot drift
+ * between passes.
+ *
+ * Supported directives: ORG, EQU, DB/DFB, DW/DA, ASC, DS, MSB, END (plus
+ * LST/SBTL, which are ignored). REL, EXT/ENT, INCLUDE, CHN and conditional
+ * assembly are runtime-only.
+ *
+ * Errors (unknown mnemonic, undefined symbol, branch out of range, ...)
+ * call assembly_error(), which is not constexpr: reaching it makes the
+ * constant evaluation ill-formed, and the compiler reports the call with
+ * its message.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include "edasm/assembler/expression.hpp"
+#include "edasm/assembler/opcode_table.hpp"
+#include "edasm/assembler/tokenizer.hpp"
+
+namespace edasm::ct {
+
+/**
+ * @brief String literal usable as a template argument
+ * @tparam N Literal size including the terminating NUL
+ */
+template <size_t N> struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&text)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            data[i] = text[i];
+        }
+    }
+
+    constexpr std::string_view view() const {
+        return {data, N - 1};
+    }
+};
+
+/**
+ * @brief Report an assembly error during constant evaluation
+ *
+ * Deliberately not constexpr: the call is a compile error naming the
+ * message. At run time (assemble_into() on a non-constant source) it is
+ * not called; Program::success is cleared instead.
+ */
+inline void assembly_error(const char *) {}
+
+/// Maximum symbols per compile-time program
+inline constexpr size_t kMaxSymbols = 128;
+
+/// Maximum mnemonic/directive length
+inline constexpr size_t kMaxMnemonic = 8;
+
+/**
+ * @brief Outcome of one assembly run
+ */
+struct Program {
+    uint16_t origin{0x0800}; ///< First ORG (Assembler default if none)
+    size_t size{0};          ///< Bytes emitted
+    bool success{true};      ///< False if assembly_error() was reached
+};
+
+namespace detail {
+
+constexpr bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+constexpr std::string_view trim(std::string_view s) {
+    while (!s.empty() && is_blank(s.front())) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (is_blank(s.back()) || s.back() == '\r')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+/**
+ * @brief One source line split into fields, mnemonic upper-cased
+ */
+struct Line {
+    std::string_view label;
+    std::string_view operand;
+    char mnemonic_text[kMaxMnemonic]{};
+    size_t mnemonic_size{0};
+    bool mnemonic_too_long{false};
+
+    constexpr std::string_view mnemonic() const {
+        return {mnemonic_text, mnemonic_size};
+    }
+};
+
+constexpr Line split_line(std::string_view text) {
+    if (!text.empty() && text.back() == '\r') {
+        text.remove_suffix(1);
+    }
+    const LineFields fields = Tokenizer::split_fields(text);
+
+    Line line;
+    line.label = fields.label;
+    line.operand = fields.operand;
+    // Upper-cased into the line's own buffer (Tokenizer::parse_line allocates)
+    for (char c : fields.mnemonic) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        if (line.mnemonic_size < kMaxMnemonic) {
+            line.mnemonic_text[line.mnemonic_size++] = c;
+        } else {
+            line.mnemonic_too_long = true;
+        }
+    }
+    return line;
+}
+
+/**
+ * @brief Fixed-capacity symbol table
+ */
+class Symbols {
+  public:
+    constexpr const uint16_t *find(std::string_view name) const {
+        for (size_t i = 0; i < count_; ++i) {
+            if (names_[i] == name) {
+                return &values_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    constexpr bool define(std::string_view name, uint16_t value) {
+        if (find(name) || count_ == kMaxSymbols) {
+            return false;
+        }
+        names_[count_] = name;
+        values_[count_] = value;
+        count_++;
+        return true;
+    }
+
+  private:
+    std::array<std::string_view, kMaxSymbols> names_{};
+    std::array<uint16_t, kMaxSymbols> values_{};
+    size_t count_{0};
+};
+
+/**
+ * @brief Comma-separated operand list iterator (DB/DW)
+ */
+constexpr bool next_item(std::string_view &list, std::string_view &item) {
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        item = trim(list.substr(0, comma));
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+        if (!item.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Two-pass assembly state
+ */
+class Assembly {
+  public:
+    constexpr Assembly(uint8_t *out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+    constexpr Program run(std::string_view source) {
+        for (int pass = 1; pass <= 2 && program_.success; ++pass) {
+            pass_ = pass;
+            pc_ = Program{}.origin;
+            program_.size = 0;
+            origin_set_ = false;
+            msb_on_ = false;
+
+            size_t pos = 0;
+            while (pos < source.size() && program_.success) {
+                size_t eol = source.find('\n', pos);
+                if (eol == std::string_view::npos) {
+                    eol = source.size();
+                }
+                if (!line(split_line(source.substr(pos, eol - pos)))) {
+                    break; // END
+                }
+                pos = eol + 1;
+            }
+        }
+        return program_;
+    }
+
+  private:
+    uint8_t *out_;
+    size_t capacity_;
+    Program program_{};
+    Symbols symbols_{};
+    int pass_{1};
+    uint16_t pc_{0};
+    bool origin_set_{false};
+    bool msb_on_{false};
+
+    constexpr void fail(const char *message) {
+        if (std::is_constant_evaluated()) {
+            assembly_error(message);
+        }
+        program_.success = false;
+    }
+
+    constexpr void emit(uint8_t byte) {
+        if (out_) {
+            if (program_.size < capacity_) {
+                out_[program_.size] = byte;
+            } else {
+                fail("Output larger than pass 1 size");
+            }
+        }
+        program_.size++;
+        pc_++;
+    }
+
+    constexpr void emit_word(uint16_t word) {
+        emit(static_cast<uint8_t>(word & 0xFF));
+        emit(static_cast<uint8_t>(word >> 8));
+    }
+
+    // Pass 1 resolves forward references to 0; pass 2 treats them as errors
+    constexpr uint16_t value(std::string_view expr) {
+        auto lookup = [this](std::string_view name) -> std::optional<ExpressionSymbol> {
+            if (const uint16_t *defined = symbols_.find(name)) {
+                return ExpressionSymbol{*defined};
+            }
+            return std::nullopt;
+        };
+        const ExpressionValue result = ExpressionEvaluator::evaluate_with(expr, pass_, lookup);
+        if (!result.ok()) {
+            fail("Invalid expression or undefined symbol");
+            return 0;
+        }
+        return result.value;
+    }
+
+    // Returns false at END
+    constexpr bool line(const Line &line) {
+        const std::string_view mnem = line.mnemonic();
+        if (line.mnemonic_too_long) {
+            fail("Unknown mnemonic");
+            return true;
+        }
+
+        if (!line.label.empty() && mnem != "EQU" && pass_ == 1 &&
+            !symbols_.define(line.label, pc_)) {
+            fail("Duplicate symbol or symbol table full");
+        }
+        if (mnem.empty()) {
+            return true;
+        }
+
+        if (mnem == "END") {
+            return false;
+        }
+        if (mnem == "EQU") {
+            if (line.label.empty()) {
+                fail("EQU requires a label");
+            } else if (pass_ == 1 && !symbols_.define(line.label, value(line.operand))) {
+                fail("Duplicate symbol or symbol table full");
+            }
+        } else if (mnem == "ORG") {
+            pc_ = value(line.operand);
+            if (!origin_set_ && program_.size == 0) {
+                program_.origin = pc_;
+            }
+            origin_set_ = true;
+        } else if (mnem == "DB" || mnem == "DFB") {
+            std::string_view list = line.operand;
+            std::string_view item;
+            while (next_item(list, item)) {
+                emit(static_cast<uint8_t>(value(item) & 0xFF));
+            }
+        } else if (mnem == "DW" || mnem == "DA") {
+            std::string_view list = line.operand;
+            std::string_view item;
+            while (next_item(list, item)) {
+                emit_word(value(item));
+            }
+        } else if (mnem == "ASC") {
+            bool in_string = false;
+            for (char c : line.operand) {
+                if (c == '"' || c == '\'') {
+                    in_string = !in_string;
+                } else if (in_string) {
+                    emit(static_cast<uint8_t>(static_cast<uint8_t>(c) | (msb_on_ ? 0x80 : 0x00)));
+                }
+            }
+        } else if (mnem == "DS") {
+            for (uint16_t n = value(line.operand); n > 0 && program_.success; --n) {
+                emit(0);
+            }
+        } else if (mnem == "MSB") {
+            msb_on_ = trim(line.operand) == "ON" || trim(line.operand) == "on";
+        } else if (mnem == "LST" || mnem == "SBTL") {
+            // Listing control has no effect on the code
+        } else {
+            instruction(mnem, line.operand);
+        }
+        return true;
+    }
+
+    constexpr void instruction(std::string_view mnem, std::string_view operand) {
+        const AddressingMode mode = AddressingModeDetector::detect(operand, mnem);
+        const OpcodeSpec *spec = find_opcode_spec(mnem, mode);
+        if (!spec) {
+            fail(is_opcode_mnemonic(mnem) ? "Invalid addressing mode" : "Unknown mnemonic");
+            return;
+        }
+
+        emit(spec->code);
+        if (spec->bytes == 1) {
+            return;
+        }
+
+        const uint16_t operand_value =
+            value(AddressingModeDetector::address_expression(operand, mode));
+        if (mode == AddressingMode::Relative) {
+            const int offset = static_cast<int>(operand_value) - static_cast<int>(pc_ + 1);
+            if (pass_ == 2 && (offset < -128 || offset > 127)) {
+                fail("Branch out of range");
+            }
+            emit(static_cast<uint8_t>(offset & 0xFF));
+        } else if (spec->bytes == 2) {
+            emit(static_cast<uint8_t>(operand_value & 0xFF));
+        } else {
+            emit_word(operand_value);
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Assemble a source string into a caller-provided buffer
+ *
+ * Usable at compile time and at run time; pass out = nullptr to size the
+ * program without emitting.
+ *
+ * @param source Assembly source
+ * @param out Output buffer, or nullptr
+ * @param capacity Size of out
+ * @return Program Origin, size and success flag
+ */
+constexpr Program assemble_into(std::string_view source, uint8_t *out = nullptr,
+                                size_t capacity = 0) {
+    return detail::Assembly(out, capacity).run(source);
+}
+
+/**
+ * @brief Assemble a source literal at compile time
+ * @tparam Source Assembly source
+ * @return std::array<uint8_t, N> Code bytes, N being the assembled size
+ */
+template <FixedString Source> constexpr auto assemble() {
+    constexpr Program program = assemble_into(Source.view());
+    std::array<uint8_t, program.size> code{};
+    assemble_into(Source.view(), code.data(), code.size());
+    return code;
+}
+
+/**
+ * @brief Load address of a compile-time program (its first ORG)
+ * @tparam Source Assembly source
+ * @return uint16_t Origin
+ */
+template <FixedString Source> constexpr uint16_t origin() {
+    return assemble_into(Source.view()).origin;
+}
+
+} // namespace edasm::ct
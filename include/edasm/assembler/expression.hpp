@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace edasm {
 
@@ -42,6 +43,47 @@ struct ExpressionResult {
     std::string error_message;  ///< Error description if success=false
 };
 
+/**
+ * @brief Why an expression failed (ExpressionEvaluator words the message)
+ */
+enum class ExpressionError : uint8_t {
+    None,
+    Empty,             ///< "Empty expression"
+    Invalid,           ///< "Invalid expression", with the text if there is one
+    InvalidHex,        ///< "Invalid hex literal"
+    InvalidBinary,     ///< "Invalid binary literal"
+    InvalidDecimal,    ///< "Invalid decimal literal"
+    UndefinedSymbol,   ///< "Undefined symbol: <text>" (pass 2 only)
+    UnexpectedEnd,     ///< "Unexpected end of expression"
+    EmptyTerm,         ///< "Empty term"
+    InvalidTerm,       ///< "Invalid term: <text>"
+};
+
+/**
+ * @brief Value and flags of a symbol, as seen by expression evaluation
+ */
+struct ExpressionSymbol {
+    uint16_t value{0};
+    bool is_relative{false};
+    bool is_external{false};
+};
+
+/**
+ * @brief Result of the constexpr evaluation core (no allocation)
+ */
+struct ExpressionValue {
+    ExpressionError error{ExpressionError::None};
+    uint16_t value{0};
+    bool is_relative{false};    ///< First term is a relative symbol
+    bool is_external{false};    ///< First term is an external symbol
+    bool is_forward_ref{false}; ///< First term is not defined yet (pass 1)
+    std::string_view text;      ///< Offending text, for the error message
+
+    constexpr bool ok() const {
+        return error == ExpressionError::None;
+    }
+};
+
 /**
  * @brief Expression evaluator for 6502 assembly operands
  *
@@ -50,14 +92,19 @@ struct ExpressionResult {
  * and complex expressions with operator precedence.
  *
  * Based on EvalExpr from ASM2.S (line 2561+)
+ *
+ * Works entirely on std::string_view slices of the operand, so evaluation
+ * performs no heap allocation (only error messages are materialised).
  */
 class ExpressionEvaluator {
   public:
     /**
      * @brief Construct a new Expression Evaluator
      * @param symbols Reference to symbol table for lookups
+     * @param evaluation_counter Optional counter incremented per evaluate() call
      */
-    explicit ExpressionEvaluator(const SymbolTable &symbols);
+    explicit ExpressionEvaluator(const SymbolTable &symbols,
+                                 uint64_t *evaluation_counter = nullptr);
 
     /**
      * @brief Evaluate an expression string
@@ -65,72 +112,133 @@ class ExpressionEvaluator {
      * @param pass Assembly pass (1 or 2)
      * @return ExpressionResult Value and metadata flags
      */
-    ExpressionResult evaluate(const std::string &expr, int pass);
+    ExpressionResult evaluate(std::string_view expr, int pass);
 
-  private:
-    const SymbolTable &symbols_; ///< Symbol table reference
+    /**
+     * @brief Evaluate an expression against any symbol source
+     *
+     * The evaluation core behind evaluate(). Usable in constant expressions
+     * (shared with the constexpr assembler, constexpr_assembler.hpp).
+     *
+     * @param expr Expression to evaluate
+     * @param pass Assembly pass (1: undefined symbols are forward references)
+     * @param lookup Callable taking a symbol name and returning
+     *        std::optional<ExpressionSymbol>
+     * @return ExpressionValue Value and flags, or the error
+     */
+    template <typename Lookup>
+    static constexpr ExpressionValue evaluate_with(std::string_view expr, int pass,
+                                                   const Lookup &lookup);
+
+    // Literal and operator primitives
 
     /**
      * @brief Parse hexadecimal literal (e.g., "$1234", "1234H")
      * @param str String to parse
      * @return std::optional<uint16_t> Parsed value or nullopt
      */
-    std::optional<uint16_t> parse_hex(const std::string &str);
+    static constexpr std::optional<uint16_t> parse_hex(std::string_view str);
 
     /**
      * @brief Parse decimal literal
      * @param str String to parse
      * @return std::optional<uint16_t> Parsed value or nullopt
      */
-    std::optional<uint16_t> parse_decimal(const std::string &str);
+    static constexpr std::optional<uint16_t> parse_decimal(std::string_view str);
 
     /**
      * @brief Parse binary literal (e.g., "%10101010")
      * @param str String to parse
      * @return std::optional<uint16_t> Parsed value or nullopt
      */
-    std::optional<uint16_t> parse_binary(const std::string &str);
+    static constexpr std::optional<uint16_t> parse_binary(std::string_view str);
 
     /**
      * @brief Check if string is a valid symbol name
      * @param str String to check
      * @return bool True if valid symbol
      */
-    bool is_symbol(const std::string &str);
+    static constexpr bool is_symbol(std::string_view str);
+
+    /**
+     * @brief Check if character is an operator
+     * @param c Character to check
+     * @return bool True if operator
+     */
+    static constexpr bool is_operator(char c);
+
+    /**
+     * @brief Apply binary operator to two operands
+     * @param op Operator character
+     * @param left Left operand
+     * @param right Right operand
+     * @return uint16_t Result value
+     */
+    static constexpr uint16_t apply_operator(char op, uint16_t left, uint16_t right);
+
+  private:
+    const SymbolTable &symbols_;              ///< Symbol table reference
+    uint64_t *evaluation_counter_{nullptr};   ///< Optional evaluate() call counter
 
     /**
      * @brief Simple expression parsing (single term, no operators)
      * @param expr Expression string
      * @param pass Assembly pass
-     * @return ExpressionResult Evaluation result
+     * @param lookup Symbol lookup (see evaluate_with)
+     * @return ExpressionValue Evaluation result
      */
-    ExpressionResult parse_simple(const std::string &expr, int pass);
+    template <typename Lookup>
+    static constexpr ExpressionValue parse_simple(std::string_view expr, int pass,
+                                                  const Lookup &lookup);
 
     /**
      * @brief Full expression parsing with operators
      * @param expr Expression string
      * @param pass Assembly pass
-     * @return ExpressionResult Evaluation result
+     * @param lookup Symbol lookup (see evaluate_with)
+     * @return ExpressionValue Evaluation result
      */
-    ExpressionResult parse_full(const std::string &expr, int pass);
+    template <typename Lookup>
+    static constexpr ExpressionValue parse_full(std::string_view expr, int pass,
+                                                const Lookup &lookup);
 
     /**
      * @brief Parse a single term from expression
      * @param expr Expression string
      * @param pos Current position (modified)
      * @param pass Assembly pass
-     * @return ExpressionResult Term value
+     * @param lookup Symbol lookup (see evaluate_with)
+     * @return ExpressionValue Term value
      */
-    ExpressionResult parse_term(const std::string &expr, size_t &pos, int pass);
+    template <typename Lookup>
+    static constexpr ExpressionValue parse_term(std::string_view expr, size_t &pos, int pass,
+                                                const Lookup &lookup);
 
     /**
-     * @brief Apply binary operator to two operands
-     * @param op Operator character
-     * @param left Left operand
-     * @param right Right operand
-     * @return uint16_t Result value
+     * @brief Parse a literal or symbol (the text of one term)
+     * @param term Term text, not empty
+     * @param pass Assembly pass
+     * @param lookup Symbol lookup (see evaluate_with)
+     * @param invalid Error for text that is neither
+     * @return ExpressionValue Term value
+     */
+    template <typename Lookup>
+    static constexpr ExpressionValue parse_value(std::string_view term, int pass,
+                                                 const Lookup &lookup, ExpressionError invalid);
+
+    /**
+     * @brief Strip leading/trailing blanks (space/tab) without copying
+     * @param str String to trim
+     * @return std::string_view Trimmed view into str
      */
-    uint16_t apply_operator(char op, uint16_t left, uint16_t right);
+    static constexpr std::string_view trim_blanks(std::string_view str);
+
+    /**
+     * @brief Check for a blank (space/tab)
+     * @param c Character to check
+     * @return bool True if blank
+     */
+    static constexpr bool is_blank(char c);
 
     /**
      * @brief Get operator precedence level
@@ -139,12 +247,454 @@ class ExpressionEvaluator {
      */
     int get_precedence(char op);
 
-    /**
-     * @brief Check if character is an operator
-     * @param c Character to check
-     * @return bool True if operator
-     */
-    bool is_operator(char c);
 };
 
+// =========================================
+// constexpr primitives (shared with the constexpr assembler)
+// =========================================
+
+constexpr std::optional<uint16_t> ExpressionEvaluator::parse_hex(std::string_view str) {
+    if (str.empty()) {
+        return std::nullopt;
+    }
+
+    uint16_t value = 0;
+    for (char c : str) {
+        value *= 16;
+        if (c >= '0' && c <= '9') {
+            value += c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            value += c - 'A' + 10;
+        } else if (c >= 'a' && c <= 'f') {
+            value += c - 'a' + 10;
+        } else {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+constexpr std::optional<uint16_t> ExpressionEvaluator::parse_decimal(std::string_view str) {
+    if (str.empty()) {
+        return std::nullopt;
+    }
+
+    uint16_t value = 0;
+    for (char c : str) {
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+constexpr std::optional<uint16_t> ExpressionEvaluator::parse_binary(std::string_view str) {
+    if (str.empty()) {
+        return std::nullopt;
+    }
+
+    uint16_t value = 0;
+    for (char c : str) {
+        if (c != '0' && c != '1') {
+            return std::nullopt;
+        }
+        value = value * 2 + (c - '0');
+    }
+    return value;
+}
+
+constexpr bool ExpressionEvaluator::is_symbol(std::string_view str) {
+    auto is_alpha = [](char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); };
+
+    if (str.empty()) {
+        return false;
+    }
+
+    // Symbol must start with letter or underscore
+    char first = str[0];
+    if (!is_alpha(first) && first != '_' && first != '@') {
+        return false;
+    }
+
+    // Rest must be alphanumeric or underscore
+    for (size_t i = 1; i < str.length(); ++i) {
+        char c = str[i];
+        if (!is_alpha(c) && !(c >= '0' && c <= '9') && c != '_' && c != '@') {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Check if character is a binary operator
+constexpr bool ExpressionEvaluator::is_operator(char c) {
+    return c == '+' || c == '-' || c == '*' || c == '/' || c == '&' || c == '|' || c == '^' ||
+           c == '!';
+}
+
+// Apply binary operator (from ASM2.S line 3029+)
+// Operators: + - * / ! ^ |
+// ! = XOR (EOR), ^ = AND, | = OR
+constexpr uint16_t ExpressionEvaluator::apply_operator(char op, uint16_t left, uint16_t right) {
+    switch (op) {
+    case '+':
+        return left + right;
+    case '-':
+        return left - right;
+    case '*':
+        return left * right;
+    case '/':
+        return (right != 0) ? left / right : 0; // Avoid division by zero
+    case '!':
+        return left ^ right; // XOR (EOR in EDASM)
+    case '^':
+        return left & right; // AND (in EDASM)
+    case '|':
+        return left | right; // OR
+    default:
+        return left; // Unknown operator, return left unchanged
+    }
+}
+
+// =========================================
+// constexpr evaluation core (shared with the constexpr assembler)
+// =========================================
+
+// Reference: ASM2.S EvalExpr ($8561) - Recursive descent parser
+template <typename Lookup>
+constexpr ExpressionValue ExpressionEvaluator::evaluate_with(std::string_view expr, int pass,
+                                                             const Lookup &lookup) {
+    if (expr.empty()) {
+        ExpressionValue result;
+        result.error = ExpressionError::Empty;
+        return result;
+    }
+
+    // Check if expression contains operators
+    // Reference: ASM2.S EvalExpr ($8561+) - Detects operator presence
+    // Need to be careful with '-' which could be unary or binary
+    // If it does, use full parser, otherwise use simple parser
+    bool has_operators = false;
+    size_t check_pos = 0;
+
+    // Skip leading # and whitespace (immediate mode indicator)
+    if (expr[check_pos] == '#') {
+        check_pos++;
+        while (check_pos < expr.length() && is_blank(expr[check_pos])) {
+            check_pos++;
+        }
+    }
+
+    // Skip < or > byte operators - these require full parser
+    // Reference: ASM3.S - < and > extract low/high bytes
+    if (check_pos < expr.length() && (expr[check_pos] == '<' || expr[check_pos] == '>')) {
+        has_operators = true; // Byte operators need full parser
+        check_pos++;
+    }
+
+    // Skip leading unary +/-
+    if (check_pos < expr.length() && (expr[check_pos] == '+' || expr[check_pos] == '-')) {
+        check_pos++;
+    }
+
+    // Now check for binary operators
+    // Reference: ASM3.S Operators table - +, -, *, /, &, |, ^, !, (, )
+    auto is_alnum = [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+    };
+    for (size_t i = check_pos; i < expr.length(); i++) {
+        char c = expr[i];
+        if (c == '+' || c == '*' || c == '/' || c == '&' || c == '|' || c == '^' || c == '!' ||
+            c == '(' || c == ')') {
+            has_operators = true;
+            break;
+        }
+        // Check for binary minus (not at start of term)
+        if (c == '-' && i > check_pos &&
+            (is_alnum(expr[i - 1]) || expr[i - 1] == ')' || expr[i - 1] == '$')) {
+            has_operators = true;
+            break;
+        }
+    }
+
+    if (has_operators) {
+        return parse_full(expr, pass, lookup);
+    } else {
+        return parse_simple(expr, pass, lookup);
+    }
+}
+
+// Simple expression parser for constants and single symbols
+// Reference: ASM2.S EvalTerm ($8724) - Parse simple terms
+// Handles: $hex, %binary, decimal, and symbol names
+template <typename Lookup>
+constexpr ExpressionValue ExpressionEvaluator::parse_simple(std::string_view expr, int pass,
+                                                            const Lookup &lookup) {
+    ExpressionValue result;
+
+    // Trim whitespace
+    std::string_view trimmed = trim_blanks(expr);
+
+    if (trimmed.empty()) {
+        result.error = ExpressionError::Empty;
+        return result;
+    }
+
+    // Skip '#' for immediate mode, and whitespace after it
+    size_t pos = 0;
+    if (trimmed[pos] == '#') {
+        pos++;
+    }
+    while (pos < trimmed.length() && is_blank(trimmed[pos])) {
+        pos++;
+    }
+
+    if (pos >= trimmed.length()) {
+        result.error = ExpressionError::Invalid;
+        return result;
+    }
+
+    return parse_value(trimmed.substr(pos), pass, lookup, ExpressionError::Invalid);
+}
+
+// Full expression parser with operator support (from ASM2.S EvalExpr line 2561+)
+// Implements operators: +, -, *, /, &, |, ^
+// Also handles: < (low byte), > (high byte), unary -/+
+template <typename Lookup>
+constexpr ExpressionValue ExpressionEvaluator::parse_full(std::string_view expr, int pass,
+                                                          const Lookup &lookup) {
+    ExpressionValue result;
+
+    // Trim whitespace
+    std::string_view trimmed = trim_blanks(expr);
+
+    if (trimmed.empty()) {
+        result.error = ExpressionError::Empty;
+        return result;
+    }
+
+    // Skip '#' for immediate mode
+    size_t pos = 0;
+    if (trimmed[pos] == '#') {
+        pos++;
+        while (pos < trimmed.length() && is_blank(trimmed[pos])) {
+            pos++;
+        }
+    }
+
+    // Check for byte extraction operators (< for low byte, > for high byte)
+    // From ASM2.S line 2574-2583
+    bool low_byte = false;
+    bool high_byte = false;
+
+    if (pos < trimmed.length() && trimmed[pos] == '<') {
+        low_byte = true;
+        pos++;
+    } else if (pos < trimmed.length() && trimmed[pos] == '>') {
+        high_byte = true;
+        pos++;
+    }
+
+    // Skip whitespace after byte operator
+    while (pos < trimmed.length() && is_blank(trimmed[pos])) {
+        pos++;
+    }
+
+    // Check for unary +/- (from ASM2.S line 2585-2593)
+    bool unary_minus = false;
+    if (pos < trimmed.length() && trimmed[pos] == '-') {
+        unary_minus = true;
+        pos++;
+    } else if (pos < trimmed.length() && trimmed[pos] == '+') {
+        pos++; // Skip unary plus
+    }
+
+    // Terms are combined strictly left to right, as in the original
+    // Operators (ASM2.S Operators table, line 3029+): + - * / ! ^ |
+    // In EDASM: ! is XOR (EOR), ^ is AND, | is OR
+
+    result = parse_term(trimmed, pos, pass, lookup);
+    if (!result.ok()) {
+        return result;
+    }
+
+    uint16_t value = result.value;
+
+    // Process binary operators
+    while (pos < trimmed.length()) {
+        // Skip whitespace
+        while (pos < trimmed.length() && is_blank(trimmed[pos])) {
+            pos++;
+        }
+
+        if (pos >= trimmed.length()) {
+            break;
+        }
+
+        char op = trimmed[pos];
+        if (!is_operator(op)) {
+            break; // No more operators
+        }
+
+        pos++; // Skip operator
+
+        // Parse right-hand term
+        ExpressionValue rhs = parse_term(trimmed, pos, pass, lookup);
+        if (!rhs.ok()) {
+            return rhs;
+        }
+
+        // Apply operator
+        value = apply_operator(op, value, rhs.value);
+    }
+
+    // Apply unary minus if needed
+    if (unary_minus) {
+        value = static_cast<uint16_t>(-static_cast<int16_t>(value));
+    }
+
+    // Apply byte extraction if needed (from ASM2.S line 2638-2648)
+    if (low_byte) {
+        value = value & 0xFF;
+    } else if (high_byte) {
+        value = (value >> 8) & 0xFF;
+    }
+
+    result.value = value;
+    return result;
+}
+
+// Parse a single term (number, symbol, or parenthesized expression)
+template <typename Lookup>
+constexpr ExpressionValue ExpressionEvaluator::parse_term(std::string_view expr, size_t &pos,
+                                                          int pass, const Lookup &lookup) {
+    ExpressionValue result;
+
+    // Skip whitespace
+    while (pos < expr.length() && is_blank(expr[pos])) {
+        pos++;
+    }
+
+    if (pos >= expr.length()) {
+        result.error = ExpressionError::UnexpectedEnd;
+        return result;
+    }
+
+    // Handle parenthesized expressions
+    if (expr[pos] == '(') {
+        pos++; // Skip '('
+        result = parse_full(expr.substr(pos), pass, lookup);
+        if (!result.ok()) {
+            return result;
+        }
+        // Find matching ')'
+        int paren_count = 1;
+        while (pos < expr.length() && paren_count > 0) {
+            if (expr[pos] == '(')
+                paren_count++;
+            if (expr[pos] == ')')
+                paren_count--;
+            pos++;
+        }
+        return result;
+    }
+
+    // Extract the term (up to next operator or end)
+    size_t term_start = pos;
+    while (pos < expr.length()) {
+        char c = expr[pos];
+        if (is_blank(c) || is_operator(c) || c == ')') {
+            break;
+        }
+        pos++;
+    }
+
+    std::string_view term = expr.substr(term_start, pos - term_start);
+    if (term.empty()) {
+        result.error = ExpressionError::EmptyTerm;
+        return result;
+    }
+    return parse_value(term, pass, lookup, ExpressionError::InvalidTerm);
+}
+
+template <typename Lookup>
+constexpr ExpressionValue ExpressionEvaluator::parse_value(std::string_view term, int pass,
+                                                           const Lookup &lookup,
+                                                           ExpressionError invalid) {
+    ExpressionValue result;
+
+    // Try hex ($xxxx)
+    if (term[0] == '$') {
+        auto val = parse_hex(term.substr(1));
+        if (val.has_value()) {
+            result.value = val.value();
+        } else {
+            result.error = ExpressionError::InvalidHex;
+        }
+        return result;
+    }
+
+    // Try binary (%nnnn)
+    if (term[0] == '%') {
+        auto val = parse_binary(term.substr(1));
+        if (val.has_value()) {
+            result.value = val.value();
+        } else {
+            result.error = ExpressionError::InvalidBinary;
+        }
+        return result;
+    }
+
+    // Try decimal (starts with digit)
+    if (term[0] >= '0' && term[0] <= '9') {
+        auto val = parse_decimal(term);
+        if (val.has_value()) {
+            result.value = val.value();
+        } else {
+            result.error = ExpressionError::InvalidDecimal;
+        }
+        return result;
+    }
+
+    // Must be a symbol
+    if (!is_symbol(term)) {
+        result.error = invalid;
+        result.text = term;
+        return result;
+    }
+
+    std::optional<ExpressionSymbol> sym = lookup(term);
+    if (!sym) {
+        if (pass == 1) {
+            // Pass 1: Forward reference is OK
+            result.value = 0; // Placeholder
+            result.is_forward_ref = true;
+        } else {
+            // Pass 2: Undefined symbol is an error
+            result.error = ExpressionError::UndefinedSymbol;
+            result.text = term;
+        }
+        return result;
+    }
+
+    result.value = sym->value;
+    result.is_relative = sym->is_relative;
+    result.is_external = sym->is_external;
+    return result;
+}
+
+constexpr std::string_view ExpressionEvaluator::trim_blanks(std::string_view str) {
+    size_t start = str.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    return str.substr(start, str.find_last_not_of(" \t") - start + 1);
+}
+
+constexpr bool ExpressionEvaluator::is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
 } // namespace edasm
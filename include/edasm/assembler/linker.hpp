@@ -13,16 +13,23 @@
  * Supports multiple output formats: BIN (binary executable), REL
  * (relocatable for further linking), SYS (system file).
  *
+ * Page layout (C-EDASM extension): modules carrying ALIGN constraints in
+ * their REL image are placed at the lowest address that satisfies them,
+ * later unconstrained modules fill the padding this leaves, and taken
+ * branches or indexed table reads that still cross a page are reported.
+ *
  * Reference: LINKER/LINK.S from EDASM.SRC
  */
 
 #pragma once
 
 #include <cstdint>
+#include <memory_resource>
+#include <optional>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "edasm/assembler/name_interner.hpp"
 #include "edasm/assembler/rel_file.hpp"
 
 namespace edasm {
@@ -52,6 +59,8 @@ class Linker {
         uint16_t origin = 0x0800;  // Default origin for BIN/SYS
         bool generate_map = false; // Generate load map
         bool align = false;        // Align module boundaries
+        bool page_layout = false;  // Place modules by their ALIGN constraints
+        bool generate_symbols = false; // Fill Result::symbol_database
     };
 
     // Result of linking operation
@@ -63,12 +72,17 @@ class Linker {
         uint16_t load_address{0x0800};
         uint16_t code_length{0};
         std::string load_map; // Optional load map
+        uint16_t padding{0};  // Fill bytes between modules
+        std::vector<std::string> page_crossings; // Branches/indexed reads crossing a page
+        std::vector<uint8_t> symbol_database;    // SymbolDatabase: modules and ENTRY symbols
     };
 
+    static constexpr uint32_t kNoEntry = 0xFFFFFFFF;
+
     // Entry table record (24 bytes in EDASM, simplified in C++)
     // Stores defined symbols (ENTRY points)
     struct EntryRecord {
-        std::string name;
+        NameInterner::Id name; // Interned symbol name
         uint16_t address;      // Final relocated address
         uint8_t flags;         // Symbol flags
         uint8_t module_number; // Which module defined this
@@ -80,13 +94,13 @@ class Linker {
     // External reference record (8 bytes in EDASM, simplified in C++)
     // Stores undefined symbols (EXTERNAL references)
     struct ExternRecord {
-        std::string name;
-        uint16_t patch_address;            // Address in code to patch
-        uint8_t flags;                     // Symbol flags
-        uint8_t module_number;             // Which module references this
-        uint8_t symbol_number;             // Symbol number in RLD
-        bool resolved{false};              // Has this been resolved?
-        const EntryRecord *entry{nullptr}; // Points to resolved entry
+        NameInterner::Id name;     // Interned symbol name
+        uint16_t patch_address;    // Address in code to patch
+        uint8_t flags;             // Symbol flags
+        uint8_t module_number;     // Which module references this
+        uint8_t symbol_number;     // Symbol number in RLD
+        bool resolved{false};      // Has this been resolved?
+        uint32_t entry{kNoEntry};  // Index of the resolved entry
     };
 
     // Module information (one per REL file)
@@ -95,11 +109,15 @@ class Linker {
         std::vector<uint8_t> code;
         std::vector<RLDEntry> rld_entries;
         std::vector<ESDEntry> esd_entries;
+        std::vector<PageSpan> page_spans; // ALIGN constraints, branch/table spans
         uint16_t load_address{0}; // Assigned during link
         uint16_t code_length{0};
+        size_t first_extern{0};   // This module's externs start here in the extern table
     };
 
     Linker() = default;
+    Linker(const Linker &) = delete;
+    Linker &operator=(const Linker &) = delete;
 
     // Link multiple REL files into output
     Result link(const std::vector<std::string> &rel_files, const Options &opts);
@@ -107,7 +125,14 @@ class Linker {
   private:
     Options options_;
     std::vector<Module> modules_;
-    std::unordered_map<std::string, EntryRecord> entry_table_;
+
+    // Symbol names are interned once per link; the entry table is a
+    // contiguous array in definition order, found by name ID through
+    // entry_by_name_ (kNoEntry: not defined)
+    std::pmr::monotonic_buffer_resource arena_;
+    NameInterner names_{&arena_};
+    std::vector<EntryRecord> entry_table_;
+    std::vector<uint32_t> entry_by_name_;
     std::vector<ExternRecord> extern_table_;
     uint16_t next_load_address_{0};
 
@@ -121,7 +146,10 @@ class Linker {
                            Result &result);
 
     // Phase 3: Assign load addresses to modules
-    void assign_load_addresses();
+    bool assign_load_addresses(Result &result);
+    bool assign_page_layout(Result &result);
+    std::optional<uint16_t> first_fit(const Module &module, uint32_t from) const;
+    void check_page_spans(Result &result);
 
     // Phase 4: Resolve external references
     bool resolve_externals(Result &result);
@@ -131,12 +159,14 @@ class Linker {
     void apply_rld_entry(Module &module, const RLDEntry &rld, size_t module_idx, Result &result);
 
     // Phase 6: Generate output
+    std::vector<uint8_t> layout_code() const;
     std::vector<uint8_t> generate_bin_output();
     std::vector<uint8_t> generate_rel_output();
     std::vector<uint8_t> generate_sys_output();
 
-    // Helper: Generate load map
+    // Helper: Generate load map and symbol database
     std::string generate_load_map() const;
+    std::vector<uint8_t> generate_symbol_database() const;
 
     // Error reporting
     void add_error(Result &result, const std::string &msg);
@@ -16,7 +16,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "edasm/assembler/symbol_table.hpp"
@@ -27,19 +30,45 @@ namespace edasm {
  * @brief Listing file generator
  *
  * Accumulates listing lines during assembly and generates formatted
- * output with optional symbol table.
+ * output with optional symbol table. Accumulated lines are allocated from
+ * the memory resource given at construction; to_string() returns an
+ * ordinary heap string the caller can keep.
  */
 class ListingGenerator {
   public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
     /**
      * @brief Single line in the listing
      */
     struct ListingLine {
-        int line_number{0};         ///< Source line number
-        uint16_t address{0};        ///< Assembly address
-        std::vector<uint8_t> bytes; ///< Generated machine code bytes
-        std::string source_line;    ///< Original source text
-        bool has_address{false};    ///< True if line generates code
+        using allocator_type = ListingGenerator::allocator_type;
+
+        int line_number{0};               ///< Source line number
+        uint16_t address{0};              ///< Assembly address
+        std::pmr::vector<uint8_t> bytes;  ///< Generated machine code bytes
+        std::pmr::string source_line;     ///< Original source text
+        bool has_address{false};          ///< True if line generates code
+        std::string_view note;            ///< Assembler annotation (static text)
+
+        ListingLine() = default;
+        ListingLine(const ListingLine &) = default;
+        ListingLine(ListingLine &&) = default;
+        ListingLine &operator=(const ListingLine &) = default;
+        ListingLine &operator=(ListingLine &&) = default;
+
+        explicit ListingLine(const allocator_type &alloc) : bytes(alloc), source_line(alloc) {}
+
+        ListingLine(const ListingLine &other, const allocator_type &alloc)
+            : line_number(other.line_number), address(other.address), bytes(other.bytes, alloc),
+              source_line(other.source_line, alloc), has_address(other.has_address),
+              note(other.note) {}
+
+        ListingLine(ListingLine &&other, const allocator_type &alloc)
+            : line_number(other.line_number), address(other.address),
+              bytes(std::move(other.bytes), alloc),
+              source_line(std::move(other.source_line), alloc), has_address(other.has_address),
+              note(other.note) {}
     };
 
     /**
@@ -55,8 +84,20 @@ class ListingGenerator {
     /**
      * @brief Construct listing generator with options
      * @param opts Listing options
+     * @param mr Memory resource for accumulated lines (default heap)
+     */
+    ListingGenerator(const Options &opts,
+                     std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+    /**
+     * @brief Allocator used for accumulated lines
+     *
+     * Build ListingLine objects with this allocator so add_line() can
+     * move them in without copying.
      */
-    ListingGenerator(const Options &opts);
+    allocator_type get_allocator() const {
+        return lines_.get_allocator();
+    }
 
     /**
      * @brief Add a line to the listing
@@ -64,6 +105,12 @@ class ListingGenerator {
      */
     void add_line(const ListingLine &line);
 
+    /**
+     * @brief Add a line to the listing (move)
+     * @param line Listing line to add
+     */
+    void add_line(ListingLine &&line);
+
     /**
      * @brief Set symbol table for inclusion in listing
      * @param symbols Symbol table reference
@@ -85,7 +132,7 @@ class ListingGenerator {
 
   private:
     Options options_;                     ///< Listing options
-    std::vector<ListingLine> lines_;      ///< Accumulated listing lines
+    std::pmr::vector<ListingLine> lines_; ///< Accumulated listing lines
     const SymbolTable *symbols_{nullptr}; ///< Symbol table reference
 
     /**
@@ -115,7 +162,7 @@ class ListingGenerator {
      * @param max_bytes Maximum bytes to show per line
      * @return std::string Formatted hex bytes
      */
-    std::string format_bytes(const std::vector<uint8_t> &bytes, size_t max_bytes = 3) const;
+    std::string format_bytes(std::span<const uint8_t> bytes, size_t max_bytes = 3) const;
 
     /**
      * @brief Generate symbol table section
@@ -125,11 +172,11 @@ class ListingGenerator {
 
     /**
      * @brief Format symbols in columns
-     * @param symbols Symbol list
+     * @param symbols Sorted symbol view
      * @param columns Number of columns
      * @return std::string Formatted multi-column output
      */
-    std::string format_symbols_in_columns(const std::vector<Symbol> &symbols, int columns) const;
+    std::string format_symbols_in_columns(SymbolTable::View symbols, int columns) const;
 
     /**
      * @brief Format a single symbol entry
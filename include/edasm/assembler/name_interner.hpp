@@ -0,0 +1,79 @@
+/**
+ * @file name_interner.hpp
+ * @brief String interner for linker symbol names
+ *
+ * Stores each distinct name once and identifies it by a dense 32-bit ID, so
+ * tables keyed by name become arrays indexed by ID and comparing two names
+ * is comparing two integers. Names are hashed once, when interned; lookup
+ * is open addressing (linear probing) over a power-of-two slot array kept
+ * at most half full.
+ *
+ * Name characters and the tables are allocated from the given memory
+ * resource and characters are never freed individually: the owner is
+ * expected to use a monotonic arena and release it after reset().
+ *
+ * No EDASM.SRC counterpart (the original linker compares p-strings in its
+ * entry table chains).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace edasm {
+
+/**
+ * @brief Maps names to dense IDs and back
+ */
+class NameInterner {
+  public:
+    using Id = uint32_t;
+    static constexpr Id kNone = 0xFFFFFFFF;
+
+    explicit NameInterner(std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+    /**
+     * @brief ID of a name, adding it if new
+     * @param name Name to intern
+     * @return Id Dense ID (0, 1, 2, ... in order of first appearance)
+     */
+    Id intern(std::string_view name);
+
+    /**
+     * @brief ID of a name without adding it
+     * @return Id ID, or kNone if the name was never interned
+     */
+    Id find(std::string_view name) const;
+
+    /**
+     * @brief Characters of an interned name (valid until reset())
+     */
+    std::string_view name(Id id) const {
+        return names_[id];
+    }
+
+    size_t size() const {
+        return names_.size();
+    }
+
+    /**
+     * @brief Forget all names and drop the tables' storage
+     */
+    void reset();
+
+  private:
+    static uint32_t hash(std::string_view name);
+    size_t slot_of(std::string_view name, uint32_t h) const;
+    void grow();
+
+    std::pmr::memory_resource *mr_;
+    std::pmr::vector<std::string_view> names_; ///< By ID; characters live in mr_
+    std::pmr::vector<uint32_t> hashes_;        ///< By ID, reused when growing
+    std::pmr::vector<Id> slots_;               ///< Open-addressing table (kNone = empty)
+};
+
+} // namespace edasm
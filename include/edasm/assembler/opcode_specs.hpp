@@ -0,0 +1,288 @@
+/**
+ * @file opcode_specs.hpp
+ * @brief Constant 6502 opcode data shared by the runtime and constexpr assemblers
+ *
+ * The single source of truth for opcode encodings: OpcodeTable builds its
+ * hash maps from kOpcodeSpecs at construction, and the compile-time
+ * assembler (constexpr_assembler.hpp) searches the same array during
+ * constant evaluation.
+ *
+ * Reference: 6502_INSTRUCTION_SET.md, ASM1.S OpcodeT ($D835-$D909)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace edasm {
+
+/**
+ * @brief 6502 addressing modes
+ *
+ * All addressing modes supported by the 6502 processor.
+ * Reference: 6502_INSTRUCTION_SET.md
+ */
+enum class AddressingMode {
+    Implied,         ///< No operand (e.g., RTS)
+    Accumulator,     ///< Accumulator (e.g., ASL A)
+    Immediate,       ///< Immediate value (e.g., LDA #$42)
+    ZeroPage,        ///< Zero page address (e.g., LDA $42)
+    ZeroPageX,       ///< Zero page indexed by X (e.g., LDA $42,X)
+    ZeroPageY,       ///< Zero page indexed by Y (e.g., LDX $42,Y)
+    Absolute,        ///< Absolute address (e.g., LDA $1234)
+    AbsoluteX,       ///< Absolute indexed by X (e.g., LDA $1234,X)
+    AbsoluteY,       ///< Absolute indexed by Y (e.g., LDA $1234,Y)
+    Indirect,        ///< Indirect (e.g., JMP ($1234))
+    IndexedIndirect, ///< Indexed indirect (e.g., LDA ($42,X))
+    IndirectIndexed, ///< Indirect indexed (e.g., LDA ($42),Y)
+    Relative         ///< Relative branch (e.g., BEQ label)
+};
+
+/**
+ * @brief Constant description of one opcode variant
+ */
+struct OpcodeSpec {
+    std::string_view mnemonic; ///< Instruction mnemonic
+    AddressingMode mode;       ///< Addressing mode
+    uint8_t code;              ///< Binary opcode
+    uint8_t bytes;             ///< Instruction length in bytes
+    uint8_t cycles;            ///< Base cycle count
+    bool page_cross;           ///< True if page crossing adds a cycle
+};
+
+/// All legal 6502 opcodes (from 6502_INSTRUCTION_SET.md)
+inline constexpr OpcodeSpec kOpcodeSpecs[] = {
+    // ==== Load/store instructions ====
+    // LDA - Load Accumulator
+    {"LDA", AddressingMode::Immediate, 0xA9, 2, 2, false},
+    {"LDA", AddressingMode::ZeroPage, 0xA5, 2, 3, false},
+    {"LDA", AddressingMode::ZeroPageX, 0xB5, 2, 4, false},
+    {"LDA", AddressingMode::Absolute, 0xAD, 3, 4, false},
+    {"LDA", AddressingMode::AbsoluteX, 0xBD, 3, 4, true},
+    {"LDA", AddressingMode::AbsoluteY, 0xB9, 3, 4, true},
+    {"LDA", AddressingMode::IndexedIndirect, 0xA1, 2, 6, false},
+    {"LDA", AddressingMode::IndirectIndexed, 0xB1, 2, 5, true},
+    // LDX - Load X
+    {"LDX", AddressingMode::Immediate, 0xA2, 2, 2, false},
+    {"LDX", AddressingMode::ZeroPage, 0xA6, 2, 3, false},
+    {"LDX", AddressingMode::ZeroPageY, 0xB6, 2, 4, false},
+    {"LDX", AddressingMode::Absolute, 0xAE, 3, 4, false},
+    {"LDX", AddressingMode::AbsoluteY, 0xBE, 3, 4, true},
+    // LDY - Load Y
+    {"LDY", AddressingMode::Immediate, 0xA0, 2, 2, false},
+    {"LDY", AddressingMode::ZeroPage, 0xA4, 2, 3, false},
+    {"LDY", AddressingMode::ZeroPageX, 0xB4, 2, 4, false},
+    {"LDY", AddressingMode::Absolute, 0xAC, 3, 4, false},
+    {"LDY", AddressingMode::AbsoluteX, 0xBC, 3, 4, true},
+    // STA - Store Accumulator
+    {"STA", AddressingMode::ZeroPage, 0x85, 2, 3, false},
+    {"STA", AddressingMode::ZeroPageX, 0x95, 2, 4, false},
+    {"STA", AddressingMode::Absolute, 0x8D, 3, 4, false},
+    {"STA", AddressingMode::AbsoluteX, 0x9D, 3, 5, false},
+    {"STA", AddressingMode::AbsoluteY, 0x99, 3, 5, false},
+    {"STA", AddressingMode::IndexedIndirect, 0x81, 2, 6, false},
+    {"STA", AddressingMode::IndirectIndexed, 0x91, 2, 6, false},
+    // STX - Store X
+    {"STX", AddressingMode::ZeroPage, 0x86, 2, 3, false},
+    {"STX", AddressingMode::ZeroPageY, 0x96, 2, 4, false},
+    {"STX", AddressingMode::Absolute, 0x8E, 3, 4, false},
+    // STY - Store Y
+    {"STY", AddressingMode::ZeroPage, 0x84, 2, 3, false},
+    {"STY", AddressingMode::ZeroPageX, 0x94, 2, 4, false},
+    {"STY", AddressingMode::Absolute, 0x8C, 3, 4, false},
+
+    // ==== Arithmetic instructions ====
+    // ADC - Add with Carry
+    {"ADC", AddressingMode::Immediate, 0x69, 2, 2, false},
+    {"ADC", AddressingMode::ZeroPage, 0x65, 2, 3, false},
+    {"ADC", AddressingMode::ZeroPageX, 0x75, 2, 4, false},
+    {"ADC", AddressingMode::Absolute, 0x6D, 3, 4, false},
+    {"ADC", AddressingMode::AbsoluteX, 0x7D, 3, 4, true},
+    {"ADC", AddressingMode::AbsoluteY, 0x79, 3, 4, true},
+    {"ADC", AddressingMode::IndexedIndirect, 0x61, 2, 6, false},
+    {"ADC", AddressingMode::IndirectIndexed, 0x71, 2, 5, true},
+    // SBC - Subtract with Carry
+    {"SBC", AddressingMode::Immediate, 0xE9, 2, 2, false},
+    {"SBC", AddressingMode::ZeroPage, 0xE5, 2, 3, false},
+    {"SBC", AddressingMode::ZeroPageX, 0xF5, 2, 4, false},
+    {"SBC", AddressingMode::Absolute, 0xED, 3, 4, false},
+    {"SBC", AddressingMode::AbsoluteX, 0xFD, 3, 4, true},
+    {"SBC", AddressingMode::AbsoluteY, 0xF9, 3, 4, true},
+    {"SBC", AddressingMode::IndexedIndirect, 0xE1, 2, 6, false},
+    {"SBC", AddressingMode::IndirectIndexed, 0xF1, 2, 5, true},
+
+    // ==== INC/DEC instructions ====
+    // INC - Increment Memory
+    {"INC", AddressingMode::ZeroPage, 0xE6, 2, 5, false},
+    {"INC", AddressingMode::ZeroPageX, 0xF6, 2, 6, false},
+    {"INC", AddressingMode::Absolute, 0xEE, 3, 6, false},
+    {"INC", AddressingMode::AbsoluteX, 0xFE, 3, 7, false},
+    // DEC - Decrement Memory
+    {"DEC", AddressingMode::ZeroPage, 0xC6, 2, 5, false},
+    {"DEC", AddressingMode::ZeroPageX, 0xD6, 2, 6, false},
+    {"DEC", AddressingMode::Absolute, 0xCE, 3, 6, false},
+    {"DEC", AddressingMode::AbsoluteX, 0xDE, 3, 7, false},
+    // Register increment/decrement
+    {"INX", AddressingMode::Implied, 0xE8, 1, 2, false},
+    {"DEX", AddressingMode::Implied, 0xCA, 1, 2, false},
+    {"INY", AddressingMode::Implied, 0xC8, 1, 2, false},
+    {"DEY", AddressingMode::Implied, 0x88, 1, 2, false},
+
+    // ==== Logical operations ====
+    // AND - Logical AND
+    {"AND", AddressingMode::Immediate, 0x29, 2, 2, false},
+    {"AND", AddressingMode::ZeroPage, 0x25, 2, 3, false},
+    {"AND", AddressingMode::ZeroPageX, 0x35, 2, 4, false},
+    {"AND", AddressingMode::Absolute, 0x2D, 3, 4, false},
+    {"AND", AddressingMode::AbsoluteX, 0x3D, 3, 4, true},
+    {"AND", AddressingMode::AbsoluteY, 0x39, 3, 4, true},
+    {"AND", AddressingMode::IndexedIndirect, 0x21, 2, 6, false},
+    {"AND", AddressingMode::IndirectIndexed, 0x31, 2, 5, true},
+    // ORA - Logical OR
+    {"ORA", AddressingMode::Immediate, 0x09, 2, 2, false},
+    {"ORA", AddressingMode::ZeroPage, 0x05, 2, 3, false},
+    {"ORA", AddressingMode::ZeroPageX, 0x15, 2, 4, false},
+    {"ORA", AddressingMode::Absolute, 0x0D, 3, 4, false},
+    {"ORA", AddressingMode::AbsoluteX, 0x1D, 3, 4, true},
+    {"ORA", AddressingMode::AbsoluteY, 0x19, 3, 4, true},
+    {"ORA", AddressingMode::IndexedIndirect, 0x01, 2, 6, false},
+    {"ORA", AddressingMode::IndirectIndexed, 0x11, 2, 5, true},
+    // EOR - Exclusive OR
+    {"EOR", AddressingMode::Immediate, 0x49, 2, 2, false},
+    {"EOR", AddressingMode::ZeroPage, 0x45, 2, 3, false},
+    {"EOR", AddressingMode::ZeroPageX, 0x55, 2, 4, false},
+    {"EOR", AddressingMode::Absolute, 0x4D, 3, 4, false},
+    {"EOR", AddressingMode::AbsoluteX, 0x5D, 3, 4, true},
+    {"EOR", AddressingMode::AbsoluteY, 0x59, 3, 4, true},
+    {"EOR", AddressingMode::IndexedIndirect, 0x41, 2, 6, false},
+    {"EOR", AddressingMode::IndirectIndexed, 0x51, 2, 5, true},
+
+    // ==== Shift/rotate instructions ====
+    // ASL - Arithmetic Shift Left
+    {"ASL", AddressingMode::Accumulator, 0x0A, 1, 2, false},
+    {"ASL", AddressingMode::ZeroPage, 0x06, 2, 5, false},
+    {"ASL", AddressingMode::ZeroPageX, 0x16, 2, 6, false},
+    {"ASL", AddressingMode::Absolute, 0x0E, 3, 6, false},
+    {"ASL", AddressingMode::AbsoluteX, 0x1E, 3, 7, false},
+    // LSR - Logical Shift Right
+    {"LSR", AddressingMode::Accumulator, 0x4A, 1, 2, false},
+    {"LSR", AddressingMode::ZeroPage, 0x46, 2, 5, false},
+    {"LSR", AddressingMode::ZeroPageX, 0x56, 2, 6, false},
+    {"LSR", AddressingMode::Absolute, 0x4E, 3, 6, false},
+    {"LSR", AddressingMode::AbsoluteX, 0x5E, 3, 7, false},
+    // ROL - Rotate Left
+    {"ROL", AddressingMode::Accumulator, 0x2A, 1, 2, false},
+    {"ROL", AddressingMode::ZeroPage, 0x26, 2, 5, false},
+    {"ROL", AddressingMode::ZeroPageX, 0x36, 2, 6, false},
+    {"ROL", AddressingMode::Absolute, 0x2E, 3, 6, false},
+    {"ROL", AddressingMode::AbsoluteX, 0x3E, 3, 7, false},
+    // ROR - Rotate Right
+    {"ROR", AddressingMode::Accumulator, 0x6A, 1, 2, false},
+    {"ROR", AddressingMode::ZeroPage, 0x66, 2, 5, false},
+    {"ROR", AddressingMode::ZeroPageX, 0x76, 2, 6, false},
+    {"ROR", AddressingMode::Absolute, 0x6E, 3, 6, false},
+    {"ROR", AddressingMode::AbsoluteX, 0x7E, 3, 7, false},
+
+    // ==== Compare instructions ====
+    // CMP - Compare Accumulator
+    {"CMP", AddressingMode::Immediate, 0xC9, 2, 2, false},
+    {"CMP", AddressingMode::ZeroPage, 0xC5, 2, 3, false},
+    {"CMP", AddressingMode::ZeroPageX, 0xD5, 2, 4, false},
+    {"CMP", AddressingMode::Absolute, 0xCD, 3, 4, false},
+    {"CMP", AddressingMode::AbsoluteX, 0xDD, 3, 4, true},
+    {"CMP", AddressingMode::AbsoluteY, 0xD9, 3, 4, true},
+    {"CMP", AddressingMode::IndexedIndirect, 0xC1, 2, 6, false},
+    {"CMP", AddressingMode::IndirectIndexed, 0xD1, 2, 5, true},
+    // CPX - Compare X
+    {"CPX", AddressingMode::Immediate, 0xE0, 2, 2, false},
+    {"CPX", AddressingMode::ZeroPage, 0xE4, 2, 3, false},
+    {"CPX", AddressingMode::Absolute, 0xEC, 3, 4, false},
+    // CPY - Compare Y
+    {"CPY", AddressingMode::Immediate, 0xC0, 2, 2, false},
+    {"CPY", AddressingMode::ZeroPage, 0xC4, 2, 3, false},
+    {"CPY", AddressingMode::Absolute, 0xCC, 3, 4, false},
+    // BIT - Bit Test
+    {"BIT", AddressingMode::ZeroPage, 0x24, 2, 3, false},
+    {"BIT", AddressingMode::Absolute, 0x2C, 3, 4, false},
+
+    // ==== Branch instructions ====
+    // All branch instructions use relative addressing
+    {"BCC", AddressingMode::Relative, 0x90, 2, 2, true},
+    {"BCS", AddressingMode::Relative, 0xB0, 2, 2, true},
+    {"BEQ", AddressingMode::Relative, 0xF0, 2, 2, true},
+    {"BNE", AddressingMode::Relative, 0xD0, 2, 2, true},
+    {"BMI", AddressingMode::Relative, 0x30, 2, 2, true},
+    {"BPL", AddressingMode::Relative, 0x10, 2, 2, true},
+    {"BVC", AddressingMode::Relative, 0x50, 2, 2, true},
+    {"BVS", AddressingMode::Relative, 0x70, 2, 2, true},
+
+    // ==== Jump instructions ====
+    // JMP - Jump
+    {"JMP", AddressingMode::Absolute, 0x4C, 3, 3, false},
+    {"JMP", AddressingMode::Indirect, 0x6C, 3, 5, false},
+    // JSR - Jump to Subroutine
+    {"JSR", AddressingMode::Absolute, 0x20, 3, 6, false},
+    // RTS - Return from Subroutine
+    {"RTS", AddressingMode::Implied, 0x60, 1, 6, false},
+    // RTI - Return from Interrupt
+    {"RTI", AddressingMode::Implied, 0x40, 1, 6, false},
+
+    // ==== Register transfer ====
+    {"TAX", AddressingMode::Implied, 0xAA, 1, 2, false},
+    {"TAY", AddressingMode::Implied, 0xA8, 1, 2, false},
+    {"TXA", AddressingMode::Implied, 0x8A, 1, 2, false},
+    {"TYA", AddressingMode::Implied, 0x98, 1, 2, false},
+    {"TSX", AddressingMode::Implied, 0xBA, 1, 2, false},
+    {"TXS", AddressingMode::Implied, 0x9A, 1, 2, false},
+
+    // ==== Stack operations ====
+    {"PHA", AddressingMode::Implied, 0x48, 1, 3, false},
+    {"PHP", AddressingMode::Implied, 0x08, 1, 3, false},
+    {"PLA", AddressingMode::Implied, 0x68, 1, 4, false},
+    {"PLP", AddressingMode::Implied, 0x28, 1, 4, false},
+
+    // ==== Flag operations ====
+    {"CLC", AddressingMode::Implied, 0x18, 1, 2, false},
+    {"CLD", AddressingMode::Implied, 0xD8, 1, 2, false},
+    {"CLI", AddressingMode::Implied, 0x58, 1, 2, false},
+    {"CLV", AddressingMode::Implied, 0xB8, 1, 2, false},
+    {"SEC", AddressingMode::Implied, 0x38, 1, 2, false},
+    {"SED", AddressingMode::Implied, 0xF8, 1, 2, false},
+    {"SEI", AddressingMode::Implied, 0x78, 1, 2, false},
+
+    // ==== System instructions ====
+    {"BRK", AddressingMode::Implied, 0x00, 1, 7, false},
+    {"NOP", AddressingMode::Implied, 0xEA, 1, 2, false},
+};
+
+/**
+ * @brief Find an opcode variant (usable in constant expressions)
+ * @param mnemonic Uppercase instruction mnemonic
+ * @param mode Addressing mode
+ * @return const OpcodeSpec* Matching entry or nullptr
+ */
+constexpr const OpcodeSpec *find_opcode_spec(std::string_view mnemonic, AddressingMode mode) {
+    for (const auto &spec : kOpcodeSpecs) {
+        if (spec.mode == mode && spec.mnemonic == mnemonic) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Check whether any opcode variant uses a mnemonic
+ * @param mnemonic Uppercase instruction mnemonic
+ * @return bool True if known
+ */
+constexpr bool is_opcode_mnemonic(std::string_view mnemonic) {
+    for (const auto &spec : kOpcodeSpecs) {
+        if (spec.mnemonic == mnemonic) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace edasm
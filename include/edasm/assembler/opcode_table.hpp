@@ -12,33 +12,16 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
-namespace edasm {
+#include "edasm/assembler/opcode_specs.hpp"
 
-/**
- * @brief 6502 addressing modes
- *
- * All addressing modes supported by the 6502 processor.
- * Reference: 6502_INSTRUCTION_SET.md
- */
-enum class AddressingMode {
-    Implied,         ///< No operand (e.g., RTS)
-    Accumulator,     ///< Accumulator (e.g., ASL A)
-    Immediate,       ///< Immediate value (e.g., LDA #$42)
-    ZeroPage,        ///< Zero page address (e.g., LDA $42)
-    ZeroPageX,       ///< Zero page indexed by X (e.g., LDA $42,X)
-    ZeroPageY,       ///< Zero page indexed by Y (e.g., LDX $42,Y)
-    Absolute,        ///< Absolute address (e.g., LDA $1234)
-    AbsoluteX,       ///< Absolute indexed by X (e.g., LDA $1234,X)
-    AbsoluteY,       ///< Absolute indexed by Y (e.g., LDA $1234,Y)
-    Indirect,        ///< Indirect (e.g., JMP ($1234))
-    IndexedIndirect, ///< Indexed indirect (e.g., LDA ($42,X))
-    IndirectIndexed, ///< Indirect indexed (e.g., LDA ($42),Y)
-    Relative         ///< Relative branch (e.g., BEQ label)
-};
+namespace edasm {
 
 /**
  * @brief Opcode entry with metadata
@@ -58,7 +41,7 @@ struct Opcode {
  * @brief Opcode lookup table
  *
  * Fast lookup of 6502 opcodes by mnemonic and addressing mode.
- * Initialized with all legal 6502 opcodes at construction.
+ * Initialized from kOpcodeSpecs (all legal 6502 opcodes) at construction.
  */
 class OpcodeTable {
   public:
@@ -73,45 +56,35 @@ class OpcodeTable {
      * @param mode Addressing mode
      * @return const Opcode* Opcode entry or nullptr if not found
      */
-    const Opcode *lookup(const std::string &mnemonic, AddressingMode mode) const;
+    const Opcode *lookup(std::string_view mnemonic, AddressingMode mode) const;
 
     /**
      * @brief Get all valid addressing modes for a mnemonic
      * @param mnemonic Instruction mnemonic
      * @return std::vector<AddressingMode> List of valid modes
      */
-    std::vector<AddressingMode> valid_modes(const std::string &mnemonic) const;
+    std::vector<AddressingMode> valid_modes(std::string_view mnemonic) const;
 
     /**
      * @brief Check if mnemonic is valid
      * @param mnemonic Instruction mnemonic
      * @return bool True if mnemonic exists
      */
-    bool is_valid_mnemonic(const std::string &mnemonic) const;
+    bool is_valid_mnemonic(std::string_view mnemonic) const;
 
   private:
-    /// Nested map: mnemonic -> (mode -> opcode)
-    std::unordered_map<std::string, std::unordered_map<AddressingMode, Opcode>> table_;
+    /// Transparent hash so lookups by std::string_view avoid building a key
+    struct MnemonicHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view mnemonic) const noexcept {
+            return std::hash<std::string_view>{}(mnemonic);
+        }
+    };
 
-    /**
-     * @brief Add an opcode to the table
-     */
-    void add(const std::string &mnem, AddressingMode mode, uint8_t code, int bytes, int cycles,
-             bool page_cross = false);
-
-    // Initialization methods for opcode groups
-    void init_load_store();          ///< Load/store instructions
-    void init_arithmetic();          ///< Arithmetic instructions
-    void init_increment_decrement(); ///< INC/DEC instructions
-    void init_logical();             ///< Logical operations
-    void init_shift_rotate();        ///< Shift/rotate instructions
-    void init_compare();             ///< Compare instructions
-    void init_branch();              ///< Branch instructions
-    void init_jump();                ///< Jump instructions
-    void init_transfer();            ///< Register transfer
-    void init_stack();               ///< Stack operations
-    void init_flags();               ///< Flag operations
-    void init_system();              ///< System instructions
+    /// Nested map: mnemonic -> (mode -> opcode)
+    std::unordered_map<std::string, std::unordered_map<AddressingMode, Opcode>, MnemonicHash,
+                       std::equal_to<>>
+        table_;
 };
 
 /**
@@ -123,11 +96,31 @@ class AddressingModeDetector {
   public:
     /**
      * @brief Detect addressing mode from operand string
+     *
+     * Usable in constant expressions (shared with the constexpr assembler).
+     *
      * @param operand Operand string (e.g., "#$42", "$1234,X")
      * @param mnemonic Instruction mnemonic (for context)
      * @return AddressingMode Detected mode
      */
-    static AddressingMode detect(const std::string &operand, const std::string &mnemonic);
+    static constexpr AddressingMode detect(std::string_view operand, std::string_view mnemonic);
+
+    /**
+     * @brief Strip addressing-mode syntax, leaving the address expression
+     * @param operand Operand string (e.g., "($42),Y", "TABLE,X")
+     * @param mode Mode returned by detect() for this operand
+     * @return std::string_view Expression to evaluate (e.g., "$42", "TABLE")
+     */
+    static constexpr std::string_view address_expression(std::string_view operand,
+                                                         AddressingMode mode);
+
+    /**
+     * @brief Zero-page counterpart of an absolute mode
+     * @param mode Addressing mode
+     * @return std::optional<AddressingMode> ZeroPage/ZeroPageX/ZeroPageY, or
+     *         nullopt if mode has no zero-page form
+     */
+    static constexpr std::optional<AddressingMode> zero_page_form(AddressingMode mode);
 
   private:
     /**
@@ -135,7 +128,132 @@ class AddressingModeDetector {
      * @param mnemonic Instruction mnemonic
      * @return bool True if branch instruction
      */
-    static bool is_branch_instruction(const std::string &mnemonic);
+    static constexpr bool is_branch_instruction(std::string_view mnemonic);
 };
 
+// =========================================
+// Addressing Mode Detection
+// =========================================
+
+constexpr AddressingMode AddressingModeDetector::detect(std::string_view operand,
+                                                        std::string_view mnemonic) {
+    // Empty operand - Implied or Accumulator
+    if (operand.empty()) {
+        return AddressingMode::Implied;
+    }
+
+    // Check for accumulator mode ("A")
+    if (operand == "A" || operand == "a") {
+        return AddressingMode::Accumulator;
+    }
+
+    // Branch instructions always use relative
+    if (is_branch_instruction(mnemonic)) {
+        return AddressingMode::Relative;
+    }
+
+    // Immediate mode (#)
+    if (operand[0] == '#') {
+        return AddressingMode::Immediate;
+    }
+
+    // Indirect modes - check for parentheses
+    if (operand.find('(') != std::string_view::npos) {
+        if (operand.find(",X)") != std::string_view::npos ||
+            operand.find(",x)") != std::string_view::npos) {
+            return AddressingMode::IndexedIndirect; // ($nn,X)
+        } else if (operand.find("),Y") != std::string_view::npos ||
+                   operand.find("),y") != std::string_view::npos) {
+            return AddressingMode::IndirectIndexed; // ($nn),Y
+        } else {
+            return AddressingMode::Indirect; // ($nnnn) - JMP only
+        }
+    }
+
+    // Indexed modes - check for ,X or ,Y
+    bool has_x = operand.find(",X") != std::string_view::npos ||
+                 operand.find(",x") != std::string_view::npos;
+    bool has_y = operand.find(",Y") != std::string_view::npos ||
+                 operand.find(",y") != std::string_view::npos;
+
+    // Extract the address part (before ,X or ,Y if present)
+    std::string_view addr_part = operand.substr(0, operand.find(','));
+
+    // Trim whitespace
+    size_t first = addr_part.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        addr_part = {};
+    } else {
+        addr_part = addr_part.substr(first, addr_part.find_last_not_of(" \t") - first + 1);
+    }
+
+    // Detect zero page vs absolute based on value
+    // Zero page is $00-$FF (values 0-255)
+    bool is_zero_page = false;
+
+    // Check if it's a hex literal we can evaluate immediately
+    if (!addr_part.empty() && addr_part[0] == '$') {
+        std::string_view hex_str = addr_part.substr(1);
+        // If it's 1 or 2 hex digits, it's zero page
+        if (hex_str.length() <= 2) {
+            is_zero_page = true;
+        }
+    }
+
+    // Return appropriate mode
+    if (has_x) {
+        return is_zero_page ? AddressingMode::ZeroPageX : AddressingMode::AbsoluteX;
+    } else if (has_y) {
+        return is_zero_page ? AddressingMode::ZeroPageY : AddressingMode::AbsoluteY;
+    } else {
+        return is_zero_page ? AddressingMode::ZeroPage : AddressingMode::Absolute;
+    }
+}
+
+constexpr std::string_view AddressingModeDetector::address_expression(std::string_view operand,
+                                                                     AddressingMode mode) {
+    switch (mode) {
+    case AddressingMode::Immediate:
+        return operand.substr(1);
+    case AddressingMode::IndexedIndirect: // (expr,X)
+        return operand.substr(1, operand.rfind(',') - 1);
+    case AddressingMode::IndirectIndexed: // (expr),Y
+        return operand.substr(1, operand.rfind(',') - 2);
+    case AddressingMode::Indirect: // (expr)
+        return operand.substr(1, operand.rfind(')') - 1);
+    case AddressingMode::ZeroPageX:
+    case AddressingMode::ZeroPageY:
+    case AddressingMode::AbsoluteX:
+    case AddressingMode::AbsoluteY:
+        return operand.substr(0, operand.rfind(','));
+    default:
+        return operand;
+    }
+}
+
+constexpr std::optional<AddressingMode>
+AddressingModeDetector::zero_page_form(AddressingMode mode) {
+    switch (mode) {
+    case AddressingMode::Absolute:
+        return AddressingMode::ZeroPage;
+    case AddressingMode::AbsoluteX:
+        return AddressingMode::ZeroPageX;
+    case AddressingMode::AbsoluteY:
+        return AddressingMode::ZeroPageY;
+    default:
+        return std::nullopt;
+    }
+}
+
+constexpr bool AddressingModeDetector::is_branch_instruction(std::string_view mnemonic) {
+    constexpr std::string_view branches[] = {"BCC", "BCS", "BEQ", "BNE",
+                                             "BMI", "BPL", "BVC", "BVS"};
+    for (std::string_view branch : branches) {
+        if (branch == mnemonic) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace edasm
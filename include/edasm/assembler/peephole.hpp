@@ -0,0 +1,102 @@
+/**
+ * @file peephole.hpp
+ * @brief Opt-in peephole optimizer for generated 6502 code
+ *
+ * Works on the instruction stream pass 2 encoded (address, opcode, operand
+ * value, label and relocation metadata) and returns source-line rewrites;
+ * the assembler applies them and reassembles, so labels, branch offsets and
+ * RLD entries behind a shortened sequence are recomputed rather than
+ * patched.
+ *
+ * Patterns (each within a run of adjacent instructions):
+ *   LDr a / LDr b        first load is dead: removed
+ *   STr a / STr a        second store removed
+ *   STr a / LDr a        reload removed if N/Z are not read before being set
+ *   CLC / LDA m / ADC #1 / STA m   -> INC m  (SEC ... SBC #1 -> DEC m)
+ *                        if A, C and V are dead afterwards
+ *   JSR x / RTS          -> JMP x
+ *   JMP next             removed
+ *
+ * Safety rules: no instruction other than the first of a pattern may carry
+ * a label (a label-only line before it counts), instructions whose operand
+ * bytes are relocated (RLD) are never touched, and loads/stores in the
+ * $C000-$CFFF I/O page are never removed (soft switches act on access).
+ * Flag/register liveness is only proven within the adjacent run; a branch,
+ * jump or the end of the run counts as a use. Computed targets such as
+ * "JMP LABEL+1" into the middle of a pattern are not detected.
+ *
+ * No EDASM.SRC counterpart. 65C02 forms (STZ, BRA, INC A) are not
+ * generated: the opcode table and the emulator are NMOS 6502 only.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "edasm/assembler/opcode_table.hpp"
+
+namespace edasm {
+
+/**
+ * @brief Pattern-based optimizer over pass 2's encoded instructions
+ */
+class PeepholeOptimizer {
+  public:
+    /**
+     * @brief One instruction as encoded by pass 2
+     */
+    struct Instruction {
+        size_t line_index{0};           ///< Index into the preprocessed lines
+        int line_number{0};             ///< Source line number
+        uint16_t address{0};            ///< Address of the opcode byte
+        const Opcode *opcode{nullptr};  ///< Encoding (mnemonic, mode, size, cycles)
+        uint16_t operand{0};            ///< Operand value (0 if none)
+        std::string_view operand_text;  ///< Operand field as written
+        bool labeled{false};            ///< A label is defined at this address
+        bool relocated{false};          ///< Operand bytes carry an RLD entry
+    };
+
+    /**
+     * @brief Rewrite of one source line
+     *
+     * An empty mnemonic removes the instruction (a label on the line stays
+     * and now names the next instruction).
+     */
+    struct LineEdit {
+        size_t line_index{0};
+        std::string_view mnemonic;
+        std::string_view operand;
+    };
+
+    /**
+     * @brief One optimization, with its effect
+     */
+    struct Change {
+        int line_number{0};         ///< Line of the first instruction
+        uint16_t address{0};        ///< Address of the first instruction
+        std::string description;    ///< e.g. "JSR COUT / RTS -> JMP COUT"
+        int bytes_saved{0};
+        int cycles_saved{0};        ///< Base cycles, without page crossing
+        std::vector<LineEdit> edits;
+
+        /**
+         * @brief Report line, e.g. "Line 12 $0803: JSR COUT / RTS -> JMP COUT
+         *        (-1 bytes, -9 cycles)"
+         */
+        std::string report() const;
+    };
+
+    /**
+     * @brief Find optimizations in an encoded instruction stream
+     * @param code Instructions in emission order
+     * @return std::vector<Change> Non-overlapping changes, in order
+     */
+    static std::vector<Change> optimize(std::span<const Instruction> code);
+};
+
+} // namespace edasm
@@ -16,13 +16,23 @@
  * - Entry points (ENT directive): symbols exported to other modules
  * - External references (EXT directive): symbols imported from other modules
  *
+ * An optional page-layout section may follow the ESD terminator (C-EDASM
+ * extension, not in EDASM.SRC): ALIGN constraints and the spans of taken
+ * branches and indexed table reads, so the linker can place the module and
+ * report page crossings. Images without it are unchanged.
+ *
  * Reference: ASM3.S and LINKER/LINK.S from EDASM.SRC
  */
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace edasm {
@@ -34,6 +44,7 @@ namespace edasm {
 //   [CODE IMAGE with 2-byte length header]
 //   [RLD - Relocation Dictionary]
 //   [ESD - External Symbol Dictionary]
+//   [PAGE - optional page-layout records, only written when present]
 
 // RLD (Relocation Dictionary) Entry - 4 bytes
 // Describes locations in code that need relocation
@@ -47,10 +58,22 @@ struct RLDEntry {
     static constexpr uint8_t TYPE_RELATIVE = 0x01;
     static constexpr uint8_t TYPE_EXTERNAL = 0x02;
 
+    static constexpr size_t kSize = 4; // Serialized size in bytes
+
+    // Serialize into out (kSize bytes); returns the position after the entry
+    uint8_t *write(uint8_t *out) const {
+        out[0] = flags;
+        out[1] = static_cast<uint8_t>(address & 0xFF);
+        out[2] = static_cast<uint8_t>(address >> 8);
+        out[3] = symbol_num;
+        return out + kSize;
+    }
+
     // Serialize to bytes
     std::vector<uint8_t> to_bytes() const {
-        return {flags, static_cast<uint8_t>(address & 0xFF), static_cast<uint8_t>(address >> 8),
-                symbol_num};
+        std::vector<uint8_t> bytes(kSize);
+        write(bytes.data());
+        return bytes;
     }
 
     // Deserialize from bytes
@@ -94,19 +117,27 @@ struct ESDEntry {
         return (flags & FLAG_UNDEFINED) != 0;
     }
 
-    // Serialize to bytes (p-string format)
-    std::vector<uint8_t> to_bytes() const {
-        std::vector<uint8_t> bytes;
-        bytes.push_back(flags);
-        bytes.push_back(static_cast<uint8_t>(address & 0xFF));
-        bytes.push_back(static_cast<uint8_t>(address >> 8));
+    // Serialized size in bytes (header + p-string)
+    size_t size() const {
+        return 4 + static_cast<uint8_t>(name.length());
+    }
+
+    // Serialize into out (size() bytes); returns the position after the entry
+    uint8_t *write(uint8_t *out) const {
+        out[0] = flags;
+        out[1] = static_cast<uint8_t>(address & 0xFF);
+        out[2] = static_cast<uint8_t>(address >> 8);
 
         // P-string: length byte + string data
-        bytes.push_back(static_cast<uint8_t>(name.length()));
-        for (char c : name) {
-            bytes.push_back(static_cast<uint8_t>(c));
-        }
+        const uint8_t length = static_cast<uint8_t>(name.length());
+        out[3] = length;
+        return std::copy_n(name.begin(), length, out + 4);
+    }
 
+    // Serialize to bytes (p-string format)
+    std::vector<uint8_t> to_bytes() const {
+        std::vector<uint8_t> bytes(size());
+        write(bytes.data());
         return bytes;
     }
 
@@ -127,11 +158,72 @@ struct ESDEntry {
     }
 };
 
+// Page-layout record - 7 bytes, in the optional section after the ESD
+// terminator. ALIGN and FIT records are constraints the linker's page
+// layout honors; BRANCH and INDEXED records are only checked and reported.
+struct PageSpan {
+    uint8_t kind;
+    uint16_t offset;   // Code offset of the first byte
+    uint16_t length;   // Bytes that should share a block (0 for KIND_ALIGN)
+    uint16_t boundary; // Block size / alignment (power of two, at most $100)
+
+    static constexpr uint8_t KIND_ALIGN = 0x01;   // offset must be a multiple of boundary
+    static constexpr uint8_t KIND_FIT = 0x02;     // span must not cross a boundary
+    static constexpr uint8_t KIND_BRANCH = 0x03;  // taken branch: next PC to target
+    static constexpr uint8_t KIND_INDEXED = 0x04; // indexed read: base to end of table
+
+    static constexpr size_t kSize = 7; // Serialized size in bytes
+
+    bool is_constraint() const {
+        return kind == KIND_ALIGN || kind == KIND_FIT;
+    }
+
+    // True if the span, with the code loaded at base, crosses a boundary
+    bool crosses(uint16_t base) const {
+        const uint32_t start = static_cast<uint32_t>(base) + offset;
+        const uint32_t end = start + (length > 0 ? length - 1 : 0);
+        return start / boundary != end / boundary;
+    }
+
+    // True if a constraint holds with the code loaded at base
+    bool satisfied_at(uint16_t base) const {
+        if (kind == KIND_ALIGN) {
+            return (static_cast<uint32_t>(base) + offset) % boundary == 0;
+        }
+        return !crosses(base);
+    }
+
+    // Serialize into out (kSize bytes); returns the position after the record
+    uint8_t *write(uint8_t *out) const {
+        out[0] = kind;
+        out[1] = static_cast<uint8_t>(offset & 0xFF);
+        out[2] = static_cast<uint8_t>(offset >> 8);
+        out[3] = static_cast<uint8_t>(length & 0xFF);
+        out[4] = static_cast<uint8_t>(length >> 8);
+        out[5] = static_cast<uint8_t>(boundary & 0xFF);
+        out[6] = static_cast<uint8_t>(boundary >> 8);
+        return out + kSize;
+    }
+
+    // Deserialize from bytes
+    static PageSpan from_bytes(const uint8_t *data) {
+        PageSpan span;
+        span.kind = data[0];
+        span.offset = data[1] | (static_cast<uint16_t>(data[2]) << 8);
+        span.length = data[3] | (static_cast<uint16_t>(data[4]) << 8);
+        span.boundary = data[5] | (static_cast<uint16_t>(data[6]) << 8);
+        return span;
+    }
+};
+
 // REL File Builder
-// Collects RLD and ESD entries during assembly and generates REL file format
+// Collects RLD and ESD entries during assembly and generates REL file format.
+// Entry lists are allocated from the given memory resource (the assembler's
+// per-assembly arena); build() returns an ordinary heap vector.
 class RELFileBuilder {
   public:
-    RELFileBuilder() = default;
+    explicit RELFileBuilder(std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+        : rld_entries_(mr), esd_entries_(mr), page_spans_(mr) {}
 
     // Add relocation entry (called when code needs relocation)
     void add_rld_entry(uint16_t address, uint8_t flags, uint8_t symbol_num = 0) {
@@ -143,7 +235,7 @@ class RELFileBuilder {
     }
 
     // Add external symbol dictionary entry
-    void add_esd_entry(const std::string &name, uint16_t address, uint8_t flags,
+    void add_esd_entry(std::string_view name, uint16_t address, uint8_t flags,
                        uint8_t symbol_num = 0) {
         ESDEntry entry;
         entry.name = name;
@@ -153,42 +245,98 @@ class RELFileBuilder {
         esd_entries_.push_back(entry);
     }
 
-    // Build complete REL file format: [length header][code][RLD][ESD]
-    std::vector<uint8_t> build(const std::vector<uint8_t> &code) const {
-        std::vector<uint8_t> rel_file;
+    // Add page-layout record (ALIGN directive, branch or indexed read)
+    void add_page_span(uint8_t kind, uint16_t offset, uint16_t length, uint16_t boundary) {
+        page_spans_.push_back(PageSpan{kind, offset, length, boundary});
+    }
 
-        // Code image with 2-byte length header (little-endian)
-        uint16_t code_len = static_cast<uint16_t>(code.size());
-        rel_file.push_back(static_cast<uint8_t>(code_len & 0xFF));
-        rel_file.push_back(static_cast<uint8_t>(code_len >> 8));
+    // Size of the RLD and ESD sections including both terminators, plus the
+    // page-layout section if there is one
+    size_t dictionaries_size() const {
+        size_t size = rld_entries_.size() * RLDEntry::kSize + 1;
+        for (const auto &entry : esd_entries_) {
+            size += entry.size();
+        }
+        if (!page_spans_.empty()) {
+            size += page_spans_.size() * PageSpan::kSize + 1;
+        }
+        return size + 1;
+    }
 
-        // Code image
-        rel_file.insert(rel_file.end(), code.begin(), code.end());
+    // Size of the complete REL image for a code image of code_size bytes
+    size_t image_size(size_t code_size) const {
+        return 2 + code_size + dictionaries_size();
+    }
 
+    // Serialize RLD, ESD and page-layout sections into out
+    // (dictionaries_size() bytes); returns the position after the last one
+    uint8_t *write_dictionaries(uint8_t *out) const {
         // RLD entries (4 bytes each)
         for (const auto &entry : rld_entries_) {
-            auto bytes = entry.to_bytes();
-            rel_file.insert(rel_file.end(), bytes.begin(), bytes.end());
+            out = entry.write(out);
         }
 
         // RLD terminator (0x00)
-        rel_file.push_back(0x00);
+        *out++ = 0x00;
 
         // ESD entries (variable length)
         for (const auto &entry : esd_entries_) {
-            auto bytes = entry.to_bytes();
-            rel_file.insert(rel_file.end(), bytes.begin(), bytes.end());
+            out = entry.write(out);
         }
 
         // ESD terminator (0x00)
-        rel_file.push_back(0x00);
+        *out++ = 0x00;
+
+        // Page-layout records (7 bytes each) and their terminator (0x00)
+        if (!page_spans_.empty()) {
+            for (const auto &span : page_spans_) {
+                out = span.write(out);
+            }
+            *out++ = 0x00;
+        }
+        return out;
+    }
+
+    // Build complete REL file format: [length header][code][RLD][ESD]
+    // The image is sized up front and every record is written in place.
+    std::vector<uint8_t> build(std::span<const uint8_t> code) const {
+        std::vector<uint8_t> rel_file(image_size(code.size()));
+
+        // Code image with 2-byte length header (little-endian)
+        uint16_t code_len = static_cast<uint16_t>(code.size());
+        rel_file[0] = static_cast<uint8_t>(code_len & 0xFF);
+        rel_file[1] = static_cast<uint8_t>(code_len >> 8);
+
+        // Code image, then the dictionaries
+        uint8_t *out = std::copy(code.begin(), code.end(), rel_file.data() + 2);
+        write_dictionaries(out);
 
         return rel_file;
     }
 
-    // Parse REL file format
+    // Stream the REL file format to out without building an in-memory
+    // image: the code is written straight from the caller's buffer and the
+    // dictionaries from one buffer serialized in place
+    bool write(std::ostream &out, std::span<const uint8_t> code) const {
+        uint16_t code_len = static_cast<uint16_t>(code.size());
+        const char header[2] = {static_cast<char>(code_len & 0xFF),
+                                static_cast<char>(code_len >> 8)};
+        out.write(header, sizeof(header));
+        out.write(reinterpret_cast<const char *>(code.data()),
+                  static_cast<std::streamsize>(code.size()));
+
+        std::vector<uint8_t> dictionaries(dictionaries_size());
+        write_dictionaries(dictionaries.data());
+        out.write(reinterpret_cast<const char *>(dictionaries.data()),
+                  static_cast<std::streamsize>(dictionaries.size()));
+        return static_cast<bool>(out);
+    }
+
+    // Parse REL file format (page_spans, if given, receives the optional
+    // page-layout section)
     static bool parse(const std::vector<uint8_t> &data, std::vector<uint8_t> &code,
-                      std::vector<RLDEntry> &rld_entries, std::vector<ESDEntry> &esd_entries) {
+                      std::vector<RLDEntry> &rld_entries, std::vector<ESDEntry> &esd_entries,
+                      std::vector<PageSpan> *page_spans = nullptr) {
         if (data.size() < 2)
             return false;
 
@@ -218,6 +366,7 @@ class RELFileBuilder {
         while (pos < data.size()) {
             if (data[pos] == 0x00) {
                 // ESD terminator
+                pos++;
                 break;
             }
 
@@ -227,24 +376,36 @@ class RELFileBuilder {
             pos += bytes_read;
         }
 
+        // Parse page-layout records (absent in older images)
+        while (page_spans && pos + PageSpan::kSize <= data.size() && data[pos] != 0x00) {
+            page_spans->push_back(PageSpan::from_bytes(&data[pos]));
+            pos += PageSpan::kSize;
+        }
+
         return true;
     }
 
+    // Drop entries and their storage so the backing arena can be released
     void reset() {
-        rld_entries_.clear();
-        esd_entries_.clear();
+        std::pmr::vector<RLDEntry>(rld_entries_.get_allocator()).swap(rld_entries_);
+        std::pmr::vector<ESDEntry>(esd_entries_.get_allocator()).swap(esd_entries_);
+        std::pmr::vector<PageSpan>(page_spans_.get_allocator()).swap(page_spans_);
     }
 
-    const std::vector<RLDEntry> &rld_entries() const {
+    const std::pmr::vector<RLDEntry> &rld_entries() const {
         return rld_entries_;
     }
-    const std::vector<ESDEntry> &esd_entries() const {
+    const std::pmr::vector<ESDEntry> &esd_entries() const {
         return esd_entries_;
     }
+    const std::pmr::vector<PageSpan> &page_spans() const {
+        return page_spans_;
+    }
 
   private:
-    std::vector<RLDEntry> rld_entries_;
-    std::vector<ESDEntry> esd_entries_;
+    std::pmr::vector<RLDEntry> rld_entries_;
+    std::pmr::vector<ESDEntry> esd_entries_;
+    std::pmr::vector<PageSpan> page_spans_;
 };
 
 } // namespace edasm
@@ -0,0 +1,153 @@
+/**
+ * @file symbol_snapshot.hpp
+ * @brief Precompiled symbol snapshots for shared equate files
+ *
+ * A symbol snapshot is the symbol table of an equate-only source file
+ * (e.g. ProDOS/monitor equates that every module INCLUDEs), assembled once
+ * and saved in a compact binary form. When Assembler::Options lists a
+ * snapshot and an INCLUDE directive reads a file whose contents hash to the
+ * snapshot's source hash, the assembler imports the stored symbols instead
+ * of tokenizing and evaluating the file again. Any edit to the file changes
+ * its hash, so a stale snapshot is simply not used.
+ *
+ * No EDASM.SRC counterpart; this is a build-speed aid for the C++ port.
+ *
+ * File format (all integers little-endian):
+ *   "EDSY"  magic
+ *   u16     format version (1)
+ *   u64     FNV-1a hash of the source text
+ *   u32     source text size in bytes
+ *   u16     length + bytes of the source path (informational)
+ *   u32     symbol count
+ *   per symbol: u8 name length, name bytes, u16 value, u8 flags, u32 line
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "edasm/assembler/symbol_table.hpp"
+
+namespace edasm {
+
+/**
+ * @brief Stored symbols of one equate file, keyed by its content hash
+ */
+class SymbolSnapshot {
+  public:
+    /**
+     * @brief One symbol as defined by the equate file
+     */
+    struct Entry {
+        std::string name;     ///< Symbol name
+        uint16_t value{0};    ///< Symbol value
+        uint8_t flags{0};     ///< SYM_* flags after assembling the file
+        int line_defined{0};  ///< Line in the equate file
+    };
+
+    static constexpr uint16_t kFormatVersion = 1;
+
+    /**
+     * @brief Assemble an equate file and capture its symbols
+     *
+     * Only comments, blank lines, EQU, LST, SBTL and conditional directives
+     * are accepted: anything that emits code, changes the PC or pulls in
+     * other files would make the symbols depend on where the file is
+     * INCLUDEd. Relative or external results are rejected for the same
+     * reason.
+     *
+     * @param source Equate file text
+     * @param source_path Path recorded in the snapshot (informational)
+     * @param error Receives the reason on failure (optional)
+     * @return std::optional<SymbolSnapshot> Snapshot, or nullopt on failure
+     */
+    static std::optional<SymbolSnapshot> build(std::string_view source,
+                                               std::string_view source_path,
+                                               std::string *error = nullptr);
+
+    /**
+     * @brief Hash used to match a snapshot to INCLUDEd file contents
+     * @param text File contents
+     * @return uint64_t 64-bit FNV-1a hash
+     */
+    static uint64_t content_hash(std::string_view text);
+
+    /**
+     * @brief Check whether this snapshot was built from the given text
+     * @param text File contents
+     * @return bool True if size and hash match
+     */
+    bool matches(std::string_view text) const {
+        return text.size() == source_size_ && content_hash(text) == source_hash_;
+    }
+
+    /**
+     * @brief Define every stored symbol in a table
+     *
+     * Equivalent to assembling the file's EQU lines at that point, without
+     * tokenizing or evaluating anything. A symbol the table already defines
+     * keeps its definition and is reported instead of being overwritten.
+     *
+     * @param table Destination table
+     * @param duplicates Receives the names of already-defined symbols (optional)
+     * @return bool True if no stored symbol was already defined
+     */
+    bool import_into(SymbolTable &table, std::vector<std::string> *duplicates = nullptr) const;
+
+    /**
+     * @brief Serialize to the binary snapshot format
+     * @return std::vector<uint8_t> Snapshot bytes
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * @brief Parse the binary snapshot format
+     * @param data Snapshot bytes
+     * @param error Receives the reason on failure (optional)
+     * @return std::optional<SymbolSnapshot> Snapshot, or nullopt if malformed
+     */
+    static std::optional<SymbolSnapshot> deserialize(std::span<const uint8_t> data,
+                                                     std::string *error = nullptr);
+
+    /**
+     * @brief Write the snapshot to a file
+     * @param path Output path
+     * @return bool True on success
+     */
+    bool save(const std::string &path) const;
+
+    /**
+     * @brief Read a snapshot file
+     * @param path Snapshot path
+     * @param error Receives the reason on failure (optional)
+     * @return std::optional<SymbolSnapshot> Snapshot, or nullopt on failure
+     */
+    static std::optional<SymbolSnapshot> load(const std::string &path,
+                                              std::string *error = nullptr);
+
+    uint64_t source_hash() const {
+        return source_hash_;
+    }
+    size_t source_size() const {
+        return source_size_;
+    }
+    const std::string &source_path() const {
+        return source_path_;
+    }
+    const std::vector<Entry> &entries() const {
+        return entries_;
+    }
+
+  private:
+    uint64_t source_hash_{0};
+    size_t source_size_{0};
+    std::string source_path_;
+    std::vector<Entry> entries_; ///< Sorted by name
+};
+
+} // namespace edasm
@@ -9,8 +9,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -23,14 +29,34 @@ namespace edasm {
  *
  * Represents a single symbol with its value and metadata flags.
  * Flags indicate symbol properties: relative, external, entry, undefined, etc.
+ * Allocator-aware so entries stored in the table share its memory resource;
+ * plain copies (e.g. from sorted_by_name()) use the default heap.
  */
 struct Symbol {
-    std::string name;         ///< Symbol name
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::string name;    ///< Symbol name
     uint16_t value{0};        ///< Symbol value (address or constant)
     uint8_t flags{0};         ///< SYM_* flags from constants.hpp
     int line_defined{0};      ///< Line where symbol was defined
     uint8_t symbol_number{0}; ///< Symbol number for REL file EXTERN refs
 
+    Symbol() = default;
+    Symbol(const Symbol &) = default;
+    Symbol(Symbol &&) = default;
+    Symbol &operator=(const Symbol &) = default;
+    Symbol &operator=(Symbol &&) = default;
+
+    explicit Symbol(const allocator_type &alloc) : name(alloc) {}
+
+    Symbol(const Symbol &other, const allocator_type &alloc)
+        : name(other.name, alloc), value(other.value), flags(other.flags),
+          line_defined(other.line_defined), symbol_number(other.symbol_number) {}
+
+    Symbol(Symbol &&other, const allocator_type &alloc)
+        : name(std::move(other.name), alloc), value(other.value), flags(other.flags),
+          line_defined(other.line_defined), symbol_number(other.symbol_number) {}
+
     /**
      * @brief Check if symbol is undefined
      * @return bool True if SYM_UNDEFINED flag set
@@ -85,11 +111,107 @@ struct Symbol {
  *
  * Hash-based symbol storage and lookup. Provides symbol definition,
  * value updates, flag manipulation, and sorted iteration.
+ *
+ * Keys, nodes and buckets are allocated from the memory resource given at
+ * construction, which lets the assembler keep the table in its per-assembly
+ * arena. Lookups take std::string_view and never allocate.
+ *
+ * Sorted iteration is offered as views (by_name(), by_value()): vectors of
+ * pointers into the node-based map, whose elements never move. Views are
+ * built on first use and cached until the table changes. Any mutating
+ * call, including the mutable lookup(), invalidates them: a View records
+ * the table version it was taken at, View::valid() reports whether it
+ * still matches, and debug builds assert on every access to a stale View.
+ * Large tables are sorted on several threads only when the caller asks
+ * for it with set_sort_threads().
  */
 class SymbolTable {
   public:
+    /// Transparent hash so lookups by std::string_view avoid building a key
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const noexcept {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    using Map = std::pmr::unordered_map<std::pmr::string, Symbol, NameHash, std::equal_to<>>;
+
+    /**
+     * @brief Sorted, non-owning view of the table (valid until the table changes)
+     */
+    class View {
+      public:
+        using iterator = std::span<const Symbol *const>::iterator;
+
+        /// False once the table has changed since the view was taken
+        bool valid() const {
+            return table_->version_ == version_;
+        }
+
+        size_t size() const {
+            check();
+            return items_.size();
+        }
+        bool empty() const {
+            check();
+            return items_.empty();
+        }
+        const Symbol *operator[](size_t index) const {
+            check();
+            return items_[index];
+        }
+        const Symbol *front() const {
+            check();
+            return items_.front();
+        }
+        const Symbol *back() const {
+            check();
+            return items_.back();
+        }
+        const Symbol *const *data() const {
+            check();
+            return items_.data();
+        }
+        iterator begin() const {
+            check();
+            return items_.begin();
+        }
+        iterator end() const {
+            check();
+            return items_.end();
+        }
+
+      private:
+        friend class SymbolTable;
+        View(const SymbolTable &table, std::span<const Symbol *const> items)
+            : table_(&table), items_(items), version_(table.version_) {}
+
+        void check() const {
+            assert(valid() && "SymbolTable::View used after the table changed");
+        }
+
+        const SymbolTable *table_;
+        std::span<const Symbol *const> items_;
+        uint64_t version_;
+    };
+
+    /// Tables at least this large are sorted on several threads (see
+    /// set_sort_threads)
+    static constexpr size_t kParallelSortThreshold = 16384;
+
+    /**
+     * @brief Construct an empty table
+     * @param mr Memory resource for symbol storage (default heap)
+     */
+    explicit SymbolTable(std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+        : table_(mr), by_name_(mr), by_value_(mr) {}
+
     /**
      * @brief Reset symbol table (clear all symbols)
+     *
+     * Also drops the bucket array so no storage from the memory resource is
+     * retained (the owning arena may be released afterwards).
      */
     void reset();
 
@@ -102,81 +224,101 @@ class SymbolTable {
      * @param flags Symbol flags (default 0)
      * @param line_num Line where defined (default 0)
      */
-    void define(const std::string &name, uint16_t value, uint8_t flags = 0, int line_num = 0);
+    void define(std::string_view name, uint16_t value, uint8_t flags = 0, int line_num = 0);
 
     /**
      * @brief Update symbol value
      * @param name Symbol name
      * @param value New value
      */
-    void update_value(const std::string &name, uint16_t value);
+    void update_value(std::string_view name, uint16_t value);
 
     /**
      * @brief Update symbol flags
      * @param name Symbol name
      * @param flags New flags
      */
-    void update_flags(const std::string &name, uint8_t flags);
+    void update_flags(std::string_view name, uint8_t flags);
 
     /**
      * @brief Mark symbol as referenced (clear SYM_UNREFERENCED)
      * @param name Symbol name
      */
-    void mark_referenced(const std::string &name);
+    void mark_referenced(std::string_view name);
 
     /**
      * @brief Look up symbol (mutable)
      * @param name Symbol name
      * @return Symbol* Pointer to symbol or nullptr
      */
-    Symbol *lookup(const std::string &name);
+    Symbol *lookup(std::string_view name);
 
     /**
      * @brief Look up symbol (const)
      * @param name Symbol name
      * @return const Symbol* Pointer to symbol or nullptr
      */
-    const Symbol *lookup(const std::string &name) const;
+    const Symbol *lookup(std::string_view name) const;
 
     /**
      * @brief Get symbol value
      * @param name Symbol name
      * @return std::optional<uint16_t> Value if defined, nullopt otherwise
      */
-    std::optional<uint16_t> get_value(const std::string &name) const;
+    std::optional<uint16_t> get_value(std::string_view name) const;
 
     /**
      * @brief Check if symbol is defined
      * @param name Symbol name
      * @return bool True if symbol exists in table
      */
-    bool is_defined(const std::string &name) const;
+    bool is_defined(std::string_view name) const;
+
+    /**
+     * @brief Threads used to sort large tables for the views
+     * @param threads 1 (default) sorts on the calling thread only
+     */
+    void set_sort_threads(unsigned threads) {
+        sort_threads_ = std::max(1u, threads);
+    }
 
     // Symbol table inspection
 
+    /**
+     * @brief View of all symbols sorted by name (cached, no copies)
+     * @return View Pointers into the table, valid until it changes
+     */
+    View by_name() const;
+
+    /**
+     * @brief View of all symbols sorted by value, then name (cached, no copies)
+     * @return View Pointers into the table, valid until it changes
+     */
+    View by_value() const;
+
     /**
      * @brief Get all symbols as vector
-     * @return std::vector<Symbol> All symbols
+     * @return std::vector<Symbol> Copies of all symbols
      */
     std::vector<Symbol> all_symbols() const;
 
     /**
      * @brief Get symbols sorted by name
-     * @return std::vector<Symbol> Sorted symbol list
+     * @return std::vector<Symbol> Copies in by_name() order
      */
     std::vector<Symbol> sorted_by_name() const;
 
     /**
      * @brief Get symbols sorted by value
-     * @return std::vector<Symbol> Sorted symbol list
+     * @return std::vector<Symbol> Copies in by_value() order
      */
     std::vector<Symbol> sorted_by_value() const;
 
     /**
      * @brief Get underlying symbol map
-     * @return const std::unordered_map<std::string, Symbol>& Symbol map
+     * @return const Map& Symbol map
      */
-    const std::unordered_map<std::string, Symbol> &get_all() const {
+    const Map &get_all() const {
         return table_;
     }
 
@@ -189,7 +331,19 @@ class SymbolTable {
     }
 
   private:
-    std::unordered_map<std::string, Symbol> table_; ///< Hash-based symbol storage
+    Map table_; ///< Hash-based symbol storage
+
+    // Sorted view caches; a cache is current when its version matches version_
+    uint64_t version_{1};                              ///< Bumped on every change
+    mutable std::pmr::vector<const Symbol *> by_name_;  ///< Cached name order
+    mutable std::pmr::vector<const Symbol *> by_value_; ///< Cached value order
+    mutable uint64_t by_name_version_{0};               ///< version_ when by_name_ built
+    mutable uint64_t by_value_version_{0};              ///< version_ when by_value_ built
+    unsigned sort_threads_{1};                          ///< Threads for large sorts
+
+    void invalidate_views() {
+        ++version_;
+    }
 };
 
 } // namespace edasm
@@ -8,7 +8,15 @@
 
 #pragma once
 
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "edasm/assembler/char_scanner.hpp"
 
 namespace edasm {
 
@@ -17,14 +25,39 @@ namespace edasm {
  *
  * Represents a single line of 6502 assembly source broken into its components.
  * Based on ASM2.S tokenization logic.
+ *
+ * Allocator-aware: when stored in a std::pmr container (or built by
+ * Tokenizer::parse_line with a memory resource) all fields allocate from the
+ * same resource, so a whole assembly's lines can live in one arena.
  */
 struct SourceLine {
-    int line_number{0};   ///< Line number in source file
-    std::string label;    ///< Optional label (symbol definition)
-    std::string mnemonic; ///< Instruction or directive
-    std::string operand;  ///< Operand field (may contain expressions)
-    std::string comment;  ///< Comment (after semicolon)
-    std::string raw_line; ///< Original line text
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    int line_number{0};        ///< Line number in source file
+    std::pmr::string label;    ///< Optional label (symbol definition)
+    std::pmr::string mnemonic; ///< Instruction or directive
+    std::pmr::string operand;  ///< Operand field (may contain expressions)
+    std::pmr::string comment;  ///< Comment (after semicolon)
+    std::pmr::string raw_line; ///< Original line text
+
+    SourceLine() = default;
+    SourceLine(const SourceLine &) = default;
+    SourceLine(SourceLine &&) = default;
+    SourceLine &operator=(const SourceLine &) = default;
+    SourceLine &operator=(SourceLine &&) = default;
+
+    explicit SourceLine(const allocator_type &alloc)
+        : label(alloc), mnemonic(alloc), operand(alloc), comment(alloc), raw_line(alloc) {}
+
+    SourceLine(const SourceLine &other, const allocator_type &alloc)
+        : line_number(other.line_number), label(other.label, alloc),
+          mnemonic(other.mnemonic, alloc), operand(other.operand, alloc),
+          comment(other.comment, alloc), raw_line(other.raw_line, alloc) {}
+
+    SourceLine(SourceLine &&other, const allocator_type &alloc)
+        : line_number(other.line_number), label(std::move(other.label), alloc),
+          mnemonic(std::move(other.mnemonic), alloc), operand(std::move(other.operand), alloc),
+          comment(std::move(other.comment), alloc), raw_line(std::move(other.raw_line), alloc) {}
 
     /**
      * @brief Check if line has a label
@@ -59,6 +92,16 @@ struct SourceLine {
     }
 };
 
+/**
+ * @brief Fields of one source line as views into its text
+ */
+struct LineFields {
+    std::string_view label;    ///< Label in column 0, without a trailing colon
+    std::string_view mnemonic; ///< Mnemonic as written (not uppercased)
+    std::string_view operand;  ///< Operand, trimmed
+    std::string_view comment;  ///< Comment, from ';' (or the whole comment line)
+};
+
 /**
  * @brief Tokenizer for 6502 assembly source
  *
@@ -72,45 +115,293 @@ class Tokenizer {
      * @brief Parse a single line into components
      * @param line Source line text
      * @param line_number Line number for tracking
+     * @param mr Memory resource for the line's strings (default heap)
      * @return SourceLine Tokenized line structure
      */
-    static SourceLine parse_line(const std::string &line, int line_number);
+    static SourceLine parse_line(std::string_view line, int line_number,
+                                 std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+    /**
+     * @brief Split a line into its fields without copying
+     *
+     * The field rules behind parse_line(). Usable in constant expressions
+     * (shared with the constexpr assembler); at run time the fields are
+     * located with CharScanner.
+     *
+     * @param line Source line text
+     * @return LineFields Views into line
+     */
+    static constexpr LineFields split_fields(std::string_view line);
+
+    /**
+     * @brief Locate the mnemonic field without tokenizing the line
+     *
+     * Applies the same field rules as parse_line() but only returns a view
+     * of the mnemonic as written (not uppercased). Used to scan lines that
+     * may never need a full SourceLine, e.g. inside inactive DO/ELSE/FIN
+     * blocks.
+     *
+     * @param line Source line text
+     * @return std::string_view Mnemonic text, empty for comment/label-only lines
+     */
+    static constexpr std::string_view peek_mnemonic(std::string_view line);
 
   private:
+    /**
+     * @brief Split off the label and mnemonic fields
+     * @param line Source line text (not a comment line)
+     * @param fields Receives label and mnemonic
+     * @return size_t Offset just past the mnemonic
+     */
+    static constexpr size_t split_label_and_mnemonic(std::string_view line, LineFields &fields);
+
     /**
      * @brief Trim whitespace from string
      * @param str String to trim
-     * @return std::string Trimmed string
+     * @return std::string_view Trimmed view into str
      */
-    static std::string trim(const std::string &str);
+    static constexpr std::string_view trim(std::string_view str);
 
     /**
-     * @brief Convert string to uppercase
+     * @brief Copy string into dest converted to uppercase
      * @param str String to convert
-     * @return std::string Uppercase string
+     * @param dest Destination string (keeps its allocator)
      */
-    static std::string to_upper(const std::string &str);
+    static void to_upper(std::string_view str, std::pmr::string &dest);
 
     /**
      * @brief Check if character is whitespace
      * @param c Character to check
      * @return bool True if whitespace
      */
-    static bool is_whitespace(char c);
+    static constexpr bool is_whitespace(char c);
 
     /**
      * @brief Check if character can start a label
      * @param c Character to check
      * @return bool True if valid label start
      */
-    static bool is_label_start(char c);
+    static constexpr bool is_label_start(char c);
 
     /**
      * @brief Check if character can be in a label
      * @param c Character to check
      * @return bool True if valid label character
      */
-    static bool is_label_char(char c);
+    static constexpr bool is_label_char(char c);
+
+    // CharScanner searches, or the same search one character at a time
+    // during constant evaluation
+    static constexpr size_t skip_blanks(std::string_view text, size_t pos);
+    static constexpr size_t skip_label_chars(std::string_view text, size_t pos);
+    static constexpr size_t find_blank_or_semicolon(std::string_view text, size_t pos);
+    static constexpr size_t find_semicolon(std::string_view text, size_t pos);
+};
+
+// =========================================
+// Field splitting (shared with the constexpr assembler)
+// =========================================
+
+constexpr LineFields Tokenizer::split_fields(std::string_view line) {
+    LineFields fields;
+
+    // Check for comment-only line (starts with * or ;)
+    if (line.empty() || line[0] == '*' || line[0] == ';') {
+        fields.comment = line;
+        return fields;
+    }
+
+    size_t pos = split_label_and_mnemonic(line, fields);
+    const size_t len = line.length();
+
+    // Skip whitespace before operand
+    pos = skip_blanks(line, pos);
+
+    // Parse operand (everything up to comment or end of line)
+    if (pos < len && line[pos] != ';') {
+        // Find comment or end of line
+        size_t operand_end = find_semicolon(line, pos);
+        // Trim trailing whitespace from operand
+        fields.operand = trim(line.substr(pos, operand_end - pos));
+        pos = operand_end;
+    }
+
+    // Parse comment (if present)
+    if (pos < len && line[pos] == ';') {
+        fields.comment = line.substr(pos);
+    }
+    return fields;
+}
+
+constexpr std::string_view Tokenizer::peek_mnemonic(std::string_view line) {
+    LineFields fields;
+    if (!line.empty() && line[0] != '*' && line[0] != ';') {
+        split_label_and_mnemonic(line, fields);
+    }
+    return fields.mnemonic;
+}
+
+constexpr size_t Tokenizer::split_label_and_mnemonic(std::string_view line, LineFields &fields) {
+    size_t pos = 0;
+    const size_t len = line.length();
+
+    // Parse label (if present)
+    // Label starts in column 0 (no leading whitespace) and ends with whitespace or colon
+    if (pos < len && !is_whitespace(line[pos]) && is_label_start(line[pos])) {
+        size_t label_end = skip_label_chars(line, pos);
+        fields.label = line.substr(pos, label_end - pos);
+        pos = label_end;
+
+        // Skip optional colon after label
+        if (pos < len && line[pos] == ':') {
+            pos++;
+        }
+    }
+
+    // Skip whitespace before mnemonic
+    pos = skip_blanks(line, pos);
+
+    // Parse mnemonic (instruction or directive)
+    if (pos < len && !is_whitespace(line[pos]) && line[pos] != ';') {
+        size_t mnem_end = find_blank_or_semicolon(line, pos);
+        fields.mnemonic = line.substr(pos, mnem_end - pos);
+        pos = mnem_end;
+    }
+    return pos;
+}
+
+constexpr std::string_view Tokenizer::trim(std::string_view str) {
+    const char *whitespace = " \t\r\n";
+    size_t start = str.find_first_not_of(whitespace);
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    size_t end = str.find_last_not_of(whitespace);
+    return str.substr(start, end - start + 1);
+}
+
+constexpr bool Tokenizer::is_whitespace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+constexpr bool Tokenizer::is_label_start(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_' || c == '@';
+}
+
+constexpr bool Tokenizer::is_label_char(char c) {
+    return is_label_start(c) || (c >= '0' && c <= '9');
+}
+
+constexpr size_t Tokenizer::skip_blanks(std::string_view text, size_t pos) {
+    if (!std::is_constant_evaluated()) {
+        return CharScanner::skip_blanks(text, pos);
+    }
+    while (pos < text.size() && is_whitespace(text[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+constexpr size_t Tokenizer::skip_label_chars(std::string_view text, size_t pos) {
+    if (!std::is_constant_evaluated()) {
+        return CharScanner::skip_label_chars(text, pos);
+    }
+    while (pos < text.size() && is_label_char(text[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+constexpr size_t Tokenizer::find_blank_or_semicolon(std::string_view text, size_t pos) {
+    if (!std::is_constant_evaluated()) {
+        return CharScanner::find_blank_or_semicolon(text, pos);
+    }
+    while (pos < text.size() && !is_whitespace(text[pos]) && text[pos] != ';') {
+        pos++;
+    }
+    return pos;
+}
+
+constexpr size_t Tokenizer::find_semicolon(std::string_view text, size_t pos) {
+    if (!std::is_constant_evaluated()) {
+        return CharScanner::find_semicolon(text, pos);
+    }
+    while (pos < text.size() && text[pos] != ';') {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * @brief Source lines that are tokenized on first access
+ *
+ * Stores a view of each line's text plus its line number; line() runs
+ * Tokenizer::parse_line() the first time a line is requested and caches the
+ * result, so lines that are only scanned (see Tokenizer::peek_mnemonic())
+ * never pay for tokenization. The referenced text must outlive the buffer.
+ * Returned SourceLine references stay valid for the buffer's lifetime.
+ */
+class LazySourceLines {
+  public:
+    /**
+     * @brief Construct an empty buffer
+     * @param mr Memory resource for the index and all tokenized lines
+     */
+    explicit LazySourceLines(std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+        : entries_(mr), parsed_(mr) {}
+
+    /**
+     * @brief Append an untokenized line
+     * @param text Line text (without newline)
+     * @param line_number Line number for tracking
+     */
+    void append(std::string_view text, int line_number) {
+        entries_.push_back(Entry{text, line_number, kNotTokenized});
+    }
+
+    size_t size() const {
+        return entries_.size();
+    }
+    std::string_view text(size_t index) const {
+        return entries_[index].text;
+    }
+    int line_number(size_t index) const {
+        return entries_[index].line_number;
+    }
+
+    /**
+     * @brief Get the tokenized form of a line, tokenizing it if needed
+     * @param index Line index
+     * @return const SourceLine& Cached tokenized line
+     */
+    const SourceLine &line(size_t index);
+
+    /**
+     * @brief Get a line for in-place rewriting (tokenizing it if needed)
+     * @param index Line index
+     * @return SourceLine& Cached tokenized line
+     */
+    SourceLine &edit(size_t index);
+
+    /**
+     * @brief Number of lines tokenized so far
+     * @return size_t Count of cached SourceLine objects
+     */
+    size_t tokenized_count() const {
+        return parsed_.size();
+    }
+
+  private:
+    static constexpr uint32_t kNotTokenized = UINT32_MAX;
+
+    struct Entry {
+        std::string_view text;
+        int line_number;
+        uint32_t parsed; // Index into parsed_, or kNotTokenized
+    };
+
+    std::pmr::vector<Entry> entries_;
+    std::pmr::deque<SourceLine> parsed_; // deque keeps references stable
 };
 
 } // namespace edasm
@@ -0,0 +1,105 @@
+/**
+ * @file batch_cpu.hpp
+ * @brief Lockstep batch interpreter for many 6502 machines
+ *
+ * Runs K machines forked from one MemorySnapshot (copy-on-write, see
+ * bus.hpp) with their registers in structure-of-arrays form. Each step, the
+ * running lanes whose PC equals the first running lane's PC form the
+ * lockstep group: if they see the same instruction and it is one of the
+ * lockstep opcodes (immediate ALU, register transfers and increments, flag
+ * operations, shifts of A, zero page/absolute loads and stores, branches,
+ * JMP, JSR, RTS), it is decoded once and applied to every lane of the group.
+ * Register and flag updates are branch-free masked loops over the register
+ * arrays, which the compiler vectorizes. Other opcodes, and lanes whose PC
+ * has diverged, step on their own scalar CPU; lanes rejoin the group when
+ * their PC matches again.
+ *
+ * Results are identical to running each lane on its own CPU. Lanes are
+ * expected to keep the snapshot's bank mapping (instruction bytes in pages
+ * a lane has not written are taken to be the snapshot's).
+ */
+
+#ifndef EDASM_BATCH_CPU_HPP
+#define EDASM_BATCH_CPU_HPP
+
+#include "bus.hpp"
+#include "cpu.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace edasm {
+
+// Registers of all lanes, one array per register (lane i is index i)
+struct LaneRegisters {
+    std::vector<uint8_t> A;
+    std::vector<uint8_t> X;
+    std::vector<uint8_t> Y;
+    std::vector<uint8_t> SP;
+    std::vector<uint8_t> P;
+    std::vector<uint16_t> PC;
+};
+
+class BatchCPU {
+  public:
+    // Fork `lanes` machines from image, all in the CPUState() power-on state
+    BatchCPU(std::shared_ptr<const MemorySnapshot> image, size_t lanes);
+
+    size_t lanes() const {
+        return buses_.size();
+    }
+
+    CPUState state(size_t lane) const;
+    void set_state(size_t lane, const CPUState &state);
+
+    Bus &bus(size_t lane) {
+        return *buses_[lane];
+    }
+
+    // Lane stopped on a trap opcode or unimplemented opcode
+    bool halted(size_t lane) const {
+        return !running_[lane];
+    }
+
+    // Step every running lane by one instruction; false once all have halted
+    bool step();
+
+    // Step until every lane has halted or max_steps steps have run
+    void run(uint64_t max_steps);
+
+    // Per lane, as CPU::instruction_count()
+    uint64_t instruction_count(size_t lane) const {
+        return instruction_counts_[lane];
+    }
+
+    // Machine-instructions executed in lockstep / on the scalar CPUs
+    uint64_t lockstep_instructions() const {
+        return lockstep_instructions_;
+    }
+    uint64_t scalar_instructions() const {
+        return scalar_instructions_;
+    }
+
+  private:
+    std::shared_ptr<const MemorySnapshot> image_;
+    std::vector<std::unique_ptr<Bus>> buses_;
+    std::vector<CPU> cpus_; // Scalar fallback, one per lane
+    LaneRegisters regs_;
+    std::vector<uint8_t> running_; // 1 while the lane has not halted
+    std::vector<uint8_t> mask_;    // 0xFF for lanes in this step's lockstep group
+    std::vector<uint64_t> instruction_counts_;
+    uint64_t lockstep_instructions_;
+    uint64_t scalar_instructions_;
+
+    // Build mask_ for the group at pc; returns the number of lanes in it
+    size_t select_group(size_t leader, uint16_t pc, uint16_t length);
+
+    // Execute the group's instruction; false if the opcode is not a lockstep one
+    bool execute_lockstep(uint8_t opcode, uint8_t lo, uint8_t hi);
+
+    void step_scalar(size_t lane);
+};
+
+} // namespace edasm
+
+#endif // EDASM_BATCH_CPU_HPP
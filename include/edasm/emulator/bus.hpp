@@ -15,6 +15,8 @@
  * - Read/write traps for address ranges
  * - Bank mapping for language card emulation
  * - Trap opcode ($02) initialization for discovery
+ * - Copy-on-write 256-byte pages shared with a MemorySnapshot, so many
+ *   machines forked from one booted state share its memory
  *
  * Reference: docs/EMULATOR_MINIMAL_PLAN.md
  */
@@ -22,11 +24,14 @@
 #ifndef EDASM_BUS_HPP
 #define EDASM_BUS_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace edasm {
@@ -65,6 +70,8 @@ struct WriteTrapRange {
     }
 };
 
+struct MemorySnapshot;
+
 // Memory bus for 6502/65C02
 class Bus {
   public:
@@ -92,8 +99,26 @@ class Bus {
     static constexpr size_t LC_FIXED_RAM_OFFSET = 0x12000; // 8KB fixed RAM at offset 72KB
     static constexpr size_t WRITE_SINK_OFFSET = 0x14000;   // 2KB write-sink at offset 80KB
 
+    // Copy-on-write granularity: the pool is POOL_PAGES pages of PAGE_SIZE
+    static constexpr size_t PAGE_SIZE = 0x100;
+    static constexpr size_t POOL_PAGES = TOTAL_MEMORY_SIZE / PAGE_SIZE; // 328
+
     Bus();
 
+    // Fork: share the snapshot's memory read-only and copy each page on the
+    // first write to it. Bank mappings come from the snapshot; traps do not.
+    explicit Bus(std::shared_ptr<const MemorySnapshot> base);
+
+    // Pages may point into a shared snapshot: copying a Bus would alias them
+    Bus(const Bus &) = delete;
+    Bus &operator=(const Bus &) = delete;
+
+    // Capture memory and bank mappings for forking (see Bus(base))
+    std::shared_ptr<const MemorySnapshot> snapshot() const;
+
+    // Pages this bus owns: POOL_PAGES unless forked, else those written since
+    size_t private_pages() const;
+
     // Address translation - converts 6502 address ranges to physical memory spans
     // Returns a vector of memory spans that cover the requested range
     // Filtered through bank switching mechanism (read vs write may differ)
@@ -101,6 +126,30 @@ class Bus {
     std::vector<ReadMemoryRange> translate_read_range(uint16_t start_addr, size_t length) const;
     std::vector<WriteMemoryRange> translate_write_range(uint16_t start_addr, size_t length);
 
+    // Allocation-free form of the above: calls visit(span) for each physical
+    // span in address order, merging pages that are physically adjacent (all
+    // of them on a bus that is not forked, so at most 33 spans for 64KB).
+    // Like translate_*_range, it bypasses traps; write spans are private
+    // pages (copied first if shared).
+    template <typename Visitor>
+    void for_each_read_span(uint16_t start_addr, size_t length, Visitor &&visit) const {
+        visit_spans(start_addr, length, visit, [this](uint16_t addr) {
+            return read_pointer(physical_read_offset(addr));
+        });
+    }
+    template <typename Visitor>
+    void for_each_write_span(uint16_t start_addr, size_t length, Visitor &&visit) {
+        visit_spans(start_addr, length, visit, [this](uint16_t addr) {
+            return write_pointer(physical_write_offset(addr));
+        });
+    }
+
+    // Bulk copies between 6502 memory and a host buffer (e.g. MLI READ/WRITE).
+    // Copy span by span, or byte by byte through read()/write() when the
+    // range overlaps a trap, so trapped addresses behave as for the CPU.
+    void read_block(uint16_t addr, std::span<uint8_t> out) const;
+    void write_block(uint16_t addr, std::span<const uint8_t> data);
+
     // Memory operations
     uint8_t read(uint16_t addr) const;
     void write(uint16_t addr, uint8_t value);
@@ -139,15 +188,86 @@ class Bus {
     void set_bank_mapping(uint8_t bank_index, uint32_t read_offset, uint32_t write_offset);
     void reset_bank_mappings();
 
+    // Write generation of a 256-byte page: bumped by every store to the page
+    // (wrapping), so an observer such as the text screen shim can detect
+    // changes by comparing counters instead of trapping each write
+    uint32_t page_generation(uint8_t page) const {
+        return page_generations_[page];
+    }
+
   private:
-    // Memory pool: 82KB total
-    std::array<uint8_t, TOTAL_MEMORY_SIZE> memory_;
+    // Memory pool: 82KB total, addressed by physical offset through a page
+    // table. read_pages_[p] points at page p's bytes; write_pages_[p] is the
+    // same pointer once the page is private to this bus, or nullptr while it
+    // is still shared with base_ (copied by write_pointer on first write).
+    std::array<const uint8_t *, POOL_PAGES> read_pages_;
+    std::array<uint8_t *, POOL_PAGES> write_pages_;
+    std::unique_ptr<uint8_t[]> arena_;                      // Whole pool (not forked)
+    std::vector<std::unique_ptr<uint8_t[]>> copied_pages_; // Written pages (forked)
+    std::shared_ptr<const MemorySnapshot> base_;
+
+    const uint8_t *read_pointer(uint32_t physical_offset) const {
+        return read_pages_[physical_offset / PAGE_SIZE] + physical_offset % PAGE_SIZE;
+    }
+    uint8_t *write_pointer(uint32_t physical_offset) {
+        uint8_t *page = write_pages_[physical_offset / PAGE_SIZE];
+        if (!page) {
+            page = copy_page(physical_offset / PAGE_SIZE);
+        }
+        return page + physical_offset % PAGE_SIZE;
+    }
+    uint8_t *copy_page(size_t page);
+
+    uint32_t physical_read_offset(uint16_t addr) const {
+        return read_bank_offsets_[addr / BANK_SIZE] + addr % BANK_SIZE;
+    }
+    uint32_t physical_write_offset(uint16_t addr) const {
+        return write_bank_offsets_[addr / BANK_SIZE] + addr % BANK_SIZE;
+    }
 
     // Bank lookup tables: for each 2KB bank, store offset to read/write from
     // Using 32-bit offsets to address full 82KB pool
     std::array<uint32_t, NUM_BANKS> read_bank_offsets_;
     std::array<uint32_t, NUM_BANKS> write_bank_offsets_;
 
+    // Per-page write generations (see page_generation())
+    std::array<uint32_t, 256> page_generations_{};
+    void bump_generations(uint16_t start_addr, size_t length);
+
+    // Walk [start_addr, start_addr + length) a page at a time (banks and
+    // pages are both page aligned), locating each chunk with locate(addr)
+    // and emitting one span per physically contiguous run
+    template <typename Visitor, typename Locate>
+    static void visit_spans(uint16_t start_addr, size_t length, Visitor &visit, Locate locate) {
+        using Byte = std::remove_pointer_t<decltype(locate(start_addr))>;
+        Byte *run = nullptr;
+        size_t run_size = 0;
+        uint16_t addr = start_addr;
+        while (length > 0) {
+            const size_t count = std::min(length, PAGE_SIZE - addr % PAGE_SIZE);
+            Byte *chunk = locate(addr);
+            if (run && run + run_size == chunk) {
+                run_size += count;
+            } else {
+                if (run) {
+                    visit(std::span<Byte>(run, run_size));
+                }
+                run = chunk;
+                run_size = count;
+            }
+            // Wraps at $FFFF for ranges longer than the address space
+            addr = static_cast<uint16_t>(addr + count);
+            length -= count;
+        }
+        if (run) {
+            visit(std::span<Byte>(run, run_size));
+        }
+    }
+
+    // True if any address in the range has a trap handler
+    bool overlaps_read_trap(uint16_t start_addr, size_t length) const;
+    bool overlaps_write_trap(uint16_t start_addr, size_t length) const;
+
     // Sparse trap storage - only store ranges that have handlers
     std::vector<ReadTrapRange> read_trap_ranges_;
     std::vector<WriteTrapRange> write_trap_ranges_;
@@ -161,6 +281,14 @@ class Bus {
     const WriteTrapRange *find_write_trap_range(uint16_t addr) const;
 };
 
+// Immutable copy of a bus's physical memory and bank mapping, shared by the
+// buses forked from it (see Bus(std::shared_ptr<const MemorySnapshot>))
+struct MemorySnapshot {
+    std::array<uint8_t, Bus::TOTAL_MEMORY_SIZE> memory;
+    std::array<uint32_t, Bus::NUM_BANKS> read_bank_offsets;
+    std::array<uint32_t, Bus::NUM_BANKS> write_bank_offsets;
+};
+
 } // namespace edasm
 
 #endif // EDASM_BUS_HPP
@@ -11,6 +11,9 @@
  * - All addressing modes
  * - Trap handler for system call emulation
  * - Cycle-accurate timing (base cycles only)
+ * - Templated on the bus type: CPU runs on the full Apple II Bus, while
+ *   BasicCPU<FlatBus> / BasicCPU<BankedBus> (ram_bus.hpp) inline memory
+ *   access completely for CPU-only tests and benchmarks
  *
  * Reference: docs/EMULATOR_MINIMAL_PLAN.md, 65C02 datasheet
  */
@@ -78,21 +81,27 @@ struct CPUState {
  * @param trap_pc PC where trap was encountered
  * @return bool True to continue execution, false to halt
  */
-using TrapHandler = std::function<bool(CPUState &cpu, Bus &bus, uint16_t trap_pc)>;
+template <typename BusT>
+using BasicTrapHandler = std::function<bool(CPUState &cpu, BusT &bus, uint16_t trap_pc)>;
+using TrapHandler = BasicTrapHandler<Bus>;
 
 /**
  * @brief 65C02 CPU emulator
  *
  * Emulates the 65C02 processor with full instruction set.
  * Supports trap handling for incremental system call discovery.
+ *
+ * @tparam BusT Memory bus providing read/write/read_word and TRAP_OPCODE.
+ *              Instantiated in cpu.cpp for Bus, FlatBus, BankedBus and
+ *              LockstepBus.
  */
-class CPU {
+template <typename BusT> class BasicCPU {
   public:
     /**
      * @brief Construct CPU with memory bus
      * @param bus Memory bus reference
      */
-    explicit CPU(Bus &bus);
+    explicit BasicCPU(BusT &bus);
 
     /**
      * @brief Reset CPU to initial state
@@ -111,7 +120,7 @@ class CPU {
      * @brief Set trap handler for opcode $02
      * @param handler Trap handler callback
      */
-    void set_trap_handler(TrapHandler handler);
+    void set_trap_handler(BasicTrapHandler<BusT> handler);
 
     /**
      * @brief Get mutable CPU state
@@ -138,10 +147,10 @@ class CPU {
     }
 
   private:
-    Bus &bus_;                   ///< Memory bus reference
-    CPUState state_;             ///< CPU register state
-    TrapHandler trap_handler_;   ///< Trap handler callback
-    uint64_t instruction_count_; ///< Instructions executed counter
+    BusT &bus_;                           ///< Memory bus reference
+    CPUState state_;                      ///< CPU register state
+    BasicTrapHandler<BusT> trap_handler_; ///< Trap handler callback
+    uint64_t instruction_count_;          ///< Instructions executed counter
 
     // Instruction execution helpers
 
@@ -211,6 +220,9 @@ class CPU {
     bool execute_instruction(uint8_t opcode);
 };
 
+/// The emulator's CPU, on the full Apple II bus
+using CPU = BasicCPU<Bus>;
+
 } // namespace edasm
 
 #endif // EDASM_CPU_HPP
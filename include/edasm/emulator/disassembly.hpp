@@ -61,4 +61,14 @@ const std::string *lookup_disassembly_symbol(uint16_t address);
 // Register all built-in address constants as disassembly symbols
 void register_default_disassembly_symbols();
 
+class SymbolDatabase;
+
+// Symbolize operands not registered above from a symbol database, as
+// "NAME" or "NAME+$offset" (nullptr detaches; the database must outlive use)
+void set_disassembly_symbol_database(const SymbolDatabase *database);
+
+// Name an address for reports: its registered symbol, else the database's
+// "NAME" or "NAME+$offset", else "$XXXX"
+std::string disassembly_address_name(uint16_t address);
+
 } // namespace edasm
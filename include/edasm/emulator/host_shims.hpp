@@ -17,6 +17,7 @@
 
 #include "bus.hpp"
 #include "cpu.hpp"
+#include <array>
 #include <queue>
 #include <string>
 #include <vector>
@@ -41,8 +42,20 @@ class HostShims {
     // Get next character from input queue (returns 0 if empty)
     char get_next_char();
 
-    // Check if emulator should stop (set when first screen char is 'E')
-    bool should_stop() const;
+    // Check if emulator should stop (set when first screen char becomes 'E').
+    // Text page 1 is not trapped: the 'E' check runs here, only when the
+    // bus reports a store to $0400-$04FF since the last call, and only
+    // stops when $0400 holds a different value than at the last check (so
+    // stores elsewhere on the page, or of the same 'E' again, do not stop).
+    bool should_stop();
+
+    // Pick up text page 1 stores since the last sync: marks the screen
+    // dirty and records them as SCREEN WRITE statistics (one entry per page)
+    void sync_screen();
+
+    // Move counted screen and $C0xx soft-switch accesses into TrapStatistics
+    // (call before TrapStatistics::print_statistics())
+    void flush_statistics();
 
     // Static utility to dump text screen (page 1 or 2) to stdout
     static void dump_text_screen(const Bus &bus, bool page2 = false, const std::string &label = "");
@@ -56,10 +69,56 @@ class HostShims {
     bool screen_dirty_;
     bool stop_requested_;
 
+    // Bus page generations of text page 1 ($04-$07) last seen by
+    // sync_screen(), and of page $04 and the $0400 value last seen by the
+    // 'E' check
+    std::array<uint32_t, 4> screen_generations_{};
+    uint32_t stop_check_generation_ = 0;
+    uint8_t stop_check_char_ = 0;
+
     // General I/O range handlers for $C000-$C7FF
     bool handle_io_read(uint16_t addr, uint8_t &value);
     bool handle_io_write(uint16_t addr, uint8_t value);
 
+    // Soft-switch dispatch: one handler per $C0xx address, built at compile
+    // time, so an access is a table lookup instead of a chain of range
+    // tests. Slot space ($C100-$C7FF) is handled as a block by
+    // handle_slot_read/write.
+    using ReadHandler = bool (HostShims::*)(uint16_t, uint8_t &);
+    using WriteHandler = bool (HostShims::*)(uint16_t, uint8_t);
+    static const std::array<ReadHandler, 256> read_dispatch_;
+    static const std::array<WriteHandler, 256> write_dispatch_;
+    static constexpr std::array<ReadHandler, 256> build_read_dispatch();
+    static constexpr std::array<WriteHandler, 256> build_write_dispatch();
+
+    // Per-address "I/O" access counts for $C000-$C0FF, moved into
+    // TrapStatistics by flush_statistics() (the language card records its own)
+    std::array<uint64_t, 256> io_read_counts_{};
+    std::array<uint64_t, 256> io_write_counts_{};
+
+    // Table entries ($C0xx reads clear the language card pending state)
+    bool io_read_kbd(uint16_t addr, uint8_t &value);
+    bool io_read_kbdstrb(uint16_t addr, uint8_t &value);
+    bool io_read_zero(uint16_t addr, uint8_t &value);
+    bool io_read_speaker(uint16_t addr, uint8_t &value);
+    bool io_read_graphics(uint16_t addr, uint8_t &value);
+    bool io_read_unhandled(uint16_t addr, uint8_t &value);
+    bool io_write_80col(uint16_t addr, uint8_t value);
+    bool io_write_kbdstrb(uint16_t addr, uint8_t value);
+    bool io_write_ignore(uint16_t addr, uint8_t value);
+    bool io_write_speaker(uint16_t addr, uint8_t value);
+    bool io_write_graphics(uint16_t addr, uint8_t value);
+    bool io_write_unhandled(uint16_t addr, uint8_t value);
+
+    // Slot I/O space ($C100-$C7FF)
+    bool handle_slot_read(uint16_t addr, uint8_t &value);
+    bool handle_slot_write(uint16_t addr, uint8_t value);
+
+    void clear_lc_pending() {
+        lc_.write_enable_pending = false;
+        lc_.last_control_addr = 0xFFFF;
+    }
+
     // Report unimplemented I/O access and request emulator stop
     void report_unhandled_io(uint16_t addr, bool is_write, uint8_t value);
 
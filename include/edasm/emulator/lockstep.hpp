@@ -0,0 +1,119 @@
+/**
+ * @file lockstep.hpp
+ * @brief Lockstep comparison of CPU/Bus against a reference trace
+ *
+ * Loads a ReferenceTrace's memory image into a Bus, starts the CPU from the
+ * first record's registers and then, for every record, checks the registers
+ * (PC, A, X, Y, SP, and P under a mask) before the instruction and the
+ * memory writes it makes, stopping at the first difference. The report
+ * shows the instructions leading up to it.
+ *
+ * - The CPU runs on LockstepBus, which forwards to the Bus (traps included,
+ *   e.g. HostShims soft switches) and records each instruction's writes
+ * - Back-to-back writes to one address within an instruction count as the
+ *   last one, so a reference NMOS 6502's read-modify-write dummy write of the
+ *   old value matches the 65C02's single write
+ * - Values read from $C000-$C0FF (keyboard, soft switches, slot I/O) come
+ *   from devices this emulator does not model alike; with sync_io_reads,
+ *   after an instruction that read there the registers are taken from the
+ *   trace when the PC agrees (counted in io_syncs) instead of compared
+ */
+
+#ifndef EDASM_LOCKSTEP_HPP
+#define EDASM_LOCKSTEP_HPP
+
+#include "bus.hpp"
+#include "cpu.hpp"
+#include "reference_trace.hpp"
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace edasm {
+
+// Bus wrapper for BasicCPU that records what one instruction does
+class LockstepBus {
+  public:
+    static constexpr uint8_t TRAP_OPCODE = Bus::TRAP_OPCODE;
+    static constexpr size_t MAX_WRITES = 8; // No 65C02 instruction writes more than 3
+
+    explicit LockstepBus(Bus &bus) : bus_(bus) {}
+
+    uint8_t read(uint16_t addr) const {
+        io_read_ |= (addr & 0xFF00) == 0xC000;
+        return bus_.read(addr);
+    }
+
+    void write(uint16_t addr, uint8_t value) {
+        if (write_count_ < MAX_WRITES) {
+            writes_[write_count_++] = TraceWrite{addr, value};
+        }
+        bus_.write(addr, value);
+    }
+
+    uint16_t read_word(uint16_t addr) const {
+        return static_cast<uint16_t>(read(addr) | (read(static_cast<uint16_t>(addr + 1)) << 8));
+    }
+
+    // Forget the previous instruction's accesses
+    void begin_instruction() {
+        write_count_ = 0;
+        io_read_ = false;
+    }
+
+    std::span<const TraceWrite> writes() const {
+        return {writes_.data(), write_count_};
+    }
+
+    bool io_read() const {
+        return io_read_;
+    }
+
+    Bus &bus() {
+        return bus_;
+    }
+
+  private:
+    Bus &bus_;
+    std::array<TraceWrite, MAX_WRITES> writes_{};
+    size_t write_count_ = 0;
+    mutable bool io_read_ = false;
+};
+
+struct LockstepOptions {
+    uint8_t flag_mask = 0xCF;   // P bits compared (B and U exist only when pushed)
+    bool sync_io_reads = true;  // See above
+    size_t context = 16;        // Instructions shown before a divergence
+    uint64_t max_records = 0;   // Stop after this many records (0: whole trace)
+};
+
+struct LockstepResult {
+    uint64_t records = 0;  // Records that matched
+    uint64_t io_syncs = 0; // Register syncs after I/O reads
+    bool diverged = false;
+    bool truncated = false; // The trace ends in a partial record
+
+    // At a divergence: the record, what differed, and both sides
+    uint64_t index = 0;
+    std::string reason;
+    TraceRecord expected{};
+    CPUState actual;
+    std::vector<TraceWrite> actual_writes;
+
+    // Up to LockstepOptions::context records before `index`, oldest first
+    std::vector<std::pair<uint64_t, CPUState>> history;
+};
+
+// Replay trace on bus (its memory is replaced by the trace's image)
+LockstepResult run_lockstep(ReferenceTrace &trace, Bus &bus, const LockstepOptions &options = {});
+
+// Summary line, plus the history and both sides at a divergence
+void print_lockstep_report(std::ostream &out, const LockstepResult &result, const Bus &bus);
+
+} // namespace edasm
+
+#endif // EDASM_LOCKSTEP_HPP
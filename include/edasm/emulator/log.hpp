@@ -0,0 +1,120 @@
+/**
+ * @file log.hpp
+ * @brief Leveled, per-category diagnostic logging for the emulator
+ *
+ * Diagnostics (instruction traces, trap and MLI logging, soft switch
+ * traces) go through EDASM_LOG instead of std::cout/std::cerr:
+ *
+ *   EDASM_LOG(TRACE, IO, "[I/O] Keyboard read at $" << std::hex << addr);
+ *
+ * - Levels below EDASM_LOG_MIN_LEVEL (a LogLevel value, set from CMake) are
+ *   compiled out, message expression included
+ * - Otherwise a record is formatted only if its level is at least
+ *   Log::level() and its category is enabled
+ * - By default records are written where the emulator always wrote them:
+ *   WARNING and ERROR to std::cerr, the rest to std::cout, one line each
+ * - After Log::start_async(), records are moved into a lock-free
+ *   single-producer ring and written by a background thread, so the
+ *   emulation thread never waits on the terminal or a pipe. A full ring
+ *   drops records (counted, reported by stop_async) rather than blocking.
+ *
+ * The producer side is not thread-safe: log from the emulation thread only.
+ * Output the emulator prints directly (screen snapshots, halt dumps) calls
+ * Log::flush() first so it stays in order with the records before it.
+ */
+
+#ifndef EDASM_LOG_HPP
+#define EDASM_LOG_HPP
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#ifndef EDASM_LOG_MIN_LEVEL
+#define EDASM_LOG_MIN_LEVEL 0 // LogLevel::TRACE: nothing compiled out
+#endif
+
+namespace edasm {
+
+enum class LogLevel : uint8_t { TRACE, DEBUG, INFO, WARNING, ERROR };
+
+enum class LogCategory : uint8_t {
+    CPU,  // Instruction trace
+    TRAP, // Trap dispatch, CPU state and memory dumps
+    MLI,  // ProDOS MLI calls
+    IO,   // $C0xx soft switches and slot I/O
+    LC,   // Language card bank switching
+    COUNT
+};
+
+class Log {
+  public:
+    // Whether records at this level are compiled in at all (the test is a
+    // preprocessor one so the default minimum of 0 is not an always-true
+    // comparison)
+    static constexpr bool compiled_in([[maybe_unused]] LogLevel level) {
+#if EDASM_LOG_MIN_LEVEL > 0
+        return static_cast<int>(level) >= EDASM_LOG_MIN_LEVEL;
+#else
+        return true;
+#endif
+    }
+
+    static bool enabled(LogLevel level, LogCategory category) {
+        return level >= s_level && (s_categories & (1u << static_cast<unsigned>(category)));
+    }
+
+    // Write one record (a line, without its newline)
+    static void write(LogLevel level, LogCategory category, std::string message);
+
+    static void set_level(LogLevel level) {
+        s_level = level;
+    }
+    static LogLevel level() {
+        return s_level;
+    }
+
+    static void set_category_enabled(LogCategory category, bool enabled);
+    static bool category_enabled(LogCategory category) {
+        return s_categories & (1u << static_cast<unsigned>(category));
+    }
+
+    // Enable exactly the categories in a comma-separated list of names
+    // ("cpu,mli,io"); "all" enables every one. False on an unknown name,
+    // leaving the enables unchanged.
+    static bool set_categories(const std::string &list);
+
+    static const char *category_name(LogCategory category);
+
+    // Start / stop the background writer (stop drains the queue first)
+    static void start_async();
+    static void stop_async();
+    static bool is_async();
+
+    // Wait until every record written so far has reached its stream
+    static void flush();
+
+    // Records dropped because the queue was full
+    static uint64_t dropped();
+
+  private:
+    static inline LogLevel s_level = LogLevel::INFO;
+    static inline uint32_t s_categories = ~0u;
+};
+
+} // namespace edasm
+
+#define EDASM_LOG(level, category, message)                                                        \
+    do {                                                                                           \
+        if constexpr (::edasm::Log::compiled_in(::edasm::LogLevel::level)) {                       \
+            if (::edasm::Log::enabled(::edasm::LogLevel::level,                                    \
+                                      ::edasm::LogCategory::category)) {                           \
+                std::ostringstream edasm_log_oss;                                                  \
+                edasm_log_oss << message;                                                          \
+                ::edasm::Log::write(::edasm::LogLevel::level, ::edasm::LogCategory::category,      \
+                                    std::move(edasm_log_oss).str());                               \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+#endif // EDASM_LOG_HPP
@@ -0,0 +1,93 @@
+/**
+ * @file profiler.hpp
+ * @brief Call-graph profiler for emulated 6502 code
+ *
+ * Keeps a shadow call stack next to the CPU: JSR and BRK push a frame for
+ * the routine they enter, and every instruction that leaves the stack
+ * pointer above a frame's return address pops that frame. One rule covers
+ * RTS and RTI, tail jumps that reset the stack with TXS, and trap handlers
+ * (ProDOS MLI, SWEET16) that return for the 6502 code. A routine that pulls
+ * its own return address (to read inline parameters) is charged to its
+ * caller from that point on.
+ *
+ * Cycles are the base cycle counts from the opcode table (no page crossing
+ * or taken-branch penalties); trap opcodes cost nothing. They are charged
+ * per call path, so each routine gets exclusive cycles (its own
+ * instructions) and inclusive cycles (including everything it called,
+ * counted once under recursion). write_folded() emits the call paths in
+ * the folded-stack format read by flamegraph.pl and speedscope, with routine
+ * names from the disassembly symbols (disassembly_address_name).
+ */
+
+#ifndef EDASM_PROFILER_HPP
+#define EDASM_PROFILER_HPP
+
+#include "cpu.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+namespace edasm {
+
+class CallProfiler {
+  public:
+    struct RoutineStats {
+        uint16_t entry;
+        uint64_t calls;
+        uint64_t inclusive_cycles;
+        uint64_t exclusive_cycles;
+    };
+
+    // Root frame: the code running when profiling starts (entry is its PC)
+    explicit CallProfiler(uint16_t root_pc);
+
+    // Account one CPU::step: before is the state it started from, opcode the
+    // byte at before.PC, after the state it left
+    void record(const CPUState &before, uint8_t opcode, const CPUState &after);
+
+    uint64_t total_cycles() const {
+        return total_cycles_;
+    }
+
+    // Frames on the shadow stack, root included
+    size_t depth() const {
+        return stack_.size();
+    }
+
+    // Per routine, by inclusive cycles (highest first)
+    std::vector<RoutineStats> routines() const;
+
+    // One "ROOT;CALLER;CALLEE cycles" line per call path with exclusive cycles
+    void write_folded(std::ostream &out) const;
+
+    // Table of the top routines by inclusive cycles
+    void print_report(std::ostream &out, size_t limit = 20) const;
+
+    static uint8_t base_cycles(uint8_t opcode);
+
+  private:
+    // One call path: entry routine under its parent path
+    struct Node {
+        uint16_t entry;
+        uint32_t parent;
+        uint64_t calls;
+        uint64_t self_cycles;
+    };
+
+    struct Frame {
+        uint32_t node;
+        uint8_t sp; // SP after the call pushed its return address
+    };
+
+    std::vector<Node> nodes_; // Parents come before their children
+    std::unordered_map<uint64_t, uint32_t> children_; // (parent << 16 | entry) -> node
+    std::vector<Frame> stack_;
+    uint64_t total_cycles_;
+
+    uint32_t child(uint32_t parent, uint16_t entry);
+};
+
+} // namespace edasm
+
+#endif // EDASM_PROFILER_HPP
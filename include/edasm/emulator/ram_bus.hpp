@@ -0,0 +1,132 @@
+/**
+ * @file ram_bus.hpp
+ * @brief Trap-free memory buses for CPU-only workloads
+ *
+ * Bus (bus.hpp) is the full Apple II bus: every access checks the trap
+ * ranges and goes through the language card bank tables, and handlers are
+ * std::function objects. CPU conformance tests and throughput benchmarks use
+ * none of that, so the CPU is a template over its bus type (BasicCPU) and
+ * these buses provide the same read/write interface with everything inline:
+ *
+ * - FlatBus: 64KB of RAM, an address is an index
+ * - BankedBus: Bus's 2KB bank tables and 82KB pool (language card RAM and
+ *   ROM write sink), without traps
+ *
+ * Both are RamBus<Mapping>, with the address mapping as the policy. The
+ * emulator itself keeps using Bus.
+ */
+
+#ifndef EDASM_RAM_BUS_HPP
+#define EDASM_RAM_BUS_HPP
+
+#include "bus.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace edasm {
+
+// Mapping policy: 6502 address = physical offset
+struct FlatMapping {
+    static constexpr size_t POOL_SIZE = Bus::MEMORY_SIZE;
+
+    static uint32_t read_offset(uint16_t addr) {
+        return addr;
+    }
+    static uint32_t write_offset(uint16_t addr) {
+        return addr;
+    }
+};
+
+// Mapping policy: Bus's 2KB bank tables over the 82KB pool, at the same
+// power-on state (ROM area read from main RAM, written to the sink)
+class BankedMapping {
+  public:
+    static constexpr size_t POOL_SIZE = Bus::TOTAL_MEMORY_SIZE;
+
+    BankedMapping() {
+        reset_bank_mappings();
+    }
+
+    uint32_t read_offset(uint16_t addr) const {
+        return read_bank_offsets_[addr / Bus::BANK_SIZE] + addr % Bus::BANK_SIZE;
+    }
+    uint32_t write_offset(uint16_t addr) const {
+        return write_bank_offsets_[addr / Bus::BANK_SIZE] + addr % Bus::BANK_SIZE;
+    }
+
+    void set_bank_mapping(uint8_t bank_index, uint32_t read_offset, uint32_t write_offset) {
+        if (bank_index < Bus::NUM_BANKS) {
+            read_bank_offsets_[bank_index] = read_offset;
+            write_bank_offsets_[bank_index] = write_offset;
+        }
+    }
+
+    void reset_bank_mappings() {
+        for (size_t i = 0; i < Bus::NUM_BANKS; ++i) {
+            const auto bank_start = static_cast<uint32_t>(i * Bus::BANK_SIZE);
+            read_bank_offsets_[i] = Bus::MAIN_RAM_OFFSET + bank_start;
+            write_bank_offsets_[i] =
+                bank_start < 0xD000 ? Bus::MAIN_RAM_OFFSET + bank_start : Bus::WRITE_SINK_OFFSET;
+        }
+    }
+
+  private:
+    std::array<uint32_t, Bus::NUM_BANKS> read_bank_offsets_;
+    std::array<uint32_t, Bus::NUM_BANKS> write_bank_offsets_;
+};
+
+// Memory bus without traps; Mapping turns 6502 addresses into pool offsets
+template <typename Mapping> class RamBus : public Mapping {
+  public:
+    static constexpr size_t MEMORY_SIZE = Bus::MEMORY_SIZE;
+    static constexpr uint8_t TRAP_OPCODE = Bus::TRAP_OPCODE;
+
+    RamBus() {
+        reset();
+    }
+
+    // Fill memory with the trap opcode (as Bus::reset does)
+    void reset() {
+        memory_.fill(TRAP_OPCODE);
+    }
+
+    uint8_t read(uint16_t addr) const {
+        return memory_[this->read_offset(addr)];
+    }
+
+    void write(uint16_t addr, uint8_t value) {
+        memory_[this->write_offset(addr)] = value;
+    }
+
+    uint16_t read_word(uint16_t addr) const {
+        return static_cast<uint16_t>(read(addr) |
+                                     (read(static_cast<uint16_t>(addr + 1)) << 8));
+    }
+
+    void write_word(uint16_t addr, uint16_t value) {
+        write(addr, static_cast<uint8_t>(value & 0xFF));
+        write(static_cast<uint16_t>(addr + 1), static_cast<uint8_t>(value >> 8));
+    }
+
+    // Load binary data through the write mapping
+    bool write_binary_data(uint16_t addr, const std::vector<uint8_t> &data) {
+        if (addr + data.size() > MEMORY_SIZE) {
+            return false; // Would overflow address space
+        }
+        for (size_t i = 0; i < data.size(); ++i) {
+            write(static_cast<uint16_t>(addr + i), data[i]);
+        }
+        return true;
+    }
+
+  private:
+    std::array<uint8_t, Mapping::POOL_SIZE> memory_;
+};
+
+using FlatBus = RamBus<FlatMapping>;
+using BankedBus = RamBus<BankedMapping>;
+
+} // namespace edasm
+
+#endif // EDASM_RAM_BUS_HPP
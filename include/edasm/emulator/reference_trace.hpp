@@ -0,0 +1,156 @@
+/**
+ * @file reference_trace.hpp
+ * @brief Binary instruction traces from a reference emulator (MAME)
+ *
+ * A reference trace records, for each instruction a reference machine ran,
+ * the registers before it and the memory writes it made, plus the 64KB of
+ * memory the machine started from. lockstep.hpp replays it against CPU/Bus.
+ *
+ * MAME writes its debugger trace as text (MAME_Stuff/emulator/
+ * trace_capture.lua); convert_mame_trace() turns that into this format once,
+ * so comparisons read fixed little-endian records instead of parsing text.
+ * ReferenceTrace maps the file read-only and decodes it in place: a
+ * multi-gigabyte trace costs one mmap and the kernel's read-ahead.
+ *
+ * File format (all integers little-endian):
+ *   "EDTR"  magic
+ *   u16     format version (1)
+ *   u16     reserved (0)
+ *   64KB    memory image ($0000-$FFFF) before the first instruction
+ *   per instruction (8 bytes + 3 per write):
+ *           u16 PC, u8 A, u8 X, u8 Y, u8 SP, u8 P, u8 write count,
+ *           per write: u16 address, u8 value (in bus order)
+ *
+ * MAME trace log lines read by convert_mame_trace() (hex fields, any other
+ * line such as MAME's own disassembly is skipped):
+ *   S <pc> <a> <x> <y> <sp> <p>   registers before an instruction
+ *   W <address> <value>           a write by the instruction above
+ */
+
+#ifndef EDASM_REFERENCE_TRACE_HPP
+#define EDASM_REFERENCE_TRACE_HPP
+
+#include "cpu.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace edasm {
+
+struct TraceWrite {
+    uint16_t address;
+    uint8_t value;
+
+    bool operator==(const TraceWrite &) const = default;
+};
+
+// One instruction of a trace
+struct TraceRecord {
+    CPUState state; // Registers before the instruction
+    uint8_t write_count;
+    std::array<TraceWrite, 255> writes;
+
+    std::span<const TraceWrite> write_span() const {
+        return {writes.data(), write_count};
+    }
+};
+
+// Read-only reference trace, memory-mapped from a file or owned bytes
+class ReferenceTrace {
+  public:
+    static constexpr uint16_t kFormatVersion = 1;
+    static constexpr size_t kHeaderSize = 8;
+    static constexpr size_t kImageSize = 0x10000;
+
+    // Map a trace file; nullopt (reason in *error) if it is not one
+    static std::optional<ReferenceTrace> open(const std::string &path,
+                                              std::string *error = nullptr);
+
+    // Trace held in memory (tests)
+    static std::optional<ReferenceTrace> from_bytes(std::span<const uint8_t> data,
+                                                    std::string *error = nullptr);
+
+    ReferenceTrace(ReferenceTrace &&other) noexcept;
+    ReferenceTrace &operator=(ReferenceTrace &&other) noexcept;
+    ReferenceTrace(const ReferenceTrace &) = delete;
+    ReferenceTrace &operator=(const ReferenceTrace &) = delete;
+    ~ReferenceTrace();
+
+    // Memory before the first instruction
+    std::span<const uint8_t> memory_image() const {
+        return {data_ + kHeaderSize, kImageSize};
+    }
+
+    // Decode the next record; false at the end of the trace, or if the last
+    // record is cut short (truncated() is then true)
+    bool next(TraceRecord &record);
+
+    // Start over from the first record
+    void rewind() {
+        position_ = kHeaderSize + kImageSize;
+        truncated_ = false;
+    }
+
+    bool truncated() const {
+        return truncated_;
+    }
+
+    // Bytes of the trace decoded so far, and in total
+    size_t position() const {
+        return position_;
+    }
+    size_t size() const {
+        return data_size_;
+    }
+
+  private:
+    ReferenceTrace() = default;
+    bool attach(std::string *error);
+    void release();
+
+    const uint8_t *data_{nullptr};
+    size_t data_size_{0};
+    void *mapping_{nullptr};    // mmap'ed file, if opened from a path
+    std::vector<uint8_t> bytes_; // Owned copy, if built from bytes
+    size_t position_{0};
+    bool truncated_{false};
+};
+
+// Streams a trace in the format above
+class TraceWriter {
+  public:
+    // Writes the header and memory image (kImageSize bytes)
+    TraceWriter(std::ostream &out, std::span<const uint8_t> memory_image);
+    TraceWriter(const TraceWriter &) = delete;
+    TraceWriter &operator=(const TraceWriter &) = delete;
+    ~TraceWriter(); // Calls flush()
+
+    // Append one instruction (at most 255 writes)
+    void add(const CPUState &state, std::span<const TraceWrite> writes);
+
+    // Write out buffered records
+    void flush();
+
+    uint64_t records() const {
+        return records_;
+    }
+
+  private:
+    std::ostream &out_;
+    std::vector<char> buffer_;
+    uint64_t records_;
+};
+
+// Convert a MAME trace log (see above) to a binary trace on out, starting
+// from memory_image. False with the reason in *error on a malformed line.
+bool convert_mame_trace(std::istream &log, std::span<const uint8_t> memory_image,
+                        std::ostream &out, std::string *error = nullptr);
+
+} // namespace edasm
+
+#endif // EDASM_REFERENCE_TRACE_HPP
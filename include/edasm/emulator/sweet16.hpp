@@ -0,0 +1,66 @@
+/**
+ * @file sweet16.hpp
+ * @brief Host-native SWEET16 interpreter for the emulator
+ *
+ * The EDASM editor calls Steve Wozniak's SWEET16 16-bit virtual machine
+ * (EDITOR/SWEET16.S) for its pointer arithmetic: a JSR to the SWEET16 entry
+ * point is followed by SWEET16 bytecode, ended by RTN, after which 6502
+ * execution continues. Under the emulator every bytecode would otherwise be
+ * decoded by the 6502 interpreter, itself being emulated.
+ *
+ * Sweet16 replaces the entry point with a trap and runs the bytecode natively
+ * against Bus memory, with registers R0-R15 in zero page ($00-$1F) exactly
+ * where the 6502 interpreter keeps them. On RTN it returns to the 6502 code
+ * after the RTN byte with A, X, Y, P and S as the 6502 version leaves them,
+ * including its SAVE area ($45-$49) and the prior-result register (R14H).
+ * Only the scratch bytes the 6502 version pushes below the stack pointer
+ * differ.
+ *
+ * BK (break, $0A) would execute a 6502 BRK inside the interpreter; it
+ * halts the emulator instead.
+ *
+ * Reference: EDITOR/SWEET16.S, Apple II Integer BASIC ROM ($F689)
+ */
+
+#ifndef EDASM_SWEET16_HPP
+#define EDASM_SWEET16_HPP
+
+#include "bus.hpp"
+#include "cpu.hpp"
+#include "edasm/constants.hpp"
+#include <cstdint>
+
+namespace edasm {
+
+class Sweet16 {
+  public:
+    Sweet16(Bus &bus);
+
+    // Patch a trap opcode over the entry point and register the handler
+    // with TrapManager (call after the code containing SWEET16 is loaded)
+    void install(uint16_t entry = SWEET16_ROM);
+
+    // Trap handler: entered at the SWEET16 entry point by the caller's JSR
+    bool trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_pc);
+
+    // Run bytecode from the return address on the stack up to RTN, then
+    // resume 6502 code; returns false if the bytecode executed BK
+    static bool run(CPUState &cpu, Bus &bus, uint64_t *instructions = nullptr);
+
+    uint64_t calls() const {
+        return calls_;
+    }
+
+    uint64_t instructions() const {
+        return instructions_;
+    }
+
+  private:
+    Bus &bus_;
+    uint64_t calls_;
+    uint64_t instructions_;
+};
+
+} // namespace edasm
+
+#endif // EDASM_SWEET16_HPP
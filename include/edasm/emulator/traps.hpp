@@ -50,9 +50,10 @@ struct TrapStatistic {
 // Trap statistics manager
 class TrapStatistics {
   public:
-    // Record a trap occurrence
+    // Record a trap occurrence (or count occurrences observed in bulk)
     static void record_trap(const std::string &name, uint16_t address, TrapKind kind,
-                            const std::string &mli_call = "", bool is_second_read = false);
+                            const std::string &mli_call = "", bool is_second_read = false,
+                            uint64_t count = 1);
 
     // Print statistics table to stdout, ordered by trap address
     static void print_statistics();
@@ -0,0 +1,187 @@
+/**
+ * @file symbol_database.hpp
+ * @brief Binary symbol database for symbolizing emulator addresses
+ *
+ * Written by the linker (ENTRY symbols of every module) and by the
+ * assembler for BIN output (every label and equate, with its source line;
+ * one module per ORG segment). It is read by the disassembler, once loaded
+ * with `emulator_runner --symbols` or `trace_lockstep --symbols`, and so
+ * also names call-graph profiler entries. The file is mapped read-only and
+ * searched in place: opening it costs one mmap, and a lookup is a binary
+ * search over fixed-size records, so symbolizing long traces allocates
+ * nothing.
+ *
+ * Each symbol covers an address range: a symbol inside a module's code runs
+ * to the next symbol or the module's end; any other symbol (an equate such
+ * as a soft switch) covers its own address only. lookup() returns the
+ * symbol whose range holds an address, plus the offset into it.
+ *
+ * No EDASM.SRC counterpart.
+ *
+ * File format (all integers little-endian):
+ *   "EDSD"  magic
+ *   u16     format version (1)
+ *   u16     reserved (0)
+ *   u32     symbol count
+ *   u32     module count
+ *   u32     string table size in bytes
+ *   per symbol (16 bytes, sorted by address, then name):
+ *           u16 address, u16 range size, u32 name offset,
+ *           u16 module index (0xFFFF: none), u16 reserved, u32 source line (0: unknown)
+ *   per module (8 bytes): u32 name offset, u16 start address, u16 length
+ *   string table: NUL-terminated names
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace edasm {
+
+/**
+ * @brief Read-only symbol database, memory-mapped from a file or owned bytes
+ */
+class SymbolDatabase {
+  public:
+    static constexpr uint16_t kFormatVersion = 1;
+    static constexpr uint16_t kNoModule = 0xFFFF;
+
+    /**
+     * @brief One symbol and the address range it covers
+     */
+    struct Symbol {
+        std::string_view name;            ///< Symbol name (points into the database)
+        uint16_t address{0};              ///< First address
+        uint16_t size{0};                 ///< Addresses covered (at least 1)
+        std::string_view module;          ///< Defining module ("" if none)
+        uint16_t module_index{kNoModule}; ///< Index of the defining module (or kNoModule)
+        uint32_t line{0};                 ///< Source line (0 if unknown)
+    };
+
+    /**
+     * @brief Result of a range lookup
+     */
+    struct Match {
+        Symbol symbol;
+        uint16_t offset{0}; ///< Address minus symbol.address
+    };
+
+    /**
+     * @brief Collects symbols and modules and serializes the database
+     */
+    class Builder {
+      public:
+        /**
+         * @brief Add a module's code range
+         * @return uint16_t Module index for add_symbol()
+         */
+        uint16_t add_module(std::string_view name, uint16_t start, uint16_t length);
+
+        /**
+         * @brief Add a symbol
+         * @param name Symbol name
+         * @param address Symbol value
+         * @param module Module index from add_module(), or kNoModule
+         * @param line Source line (0 if unknown)
+         */
+        void add_symbol(std::string_view name, uint16_t address, uint16_t module = kNoModule,
+                        uint32_t line = 0);
+
+        /**
+         * @brief Serialize (computes each symbol's range)
+         * @return std::vector<uint8_t> Database bytes
+         */
+        std::vector<uint8_t> build() const;
+
+      private:
+        struct PendingSymbol {
+            std::string name;
+            uint16_t address;
+            uint16_t module;
+            uint32_t line;
+        };
+        struct PendingModule {
+            std::string name;
+            uint16_t start;
+            uint16_t length;
+        };
+        std::vector<PendingSymbol> symbols_;
+        std::vector<PendingModule> modules_;
+    };
+
+    /**
+     * @brief Map a database file
+     * @param path Database path
+     * @param error Receives the reason on failure (optional)
+     * @return std::optional<SymbolDatabase> Database, or nullopt on failure
+     */
+    static std::optional<SymbolDatabase> open(const std::string &path,
+                                              std::string *error = nullptr);
+
+    /**
+     * @brief Use database bytes held in memory (copied)
+     * @param data Database bytes
+     * @param error Receives the reason on failure (optional)
+     * @return std::optional<SymbolDatabase> Database, or nullopt if malformed
+     */
+    static std::optional<SymbolDatabase> from_bytes(std::span<const uint8_t> data,
+                                                    std::string *error = nullptr);
+
+    /**
+     * @brief Write database bytes to a file
+     * @return bool True on success
+     */
+    static bool save(const std::string &path, std::span<const uint8_t> data);
+
+    SymbolDatabase(SymbolDatabase &&other) noexcept;
+    SymbolDatabase &operator=(SymbolDatabase &&other) noexcept;
+    SymbolDatabase(const SymbolDatabase &) = delete;
+    SymbolDatabase &operator=(const SymbolDatabase &) = delete;
+    ~SymbolDatabase();
+
+    /**
+     * @brief Find the symbol whose range holds an address (O(log n))
+     * @param address Address to symbolize
+     * @return std::optional<Match> Symbol and offset, or nullopt
+     */
+    std::optional<Match> lookup(uint16_t address) const;
+
+    /**
+     * @brief Format an address as "NAME" or "NAME+$offset"
+     * @return std::string Symbolized address, or "" if no symbol covers it
+     */
+    std::string symbolize(uint16_t address) const;
+
+    size_t size() const {
+        return symbol_count_;
+    }
+
+    /**
+     * @brief Symbol by index, in address order
+     */
+    Symbol symbol(size_t index) const;
+
+  private:
+    SymbolDatabase() = default;
+    bool attach(std::string *error);
+    void release();
+
+    const uint8_t *data_{nullptr};
+    size_t data_size_{0};
+    void *mapping_{nullptr};    // mmap'ed file, if opened from a path
+    std::vector<uint8_t> bytes_; // Owned copy, if built from bytes
+    uint32_t symbol_count_{0};
+    uint32_t module_count_{0};
+    const uint8_t *symbols_{nullptr};
+    const uint8_t *modules_{nullptr};
+    const char *strings_{nullptr};
+    uint32_t strings_size_{0};
+};
+
+} // namespace edasm
@@ -20,13 +20,112 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
 #include <memory>
+#include <optional>
 #include <sstream>
 
+#include "edasm/assembler/char_scanner.hpp"
+#include "edasm/files/symbol_database.hpp"
+
 namespace edasm {
 
-Assembler::Assembler() = default;
+namespace {
+
+// Strip leading/trailing blanks (space/tab) without copying
+std::string_view trim_blanks(std::string_view str) {
+    size_t start = str.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    return str.substr(start, str.find_last_not_of(" \t") - start + 1);
+}
+
+// Case-insensitive search for an ON/OFF keyword in an LST/MSB operand
+bool contains_keyword(std::string_view operand, std::string_view keyword) {
+    auto it = std::search(operand.begin(), operand.end(), keyword.begin(), keyword.end(),
+                          [](char a, char b) {
+                              return std::toupper(static_cast<unsigned char>(a)) == b;
+                          });
+    return it != operand.end();
+}
+
+// Case-insensitive comparison of a raw (not uppercased) mnemonic to a keyword
+bool equals_keyword(std::string_view mnemonic, std::string_view keyword) {
+    return mnemonic.size() == keyword.size() &&
+           std::equal(mnemonic.begin(), mnemonic.end(), keyword.begin(), [](char a, char b) {
+               return std::toupper(static_cast<unsigned char>(a)) == b;
+           });
+}
+
+// Conditional assembly directives (from ASM3.S)
+constexpr std::string_view kConditionalDirectives[] = {"DO",   "ELSE", "FIN",  "IFEQ", "IFNE",
+                                                       "IFGT", "IFGE", "IFLT", "IFLE"};
+
+// Cheap test used while skipping an inactive block: only the mnemonic field
+// is located, and nothing is tokenized unless it names a conditional directive
+bool is_conditional_line(std::string_view text) {
+    std::string_view mnem = Tokenizer::peek_mnemonic(text);
+    if (mnem.size() < 2 || mnem.size() > 4) {
+        return false;
+    }
+    return std::any_of(std::begin(kConditionalDirectives), std::end(kConditionalDirectives),
+                       [mnem](std::string_view keyword) { return equals_keyword(mnem, keyword); });
+}
+
+// Call fn for each line of text, split on '\n' like std::getline
+template <typename Fn> void for_each_line(std::string_view text, Fn &&fn) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = CharScanner::find_newline(text, pos);
+        fn(text.substr(pos, eol - pos));
+        pos = eol + 1;
+    }
+}
+
+// Accumulates wall time and allocation deltas into a PhaseProfile for the
+// lifetime of the scope (no-op when profiling is disabled)
+class PhaseScope {
+  public:
+    PhaseScope(PhaseProfile &out, const CountingMemoryResource &counter, bool enabled)
+        : out_(enabled ? &out : nullptr), counter_(counter) {
+        if (out_) {
+            start_ = std::chrono::steady_clock::now();
+            start_allocations_ = counter_.allocations();
+            start_bytes_ = counter_.bytes_allocated();
+        }
+    }
+
+    ~PhaseScope() {
+        if (out_) {
+            std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start_;
+            out_->wall_ms += elapsed.count();
+            out_->allocations += counter_.allocations() - start_allocations_;
+            out_->bytes_allocated += counter_.bytes_allocated() - start_bytes_;
+        }
+    }
+
+    PhaseScope(const PhaseScope &) = delete;
+    PhaseScope &operator=(const PhaseScope &) = delete;
+
+  private:
+    PhaseProfile *out_;
+    const CountingMemoryResource &counter_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t start_allocations_{0};
+    uint64_t start_bytes_{0};
+};
+
+} // namespace
+
+Assembler::Assembler(std::pmr::memory_resource *upstream)
+    : arena_(upstream), memory_(&arena_), symbols_(&memory_), zero_page_lines_(&memory_),
+      previous_symbols_(&memory_), instructions_(&memory_), peephole_lines_(&memory_),
+      data_blocks_(&memory_), code_segments_(&memory_), rel_builder_(&memory_),
+      snapshot_imports_(&memory_) {}
 
 // Main assembly entry point
 // Reference: ASM2.S ExecAsm ($7806) - Main assembly coordinator
@@ -40,22 +139,36 @@ Assembler::Result Assembler::assemble(const std::string &source, const Options &
     // Reset state
     // Reference: ASM2.S InitASM ($7DC3) - Initialize assembler state
     reset();
-
-    // Tokenize source into lines
-    std::vector<SourceLine> lines;
-    std::stringstream ss(source);
-    std::string line;
-    int line_num = 1;
-
-    while (std::getline(ss, line)) {
-        auto parsed = Tokenizer::parse_line(line, line_num++);
-        lines.push_back(parsed);
+    symbols_.set_sort_threads(opts.sort_threads);
+
+    const bool profiling = options_.collect_profile;
+    AssemblyProfile &profile = result.profile;
+    profile.enabled = profiling;
+
+    // Split source into lines (on '\n' like std::getline, no copy of the
+    // source). Lines are tokenized lazily by the passes, so lines inside
+    // inactive conditional blocks are only ever scanned for their mnemonic.
+    LazySourceLines lines(&memory_);
+    bool has_file_directive = false;
+    {
+        PhaseScope scope(profile.tokenize, memory_, profiling);
+        int line_num = 1;
+        for_each_line(source, [&](std::string_view line) {
+            lines.append(line, line_num++);
+            std::string_view mnem = Tokenizer::peek_mnemonic(line);
+            has_file_directive = has_file_directive || equals_keyword(mnem, "INCLUDE") ||
+                                 equals_keyword(mnem, "CHN");
+        });
     }
 
     // Preprocess INCLUDE and CHN directives
     // Reference: ASM3.S L9348-L93C0 - INCLUDE directive handler
     // Reference: ASM3.S L928C-L92B9 - CHN directive handler
-    lines = preprocess_includes(lines, result, 0);
+    if (has_file_directive) {
+        PhaseScope scope(profile.includes, memory_, profiling);
+        lines = preprocess_includes(lines, result, 0);
+    }
+    profile.lines = lines.size();
     if (!result.errors.empty()) {
         result.success = false;
         return result;
@@ -63,35 +176,51 @@ Assembler::Result Assembler::assemble(const std::string &source, const Options &
 
     // Pass 1: Build symbol table, track PC
     // Reference: ASM2.S DoPass1 ($7E1E) - First pass lexical analysis
-    if (!pass1(lines, result)) {
+    bool pass1_ok;
+    {
+        PhaseScope scope(profile.pass1, memory_, profiling);
+        pass1_ok = pass1(lines, result);
+        if (pass1_ok && options_.shrink_zero_page) {
+            pass1_ok = shrink_zero_page(lines, result);
+        }
+    }
+    profile.symbols = symbols_.size();
+    profile.tokenized_lines = lines.tokenized_count();
+    profile.expression_evaluations = expression_evaluations_;
+    if (!pass1_ok) {
         return result;
     }
 
     // Pass 2: Generate code
     // Reference: ASM2.S DoPass2 ($7F69) - Second pass code generation
-    ListingGenerator *listing = nullptr;
     std::unique_ptr<ListingGenerator> listing_ptr;
-
-    if (options_.generate_listing) {
-        ListingGenerator::Options list_opts;
-        list_opts.include_symbols = options_.list_symbols;
-        list_opts.sort_by_value = options_.sort_symbols_by_value;
-        list_opts.symbol_columns = options_.symbol_columns;
-        listing_ptr = std::make_unique<ListingGenerator>(list_opts);
-        listing = listing_ptr.get();
-        listing->set_symbol_table(symbols_);
+    bool pass2_ok;
+    {
+        PhaseScope scope(profile.pass2, memory_, profiling);
+        pass2_ok = generate_code(lines, result, listing_ptr);
+        if (pass2_ok && options_.peephole) {
+            pass2_ok = optimize_peephole(lines, result, listing_ptr);
+        }
     }
-
-    if (!pass2(lines, result, listing)) {
+    ListingGenerator *listing = listing_ptr.get();
+    profile.symbols = symbols_.size();
+    profile.tokenized_lines = lines.tokenized_count();
+    profile.expression_evaluations = expression_evaluations_;
+    if (!pass2_ok) {
         return result;
     }
 
-    // Generate REL file format if in REL mode
+    // Generate REL file format if in REL mode (RLD/ESD are kept so the
+    // image can also be streamed with write_rel_file())
     if (rel_mode_) {
+        PhaseScope scope(profile.rel_build, memory_, profiling);
         // Build ESD entries from symbol table
         int entry_count = 0;
         int external_count = 0;
-        for (const auto &[name, symbol] : symbols_.get_all()) {
+        // Walk the cached name-ordered view so ESD order is deterministic
+        for (const Symbol *sym : symbols_.by_name()) {
+            const Symbol &symbol = *sym;
+            const auto &name = symbol.name;
             // Add ENTRY symbols (defined in this module)
             if (symbol.flags & SYM_ENTRY) {
                 entry_count++;
@@ -118,13 +247,45 @@ Assembler::Result Assembler::assemble(const std::string &source, const Options &
             }
         }
 
-        // Build complete REL file format
-        result.rel_file_data = rel_builder_.build(result.code);
+        // Build complete REL file format (one presized buffer)
+        if (options_.build_rel_image) {
+            result.rel_file_data = rel_builder_.build(result.code);
+        }
         result.is_rel_file = true;
     }
 
+    // Symbol database for the emulator's disassembler: one module per run
+    // of code at consecutive addresses. A symbol belongs to the run holding
+    // its address; equates and the like outside every run have no module
+    if (options_.build_symbol_database && !rel_mode_) {
+        SymbolDatabase::Builder database;
+        if (code_segments_.empty()) {
+            database.add_module(options_.module_name, org_address_, 0);
+        }
+        for (const CodeSegment &segment : code_segments_) {
+            database.add_module(options_.module_name, segment.start, segment.length);
+        }
+        for (const Symbol *sym : symbols_.by_name()) {
+            if (sym->is_external() || (sym->flags & SYM_UNDEFINED)) {
+                continue;
+            }
+            uint16_t module = SymbolDatabase::kNoModule;
+            for (size_t i = 0; i < code_segments_.size(); ++i) {
+                const CodeSegment &segment = code_segments_[i];
+                if (sym->value >= segment.start && sym->value - segment.start < segment.length) {
+                    module = static_cast<uint16_t>(i);
+                    break;
+                }
+            }
+            database.add_symbol(sym->name, sym->value, module,
+                                static_cast<uint32_t>(sym->line_defined));
+        }
+        result.symbol_database = database.build();
+    }
+
     // Generate listing if requested
     if (listing) {
+        PhaseScope scope(profile.listing, memory_, profiling);
         result.listing = listing->to_string();
     }
 
@@ -133,13 +294,100 @@ Assembler::Result Assembler::assemble(const std::string &source, const Options &
     return result;
 }
 
+// Pass 2 with a fresh listing
+bool Assembler::generate_code(LazySourceLines &lines, Result &result,
+                              std::unique_ptr<ListingGenerator> &listing) {
+    listing.reset();
+    if (options_.generate_listing) {
+        ListingGenerator::Options list_opts;
+        list_opts.include_symbols = options_.list_symbols;
+        list_opts.sort_by_value = options_.sort_symbols_by_value;
+        list_opts.symbol_columns = options_.symbol_columns;
+        listing = std::make_unique<ListingGenerator>(list_opts, &memory_);
+        listing->set_symbol_table(symbols_);
+    }
+
+    // Pass 1 sizes every line exactly as pass 2 encodes it, so emitting
+    // code never regrows the buffer
+    result.code.reserve(code_size_estimate_);
+
+    return pass2(lines, result, listing.get());
+}
+
+// Apply peephole rewrites to the source lines and reassemble until the
+// optimizer finds nothing more. Reassembling (rather than patching bytes)
+// moves every later label and recomputes branches and RLD entries.
+bool Assembler::optimize_peephole(LazySourceLines &lines, Result &result,
+                                  std::unique_ptr<ListingGenerator> &listing) {
+    peephole_lines_.resize(lines.size(), 0);
+
+    for (int pass = 0; pass < kMaxPeepholePasses; ++pass) {
+        const auto changes = PeepholeOptimizer::optimize(instructions_);
+        if (changes.empty()) {
+            break;
+        }
+
+        for (const auto &change : changes) {
+            result.optimizations.push_back(change.report());
+            for (const auto &edit : change.edits) {
+                SourceLine &line = lines.edit(edit.line_index);
+                line.mnemonic = edit.mnemonic;
+                line.operand = edit.operand;
+                peephole_lines_[edit.line_index] =
+                    edit.mnemonic.empty() ? kPeepholeRemoved : kPeepholeRewritten;
+                if (edit.line_index < zero_page_lines_.size()) {
+                    zero_page_lines_[edit.line_index] = 0;
+                }
+            }
+        }
+
+        // Reassemble from a clean symbol table and REL state
+        symbols_.reset();
+        rel_builder_.reset();
+        next_extern_symbol_num_ = 0;
+        result.code.clear();
+        result.errors.clear();
+        result.warnings.clear();
+        result.page_crossings.clear();
+        if (!pass1(lines, result) ||
+            (options_.shrink_zero_page && !shrink_zero_page(lines, result)) ||
+            !generate_code(lines, result, listing)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Assembler::write_rel_file(std::ostream &out, const Result &result) const {
+    if (!result.is_rel_file) {
+        return false;
+    }
+    return rel_builder_.write(out, result.code);
+}
+
 // Reset assembler state between assemblies
 // Reference: ASM2.S InitASM ($7DC3) - Initializes zero page variables,
 // resets flags (RelCodeF, ListingF, CondAsmF), clears symbol table
 void Assembler::reset() {
     symbols_.reset();
+    previous_symbols_.reset();
+    rel_builder_.reset();
+    std::pmr::vector<uint8_t>(&memory_).swap(zero_page_lines_);
+    std::pmr::vector<PeepholeOptimizer::Instruction>(&memory_).swap(instructions_);
+    std::pmr::vector<uint8_t>(&memory_).swap(peephole_lines_);
+    std::pmr::vector<DataBlock>(&memory_).swap(data_blocks_);
+    std::pmr::vector<CodeSegment>(&memory_).swap(code_segments_);
+    std::pmr::vector<SnapshotImport>(&memory_).swap(snapshot_imports_);
+    // Nothing allocated from the arena is reachable any more
+    arena_.release();
+    expression_evaluations_ = 0;
+    code_size_estimate_ = 0;
+    zero_page_forward_refs_ = 0;
     program_counter_ = org_address_;
     current_line_ = 0;
+    current_line_index_ = 0;
+    pending_label_ = false;
+    data_block_open_ = false;
     rel_mode_ = false;        // RelCodeF in ASM3.S
     file_type_ = 0x06;        // Default to BIN type (ASM3.S FileType $51)
     listing_enabled_ = true;  // Default LST ON (ASM3.S ListingF $68)
@@ -147,7 +395,6 @@ void Assembler::reset() {
     in_include_file_ = false; // Not in include file (ASM3.S IDskSrcF)
     base_path_ = ".";         // Default to current directory
     cond_asm_flag_ = 0x00;    // Default to normal assembly (ASM3.S CondAsmF $BA)
-    rel_builder_.reset();
     next_extern_symbol_num_ = 0;
 }
 
@@ -158,12 +405,44 @@ void Assembler::reset() {
 
 // Pass 1 implementation - builds symbol table and validates structure
 // Reference: ASM2.S DoPass1 ($7E1E) - Scans source, creates symbols, tracks PC
-bool Assembler::pass1(const std::vector<SourceLine> &lines, Result &result) {
+bool Assembler::pass1(LazySourceLines &lines, Result &result) {
     program_counter_ = org_address_;
+    code_size_estimate_ = 0;
+    zero_page_forward_refs_ = 0;
+    data_blocks_.clear();
+    data_block_open_ = false;
     cond_asm_flag_ = 0x00; // Reset conditional assembly state (ASM3.S CondAsmF)
+    if (options_.shrink_zero_page) {
+        zero_page_lines_.resize(lines.size(), 0);
+    }
+
+    // Symbols of INCLUDEd equate files that matched a snapshot are defined
+    // where the file's lines would have been (unless in a false block)
+    auto next_import = snapshot_imports_.begin();
+    auto import_snapshots_before = [&](size_t index) {
+        for (; next_import != snapshot_imports_.end() && next_import->line_index <= index;
+             ++next_import) {
+            std::vector<std::string> duplicates;
+            if (should_assemble_line() &&
+                !next_import->snapshot->import_into(symbols_, &duplicates)) {
+                for (const auto &name : duplicates) {
+                    add_error(result, "DUPLICATE SYMBOL: " + name, next_import->line_number);
+                }
+            }
+        }
+    };
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        current_line_ = lines.line_number(i);
+        current_line_index_ = i;
+        import_snapshots_before(i);
 
-    for (const auto &line : lines) {
-        current_line_ = line.line_number;
+        // Inside a false conditional block only DO/ELSE/FIN and friends
+        // matter, so other lines are skipped without being tokenized
+        if (!should_assemble_line() && !is_conditional_line(lines.text(i))) {
+            continue;
+        }
+        const SourceLine &line = lines.line(i);
 
         // Skip comment-only lines
         // Reference: ASM2.S checks first char for ';' or '*'
@@ -193,6 +472,7 @@ bool Assembler::pass1(const std::vector<SourceLine> &lines, Result &result) {
 
         // Process directives that affect PC or symbol table
         // Reference: ASM3.S - various directive handlers (ORG, EQU, DS, etc.)
+        const uint16_t line_start_pc = program_counter_;
         if (line.has_mnemonic() && is_directive(line.mnemonic)) {
             process_directive_pass1(line, result);
         } else if (line.has_mnemonic()) {
@@ -200,8 +480,18 @@ bool Assembler::pass1(const std::vector<SourceLine> &lines, Result &result) {
             // Reference: ASM2.S GInstLen ($8458) - Calculate instruction size
             update_pc_pass1(line);
         }
+        track_data_block(line, line_start_pc);
+
+        // Bytes this line will emit in pass 2 (ORG moves the PC without emitting)
+        if (line.mnemonic != "ORG") {
+            code_size_estimate_ += static_cast<uint16_t>(program_counter_ - line_start_pc);
+        }
     }
 
+    import_snapshots_before(lines.size());
+    std::sort(data_blocks_.begin(), data_blocks_.end(),
+              [](const DataBlock &a, const DataBlock &b) { return a.start < b.start; });
+
     return result.errors.empty();
 }
 
@@ -236,12 +526,13 @@ void Assembler::process_directive_pass1(const SourceLine &line, Result &result)
     // CHN and INCLUDE are handled in preprocessing, should not reach here
     if (mnem == "CHN" || mnem == "INCLUDE") {
         // These should have been handled in preprocess_includes()
-        add_error(result, "Internal error: " + mnem + " not preprocessed", line.line_number);
+        add_error(result, "Internal error: " + std::string(mnem) + " not preprocessed",
+                  line.line_number);
         return;
     }
 
     // Create expression evaluator for this pass
-    ExpressionEvaluator eval(symbols_);
+    ExpressionEvaluator eval(symbols_, &expression_evaluations_);
 
     if (mnem == "ORG") {
         // ORG directive - set program counter (from ASM3.S L8A82)
@@ -337,12 +628,9 @@ void Assembler::process_directive_pass1(const SourceLine &line, Result &result)
     } else if (mnem == "LST") {
         // LST directive - control listing output (from ASM3.S L8ECA)
         // LST ON or LST OFF
-        std::string operand = line.operand;
-        std::transform(operand.begin(), operand.end(), operand.begin(), ::toupper);
-
-        if (operand.find("ON") != std::string::npos) {
+        if (contains_keyword(line.operand, "ON")) {
             listing_enabled_ = true;
-        } else if (operand.find("OFF") != std::string::npos) {
+        } else if (contains_keyword(line.operand, "OFF")) {
             listing_enabled_ = false;
         } else {
             add_error(result, "LST requires ON or OFF", line.line_number);
@@ -350,12 +638,9 @@ void Assembler::process_directive_pass1(const SourceLine &line, Result &result)
     } else if (mnem == "MSB") {
         // MSB directive - control high bit on ASCII chars (from ASM3.S L8E66)
         // MSB ON or MSB OFF
-        std::string operand = line.operand;
-        std::transform(operand.begin(), operand.end(), operand.begin(), ::toupper);
-
-        if (operand.find("ON") != std::string::npos) {
+        if (contains_keyword(line.operand, "ON")) {
             msb_on_ = true;
-        } else if (operand.find("OFF") != std::string::npos) {
+        } else if (contains_keyword(line.operand, "OFF")) {
             msb_on_ = false;
         } else {
             add_error(result, "MSB requires ON or OFF", line.line_number);
@@ -405,78 +690,273 @@ void Assembler::process_directive_pass1(const SourceLine &line, Result &result)
             }
             program_counter_ += static_cast<uint16_t>(len);
         }
+    } else if (mnem == "ALIGN") {
+        // ALIGN - pad to a boundary (C-EDASM extension)
+        program_counter_ +=
+            align_padding(line, rel_mode_ ? code_size_estimate_ : program_counter_, 1, result);
     } else if (mnem == "END") {
         // END directive - stop assembly
         // Nothing to do in pass 1
     }
 }
 
-void Assembler::update_pc_pass1(const SourceLine &line) {
-    // Estimate instruction size based on addressing mode
-    // For Pass 1, we make a simple estimate
-    // TODO: Proper addressing mode detection
+// ALIGN [boundary[,length]] (C-EDASM extension, no ASM3.S counterpart).
+// Pads with zeros to the next multiple of boundary (a power of two up to
+// $100, default $100); with a length, only when the next length bytes would
+// otherwise cross a boundary, so a table or loop shares one page at the
+// least cost. position is the PC, or the code offset in REL mode: there the
+// linker chooses the final address, so pass 2 records each ALIGN as a
+// constraint in the REL image and the length form pads nothing.
+uint16_t Assembler::align_padding(const SourceLine &line, uint32_t position, int pass,
+                                  Result &result) {
+    const std::string_view operand = trim_blanks(line.operand);
+    const size_t comma = operand.find(',');
+    uint32_t boundary = 0x100;
+    uint32_t length = 0;
+
+    // Both operands must be known when pass 1 reaches the line
+    ExpressionEvaluator eval(symbols_, &expression_evaluations_);
+    if (!operand.empty()) {
+        auto value = eval.evaluate(trim_blanks(operand.substr(0, comma)), 2);
+        if (!value.success) {
+            add_error(result, "ALIGN: " + value.error_message, line.line_number);
+            return 0;
+        }
+        boundary = value.value;
+    }
+    if (comma != std::string_view::npos) {
+        auto value = eval.evaluate(trim_blanks(operand.substr(comma + 1)), 2);
+        if (!value.success) {
+            add_error(result, "ALIGN: " + value.error_message, line.line_number);
+            return 0;
+        }
+        length = value.value;
+    }
+    if (boundary == 0 || boundary > 0x100 || (boundary & (boundary - 1)) != 0) {
+        add_error(result, "ALIGN: boundary must be a power of two up to $100", line.line_number);
+        return 0;
+    }
+    if (length > boundary) {
+        add_error(result, "ALIGN: length exceeds boundary", line.line_number);
+        return 0;
+    }
+
+    const uint32_t padding = (boundary - position % boundary) % boundary;
+    if (rel_mode_) {
+        if (pass == 2) {
+            const uint8_t kind = length == 0 ? PageSpan::KIND_ALIGN : PageSpan::KIND_FIT;
+            const uint32_t start = length == 0 ? position + padding : position;
+            rel_builder_.add_page_span(kind, static_cast<uint16_t>(start),
+                                       static_cast<uint16_t>(length),
+                                       static_cast<uint16_t>(boundary));
+        }
+        return length == 0 ? static_cast<uint16_t>(padding) : 0;
+    }
+    if (length == 0 || position / boundary != (position + length - 1) / boundary) {
+        return static_cast<uint16_t>(padding);
+    }
+    return 0;
+}
+
+// Pass 1: a run of data lines starts at a label (or after code) and ends
+// at the next label or instruction
+void Assembler::track_data_block(const SourceLine &line, uint16_t start) {
+    if (line.has_label()) {
+        data_block_open_ = false;
+    }
+    if (!line.has_mnemonic()) {
+        return;
+    }
 
-    if (line.operand.empty()) {
-        // Implied/Accumulator mode - 1 byte
+    const std::string_view mnem = line.mnemonic;
+    if (mnem != "DB" && mnem != "DFB" && mnem != "DW" && mnem != "DA" && mnem != "DS" &&
+        mnem != "ASC" && mnem != "DCI") {
+        data_block_open_ = false;
+        return;
+    }
+
+    const uint16_t size = static_cast<uint16_t>(program_counter_ - start);
+    if (data_block_open_ &&
+        static_cast<uint16_t>(data_blocks_.back().start + data_blocks_.back().size) == start) {
+        data_blocks_.back().size += size;
+    } else {
+        data_blocks_.push_back(DataBlock{start, size});
+        data_block_open_ = true;
+    }
+}
+
+void Assembler::update_pc_pass1(const SourceLine &line) {
+    // Size the instruction from the mode pass 2 will encode, so labels after
+    // branches and zero-page operands get their final addresses
+    // Reference: ASM2.S GInstLen ($8458)
+    const Opcode *opcode = opcodes_.lookup(line.mnemonic, instruction_mode(line, 1));
+    if (opcode) {
+        program_counter_ += opcode->bytes;
+    } else if (line.operand.empty()) {
+        // Invalid mnemonic/mode (reported in pass 2): keep the old estimate
         program_counter_ += 1;
     } else if (line.operand[0] == '#') {
-        // Immediate mode - 2 bytes
         program_counter_ += 2;
     } else {
-        // Assume absolute mode for now - 3 bytes
-        // TODO: Detect zero page vs absolute
         program_counter_ += 3;
     }
 }
 
+// Addressing mode of an instruction line. Modes come from the operand's
+// syntax; with Options::shrink_zero_page an absolute operand whose value is
+// known to fit in zero page switches to the zero-page form (pass 1 makes the
+// decision, pass 2 reads it back from zero_page_lines_).
+AddressingMode Assembler::instruction_mode(const SourceLine &line, int pass) {
+    const AddressingMode mode = AddressingModeDetector::detect(line.operand, line.mnemonic);
+    if (!options_.shrink_zero_page || current_line_index_ >= zero_page_lines_.size()) {
+        return mode;
+    }
+
+    const auto zero_page = AddressingModeDetector::zero_page_form(mode);
+    if (!zero_page || !opcodes_.lookup(line.mnemonic, *zero_page)) {
+        return mode;
+    }
+    if (zero_page_lines_[current_line_index_]) {
+        return *zero_page;
+    }
+    if (pass != 1) {
+        return mode;
+    }
+
+    // Pass 2 semantics: every symbol must have a value. Forward references
+    // take the previous sizing pass's values (none on the first pass).
+    const std::string_view expr = AddressingModeDetector::address_expression(line.operand, mode);
+    ExpressionEvaluator eval(symbols_, &expression_evaluations_);
+    ExpressionResult value = eval.evaluate(expr, 2);
+    if (!value.success) {
+        zero_page_forward_refs_++;
+        ExpressionEvaluator previous(previous_symbols_, &expression_evaluations_);
+        value = previous.evaluate(expr, 2);
+    }
+    if (!value.success || value.is_external || (value.is_relative && rel_mode_) ||
+        value.value > 0xFF) {
+        return mode;
+    }
+
+    zero_page_lines_[current_line_index_] = 1;
+    return *zero_page;
+}
+
+// Repeat pass 1 until no further operand shrinks to zero page. Shrinking
+// only moves later labels down and a shrunk line never grows back, so each
+// pass either shrinks something new or is the fixed point.
+bool Assembler::shrink_zero_page(LazySourceLines &lines, Result &result) {
+    for (int pass = 1; pass < kMaxSizingPasses && zero_page_forward_refs_ > 0; ++pass) {
+        const auto shrunk_before =
+            std::count(zero_page_lines_.begin(), zero_page_lines_.end(), uint8_t{1});
+
+        previous_symbols_.reset();
+        for (const Symbol *sym : symbols_.by_name()) {
+            previous_symbols_.define(sym->name, sym->value, sym->flags, sym->line_defined);
+        }
+
+        // Errors and warnings were already reported by the first pass 1
+        symbols_.reset();
+        Result sizing;
+        if (!pass1(lines, sizing)) {
+            result.errors.insert(result.errors.end(), sizing.errors.begin(), sizing.errors.end());
+            return false;
+        }
+
+        if (std::count(zero_page_lines_.begin(), zero_page_lines_.end(), uint8_t{1}) ==
+            shrunk_before) {
+            break;
+        }
+    }
+    return true;
+}
+
 // =========================================
 // Pass 2: Generate Code
 // =========================================
 
-bool Assembler::pass2(const std::vector<SourceLine> &lines, Result &result,
-                      ListingGenerator *listing) {
+bool Assembler::pass2(LazySourceLines &lines, Result &result, ListingGenerator *listing) {
     program_counter_ = org_address_;
     cond_asm_flag_ = 0x00; // Reset conditional assembly state
+    instructions_.clear();
+    code_segments_.clear();
+    pending_label_ = false;
+
+    // Listing annotation for lines the peephole optimizer rewrote or removed
+    auto peephole_note = [this](size_t index) -> std::string_view {
+        return index < peephole_lines_.size() && peephole_lines_[index] ? "PEEPHOLE" : "";
+    };
+
+    // Listing entry for a line that produced no code (no address column)
+    auto list_unassembled = [listing](int line_number, std::string_view text,
+                                      std::string_view note = {}) {
+        ListingGenerator::ListingLine list_line(listing->get_allocator());
+        list_line.line_number = line_number;
+        list_line.source_line = text;
+        list_line.has_address = false;
+        list_line.note = note;
+        listing->add_line(std::move(list_line));
+    };
+
+    // INCLUDEs satisfied by a symbol snapshot have no lines of their own;
+    // list the directive itself where the file's lines would have been
+    auto next_import = snapshot_imports_.begin();
+    auto list_snapshots_before = [&](size_t index) {
+        for (; next_import != snapshot_imports_.end() && next_import->line_index <= index;
+             ++next_import) {
+            if (listing) {
+                list_unassembled(next_import->line_number, next_import->text, "SNAPSHOT");
+            }
+        }
+    };
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        current_line_ = lines.line_number(i);
+        current_line_index_ = i;
+        list_snapshots_before(i);
+
+        // Lines in a false conditional block are listed as-is (every line is
+        // listed) but never tokenized unless they hold a conditional directive
+        if (!should_assemble_line() && !is_conditional_line(lines.text(i))) {
+            if (listing) {
+                // Note: In EDASM.SRC, skipped lines show " S" prefix (from ASM3.S L951E)
+                list_unassembled(current_line_, lines.text(i));
+            }
+            continue;
+        }
 
-    for (const auto &line : lines) {
-        current_line_ = line.line_number;
+        const SourceLine &line = lines.line(i);
         uint16_t line_start_pc = program_counter_;
         size_t code_start = result.code.size();
 
-        // Skip comment-only lines
+        // Skip comment-only lines (and instructions the optimizer removed)
         if (line.is_comment_only()) {
             if (listing) {
-                ListingGenerator::ListingLine list_line;
-                list_line.line_number = line.line_number;
-                list_line.source_line = line.raw_line;
-                list_line.has_address = false;
-                listing->add_line(list_line);
+                list_unassembled(line.line_number, line.raw_line, peephole_note(i));
             }
             continue;
         }
 
+        // A label not on an instruction names the next one (peephole boundary)
+        if (line.has_label() && (!line.has_mnemonic() || is_directive(line.mnemonic)) &&
+            line.mnemonic != "EQU") {
+            pending_label_ = true;
+        }
+
         // Check if this is a conditional directive (these are ALWAYS processed)
-        bool is_cond_directive = false;
         if (line.has_mnemonic() && is_conditional_directive(line.mnemonic)) {
-            is_cond_directive = true;
             process_conditional_directive_pass2(line, result);
 
             // Add to listing if enabled (mark as unassembled if skipped)
             if (listing) {
-                ListingGenerator::ListingLine list_line;
-                list_line.line_number = line.line_number;
-                list_line.source_line = line.raw_line;
-                list_line.has_address = false;
-                listing->add_line(list_line);
+                list_unassembled(line.line_number, line.raw_line);
             }
             continue; // Don't process further
         }
 
-        // Check if we should assemble this line (based on conditional state)
-        bool skip_line = !should_assemble_line();
-
-        // Process instruction or directive (unless in false conditional block)
-        if (line.has_mnemonic() && !skip_line) {
+        // Process instruction or directive (false conditional blocks were
+        // filtered out above)
+        if (line.has_mnemonic()) {
             if (is_directive(line.mnemonic)) {
                 if (!process_directive_pass2(line, result, listing)) {
                     // Continue on error to find more errors
@@ -490,30 +970,25 @@ bool Assembler::pass2(const std::vector<SourceLine> &lines, Result &result,
 
         // Add to listing if enabled
         if (listing && (line.has_mnemonic() || line.has_label())) {
-            // If line was skipped due to conditional, mark it specially
-            if (skip_line) {
-                ListingGenerator::ListingLine list_line;
-                list_line.line_number = line.line_number;
-                list_line.source_line = line.raw_line;
-                list_line.has_address = false;
-                // Note: In EDASM.SRC, skipped lines show " S" prefix (from ASM3.S L951E)
-                listing->add_line(list_line);
-            } else if (!is_cond_directive) {
-                ListingGenerator::ListingLine list_line;
-                list_line.line_number = line.line_number;
-                list_line.address = line_start_pc;
-                list_line.source_line = line.raw_line;
-                list_line.has_address = (result.code.size() > code_start);
-
-                // Copy generated bytes for this line
-                for (size_t i = code_start; i < result.code.size(); ++i) {
-                    list_line.bytes.push_back(result.code[i]);
-                }
-
-                listing->add_line(list_line);
+            ListingGenerator::ListingLine list_line(listing->get_allocator());
+            list_line.line_number = line.line_number;
+            list_line.address = line_start_pc;
+            list_line.source_line = line.raw_line;
+            list_line.has_address = (result.code.size() > code_start);
+            if (options_.shrink_zero_page && zero_page_lines_[i]) {
+                list_line.note = "ZP";
+            }
+            if (!peephole_note(i).empty()) {
+                list_line.note = peephole_note(i);
             }
+
+            // Copy generated bytes for this line
+            list_line.bytes.assign(result.code.begin() + code_start, result.code.end());
+
+            listing->add_line(std::move(list_line));
         }
     }
+    list_snapshots_before(lines.size());
 
     return result.errors.empty();
 }
@@ -526,26 +1001,34 @@ bool Assembler::process_line_pass2(const SourceLine &line, Result &result,
 
 bool Assembler::encode_instruction(const SourceLine &line, Result &result,
                                    ListingGenerator *listing) {
-    // Detect addressing mode from operand
-    AddressingMode mode = AddressingModeDetector::detect(line.operand, line.mnemonic);
+    // Detect addressing mode from operand (zero-page forms chosen in pass 1)
+    AddressingMode mode = instruction_mode(line, 2);
 
     // Look up opcode
     const Opcode *opcode = opcodes_.lookup(line.mnemonic, mode);
     if (!opcode) {
-        // Try alternate addressing modes if needed
-        // For example, if we detected Absolute but ZeroPage would work
-        add_error(result, "Invalid addressing mode for " + line.mnemonic + ": " + line.operand,
+        add_error(result,
+                  "Invalid addressing mode for " + std::string(line.mnemonic) + ": " +
+                      std::string(line.operand),
                   line.line_number);
         return false;
     }
 
+    const uint16_t address = program_counter_;
+    const size_t relocations = rel_builder_.rld_entries().size();
+    uint16_t operand_value = 0;
+
     // Emit opcode byte
     emit_byte(opcode->code, result);
 
+    // Operand without the addressing syntax ("($12),Y" -> "$12")
+    const std::string_view expr = AddressingModeDetector::address_expression(line.operand, mode);
+
     // Emit operand bytes based on addressing mode
     if (mode == AddressingMode::Relative) {
         // Branch instructions: calculate PC-relative offset
-        uint16_t target = evaluate_operand(line.operand);
+        uint16_t target = evaluate_operand(expr);
+        operand_value = target;
         // PC after this instruction (PC + 2 since branch is 2 bytes: opcode + offset)
         // Note: program_counter_ has been incremented by 1 from emit_byte above
         uint16_t next_pc = program_counter_ + 1; // +1 for the offset byte we're about to emit
@@ -561,20 +1044,118 @@ bool Assembler::encode_instruction(const SourceLine &line, Result &result,
                mode == AddressingMode::ZeroPageX || mode == AddressingMode::ZeroPageY ||
                mode == AddressingMode::IndexedIndirect || mode == AddressingMode::IndirectIndexed) {
         // 1-byte operand
-        uint16_t value = evaluate_operand(line.operand);
+        uint16_t value = evaluate_operand(expr);
+        operand_value = value;
+        if (value > 0xFF && mode != AddressingMode::Immediate && options_.shrink_zero_page &&
+            zero_page_lines_[current_line_index_]) {
+            // Sized as zero page from an earlier sizing pass's value
+            add_error(result, "Zero-page operand out of range: " + std::string(line.operand),
+                      line.line_number);
+        }
         emit_byte(static_cast<uint8_t>(value & 0xFF), result);
     } else if (mode == AddressingMode::Absolute || mode == AddressingMode::AbsoluteX ||
                mode == AddressingMode::AbsoluteY || mode == AddressingMode::Indirect) {
         // 2-byte operand (little-endian)
-        uint16_t value = evaluate_operand(line.operand);
-        emit_word_with_relocation(value, line.operand, result);
+        uint16_t value = evaluate_operand(expr);
+        operand_value = value;
+        emit_word_with_relocation(value, expr, result);
     }
     // Implied and Accumulator modes have no operand bytes
 
+    const bool relocated = rel_builder_.rld_entries().size() != relocations;
+    check_page_crossing(line, *opcode, address, operand_value, relocated, result);
+
+    if (options_.peephole) {
+        PeepholeOptimizer::Instruction ins;
+        ins.line_index = current_line_index_;
+        ins.line_number = line.line_number;
+        ins.address = address;
+        ins.opcode = opcode;
+        ins.operand = operand_value;
+        ins.operand_text = line.operand;
+        ins.labeled = line.has_label() || pending_label_;
+        ins.relocated = relocated;
+        instructions_.push_back(ins);
+        pending_label_ = false;
+    }
+
     return true;
 }
 
+// A taken branch whose target is in another page than the next instruction,
+// or an indexed read whose table (the data block holding the base address)
+// spans a page, costs a cycle. Absolute code is reported in
+// Result::page_crossings; in REL mode the span goes into the REL image and
+// the linker checks it at the module's load address.
+void Assembler::check_page_crossing(const SourceLine &line, const Opcode &opcode,
+                                    uint16_t address, uint16_t operand, bool relocated,
+                                    Result &result) {
+    uint8_t kind;
+    uint16_t first;
+    uint16_t last;
+    if (opcode.mode == AddressingMode::Relative) {
+        const uint16_t next = static_cast<uint16_t>(address + 2);
+        kind = PageSpan::KIND_BRANCH;
+        first = std::min(next, operand);
+        last = std::max(next, operand);
+    } else if ((opcode.mode == AddressingMode::AbsoluteX ||
+                opcode.mode == AddressingMode::AbsoluteY) &&
+               opcode.extra_cycle_on_page_cross) {
+        auto block = std::upper_bound(
+            data_blocks_.begin(), data_blocks_.end(), operand,
+            [](uint16_t value, const DataBlock &b) { return value < b.start; });
+        if (block == data_blocks_.begin()) {
+            return;
+        }
+        --block;
+        const uint32_t end = static_cast<uint32_t>(block->start) + block->size;
+        if (operand >= end) {
+            return;
+        }
+        kind = PageSpan::KIND_INDEXED;
+        first = operand;
+        last = static_cast<uint16_t>(end - 1);
+    } else {
+        return;
+    }
+
+    if (rel_mode_) {
+        // Branch targets move with the module; an indexed base only if relocated
+        if (kind == PageSpan::KIND_INDEXED && !relocated) {
+            return;
+        }
+        const uint16_t origin = static_cast<uint16_t>(program_counter_ - result.code.size());
+        rel_builder_.add_page_span(kind, static_cast<uint16_t>(first - origin),
+                                   static_cast<uint16_t>(last - first + 1), 0x100);
+        return;
+    }
+    if ((first >> 8) == (last >> 8)) {
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << std::hex << std::uppercase << std::setfill('0');
+    oss << "Line " << std::dec << line.line_number << std::hex << " $" << std::setw(4) << address
+        << ": " << line.mnemonic << ' ' << line.operand << " crosses a page (";
+    if (kind == PageSpan::KIND_BRANCH) {
+        oss << '$' << std::setw(4) << static_cast<uint16_t>(address + 2) << " -> $" << std::setw(4)
+            << operand << "), +1 cycle when taken";
+    } else {
+        oss << "table $" << std::setw(4) << first << "-$" << std::setw(4) << last
+            << "), +1 cycle past $" << std::setw(4) << ((first | 0xFF) & 0xFFFF);
+    }
+    result.page_crossings.push_back(oss.str());
+}
+
 void Assembler::emit_byte(uint8_t byte, Result &result) {
+    if (options_.build_symbol_database) {
+        if (code_segments_.empty() ||
+            static_cast<uint16_t>(code_segments_.back().start + code_segments_.back().length) !=
+                program_counter_) {
+            code_segments_.push_back(CodeSegment{program_counter_, 0});
+        }
+        code_segments_.back().length++;
+    }
     result.code.push_back(byte);
     program_counter_++;
 }
@@ -586,11 +1167,11 @@ void Assembler::emit_word(uint16_t word, Result &result) {
 }
 
 // Emit word with relocation tracking for REL mode
-void Assembler::emit_word_with_relocation(uint16_t word, const std::string &operand,
+void Assembler::emit_word_with_relocation(uint16_t word, std::string_view operand,
                                           Result &result) {
     if (rel_mode_) {
         // Evaluate to get relocation info
-        ExpressionEvaluator eval(symbols_);
+        ExpressionEvaluator eval(symbols_, &expression_evaluations_);
         auto expr_result = eval.evaluate(operand, 2);
 
         if (expr_result.success) {
@@ -604,14 +1185,14 @@ void Assembler::emit_word_with_relocation(uint16_t word, const std::string &oper
                 if (expr_result.is_external) {
                     // Find the external symbol to get its symbol number
                     // Extract symbol name from operand (simplified - may need better parsing)
-                    std::string sym_name = operand;
+                    std::string_view sym_name = operand;
                     // Remove addressing mode prefixes
                     if (!sym_name.empty() && sym_name[0] == '#')
-                        sym_name = sym_name.substr(1);
+                        sym_name.remove_prefix(1);
                     if (!sym_name.empty() && sym_name[0] == '<')
-                        sym_name = sym_name.substr(1);
+                        sym_name.remove_prefix(1);
                     if (!sym_name.empty() && sym_name[0] == '>')
-                        sym_name = sym_name.substr(1);
+                        sym_name.remove_prefix(1);
 
                     Symbol *sym = symbols_.lookup(sym_name);
                     if (sym && sym->is_external()) {
@@ -628,9 +1209,9 @@ void Assembler::emit_word_with_relocation(uint16_t word, const std::string &oper
     emit_word(word, result);
 }
 
-uint16_t Assembler::evaluate_operand(const std::string &operand) {
+uint16_t Assembler::evaluate_operand(std::string_view operand) {
     // Use the full ExpressionEvaluator (from ASM2.S EvalExpr line 2561+)
-    ExpressionEvaluator eval(symbols_);
+    ExpressionEvaluator eval(symbols_, &expression_evaluations_);
 
     // Pass 2 evaluation (all symbols should be defined)
     auto result = eval.evaluate(operand, 2);
@@ -639,19 +1220,24 @@ uint16_t Assembler::evaluate_operand(const std::string &operand) {
         // Mark any symbols in the operand as referenced
         // The expression evaluator uses const lookup, so we need to explicitly mark symbols
         // Reference: EDASM.SRC clears unreferenced bit during Pass 2 symbol lookups
-        std::string clean_operand = operand;
-        // Remove addressing mode characters
-        for (auto &c : clean_operand) {
-            if (c == '#' || c == '(' || c == ')' || c == ',' || c == '<' || c == '>') {
-                c = ' ';
+        // Tokens are separated by whitespace and addressing mode characters
+        auto is_separator = [](char c) {
+            return std::isspace(static_cast<unsigned char>(c)) || c == '#' || c == '(' ||
+                   c == ')' || c == ',' || c == '<' || c == '>';
+        };
+        size_t pos = 0;
+        while (pos < operand.size()) {
+            while (pos < operand.size() && is_separator(operand[pos])) {
+                pos++;
             }
-        }
-        // Extract potential symbol names
-        std::istringstream iss(clean_operand);
-        std::string token;
-        while (iss >> token) {
+            size_t start = pos;
+            while (pos < operand.size() && !is_separator(operand[pos])) {
+                pos++;
+            }
+            std::string_view token = operand.substr(start, pos - start);
             // Check if this looks like a symbol (starts with letter/underscore)
-            if (!token.empty() && (std::isalpha(token[0]) || token[0] == '_' || token[0] == '@')) {
+            if (!token.empty() && (std::isalpha(static_cast<unsigned char>(token[0])) ||
+                                   token[0] == '_' || token[0] == '@')) {
                 // Mark as referenced if it exists in symbol table
                 symbols_.mark_referenced(token);
             }
@@ -666,12 +1252,13 @@ uint16_t Assembler::evaluate_operand(const std::string &operand) {
 bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
                                         ListingGenerator *listing) {
     const auto &mnem = line.mnemonic;
-    ExpressionEvaluator eval(symbols_);
+    ExpressionEvaluator eval(symbols_, &expression_evaluations_);
 
     // CHN and INCLUDE are handled in preprocessing, should not reach here
     if (mnem == "CHN" || mnem == "INCLUDE") {
         // These should have been handled in preprocess_includes()
-        add_error(result, "Internal error: " + mnem + " not preprocessed", line.line_number);
+        add_error(result, "Internal error: " + std::string(mnem) + " not preprocessed",
+                  line.line_number);
         return false;
     }
 
@@ -699,12 +1286,9 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
     } else if (mnem == "LST") {
         // LST - listing control (from ASM3.S L8ECA)
         // LST ON or LST OFF
-        std::string operand = line.operand;
-        std::transform(operand.begin(), operand.end(), operand.begin(), ::toupper);
-
-        if (operand.find("ON") != std::string::npos) {
+        if (contains_keyword(line.operand, "ON")) {
             listing_enabled_ = true;
-        } else if (operand.find("OFF") != std::string::npos) {
+        } else if (contains_keyword(line.operand, "OFF")) {
             listing_enabled_ = false;
         } else {
             add_error(result, "LST requires ON or OFF", line.line_number);
@@ -713,12 +1297,9 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
     } else if (mnem == "MSB") {
         // MSB - high bit control (from ASM3.S L8E66)
         // MSB ON or MSB OFF - must be processed in pass2 for code generation
-        std::string operand = line.operand;
-        std::transform(operand.begin(), operand.end(), operand.begin(), ::toupper);
-
-        if (operand.find("ON") != std::string::npos) {
+        if (contains_keyword(line.operand, "ON")) {
             msb_on_ = true;
-        } else if (operand.find("OFF") != std::string::npos) {
+        } else if (contains_keyword(line.operand, "OFF")) {
             msb_on_ = false;
         } else {
             add_error(result, "MSB requires ON or OFF", line.line_number);
@@ -744,20 +1325,17 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
         // DB/DFB - define byte(s)
         // Parse operand list: $12,$34,$56 or LABEL,#$00
         // Split on commas
-        std::string operand = line.operand;
+        std::string_view operand = line.operand;
         size_t pos = 0;
         while (pos < operand.length()) {
             // Find next comma or end
             size_t comma = operand.find(',', pos);
-            if (comma == std::string::npos) {
+            if (comma == std::string_view::npos) {
                 comma = operand.length();
             }
 
-            // Extract this value
-            std::string value_str = operand.substr(pos, comma - pos);
-            // Trim whitespace
-            value_str.erase(0, value_str.find_first_not_of(" \t"));
-            value_str.erase(value_str.find_last_not_of(" \t") + 1);
+            // Extract this value (trimmed)
+            std::string_view value_str = trim_blanks(operand.substr(pos, comma - pos));
 
             if (!value_str.empty()) {
                 auto expr_result = eval.evaluate(value_str, 2);
@@ -774,17 +1352,15 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
     } else if (mnem == "DW" || mnem == "DA") {
         // DW/DA - define word(s)
         // Parse operand list similar to DB
-        std::string operand = line.operand;
+        std::string_view operand = line.operand;
         size_t pos = 0;
         while (pos < operand.length()) {
             size_t comma = operand.find(',', pos);
-            if (comma == std::string::npos) {
+            if (comma == std::string_view::npos) {
                 comma = operand.length();
             }
 
-            std::string value_str = operand.substr(pos, comma - pos);
-            value_str.erase(0, value_str.find_first_not_of(" \t"));
-            value_str.erase(value_str.find_last_not_of(" \t") + 1);
+            std::string_view value_str = trim_blanks(operand.substr(pos, comma - pos));
 
             if (!value_str.empty()) {
                 auto expr_result = eval.evaluate(value_str, 2);
@@ -802,7 +1378,7 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
         // ASC - ASCII string (from ASM3.S)
         // Extract string from quotes
         // If MSB ON, set high bit on all characters
-        std::string str = line.operand;
+        std::string_view str = line.operand;
         bool in_string = false;
         for (char c : str) {
             if (c == '"' || c == '\'') {
@@ -817,8 +1393,8 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
         }
     } else if (mnem == "DCI") {
         // DCI - DCI string (last char inverted/high bit set)
-        std::string str = line.operand;
-        std::vector<uint8_t> chars;
+        std::string_view str = line.operand;
+        std::pmr::vector<uint8_t> chars(&memory_);
         bool in_string = false;
         for (char c : str) {
             if (c == '"' || c == '\'') {
@@ -836,11 +1412,19 @@ bool Assembler::process_directive_pass2(const SourceLine &line, Result &result,
                 emit_byte(chars[i], result);
             }
         }
+    } else if (mnem == "ALIGN") {
+        // ALIGN - pad to a boundary (C-EDASM extension)
+        const uint16_t padding = align_padding(
+            line, rel_mode_ ? static_cast<uint32_t>(result.code.size()) : program_counter_, 2,
+            result);
+        for (uint16_t i = 0; i < padding; ++i) {
+            emit_byte(0, result);
+        }
     } else if (mnem == "END") {
         // END - stop assembly
         // Nothing to emit, but could set a flag to stop
     } else {
-        add_error(result, "Unknown directive: " + mnem, line.line_number);
+        add_error(result, "Unknown directive: " + std::string(mnem), line.line_number);
         return false;
     }
 
@@ -865,41 +1449,67 @@ void Assembler::add_warning(Result &result, const std::string &msg, int line_num
     result.warnings.push_back("Line " + std::to_string(line_num) + ": " + msg);
 }
 
-bool Assembler::is_directive(const std::string &mnemonic) const {
+bool Assembler::is_directive(std::string_view mnemonic) const {
     // List of assembler directives (from ASM3.S)
-    static const std::vector<std::string> directives = {
+    static constexpr std::string_view directives[] = {
         "ORG", "EQU",  "DA",  "DW",   "DB",   "DFB",  "ASC",  "DCI",     "DS",
         "REL", "ENT",  "EXT", "END",  "LST",  "SBTL", "MSB",  "INCLUDE", "CHN",
-        "DO",  "ELSE", "FIN", "IFEQ", "IFNE", "IFGT", "IFGE", "IFLT",    "IFLE"};
+        "DO",  "ELSE", "FIN", "IFEQ", "IFNE", "IFGT", "IFGE", "IFLT",    "IFLE",
+        "ALIGN"};
 
-    return std::find(directives.begin(), directives.end(), mnemonic) != directives.end();
+    return std::find(std::begin(directives), std::end(directives), mnemonic) !=
+           std::end(directives);
 }
 
 // =========================================
 // Include File Preprocessing (from ASM3.S L9348)
 // =========================================
 
-std::string Assembler::resolve_include_path(const std::string &include_path) const {
+std::string Assembler::resolve_include_path(std::string_view include_path) const {
     // Remove quotes from include path
-    std::string path = include_path;
+    std::string_view path = include_path;
     if (!path.empty() && (path.front() == '"' || path.front() == '\'')) {
-        path = path.substr(1);
+        path.remove_prefix(1);
     }
     if (!path.empty() && (path.back() == '"' || path.back() == '\'')) {
-        path = path.substr(0, path.size() - 1);
+        path.remove_suffix(1);
     }
 
     // If path is relative and we have a base path, resolve relative to base
     if (!path.empty() && path[0] != '/' && !base_path_.empty()) {
-        return base_path_ + "/" + path;
+        return base_path_ + "/" + std::string(path);
     }
 
-    return path;
+    return std::string(path);
+}
+
+std::optional<std::string_view> Assembler::load_source_file(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string text = contents.str();
+
+    // Lines keep views into the text, so it lives in the arena until reset()
+    char *copy = static_cast<char *>(memory_.allocate(text.size() + 1, 1));
+    std::copy(text.begin(), text.end(), copy);
+    return std::string_view(copy, text.size());
+}
+
+const SymbolSnapshot *Assembler::find_symbol_snapshot(std::string_view text) const {
+    for (const SymbolSnapshot *snapshot : options_.symbol_snapshots) {
+        if (snapshot && snapshot->matches(text)) {
+            return snapshot;
+        }
+    }
+    return nullptr;
 }
 
-std::vector<SourceLine> Assembler::preprocess_includes(const std::vector<SourceLine> &lines,
-                                                       Result &result, int nesting_level) {
-    std::vector<SourceLine> expanded;
+LazySourceLines Assembler::preprocess_includes(LazySourceLines &lines, Result &result,
+                                               int nesting_level) {
+    LazySourceLines expanded(&memory_);
 
     // Check for nesting limit (original EDASM doesn't allow nested INCLUDEs)
     if (nesting_level > 0) {
@@ -907,9 +1517,14 @@ std::vector<SourceLine> Assembler::preprocess_includes(const std::vector<SourceL
         return expanded;
     }
 
-    for (const auto &line : lines) {
+    for (size_t i = 0; i < lines.size(); ++i) {
+        // Only INCLUDE/CHN lines need tokenizing here
+        std::string_view mnem = Tokenizer::peek_mnemonic(lines.text(i));
+
         // Check if this is an INCLUDE directive
-        if (line.has_mnemonic() && line.mnemonic == "INCLUDE") {
+        if (equals_keyword(mnem, "INCLUDE")) {
+            const SourceLine &line = lines.line(i);
+
             // Validate that INCLUDE is not called from within an include file
             if (in_include_file_) {
                 add_error(result, "INCLUDE/CHN NESTING", line.line_number);
@@ -920,51 +1535,50 @@ std::vector<SourceLine> Assembler::preprocess_includes(const std::vector<SourceL
             std::string include_path = resolve_include_path(line.operand);
 
             // Try to read the include file
-            std::ifstream include_file(include_path);
-            if (!include_file.is_open()) {
+            auto include_text = load_source_file(include_path);
+            if (!include_text) {
                 add_error(result, "INCLUDE FILE NOT FOUND: " + include_path, line.line_number);
                 continue;
             }
 
-            // Read all lines from include file
-            std::vector<SourceLine> include_lines;
-            std::string include_line;
-            int include_line_num = 1;
+            // Precompiled equates: import the stored symbols in pass 1 instead
+            if (const SymbolSnapshot *snapshot = find_symbol_snapshot(*include_text)) {
+                snapshot_imports_.push_back(
+                    SnapshotImport{expanded.size(), snapshot, line.line_number, lines.text(i)});
+                continue;
+            }
 
             // Set flag that we're in an include file
             bool saved_include_state = in_include_file_;
-            const_cast<Assembler *>(this)->in_include_file_ = true;
+            in_include_file_ = true;
 
-            while (std::getline(include_file, include_line)) {
-                auto parsed = Tokenizer::parse_line(include_line, include_line_num++);
+            // Add all lines from include file to expanded lines
+            int include_line_num = 1;
+            for_each_line(*include_text, [&](std::string_view include_line) {
+                int line_num = include_line_num++;
+                std::string_view include_mnem = Tokenizer::peek_mnemonic(include_line);
 
                 // Check for directives that are invalid from include files
-                if (parsed.has_mnemonic()) {
-                    if (parsed.mnemonic == "INCLUDE") {
-                        add_error(result, "INCLUDE/CHN NESTING", parsed.line_number);
-                        continue;
-                    }
-                    // According to EDASM.SRC, CHN is also invalid from INCLUDE
-                    if (parsed.mnemonic == "CHN") {
-                        add_error(result, "INVALID FROM INCLUDE", parsed.line_number);
-                        continue;
-                    }
+                if (equals_keyword(include_mnem, "INCLUDE")) {
+                    add_error(result, "INCLUDE/CHN NESTING", line_num);
+                    return;
+                }
+                // According to EDASM.SRC, CHN is also invalid from INCLUDE
+                if (equals_keyword(include_mnem, "CHN")) {
+                    add_error(result, "INVALID FROM INCLUDE", line_num);
+                    return;
                 }
 
-                include_lines.push_back(parsed);
-            }
+                expanded.append(include_line, line_num);
+            });
 
             // Restore include state
-            const_cast<Assembler *>(this)->in_include_file_ = saved_include_state;
-
-            include_file.close();
-
-            // Add all lines from include file to expanded lines
-            expanded.insert(expanded.end(), include_lines.begin(), include_lines.end());
+            in_include_file_ = saved_include_state;
 
-        } else if (line.has_mnemonic() && line.mnemonic == "CHN") {
+        } else if (equals_keyword(mnem, "CHN")) {
             // CHN directive - chain to another source file
             // Reference: ASM3.S L928C - CHN directive handler
+            const SourceLine &line = lines.line(i);
 
             // Validate that CHN is not called from within an include file
             // Reference: ASM3.S L928C CPX #MacFile check
@@ -977,23 +1591,17 @@ std::vector<SourceLine> Assembler::preprocess_includes(const std::vector<SourceL
             std::string chain_path = resolve_include_path(line.operand);
 
             // Try to read the chain file
-            std::ifstream chain_file(chain_path);
-            if (!chain_file.is_open()) {
+            // Reference: ASM3.S L929C - Opens new file and continues assembly
+            auto chain_text = load_source_file(chain_path);
+            if (!chain_text) {
                 add_error(result, "CHN FILE NOT FOUND: " + chain_path, line.line_number);
                 continue;
             }
 
-            // Read all lines from chain file
-            // Reference: ASM3.S L929C - Opens new file and continues assembly
-            std::string chain_line;
             int chain_line_num = 1;
-
-            while (std::getline(chain_file, chain_line)) {
-                auto parsed = Tokenizer::parse_line(chain_line, chain_line_num++);
-                expanded.push_back(parsed);
-            }
-
-            chain_file.close();
+            for_each_line(*chain_text, [&](std::string_view chain_line) {
+                expanded.append(chain_line, chain_line_num++);
+            });
 
             // CHN means we switch files - don't process any more lines from current file
             // All remaining lines after CHN are ignored (file is "closed")
@@ -1001,7 +1609,7 @@ std::vector<SourceLine> Assembler::preprocess_includes(const std::vector<SourceL
 
         } else {
             // Not an INCLUDE or CHN directive, just copy the line
-            expanded.push_back(line);
+            expanded.append(lines.text(i), lines.line_number(i));
         }
     }
 
@@ -1020,15 +1628,13 @@ bool Assembler::should_assemble_line() const {
     return cond_asm_flag_ == 0x00;
 }
 
-bool Assembler::is_conditional_directive(const std::string &mnemonic) const {
-    // List of conditional assembly directives (from ASM3.S)
-    static const std::vector<std::string> conditionals = {"DO",   "ELSE", "FIN",  "IFEQ", "IFNE",
-                                                          "IFGT", "IFGE", "IFLT", "IFLE"};
-    return std::find(conditionals.begin(), conditionals.end(), mnemonic) != conditionals.end();
+bool Assembler::is_conditional_directive(std::string_view mnemonic) const {
+    return std::find(std::begin(kConditionalDirectives), std::end(kConditionalDirectives),
+                     mnemonic) != std::end(kConditionalDirectives);
 }
 
 bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Result &result) {
-    const std::string &mnem = line.mnemonic;
+    const auto &mnem = line.mnemonic;
 
     // DO directive - marks beginning of conditional block (from ASM3.S L90B7)
     // Evaluates operand: if non-zero, assemble block; if zero, skip
@@ -1039,7 +1645,7 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
@@ -1057,15 +1663,17 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
     // Functionally identical to DO
     if (mnem == "IFNE") {
         if (line.operand.empty()) {
-            add_error(result, mnem + " requires an expression", line.line_number);
+            add_error(result, std::string(mnem) + " requires an expression", line.line_number);
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
-            add_error(result, "Invalid expression in " + mnem + ": " + eval_result.error_message,
+            add_error(result,
+                      "Invalid expression in " + std::string(mnem) + ": " +
+                          eval_result.error_message,
                       line.line_number);
             return false;
         }
@@ -1086,7 +1694,7 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
@@ -1107,7 +1715,7 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
@@ -1129,7 +1737,7 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
@@ -1151,7 +1759,7 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
@@ -1173,7 +1781,7 @@ bool Assembler::process_conditional_directive_pass1(const SourceLine &line, Resu
             return false;
         }
 
-        ExpressionEvaluator evaluator(symbols_);
+        ExpressionEvaluator evaluator(symbols_, &expression_evaluations_);
         auto eval_result = evaluator.evaluate(line.operand, program_counter_);
 
         if (!eval_result.success) {
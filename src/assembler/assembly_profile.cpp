@@ -0,0 +1,62 @@
+/**
+ * @file assembly_profile.cpp
+ * @brief Formatting for assembler phase instrumentation
+ *
+ * No EDASM.SRC counterpart; this is a diagnostic aid for the C++ port.
+ */
+
+#include "edasm/assembler/assembly_profile.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace edasm {
+
+namespace {
+
+std::string format_phase(const char *name, const PhaseProfile &phase) {
+    std::ostringstream oss;
+    oss << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+        << std::setw(10) << phase.wall_ms << std::setw(10) << phase.allocations << std::setw(12)
+        << phase.bytes_allocated;
+    return oss.str();
+}
+
+} // namespace
+
+PhaseProfile AssemblyProfile::total() const {
+    PhaseProfile sum;
+    for (const PhaseProfile *phase : {&tokenize, &includes, &pass1, &pass2, &rel_build, &listing}) {
+        sum.wall_ms += phase->wall_ms;
+        sum.allocations += phase->allocations;
+        sum.bytes_allocated += phase->bytes_allocated;
+    }
+    return sum;
+}
+
+std::vector<std::string> AssemblyProfile::format_lines() const {
+    std::vector<std::string> out;
+    out.push_back("Phase        Time ms    Allocs       Bytes");
+    out.push_back(format_phase("tokenize", tokenize));
+    out.push_back(format_phase("include", includes));
+    out.push_back(format_phase("pass1", pass1));
+    out.push_back(format_phase("pass2", pass2));
+    out.push_back(format_phase("rel", rel_build));
+    out.push_back(format_phase("listing", listing));
+    out.push_back(format_phase("total", total()));
+    out.push_back("Lines: " + std::to_string(lines) + " (" + std::to_string(tokenized_lines) +
+                  " tokenized)  Symbols: " + std::to_string(symbols) +
+                  "  Expressions: " + std::to_string(expression_evaluations));
+    return out;
+}
+
+std::string AssemblyProfile::to_string() const {
+    std::string text;
+    for (const auto &line : format_lines()) {
+        text += line;
+        text += '\n';
+    }
+    return text;
+}
+
+} // namespace edasm
@@ -0,0 +1,171 @@
+/**
+ * @file char_scanner.cpp
+ * @brief Block-wise character-class scanning for the tokenizer
+ *
+ * No EDASM.SRC counterpart (the original scans one character at a time from
+ * the editor's text buffer). Each search is written once as a pair: a
+ * 16-byte block predicate returning a match bitmask (bit i set when byte i
+ * matches) and the equivalent scalar predicate for the tail.
+ */
+
+#include "edasm/assembler/char_scanner.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+#define EDASM_SCANNER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace edasm {
+
+namespace {
+
+bool is_blank(unsigned char c) {
+    return c == ' ' || c == '\t';
+}
+
+bool is_label_char(unsigned char c) {
+    unsigned char lower = c | 0x20;
+    return (lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '@';
+}
+
+#ifdef EDASM_SCANNER_SSE2
+
+// Byte-wise equality with a constant
+__m128i eq(__m128i block, char c) {
+    return _mm_cmpeq_epi8(block, _mm_set1_epi8(c));
+}
+
+// Byte-wise lo <= block <= hi for ASCII bounds (bytes >= 0x80 are negative
+// as signed chars and never match)
+__m128i in_range(__m128i block, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+__m128i blank_mask(__m128i block) {
+    return _mm_or_si128(eq(block, ' '), eq(block, '\t'));
+}
+
+__m128i label_mask(__m128i block) {
+    __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+    __m128i m = _mm_or_si128(in_range(lower, 'a', 'z'), in_range(block, '0', '9'));
+    return _mm_or_si128(m, _mm_or_si128(eq(block, '_'), eq(block, '@')));
+}
+
+uint32_t bits(__m128i mask) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(mask));
+}
+
+#endif
+
+// Searches: scalar() tests one byte, block() returns the match bitmask of
+// a 16-byte block (bit i set when byte i matches)
+
+struct Newline {
+    static bool scalar(unsigned char c) {
+        return c == '\n';
+    }
+#ifdef EDASM_SCANNER_SSE2
+    static uint32_t block(__m128i b) {
+        return bits(eq(b, '\n'));
+    }
+#endif
+};
+
+struct Semicolon {
+    static bool scalar(unsigned char c) {
+        return c == ';';
+    }
+#ifdef EDASM_SCANNER_SSE2
+    static uint32_t block(__m128i b) {
+        return bits(eq(b, ';'));
+    }
+#endif
+};
+
+struct BlankOrSemicolon {
+    static bool scalar(unsigned char c) {
+        return is_blank(c) || c == ';';
+    }
+#ifdef EDASM_SCANNER_SSE2
+    static uint32_t block(__m128i b) {
+        return bits(_mm_or_si128(blank_mask(b), eq(b, ';')));
+    }
+#endif
+};
+
+struct NonBlank {
+    static bool scalar(unsigned char c) {
+        return !is_blank(c);
+    }
+#ifdef EDASM_SCANNER_SSE2
+    static uint32_t block(__m128i b) {
+        return ~bits(blank_mask(b)) & 0xFFFF;
+    }
+#endif
+};
+
+struct NonLabelChar {
+    static bool scalar(unsigned char c) {
+        return !is_label_char(c);
+    }
+#ifdef EDASM_SCANNER_SSE2
+    static uint32_t block(__m128i b) {
+        return ~bits(label_mask(b)) & 0xFFFF;
+    }
+#endif
+};
+
+// Offset of the first byte at or after pos matching Search, or text.size()
+template <typename Search> size_t scan(std::string_view text, size_t pos) {
+    const size_t size = text.size();
+#ifdef EDASM_SCANNER_SSE2
+    const char *data = text.data();
+    while (pos + CharScanner::kBlockSize <= size) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        uint32_t match = Search::block(block);
+        if (match != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(match));
+        }
+        pos += CharScanner::kBlockSize;
+    }
+#endif
+    while (pos < size && !Search::scalar(static_cast<unsigned char>(text[pos]))) {
+        pos++;
+    }
+    return pos < size ? pos : size;
+}
+
+} // namespace
+
+bool CharScanner::vectorized() {
+#ifdef EDASM_SCANNER_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t CharScanner::find_newline(std::string_view text, size_t pos) {
+    return scan<Newline>(text, pos);
+}
+
+size_t CharScanner::find_semicolon(std::string_view text, size_t pos) {
+    return scan<Semicolon>(text, pos);
+}
+
+size_t CharScanner::find_blank_or_semicolon(std::string_view text, size_t pos) {
+    return scan<BlankOrSemicolon>(text, pos);
+}
+
+size_t CharScanner::skip_blanks(std::string_view text, size_t pos) {
+    return scan<NonBlank>(text, pos);
+}
+
+size_t CharScanner::skip_label_chars(std::string_view text, size_t pos) {
+    return scan<NonLabelChar>(text, pos);
+}
+
+} // namespace edasm
@@ -22,11 +22,31 @@
 
 #include "edasm/assembler/linker.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 
+#include "edasm/files/symbol_database.hpp"
+
 namespace edasm {
 
+namespace {
+
+std::string hex4(uint32_t value) {
+    std::ostringstream oss;
+    oss << '$' << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << value;
+    return oss.str();
+}
+
+bool valid_page_span(const PageSpan &span) {
+    return span.kind >= PageSpan::KIND_ALIGN && span.kind <= PageSpan::KIND_INDEXED &&
+           span.boundary != 0 && span.boundary <= 0x100 &&
+           (span.boundary & (span.boundary - 1)) == 0;
+}
+
+} // namespace
+
 Linker::Result Linker::link(const std::vector<std::string> &rel_files, const Options &opts) {
     Result result;
     options_ = opts;
@@ -34,7 +54,10 @@ Linker::Result Linker::link(const std::vector<std::string> &rel_files, const Opt
     // Reset state
     modules_.clear();
     entry_table_.clear();
+    entry_by_name_.clear();
     extern_table_.clear();
+    names_.reset();
+    arena_.release();
     next_load_address_ = options_.origin;
 
     // Phase 1: Load and parse REL files
@@ -48,7 +71,9 @@ Linker::Result Linker::link(const std::vector<std::string> &rel_files, const Opt
     }
 
     // Phase 3: Assign load addresses to modules
-    assign_load_addresses();
+    if (!assign_load_addresses(result)) {
+        return result;
+    }
 
     // Phase 4: Resolve external references
     if (!resolve_externals(result)) {
@@ -60,6 +85,9 @@ Linker::Result Linker::link(const std::vector<std::string> &rel_files, const Opt
         return result;
     }
 
+    // Page constraints and crossings at the final addresses
+    check_page_spans(result);
+
     // Phase 6: Generate output based on output type
     switch (options_.output_type) {
     case Options::OutputType::BIN:
@@ -80,6 +108,9 @@ Linker::Result Linker::link(const std::vector<std::string> &rel_files, const Opt
     if (options_.generate_map) {
         result.load_map = generate_load_map();
     }
+    if (options_.generate_symbols) {
+        result.symbol_database = generate_symbol_database();
+    }
 
     result.success = result.errors.empty();
     return result;
@@ -128,7 +159,9 @@ bool Linker::load_rel_file(const std::string &filename, Module &module, Result &
     }
 
     // Parse REL file format
-    if (!RELFileBuilder::parse(file_data, module.code, module.rld_entries, module.esd_entries)) {
+    if (!RELFileBuilder::parse(file_data, module.code, module.rld_entries, module.esd_entries,
+                               &module.page_spans) ||
+        !std::all_of(module.page_spans.begin(), module.page_spans.end(), valid_page_span)) {
         add_error(result, "Invalid REL file format: " + filename);
         return false;
     }
@@ -144,7 +177,8 @@ bool Linker::load_rel_file(const std::string &filename, Module &module, Result &
 bool Linker::build_symbol_tables(Result &result) {
     // Process ESD entries from all modules
     for (size_t mod_num = 0; mod_num < modules_.size(); ++mod_num) {
-        const auto &module = modules_[mod_num];
+        auto &module = modules_[mod_num];
+        module.first_extern = extern_table_.size();
 
         // Count external symbols for this module (for symbol numbering)
         uint8_t ext_count = 0;
@@ -162,27 +196,33 @@ bool Linker::build_symbol_tables(Result &result) {
 
 void Linker::process_esd_entry(const ESDEntry &esd, uint8_t module_num, uint8_t &ext_count,
                                Result &result) {
+    const NameInterner::Id name = names_.intern(esd.name);
+    if (name >= entry_by_name_.size()) {
+        entry_by_name_.resize(name + 1, kNoEntry);
+    }
+
     if (esd.is_entry()) {
         // ENTRY symbol - add to entry table
-        if (entry_table_.find(esd.name) != entry_table_.end()) {
+        if (entry_by_name_[name] != kNoEntry) {
             // Duplicate ENTRY definition
             add_warning(result, "Duplicate ENTRY symbol: " + esd.name);
             return;
         }
 
         EntryRecord entry;
-        entry.name = esd.name;
+        entry.name = name;
         entry.address = esd.address; // Will be relocated later
         entry.flags = esd.flags;
         entry.module_number = module_num;
 
-        entry_table_[esd.name] = entry;
+        entry_by_name_[name] = static_cast<uint32_t>(entry_table_.size());
+        entry_table_.push_back(entry);
 
     } else if (esd.is_external()) {
         // EXTERNAL reference - add to extern table
         // The symbol number in RLD will be the index of this external symbol (1-indexed)
         ExternRecord ext;
-        ext.name = esd.name;
+        ext.name = name;
         ext.patch_address = esd.address;
         ext.flags = esd.flags;
         ext.module_number = module_num;
@@ -197,16 +237,112 @@ void Linker::process_esd_entry(const ESDEntry &esd, uint8_t module_num, uint8_t
 // Phase 3: Assign Load Addresses
 // =========================================
 
-void Linker::assign_load_addresses() {
-    uint16_t current_address = next_load_address_;
+bool Linker::assign_load_addresses(Result &result) {
+    if (options_.page_layout) {
+        if (!assign_page_layout(result)) {
+            return false;
+        }
+    } else {
+        uint16_t current_address = next_load_address_;
+
+        for (auto &module : modules_) {
+            module.load_address = current_address;
+            current_address += module.code_length;
+
+            // Optional alignment (align to page boundary)
+            if (options_.align && (current_address & 0xFF) != 0) {
+                current_address = (current_address + 0x100) & 0xFF00;
+            }
+        }
+    }
+
+    // Padding: the extent of the image less the code it holds
+    uint32_t end = next_load_address_;
+    uint32_t code = 0;
+    for (const auto &module : modules_) {
+        end = std::max<uint32_t>(end, module.load_address + module.code_length);
+        code += module.code_length;
+    }
+    result.padding = static_cast<uint16_t>(end - next_load_address_ - code);
+    return true;
+}
+
+// Modules are placed in order, each at the lowest address meeting its ALIGN
+// constraints. The padding in front of a module is first offered to later
+// modules that fit in it (first fit); nothing moves ahead of the first
+// module, which holds the entry point at the origin.
+bool Linker::assign_page_layout(Result &result) {
+    uint32_t cursor = next_load_address_;
+    std::vector<bool> placed(modules_.size(), false);
+
+    for (size_t i = 0; i < modules_.size(); ++i) {
+        if (placed[i]) {
+            continue;
+        }
+        auto &module = modules_[i];
+        const auto address = first_fit(module, cursor);
+        if (!address) {
+            add_error(result, "Cannot place " + module.filename + " with its ALIGN constraints");
+            return false;
+        }
+
+        for (size_t j = i + 1; i > 0 && j < modules_.size() && cursor < *address; ++j) {
+            const auto fill = placed[j] ? std::nullopt : first_fit(modules_[j], cursor);
+            if (fill && *fill + modules_[j].code_length <= *address) {
+                modules_[j].load_address = *fill;
+                placed[j] = true;
+                cursor = *fill + modules_[j].code_length;
+            }
+        }
+
+        module.load_address = *address;
+        placed[i] = true;
+        cursor = *address + module.code_length;
+    }
+    return true;
+}
 
-    for (auto &module : modules_) {
-        module.load_address = current_address;
-        current_address += module.code_length;
+// Lowest address at or above from where all of the module's constraints
+// hold; they repeat every page, so one page of candidates is enough
+std::optional<uint16_t> Linker::first_fit(const Module &module, uint32_t from) const {
+    for (uint32_t address = from; address < from + 0x100; ++address) {
+        if (address + module.code_length > 0x10000) {
+            break;
+        }
+        const bool fits = std::all_of(
+            module.page_spans.begin(), module.page_spans.end(), [address](const PageSpan &span) {
+                return !span.is_constraint() || span.satisfied_at(static_cast<uint16_t>(address));
+            });
+        if (fits) {
+            return static_cast<uint16_t>(address);
+        }
+    }
+    return std::nullopt;
+}
 
-        // Optional alignment (align to page boundary)
-        if (options_.align && (current_address & 0xFF) != 0) {
-            current_address = (current_address + 0x100) & 0xFF00;
+// Constraints the layout did not honor are warnings (only possible without
+// page layout); branches and table reads that cross a page are reported
+void Linker::check_page_spans(Result &result) {
+    for (const auto &module : modules_) {
+        for (const auto &span : module.page_spans) {
+            const uint32_t start = module.load_address + span.offset;
+            const uint32_t end = start + (span.length > 0 ? span.length - 1 : 0);
+            if (span.is_constraint()) {
+                if (!span.satisfied_at(module.load_address)) {
+                    add_warning(result, module.filename + ": ALIGN " + hex4(span.boundary) +
+                                            " at " + hex4(start) + " not honored");
+                }
+            } else if (span.crosses(module.load_address)) {
+                if (span.kind == PageSpan::KIND_BRANCH) {
+                    result.page_crossings.push_back(module.filename + ": branch between " +
+                                                    hex4(start) + " and " + hex4(end) +
+                                                    " crosses a page, +1 cycle when taken");
+                } else {
+                    result.page_crossings.push_back(
+                        module.filename + ": indexed read of table " + hex4(start) + "-" +
+                        hex4(end) + " crosses a page, +1 cycle past " + hex4(start | 0xFF));
+                }
+            }
         }
     }
 }
@@ -216,26 +352,28 @@ void Linker::assign_load_addresses() {
 // =========================================
 
 bool Linker::resolve_externals(Result &result) {
-    for (auto &ext : extern_table_) {
+    for (size_t i = 0; i < extern_table_.size(); ++i) {
+        auto &ext = extern_table_[i];
         // Look up in entry table
-        auto it = entry_table_.find(ext.name);
-        if (it == entry_table_.end()) {
+        const uint32_t entry = entry_by_name_[ext.name];
+        if (entry == kNoEntry) {
             // Unresolved external - error or warning depending on output type
+            const std::string msg = "Unresolved external: " + std::string(names_.name(ext.name));
             if (options_.output_type == Options::OutputType::REL) {
                 // For REL output, unresolved externals are OK
-                add_warning(result, "Unresolved external: " + ext.name);
+                add_warning(result, msg);
             } else {
-                add_error(result, "Unresolved external: " + ext.name);
+                add_error(result, msg);
             }
             continue;
         }
 
         // Resolve the external reference
         ext.resolved = true;
-        ext.entry = &it->second;
+        ext.entry = entry;
 
         // Add this external to the entry's reference list
-        it->second.extern_refs.push_back(extern_table_.size() - 1);
+        entry_table_[entry].extern_refs.push_back(i);
     }
 
     return result.errors.empty();
@@ -276,17 +414,18 @@ void Linker::apply_rld_entry(Module &module, const RLDEntry &rld, size_t module_
         relocated_value = current_value + module.load_address;
 
     } else if (rld.flags == RLDEntry::TYPE_EXTERNAL) {
-        // External reference - find the external symbol by number for this module
+        // External reference - the module's externs are numbered from 1 in
+        // ESD order, starting at module.first_extern in the extern table
         bool found = false;
-        for (const auto &ext : extern_table_) {
-            if (ext.module_number == module_idx && ext.symbol_number == rld.symbol_num) {
-                if (ext.resolved && ext.entry) {
-                    // Use the entry's relocated address (absolute address)
-                    relocated_value =
-                        ext.entry->address + modules_[ext.entry->module_number].load_address;
-                    found = true;
-                    break;
-                }
+        const size_t ext_idx = module.first_extern + rld.symbol_num - 1;
+        if (rld.symbol_num != 0 && ext_idx < extern_table_.size()) {
+            const auto &ext = extern_table_[ext_idx];
+            if (ext.module_number == module_idx && ext.symbol_number == rld.symbol_num &&
+                ext.resolved) {
+                // Use the entry's relocated address (absolute address)
+                const auto &entry = entry_table_[ext.entry];
+                relocated_value = entry.address + modules_[entry.module_number].load_address;
+                found = true;
             }
         }
 
@@ -306,15 +445,24 @@ void Linker::apply_rld_entry(Module &module, const RLDEntry &rld, size_t module_
 // Phase 6: Generate Output
 // =========================================
 
-std::vector<uint8_t> Linker::generate_bin_output() {
-    std::vector<uint8_t> output;
+// Module code at its load address relative to the origin; the padding left
+// by alignment or page layout is zero-filled
+std::vector<uint8_t> Linker::layout_code() const {
+    size_t size = 0;
+    for (const auto &module : modules_) {
+        size = std::max<size_t>(size, module.load_address - options_.origin + module.code.size());
+    }
 
-    // Concatenate all module code
+    std::vector<uint8_t> image(size, 0);
     for (const auto &module : modules_) {
-        output.insert(output.end(), module.code.begin(), module.code.end());
+        std::copy(module.code.begin(), module.code.end(),
+                  image.begin() + (module.load_address - options_.origin));
     }
+    return image;
+}
 
-    return output;
+std::vector<uint8_t> Linker::generate_bin_output() {
+    return layout_code();
 }
 
 std::vector<uint8_t> Linker::generate_rel_output() {
@@ -323,29 +471,30 @@ std::vector<uint8_t> Linker::generate_rel_output() {
     // 2. Generate new RLD for remaining relocations
     // 3. Generate new ESD for unresolved externals and entries
 
-    std::vector<uint8_t> combined_code;
+    std::vector<uint8_t> combined_code = layout_code();
     std::vector<RLDEntry> combined_rld;
     std::vector<ESDEntry> combined_esd;
+    std::vector<PageSpan> combined_spans;
 
-    // Combine code and adjust RLD addresses
-    uint16_t code_offset = 0;
+    // Adjust RLD addresses and page spans by each module's code offset
     for (const auto &module : modules_) {
-        combined_code.insert(combined_code.end(), module.code.begin(), module.code.end());
+        const uint16_t code_offset = module.load_address - options_.origin;
 
-        // Adjust RLD addresses by code offset
         for (auto rld : module.rld_entries) {
             rld.address += code_offset;
             combined_rld.push_back(rld);
         }
-
-        code_offset += module.code_length;
+        for (auto span : module.page_spans) {
+            span.offset += code_offset;
+            combined_spans.push_back(span);
+        }
     }
 
     // Add unresolved externals to ESD
     for (const auto &ext : extern_table_) {
         if (!ext.resolved) {
             ESDEntry esd;
-            esd.name = ext.name;
+            esd.name = names_.name(ext.name);
             esd.address = ext.patch_address;
             esd.flags = ext.flags;
             esd.symbol_num = ext.symbol_number;
@@ -354,9 +503,9 @@ std::vector<uint8_t> Linker::generate_rel_output() {
     }
 
     // Add entries to ESD
-    for (const auto &[name, entry] : entry_table_) {
+    for (const auto &entry : entry_table_) {
         ESDEntry esd;
-        esd.name = name;
+        esd.name = names_.name(entry.name);
         esd.address = entry.address + modules_[entry.module_number].load_address;
         esd.flags = entry.flags;
         combined_esd.push_back(esd);
@@ -370,6 +519,9 @@ std::vector<uint8_t> Linker::generate_rel_output() {
     for (const auto &esd : combined_esd) {
         builder.add_esd_entry(esd.name, esd.address, esd.flags, esd.symbol_num);
     }
+    for (const auto &span : combined_spans) {
+        builder.add_page_span(span.kind, span.offset, span.length, span.boundary);
+    }
 
     return builder.build(combined_code);
 }
@@ -399,16 +551,17 @@ std::string Linker::generate_load_map() const {
     }
 
     map << "\nEntry Points:\n";
-    for (const auto &[name, entry] : entry_table_) {
+    for (const auto &entry : entry_table_) {
         uint16_t final_addr = entry.address + modules_[entry.module_number].load_address;
-        map << "  " << name << " = $" << std::hex << std::uppercase << final_addr;
+        map << "  " << names_.name(entry.name) << " = $" << std::hex << std::uppercase
+            << final_addr;
         map << " (module " << (entry.module_number + 1) << ")\n";
     }
 
     if (!extern_table_.empty()) {
         map << "\nExternal References:\n";
         for (const auto &ext : extern_table_) {
-            map << "  " << ext.name << " (module " << (ext.module_number + 1) << ")";
+            map << "  " << names_.name(ext.name) << " (module " << (ext.module_number + 1) << ")";
             if (ext.resolved) {
                 map << " -> RESOLVED\n";
             } else {
@@ -420,6 +573,20 @@ std::string Linker::generate_load_map() const {
     return map.str();
 }
 
+// Module code ranges and ENTRY symbols at their final addresses, for the
+// emulator (REL files carry no source lines)
+std::vector<uint8_t> Linker::generate_symbol_database() const {
+    SymbolDatabase::Builder database;
+    for (const auto &module : modules_) {
+        database.add_module(module.filename, module.load_address, module.code_length);
+    }
+    for (const auto &entry : entry_table_) {
+        const uint16_t final_addr = entry.address + modules_[entry.module_number].load_address;
+        database.add_symbol(names_.name(entry.name), final_addr, entry.module_number);
+    }
+    return database.build();
+}
+
 // =========================================
 // Error Reporting
 // =========================================
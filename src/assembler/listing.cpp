@@ -30,12 +30,17 @@
 
 namespace edasm {
 
-ListingGenerator::ListingGenerator(const Options &opts) : options_(opts) {}
+ListingGenerator::ListingGenerator(const Options &opts, std::pmr::memory_resource *mr)
+    : options_(opts), lines_(mr) {}
 
 void ListingGenerator::add_line(const ListingLine &line) {
     lines_.push_back(line);
 }
 
+void ListingGenerator::add_line(ListingLine &&line) {
+    lines_.push_back(std::move(line));
+}
+
 void ListingGenerator::set_symbol_table(const SymbolTable &symbols) {
     symbols_ = &symbols;
 }
@@ -89,6 +94,9 @@ std::string ListingGenerator::format_listing_line(const ListingLine &line) const
 
     // Source line
     oss << line.source_line;
+    if (!line.note.empty()) {
+        oss << "  [" << line.note << "]";
+    }
 
     // If more than 3 bytes, continue on next lines
     if (line.bytes.size() > 3) {
@@ -97,10 +105,7 @@ std::string ListingGenerator::format_listing_line(const ListingLine &line) const
             oss << "      " << format_address(line.address + i) << "  ";
 
             // Get next chunk of bytes
-            std::vector<uint8_t> chunk;
-            for (size_t j = i; j < i + 3 && j < line.bytes.size(); ++j) {
-                chunk.push_back(line.bytes[j]);
-            }
+            auto chunk = std::span<const uint8_t>(line.bytes).subspan(i);
             oss << std::left << std::setw(12) << format_bytes(chunk, 3);
         }
     }
@@ -129,7 +134,7 @@ std::string ListingGenerator::format_address(uint16_t addr) const {
     return oss.str();
 }
 
-std::string ListingGenerator::format_bytes(const std::vector<uint8_t> &bytes,
+std::string ListingGenerator::format_bytes(std::span<const uint8_t> bytes,
                                            size_t max_bytes) const {
     std::ostringstream oss;
 
@@ -147,13 +152,9 @@ std::string ListingGenerator::format_bytes(const std::vector<uint8_t> &bytes,
 std::string ListingGenerator::generate_symbol_table() const {
     std::ostringstream oss;
 
-    // Get symbols sorted by name or value
-    std::vector<Symbol> symbols;
-    if (options_.sort_by_value) {
-        symbols = symbols_->sorted_by_value();
-    } else {
-        symbols = symbols_->sorted_by_name();
-    }
+    // Get symbols sorted by name or value (cached views, no copies)
+    SymbolTable::View symbols =
+        options_.sort_by_value ? symbols_->by_value() : symbols_->by_name();
 
     if (symbols.empty()) {
         return "";
@@ -175,7 +176,7 @@ std::string ListingGenerator::generate_symbol_table() const {
     return oss.str();
 }
 
-std::string ListingGenerator::format_symbols_in_columns(const std::vector<Symbol> &symbols,
+std::string ListingGenerator::format_symbols_in_columns(SymbolTable::View symbols,
                                                         int columns) const {
 
     std::ostringstream oss;
@@ -190,7 +191,7 @@ std::string ListingGenerator::format_symbols_in_columns(const std::vector<Symbol
         for (int col = 0; col < columns; ++col) {
             int idx = row + col * rows;
             if (idx < static_cast<int>(symbols.size())) {
-                std::string formatted = format_symbol(symbols[idx]);
+                std::string formatted = format_symbol(*symbols[idx]);
                 oss << std::left << std::setw(col_width) << formatted;
             }
         }
@@ -0,0 +1,96 @@
+/**
+ * @file name_interner.cpp
+ * @brief String interner for linker symbol names
+ *
+ * No EDASM.SRC counterpart; see name_interner.hpp.
+ */
+
+#include "edasm/assembler/name_interner.hpp"
+
+#include <algorithm>
+
+namespace edasm {
+
+namespace {
+
+constexpr size_t kInitialSlots = 64;
+
+} // namespace
+
+NameInterner::NameInterner(std::pmr::memory_resource *mr)
+    : mr_(mr), names_(mr), hashes_(mr), slots_(mr) {}
+
+// 32-bit FNV-1a
+uint32_t NameInterner::hash(std::string_view name) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : name) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Slot holding name, or the empty slot where it would be inserted
+size_t NameInterner::slot_of(std::string_view name, uint32_t h) const {
+    const size_t mask = slots_.size() - 1;
+    size_t slot = h & mask;
+    while (slots_[slot] != kNone) {
+        const Id id = slots_[slot];
+        if (hashes_[id] == h && names_[id] == name) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+NameInterner::Id NameInterner::find(std::string_view name) const {
+    if (slots_.empty()) {
+        return kNone;
+    }
+    return slots_[slot_of(name, hash(name))];
+}
+
+NameInterner::Id NameInterner::intern(std::string_view name) {
+    if ((names_.size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    const uint32_t h = hash(name);
+    const size_t slot = slot_of(name, h);
+    if (slots_[slot] != kNone) {
+        return slots_[slot];
+    }
+
+    char *chars = static_cast<char *>(mr_->allocate(name.size() + 1, 1));
+    std::copy(name.begin(), name.end(), chars);
+    chars[name.size()] = '\0';
+
+    const Id id = static_cast<Id>(names_.size());
+    names_.push_back(std::string_view(chars, name.size()));
+    hashes_.push_back(h);
+    slots_[slot] = id;
+    return id;
+}
+
+// Double the slot array and reinsert every ID from its stored hash
+void NameInterner::grow() {
+    const size_t size = slots_.empty() ? kInitialSlots : slots_.size() * 2;
+    slots_.assign(size, kNone);
+    const size_t mask = size - 1;
+    for (Id id = 0; id < names_.size(); ++id) {
+        size_t slot = hashes_[id] & mask;
+        while (slots_[slot] != kNone) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = id;
+    }
+}
+
+void NameInterner::reset() {
+    std::pmr::vector<std::string_view>(mr_).swap(names_);
+    std::pmr::vector<uint32_t>(mr_).swap(hashes_);
+    std::pmr::vector<Id>(mr_).swap(slots_);
+}
+
+} // namespace edasm
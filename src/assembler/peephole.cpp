@@ -0,0 +1,312 @@
+/**
+ * @file peephole.cpp
+ * @brief Opt-in peephole optimizer for generated 6502 code
+ *
+ * No EDASM.SRC counterpart; see peephole.hpp for the patterns and the
+ * safety rules.
+ */
+
+#include "edasm/assembler/peephole.hpp"
+
+#include <sstream>
+
+namespace edasm {
+
+namespace {
+
+// Machine state tracked by the liveness scan
+enum Resource : uint8_t {
+    kA = 0x01,  // Accumulator
+    kC = 0x02,  // Carry
+    kNZ = 0x04, // Negative and zero (always set together)
+    kV = 0x08,  // Overflow
+};
+
+struct Effects {
+    uint8_t reads{0};
+    uint8_t writes{0};
+    bool flow{false}; // Control may leave the adjacent run
+};
+
+// What an instruction reads and writes among the tracked resources
+// (X and Y are not tracked: no pattern needs them dead)
+Effects effects(const Opcode &op) {
+    const std::string_view m = op.mnemonic;
+    const bool accumulator = op.mode == AddressingMode::Accumulator;
+
+    if (m == "LDA" || m == "TXA" || m == "TYA" || m == "PLA") {
+        return {0, kA | kNZ};
+    }
+    if (m == "LDX" || m == "LDY" || m == "TSX" || m == "INX" || m == "INY" || m == "DEX" ||
+        m == "DEY" || m == "INC" || m == "DEC") {
+        return {0, kNZ};
+    }
+    if (m == "STA" || m == "PHA") {
+        return {kA, 0};
+    }
+    if (m == "TAX" || m == "TAY") {
+        return {kA, kNZ};
+    }
+    if (m == "ADC" || m == "SBC") {
+        return {kA | kC, kA | kC | kNZ | kV};
+    }
+    if (m == "AND" || m == "ORA" || m == "EOR") {
+        return {kA, kA | kNZ};
+    }
+    if (m == "CMP") {
+        return {kA, kC | kNZ};
+    }
+    if (m == "CPX" || m == "CPY") {
+        return {0, kC | kNZ};
+    }
+    if (m == "BIT") {
+        return {kA, kNZ | kV};
+    }
+    if (m == "ASL" || m == "LSR") {
+        return accumulator ? Effects{kA, kA | kC | kNZ} : Effects{0, kC | kNZ};
+    }
+    if (m == "ROL" || m == "ROR") {
+        return accumulator ? Effects{kA | kC, kA | kC | kNZ} : Effects{kC, kC | kNZ};
+    }
+    if (m == "CLC" || m == "SEC") {
+        return {0, kC};
+    }
+    if (m == "CLV") {
+        return {0, kV};
+    }
+    if (m == "PHP") {
+        return {kC | kNZ | kV, 0};
+    }
+    if (m == "PLP") {
+        return {0, kC | kNZ | kV};
+    }
+    if (m == "BCC" || m == "BCS") {
+        return {kC, 0, true};
+    }
+    if (m == "BEQ" || m == "BNE" || m == "BMI" || m == "BPL") {
+        return {kNZ, 0, true};
+    }
+    if (m == "BVC" || m == "BVS") {
+        return {kV, 0, true};
+    }
+    if (m == "JMP" || m == "JSR" || m == "RTS" || m == "RTI" || m == "BRK") {
+        return {0, 0, true};
+    }
+    // STX, STY, TXS, NOP, CLD, SED, CLI, SEI
+    return {};
+}
+
+bool adjacent(const PeepholeOptimizer::Instruction &a, const PeepholeOptimizer::Instruction &b) {
+    return static_cast<uint16_t>(a.address + a.opcode->bytes) == b.address;
+}
+
+bool has_memory_operand(const Opcode &op) {
+    return op.mode != AddressingMode::Implied && op.mode != AddressingMode::Accumulator &&
+           op.mode != AddressingMode::Immediate && op.mode != AddressingMode::Relative;
+}
+
+// Loads and stores in the I/O page have side effects (soft switches)
+bool is_io(const PeepholeOptimizer::Instruction &ins) {
+    return has_memory_operand(*ins.opcode) && ins.operand >= 0xC000 && ins.operand <= 0xCFFF;
+}
+
+char load_register(std::string_view m) {
+    return (m == "LDA" || m == "LDX" || m == "LDY") ? m[2] : '\0';
+}
+
+char store_register(std::string_view m) {
+    return (m == "STA" || m == "STX" || m == "STY") ? m[2] : '\0';
+}
+
+bool same_operand(const PeepholeOptimizer::Instruction &a,
+                  const PeepholeOptimizer::Instruction &b) {
+    return a.opcode->mode == b.opcode->mode && a.operand == b.operand;
+}
+
+std::string text(const PeepholeOptimizer::Instruction &ins) {
+    std::string s = ins.opcode->mnemonic;
+    if (!ins.operand_text.empty()) {
+        s += ' ';
+        s += ins.operand_text;
+    }
+    return s;
+}
+
+int cycles(std::span<const PeepholeOptimizer::Instruction> run) {
+    int total = 0;
+    for (const auto &ins : run) {
+        total += ins.opcode->cycles;
+    }
+    return total;
+}
+
+int bytes(std::span<const PeepholeOptimizer::Instruction> run) {
+    int total = 0;
+    for (const auto &ins : run) {
+        total += ins.opcode->bytes;
+    }
+    return total;
+}
+
+class Matcher {
+  public:
+    explicit Matcher(std::span<const PeepholeOptimizer::Instruction> code) : code_(code) {}
+
+    // Instruction i + n when instructions i..i+n are adjacent and none after
+    // the first is labeled; nullptr otherwise
+    const PeepholeOptimizer::Instruction *next(size_t i, size_t n) const {
+        if (i + n >= code_.size()) {
+            return nullptr;
+        }
+        for (size_t k = i + 1; k <= i + n; ++k) {
+            if (code_[k].labeled || !adjacent(code_[k - 1], code_[k])) {
+                return nullptr;
+            }
+        }
+        return &code_[i + n];
+    }
+
+    // True if every resource in mask is written before it is read on the
+    // fall-through path after instruction `after`
+    bool dead_after(size_t after, uint8_t mask) const {
+        for (size_t k = after + 1; k < code_.size() && adjacent(code_[k - 1], code_[k]); ++k) {
+            const Effects e = effects(*code_[k].opcode);
+            if (e.reads & mask) {
+                return false;
+            }
+            mask &= static_cast<uint8_t>(~e.writes);
+            if (mask == 0) {
+                return true;
+            }
+            if (e.flow) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool untouched(size_t i, size_t n) const {
+        for (size_t k = i; k <= i + n; ++k) {
+            if (code_[k].relocated) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    std::span<const PeepholeOptimizer::Instruction> code_;
+};
+
+PeepholeOptimizer::LineEdit remove_line(const PeepholeOptimizer::Instruction &ins) {
+    return {ins.line_index, {}, {}};
+}
+
+} // namespace
+
+std::string PeepholeOptimizer::Change::report() const {
+    std::ostringstream oss;
+    oss << "Line " << line_number << " $" << std::hex << std::uppercase;
+    oss.width(4);
+    oss.fill('0');
+    oss << address << std::dec << ": " << description << " (-" << bytes_saved << " bytes, -"
+        << cycles_saved << " cycles)";
+    return oss.str();
+}
+
+std::vector<PeepholeOptimizer::Change> PeepholeOptimizer::optimize(
+    std::span<const Instruction> code) {
+    std::vector<Change> changes;
+    Matcher match(code);
+
+    size_t i = 0;
+    while (i < code.size()) {
+        const Instruction &first = code[i];
+        const std::string_view m = first.opcode->mnemonic;
+        Change change;
+        change.line_number = first.line_number;
+        change.address = first.address;
+        size_t consumed = 1;
+
+        const Instruction *second = match.next(i, 1);
+        const std::string_view m2 = second ? std::string_view(second->opcode->mnemonic) : "";
+
+        if (second && match.untouched(i, 1) && load_register(m) &&
+            load_register(m) == load_register(m2) && !is_io(first)) {
+            // LDr a / LDr b: the first load is overwritten unused
+            change.description = text(first) + " / " + text(*second) + " -> " + text(*second);
+            change.edits = {remove_line(first)};
+            change.bytes_saved = first.opcode->bytes;
+            change.cycles_saved = first.opcode->cycles;
+            consumed = 2;
+        } else if (second && match.untouched(i, 1) && store_register(m) &&
+                   first.opcode->code == second->opcode->code && same_operand(first, *second) &&
+                   !is_io(first)) {
+            // STr a / STr a
+            change.description = text(first) + " / " + text(*second) + " -> " + text(first);
+            change.edits = {remove_line(*second)};
+            change.bytes_saved = second->opcode->bytes;
+            change.cycles_saved = second->opcode->cycles;
+            consumed = 2;
+        } else if (second && match.untouched(i, 1) && store_register(m) &&
+                   store_register(m) == load_register(m2) && same_operand(first, *second) &&
+                   !is_io(first) && match.dead_after(i + 1, kNZ)) {
+            // STr a / LDr a: the register already holds the value
+            change.description = text(first) + " / " + text(*second) + " -> " + text(first);
+            change.edits = {remove_line(*second)};
+            change.bytes_saved = second->opcode->bytes;
+            change.cycles_saved = second->opcode->cycles;
+            consumed = 2;
+        } else if ((m == "CLC" || m == "SEC") && match.next(i, 3) && match.untouched(i, 3)) {
+            // CLC / LDA m / ADC #1 / STA m -> INC m (SEC / SBC #1 -> DEC m)
+            const Instruction &load = code[i + 1];
+            const Instruction &op = code[i + 2];
+            const Instruction &store = code[i + 3];
+            const std::string_view arith = m == "CLC" ? "ADC" : "SBC";
+            const std::string_view replacement = m == "CLC" ? "INC" : "DEC";
+            const OpcodeSpec *spec = find_opcode_spec(replacement, store.opcode->mode);
+            if (load.opcode->mnemonic == "LDA" && store.opcode->mnemonic == "STA" &&
+                op.opcode->mnemonic == arith && op.opcode->mode == AddressingMode::Immediate &&
+                op.operand == 1 && same_operand(load, store) && spec && !is_io(store) &&
+                match.dead_after(i + 3, kA | kC | kV)) {
+                const auto run = code.subspan(i, 4);
+                change.description = text(first) + " / " + text(load) + " / " + text(op) +
+                                     " / " + text(store) + " -> " + std::string(replacement) +
+                                     " " + std::string(store.operand_text);
+                change.edits = {{first.line_index, replacement, store.operand_text},
+                                remove_line(load),
+                                remove_line(op),
+                                remove_line(store)};
+                change.bytes_saved = bytes(run) - spec->bytes;
+                change.cycles_saved = cycles(run) - spec->cycles;
+                consumed = 4;
+            }
+        } else if (m == "JSR" && m2 == "RTS" && match.untouched(i, 1)) {
+            // Tail call: the callee's RTS returns to our caller
+            const OpcodeSpec *jmp = find_opcode_spec("JMP", AddressingMode::Absolute);
+            change.description = text(first) + " / RTS -> JMP " + std::string(first.operand_text);
+            change.edits = {{first.line_index, "JMP", first.operand_text}, remove_line(*second)};
+            change.bytes_saved = bytes(code.subspan(i, 2)) - jmp->bytes;
+            change.cycles_saved = cycles(code.subspan(i, 2)) - jmp->cycles;
+            consumed = 2;
+        } else if (m == "JMP" && first.opcode->mode == AddressingMode::Absolute &&
+                   !first.relocated &&
+                   first.operand == static_cast<uint16_t>(first.address + first.opcode->bytes)) {
+            // Jump to the next instruction
+            change.description = text(first) + " (next instruction) removed";
+            change.edits = {remove_line(first)};
+            change.bytes_saved = first.opcode->bytes;
+            change.cycles_saved = first.opcode->cycles;
+        }
+
+        if (change.edits.empty()) {
+            i++;
+            continue;
+        }
+        changes.push_back(std::move(change));
+        i += consumed;
+    }
+    return changes;
+}
+
+} // namespace edasm
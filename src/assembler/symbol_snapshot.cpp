@@ -0,0 +1,257 @@
+/**
+ * @file symbol_snapshot.cpp
+ * @brief Precompiled symbol snapshots for shared equate files
+ *
+ * No EDASM.SRC counterpart; see symbol_snapshot.hpp for the file format.
+ */
+
+#include "edasm/assembler/symbol_snapshot.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "edasm/assembler/assembler.hpp"
+#include "edasm/assembler/tokenizer.hpp"
+
+namespace edasm {
+
+namespace {
+
+constexpr char kMagic[4] = {'E', 'D', 'S', 'Y'};
+
+// Directives that neither emit code nor depend on the PC or other files
+constexpr std::string_view kEquateFileDirectives[] = {"EQU",  "LST",  "SBTL", "END",  "DO",
+                                                      "ELSE", "FIN",  "IFEQ", "IFNE", "IFGT",
+                                                      "IFGE", "IFLT", "IFLE"};
+
+void fail(std::string *error, std::string message) {
+    if (error) {
+        *error = std::move(message);
+    }
+}
+
+void put_u8(std::vector<uint8_t> &out, uint8_t v) {
+    out.push_back(v);
+}
+
+void put_u16(std::vector<uint8_t> &out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v & 0xFF));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put_u32(std::vector<uint8_t> &out, uint32_t v) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(v >> shift));
+    }
+}
+
+void put_u64(std::vector<uint8_t> &out, uint64_t v) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<uint8_t>(v >> shift));
+    }
+}
+
+// Bounds-checked little-endian reader over the snapshot bytes
+class Reader {
+  public:
+    explicit Reader(std::span<const uint8_t> data) : data_(data) {}
+
+    bool ok() const {
+        return ok_;
+    }
+
+    uint64_t get(size_t bytes) {
+        if (!ok_ || data_.size() - pos_ < bytes) {
+            ok_ = false;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            v |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+        }
+        pos_ += bytes;
+        return v;
+    }
+
+    std::string get_string(size_t length) {
+        if (!ok_ || data_.size() - pos_ < length) {
+            ok_ = false;
+            return {};
+        }
+        std::string s(reinterpret_cast<const char *>(data_.data() + pos_), length);
+        pos_ += length;
+        return s;
+    }
+
+  private:
+    std::span<const uint8_t> data_;
+    size_t pos_{0};
+    bool ok_{true};
+};
+
+} // namespace
+
+uint64_t SymbolSnapshot::content_hash(std::string_view text) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+std::optional<SymbolSnapshot> SymbolSnapshot::build(std::string_view source,
+                                                    std::string_view source_path,
+                                                    std::string *error) {
+    // Reject anything whose symbols would depend on where the file is INCLUDEd
+    int line_num = 1;
+    size_t pos = 0;
+    while (pos < source.size()) {
+        size_t eol = source.find('\n', pos);
+        if (eol == std::string_view::npos) {
+            eol = source.size();
+        }
+        SourceLine line = Tokenizer::parse_line(source.substr(pos, eol - pos), line_num);
+        pos = eol + 1;
+
+        if (line.has_mnemonic() &&
+            std::find(std::begin(kEquateFileDirectives), std::end(kEquateFileDirectives),
+                      line.mnemonic) == std::end(kEquateFileDirectives)) {
+            fail(error, "Line " + std::to_string(line_num) + ": " + std::string(line.mnemonic) +
+                            " not allowed in an equate file");
+            return std::nullopt;
+        }
+        if (line.has_label() && line.mnemonic != "EQU") {
+            fail(error, "Line " + std::to_string(line_num) + ": label without EQU");
+            return std::nullopt;
+        }
+        line_num++;
+    }
+
+    Assembler assembler;
+    auto result = assembler.assemble(std::string(source));
+    if (!result.success) {
+        fail(error, result.errors.empty() ? "Assembly failed" : result.errors.front());
+        return std::nullopt;
+    }
+
+    SymbolSnapshot snapshot;
+    snapshot.source_hash_ = content_hash(source);
+    snapshot.source_size_ = source.size();
+    snapshot.source_path_ = source_path;
+
+    for (const Symbol *sym : assembler.symbols().by_name()) {
+        if (sym->flags & (SYM_RELATIVE | SYM_EXTERNAL)) {
+            fail(error, "Symbol " + std::string(sym->name) + " is not an absolute equate");
+            return std::nullopt;
+        }
+        if (sym->name.size() > 0xFF) {
+            fail(error, "Symbol name too long: " + std::string(sym->name));
+            return std::nullopt;
+        }
+        snapshot.entries_.push_back(
+            Entry{std::string(sym->name), sym->value, sym->flags, sym->line_defined});
+    }
+    return snapshot;
+}
+
+bool SymbolSnapshot::import_into(SymbolTable &table, std::vector<std::string> *duplicates) const {
+    bool ok = true;
+    for (const auto &entry : entries_) {
+        const Symbol *existing = std::as_const(table).lookup(entry.name);
+        if (existing && !existing->is_undefined()) {
+            if (duplicates) {
+                duplicates->push_back(entry.name);
+            }
+            ok = false;
+            continue;
+        }
+        table.define(entry.name, entry.value, 0, entry.line_defined);
+        // define() marks the symbol unreferenced; restore the stored flags
+        table.update_flags(entry.name, entry.flags);
+    }
+    return ok;
+}
+
+std::vector<uint8_t> SymbolSnapshot::serialize() const {
+    std::vector<uint8_t> out(std::begin(kMagic), std::end(kMagic));
+    put_u16(out, kFormatVersion);
+    put_u64(out, source_hash_);
+    put_u32(out, static_cast<uint32_t>(source_size_));
+    const size_t path_length = std::min<size_t>(source_path_.size(), 0xFFFF);
+    put_u16(out, static_cast<uint16_t>(path_length));
+    out.insert(out.end(), source_path_.begin(), source_path_.begin() + path_length);
+    put_u32(out, static_cast<uint32_t>(entries_.size()));
+
+    for (const auto &entry : entries_) {
+        put_u8(out, static_cast<uint8_t>(entry.name.size()));
+        out.insert(out.end(), entry.name.begin(), entry.name.end());
+        put_u16(out, entry.value);
+        put_u8(out, entry.flags);
+        put_u32(out, static_cast<uint32_t>(entry.line_defined));
+    }
+    return out;
+}
+
+std::optional<SymbolSnapshot> SymbolSnapshot::deserialize(std::span<const uint8_t> data,
+                                                          std::string *error) {
+    if (data.size() < sizeof(kMagic) || !std::equal(std::begin(kMagic), std::end(kMagic),
+                                                    data.begin())) {
+        fail(error, "Not a symbol snapshot");
+        return std::nullopt;
+    }
+
+    Reader in(data.subspan(sizeof(kMagic)));
+    const auto version = in.get(2);
+    if (in.ok() && version != kFormatVersion) {
+        fail(error, "Unsupported snapshot version " + std::to_string(version));
+        return std::nullopt;
+    }
+
+    SymbolSnapshot snapshot;
+    snapshot.source_hash_ = in.get(8);
+    snapshot.source_size_ = in.get(4);
+    snapshot.source_path_ = in.get_string(in.get(2));
+    const auto count = in.get(4);
+
+    for (uint64_t i = 0; i < count && in.ok(); ++i) {
+        Entry entry;
+        entry.name = in.get_string(in.get(1));
+        entry.value = static_cast<uint16_t>(in.get(2));
+        entry.flags = static_cast<uint8_t>(in.get(1));
+        entry.line_defined = static_cast<int>(static_cast<uint32_t>(in.get(4)));
+        snapshot.entries_.push_back(std::move(entry));
+    }
+
+    if (!in.ok()) {
+        fail(error, "Truncated symbol snapshot");
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+bool SymbolSnapshot::save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    const auto bytes = serialize();
+    file.write(reinterpret_cast<const char *>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+std::optional<SymbolSnapshot> SymbolSnapshot::load(const std::string &path, std::string *error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fail(error, "Cannot open file: " + path);
+        return std::nullopt;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+    return deserialize(bytes, error);
+}
+
+} // namespace edasm
@@ -12,7 +12,7 @@
  * - HashFn ($8955): 3-character hash function (simplified in C++ to std::unordered_map)
  *
  * Key routines from ASM1.S:
- * - DoSort ($D1D6): Shell sort algorithm -> sorted_by_name(), sorted_by_value()
+ * - DoSort ($D1D6): Shell sort algorithm -> by_name(), by_value() views
  * - DoPass3 ($D000): Symbol table printing (implemented in listing.cpp)
  *
  * Original EDASM uses 128-entry hash table with chaining. C++ uses std::unordered_map
@@ -22,56 +22,133 @@
 #include "edasm/assembler/symbol_table.hpp"
 
 #include <algorithm>
+#include <thread>
 
 namespace edasm {
 
+namespace {
+
+// Sort on up to `threads` threads: sort equal chunks concurrently, then
+// merge neighbouring runs pairwise (also concurrently) until one run
+// remains. Keys are unique (names), so the result matches a serial std::sort.
+template <typename Compare>
+void parallel_sort(std::pmr::vector<const Symbol *> &v, Compare cmp, unsigned threads) {
+    const size_t n = v.size();
+    const size_t chunks = std::min<size_t>(threads, n / (SymbolTable::kParallelSortThreshold / 4));
+    if (n < SymbolTable::kParallelSortThreshold || chunks < 2) {
+        std::sort(v.begin(), v.end(), cmp);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) {
+        bounds[i] = n * i / chunks;
+    }
+
+    {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunks; ++i) {
+            workers.emplace_back([&v, &cmp, b = bounds[i], e = bounds[i + 1]] {
+                std::sort(v.begin() + b, v.begin() + e, cmp);
+            });
+        }
+        std::sort(v.begin(), v.begin() + bounds[1], cmp);
+        for (auto &t : workers) {
+            t.join();
+        }
+    }
+
+    while (bounds.size() > 2) {
+        const size_t runs = bounds.size() - 1;
+        std::vector<size_t> merged;
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i + 1 < runs; i += 2) {
+            workers.emplace_back([&v, &cmp, b = bounds[i], m = bounds[i + 1], e = bounds[i + 2]] {
+                std::inplace_merge(v.begin() + b, v.begin() + m, v.begin() + e, cmp);
+            });
+            merged.push_back(bounds[i]);
+        }
+        if (runs % 2 == 1) {
+            merged.push_back(bounds[runs - 1]); // Odd run carried to next round
+        }
+        merged.push_back(n);
+        for (auto &t : workers) {
+            t.join();
+        }
+        bounds = std::move(merged);
+    }
+}
+
+bool name_less(const Symbol *a, const Symbol *b) {
+    return a->name < b->name;
+}
+
+bool value_less(const Symbol *a, const Symbol *b) {
+    if (a->value != b->value) {
+        return a->value < b->value;
+    }
+    return a->name < b->name;
+}
+
+} // namespace
+
 // Clear all symbols from table
 // Reference: ASM2.S InitASM ($7DC3) - Clears symbol table on init
 void SymbolTable::reset() {
-    table_.clear();
+    Map(table_.get_allocator()).swap(table_);
+    std::pmr::vector<const Symbol *>(by_name_.get_allocator()).swap(by_name_);
+    std::pmr::vector<const Symbol *>(by_value_.get_allocator()).swap(by_value_);
+    invalidate_views();
 }
 
 // Define or update a symbol in the table
 // Reference: ASM2.S AddNode ($89A9) - Adds symbol to hash chain
 // Symbol names are 1-16 characters per EDASM.SRC symbol format
-void SymbolTable::define(const std::string &name, uint16_t value, uint8_t flags, int line_num) {
+void SymbolTable::define(std::string_view name, uint16_t value, uint8_t flags, int line_num) {
     // Validate symbol name length (1-16 chars per EDASM.SRC)
     if (name.empty() || name.length() > 16) {
         // Silently truncate for compatibility, but ideally should error
         // For now, we'll allow it but track it
     }
 
-    Symbol sym;
+    auto it = table_.find(name);
+    if (it == table_.end()) {
+        it = table_.try_emplace(std::pmr::string(name, table_.get_allocator())).first;
+    }
+    invalidate_views();
+    Symbol &sym = it->second;
     sym.name = name;
     sym.value = value;
     // Reference: ASM2.S L8A00 - Mark new symbols as unreferenced
     // "ORA #unrefd" at line ~8998 in ASM2.S
     sym.flags = flags | SYM_UNREFERENCED;
     sym.line_defined = line_num;
-    table_[name] = sym;
+    sym.symbol_number = 0;
 }
 
 // Update symbol value
 // Used during pass 1 to resolve forward references
-void SymbolTable::update_value(const std::string &name, uint16_t value) {
+void SymbolTable::update_value(std::string_view name, uint16_t value) {
     auto it = table_.find(name);
     if (it != table_.end()) {
         it->second.value = value;
+        invalidate_views();
     }
 }
 
 // Update symbol flags (ENTRY, EXTERNAL, RELATIVE, etc.)
 // Reference: ASM3.S L9144, L91A8 - ENT/ENTRY and EXT/EXTRN directives
-void SymbolTable::update_flags(const std::string &name, uint8_t flags) {
+void SymbolTable::update_flags(std::string_view name, uint8_t flags) {
     auto it = table_.find(name);
     if (it != table_.end()) {
         it->second.flags = flags;
+        invalidate_views();
     }
 }
 
 // Mark symbol as referenced (clear unreferenced bit)
 // Reference: Original EDASM clears bit 6 when symbol is used in Pass 2
-void SymbolTable::mark_referenced(const std::string &name) {
+void SymbolTable::mark_referenced(std::string_view name) {
     auto it = table_.find(name);
     if (it != table_.end()) {
         it->second.flags &= ~SYM_UNREFERENCED;
@@ -83,7 +160,7 @@ void SymbolTable::mark_referenced(const std::string &name) {
 // Returns pointer to symbol or nullptr if not found
 // Note: When a symbol is looked up for use (not just checking existence),
 // the unreferenced bit should be cleared to mark it as referenced
-Symbol *SymbolTable::lookup(const std::string &name) {
+Symbol *SymbolTable::lookup(std::string_view name) {
     auto it = table_.find(name);
     if (it == table_.end()) {
         return nullptr;
@@ -91,10 +168,12 @@ Symbol *SymbolTable::lookup(const std::string &name) {
     // Clear the unreferenced bit when symbol is looked up
     // Reference: Original EDASM clears bit 6 when symbol is used
     it->second.flags &= ~SYM_UNREFERENCED;
+    // Caller may change the value through the returned pointer
+    invalidate_views();
     return &it->second;
 }
 
-const Symbol *SymbolTable::lookup(const std::string &name) const {
+const Symbol *SymbolTable::lookup(std::string_view name) const {
     auto it = table_.find(name);
     if (it == table_.end()) {
         return nullptr;
@@ -102,7 +181,7 @@ const Symbol *SymbolTable::lookup(const std::string &name) const {
     return &it->second;
 }
 
-std::optional<uint16_t> SymbolTable::get_value(const std::string &name) const {
+std::optional<uint16_t> SymbolTable::get_value(std::string_view name) const {
     auto sym = lookup(name);
     if (!sym || sym->is_undefined()) {
         return std::nullopt;
@@ -110,11 +189,40 @@ std::optional<uint16_t> SymbolTable::get_value(const std::string &name) const {
     return sym->value;
 }
 
-bool SymbolTable::is_defined(const std::string &name) const {
+bool SymbolTable::is_defined(std::string_view name) const {
     auto sym = lookup(name);
     return sym && !sym->is_undefined();
 }
 
+SymbolTable::View SymbolTable::by_name() const {
+    if (by_name_version_ != version_) {
+        by_name_.clear();
+        by_name_.reserve(table_.size());
+        for (const auto &[name, sym] : table_) {
+            by_name_.push_back(&sym);
+        }
+        // Reference: ASM1.S DoSort ($D1D6) - Shell sort with alphabetic comparison
+        // Original uses DCI (reversed-case) format; C++ uses standard string comparison
+        parallel_sort(by_name_, name_less, sort_threads_);
+        by_name_version_ = version_;
+    }
+    return View(*this, by_name_);
+}
+
+SymbolTable::View SymbolTable::by_value() const {
+    if (by_value_version_ != version_) {
+        by_value_.clear();
+        by_value_.reserve(table_.size());
+        for (const auto &[name, sym] : table_) {
+            by_value_.push_back(&sym);
+        }
+        // Reference: ASM1.S DoSort ($D1D6) - Shell sort with address comparison
+        parallel_sort(by_value_, value_less, sort_threads_);
+        by_value_version_ = version_;
+    }
+    return View(*this, by_value_);
+}
+
 std::vector<Symbol> SymbolTable::all_symbols() const {
     std::vector<Symbol> result;
     result.reserve(table_.size());
@@ -124,27 +232,26 @@ std::vector<Symbol> SymbolTable::all_symbols() const {
     return result;
 }
 
-// Sort symbols alphabetically by name
-// Reference: ASM1.S DoSort ($D1D6) - Shell sort with alphabetic comparison
-// Original uses DCI (reversed-case) format; C++ uses standard string comparison
+// Sort symbols alphabetically by name (copies of the by_name() view)
 std::vector<Symbol> SymbolTable::sorted_by_name() const {
-    auto result = all_symbols();
-    std::sort(result.begin(), result.end(),
-              [](const Symbol &a, const Symbol &b) { return a.name < b.name; });
+    View view = by_name();
+    std::vector<Symbol> result;
+    result.reserve(view.size());
+    for (const Symbol *sym : view) {
+        result.push_back(*sym);
+    }
     return result;
 }
 
-// Sort symbols by address value, then by name for ties
-// Reference: ASM1.S DoSort ($D1D6) - Shell sort with address comparison
+// Sort symbols by address value, then by name for ties (copies of by_value())
 // Used for generating address-ordered symbol listings
 std::vector<Symbol> SymbolTable::sorted_by_value() const {
-    auto result = all_symbols();
-    std::sort(result.begin(), result.end(), [](const Symbol &a, const Symbol &b) {
-        if (a.value != b.value) {
-            return a.value < b.value;
-        }
-        return a.name < b.name;
-    });
+    View view = by_value();
+    std::vector<Symbol> result;
+    result.reserve(view.size());
+    for (const Symbol *sym : view) {
+        result.push_back(*sym);
+    }
     return result;
 }
 
@@ -4,6 +4,9 @@
  *
  * Parses assembly source lines into components: label, mnemonic, operand, comment.
  * Implements tokenization logic compatible with EDASM source format.
+ * The field rules live in tokenizer.hpp (Tokenizer::split_fields), where
+ * they are constexpr; at run time they locate field boundaries with
+ * CharScanner (16 bytes per step).
  */
 
 #include "edasm/assembler/tokenizer.hpp"
@@ -13,103 +16,39 @@
 
 namespace edasm {
 
-SourceLine Tokenizer::parse_line(const std::string &line, int line_number) {
-    SourceLine result;
+SourceLine Tokenizer::parse_line(std::string_view line, int line_number,
+                                 std::pmr::memory_resource *mr) {
+    SourceLine result{SourceLine::allocator_type(mr)};
     result.line_number = line_number;
     result.raw_line = line;
 
-    // Check for comment-only line (starts with * or ;)
-    if (line.empty() || line[0] == '*' || line[0] == ';') {
-        result.comment = line;
-        return result;
-    }
-
-    size_t pos = 0;
-    const size_t len = line.length();
-
-    // Parse label (if present)
-    // Label starts in column 0 (no leading whitespace) and ends with whitespace or colon
-    if (pos < len && !is_whitespace(line[pos]) && is_label_start(line[pos])) {
-        size_t label_end = pos;
-        while (label_end < len && is_label_char(line[label_end])) {
-            label_end++;
-        }
-        result.label = line.substr(pos, label_end - pos);
-        pos = label_end;
-
-        // Skip optional colon after label
-        if (pos < len && line[pos] == ':') {
-            pos++;
-        }
-    }
-
-    // Skip whitespace before mnemonic
-    while (pos < len && is_whitespace(line[pos])) {
-        pos++;
-    }
-
-    // Parse mnemonic (instruction or directive)
-    if (pos < len && !is_whitespace(line[pos]) && line[pos] != ';') {
-        size_t mnem_end = pos;
-        while (mnem_end < len && !is_whitespace(line[mnem_end]) && line[mnem_end] != ';') {
-            mnem_end++;
-        }
-        result.mnemonic = to_upper(line.substr(pos, mnem_end - pos));
-        pos = mnem_end;
-    }
-
-    // Skip whitespace before operand
-    while (pos < len && is_whitespace(line[pos])) {
-        pos++;
-    }
-
-    // Parse operand (everything up to comment or end of line)
-    if (pos < len && line[pos] != ';') {
-        size_t operand_end = pos;
-        // Find comment or end of line
-        while (operand_end < len && line[operand_end] != ';') {
-            operand_end++;
-        }
-        // Trim trailing whitespace from operand
-        result.operand = trim(line.substr(pos, operand_end - pos));
-        pos = operand_end;
-    }
-
-    // Parse comment (if present)
-    if (pos < len && line[pos] == ';') {
-        result.comment = line.substr(pos);
-    }
-
+    const LineFields fields = split_fields(line);
+    result.label = fields.label;
+    to_upper(fields.mnemonic, result.mnemonic);
+    result.operand = fields.operand;
+    result.comment = fields.comment;
     return result;
 }
 
-std::string Tokenizer::trim(const std::string &str) {
-    const char *whitespace = " \t\r\n";
-    size_t start = str.find_first_not_of(whitespace);
-    if (start == std::string::npos) {
-        return "";
+const SourceLine &LazySourceLines::line(size_t index) {
+    Entry &entry = entries_[index];
+    if (entry.parsed == kNotTokenized) {
+        entry.parsed = static_cast<uint32_t>(parsed_.size());
+        parsed_.push_back(Tokenizer::parse_line(entry.text, entry.line_number,
+                                                parsed_.get_allocator().resource()));
     }
-    size_t end = str.find_last_not_of(whitespace);
-    return str.substr(start, end - start + 1);
-}
-
-std::string Tokenizer::to_upper(const std::string &str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::toupper(c); });
-    return result;
-}
-
-bool Tokenizer::is_whitespace(char c) {
-    return c == ' ' || c == '\t';
+    return parsed_[entry.parsed];
 }
 
-bool Tokenizer::is_label_start(char c) {
-    return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '@';
+SourceLine &LazySourceLines::edit(size_t index) {
+    line(index);
+    return parsed_[entries_[index].parsed];
 }
 
-bool Tokenizer::is_label_char(char c) {
-    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '@';
+void Tokenizer::to_upper(std::string_view str, std::pmr::string &dest) {
+    dest.assign(str);
+    std::transform(dest.begin(), dest.end(), dest.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
 }
 
 } // namespace edasm
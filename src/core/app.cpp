@@ -92,11 +92,13 @@ App::~App() {
 }
 
 int App::run(int argc, char **argv) {
-    if (argc > 1) {
-        std::string_view arg{argv[1]};
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
         if (arg == "-h" || arg == "--help") {
             print_help();
             return 0;
+        } else if (arg == "--profile") {
+            profile_assembly_ = true;
         }
     }
 
@@ -441,7 +443,20 @@ void App::cmd_prefix(const std::vector<std::string> &args) {
 
 void App::cmd_asm(const std::vector<std::string> &args) {
     // Assemble current buffer
-    auto result = assembler_->assemble(editor_->joined_buffer());
+    // ASM PROFILE (or edasm_cli --profile) also shows per-phase timing and
+    // allocation counts
+    Assembler::Options opts;
+    opts.collect_profile = profile_assembly_;
+    for (const auto &arg : args) {
+        std::string opt = arg;
+        std::transform(opt.begin(), opt.end(), opt.begin(),
+                       [](unsigned char c) { return std::toupper(c); });
+        if (opt == "PROFILE") {
+            opts.collect_profile = true;
+        }
+    }
+
+    auto result = assembler_->assemble(editor_->joined_buffer(), opts);
     if (!result.success) {
         for (const auto &err : result.errors) {
             print_error(err);
@@ -450,6 +465,14 @@ void App::cmd_asm(const std::vector<std::string> &args) {
         screen_->write_line(1, "Assembly successful");
         screen_->refresh();
     }
+
+    if (opts.collect_profile) {
+        int row = 2;
+        for (const auto &line : result.profile.format_lines()) {
+            screen_->write_line(row++, line);
+        }
+        screen_->refresh();
+    }
 }
 
 void App::cmd_bye(const std::vector<std::string> &args) {
@@ -603,7 +626,7 @@ void App::cmd_help(const std::vector<std::string> &args) {
     screen_->write_line(row++, "  UNLOCK <file>     - Remove read-only");
     screen_->write_line(row++, "  DELETEFILE <file> - Delete a file");
     screen_->write_line(row++, "  EXEC <file>       - Execute commands from file");
-    screen_->write_line(row++, "  ASM [opts]        - Assemble buffer");
+    screen_->write_line(row++, "  ASM [PROFILE]     - Assemble buffer (PROFILE: phase stats)");
     screen_->write_line(row++, "  BYE/QUIT          - Exit EDASM");
     screen_->write_line(row++, "  HELP/?            - Show this help");
     screen_->write_line(row++, "");
@@ -616,6 +639,7 @@ void App::print_help() const {
     std::cout << "EDASM (C++/ncurses) - 6502 Editor/Assembler" << std::endl;
     std::cout << "Usage: edasm_cli [options]" << std::endl;
     std::cout << "  -h, --help    Show this message" << std::endl;
+    std::cout << "  --profile     Show per-phase timing and allocations after ASM" << std::endl;
     std::cout << std::endl;
     std::cout << "Port of Apple II EDASM to modern C++/ncurses" << std::endl;
     std::cout << "Based on EDASM.SRC from markpmlim/EdAsm" << std::endl;
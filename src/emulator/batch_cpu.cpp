@@ -0,0 +1,568 @@
+/**
+ * @file batch_cpu.cpp
+ * @brief Lockstep batch interpreter implementation
+ *
+ * The lockstep opcodes mirror their CPU::execute_instruction cases exactly;
+ * everything else goes through the lane's scalar CPU.
+ */
+
+#include "edasm/emulator/batch_cpu.hpp"
+#include "edasm/constants.hpp"
+
+namespace edasm {
+
+namespace {
+
+using namespace StatusFlags;
+
+// Select v for lanes with m = 0xFF, keep old for m = 0x00
+inline uint8_t blend(uint8_t m, uint8_t v, uint8_t old) {
+    return static_cast<uint8_t>((v & m) | (old & ~m));
+}
+
+inline uint8_t with_flag(uint8_t p, uint8_t flag, bool set) {
+    return static_cast<uint8_t>((p & ~flag) | (set ? flag : 0));
+}
+
+inline uint8_t with_nz(uint8_t p, uint8_t value) {
+    return static_cast<uint8_t>((p & ~(N | Z)) | (value & N) | (value == 0 ? Z : 0));
+}
+
+// Apply op to the registers of every lane and keep the result where the
+// mask is set. op must be branch-free so the loop vectorizes.
+template <typename Op>
+void apply(LaneRegisters &regs, const std::vector<uint8_t> &mask, uint16_t length, Op op) {
+    uint8_t *A = regs.A.data();
+    uint8_t *X = regs.X.data();
+    uint8_t *Y = regs.Y.data();
+    uint8_t *SP = regs.SP.data();
+    uint8_t *P = regs.P.data();
+    uint16_t *PC = regs.PC.data();
+    const uint8_t *M = mask.data();
+    const size_t n = mask.size();
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t a = A[i];
+        uint8_t x = X[i];
+        uint8_t y = Y[i];
+        uint8_t sp = SP[i];
+        uint8_t p = P[i];
+        op(a, x, y, sp, p);
+        const uint8_t m = M[i];
+        A[i] = blend(m, a, A[i]);
+        X[i] = blend(m, x, X[i]);
+        Y[i] = blend(m, y, Y[i]);
+        SP[i] = blend(m, sp, SP[i]);
+        P[i] = blend(m, p, P[i]);
+        PC[i] = static_cast<uint16_t>(PC[i] + (m & length));
+    }
+}
+
+// Relative branch: taken where (P & flag) != 0 equals when_set
+void branch(LaneRegisters &regs, const std::vector<uint8_t> &mask, uint8_t flag, bool when_set,
+            int8_t offset) {
+    uint16_t *PC = regs.PC.data();
+    const uint8_t *P = regs.P.data();
+    const uint8_t *M = mask.data();
+    const size_t n = mask.size();
+    for (size_t i = 0; i < n; ++i) {
+        const bool taken = ((P[i] & flag) != 0) == when_set;
+        const auto next = static_cast<uint16_t>(PC[i] + 2 + (taken ? offset : 0));
+        PC[i] = M[i] ? next : PC[i];
+    }
+}
+
+// Instruction length of a lockstep opcode, 0 for the others
+uint16_t lockstep_length(uint8_t opcode) {
+    switch (opcode) {
+    case 0xEA: // NOP
+    case 0xAA: // TAX
+    case 0xA8: // TAY
+    case 0x8A: // TXA
+    case 0x98: // TYA
+    case 0x9A: // TXS
+    case 0xBA: // TSX
+    case 0xE8: // INX
+    case 0xC8: // INY
+    case 0xCA: // DEX
+    case 0x88: // DEY
+    case 0x18: // CLC
+    case 0x38: // SEC
+    case 0x58: // CLI
+    case 0x78: // SEI
+    case 0xB8: // CLV
+    case 0xD8: // CLD
+    case 0xF8: // SED
+    case 0x0A: // ASL A
+    case 0x4A: // LSR A
+    case 0x2A: // ROL A
+    case 0x6A: // ROR A
+    case 0x60: // RTS
+        return 1;
+    case 0xA9: // LDA #
+    case 0xA2: // LDX #
+    case 0xA0: // LDY #
+    case 0x69: // ADC #
+    case 0xE9: // SBC #
+    case 0x29: // AND #
+    case 0x09: // ORA #
+    case 0x49: // EOR #
+    case 0xC9: // CMP #
+    case 0xE0: // CPX #
+    case 0xC0: // CPY #
+    case 0xA5: // LDA zp
+    case 0xA6: // LDX zp
+    case 0xA4: // LDY zp
+    case 0x85: // STA zp
+    case 0x86: // STX zp
+    case 0x84: // STY zp
+    case 0x10: // BPL
+    case 0x30: // BMI
+    case 0x50: // BVC
+    case 0x70: // BVS
+    case 0x90: // BCC
+    case 0xB0: // BCS
+    case 0xD0: // BNE
+    case 0xF0: // BEQ
+        return 2;
+    case 0xAD: // LDA abs
+    case 0xAE: // LDX abs
+    case 0xAC: // LDY abs
+    case 0x8D: // STA abs
+    case 0x8E: // STX abs
+    case 0x8C: // STY abs
+    case 0x4C: // JMP abs
+    case 0x20: // JSR abs
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+BatchCPU::BatchCPU(std::shared_ptr<const MemorySnapshot> image, size_t lanes)
+    : image_(std::move(image)), lockstep_instructions_(0), scalar_instructions_(0) {
+    const CPUState power_on;
+    buses_.reserve(lanes);
+    cpus_.reserve(lanes);
+    for (size_t i = 0; i < lanes; ++i) {
+        buses_.push_back(std::make_unique<Bus>(image_));
+        cpus_.emplace_back(*buses_.back());
+    }
+    regs_.A.assign(lanes, power_on.A);
+    regs_.X.assign(lanes, power_on.X);
+    regs_.Y.assign(lanes, power_on.Y);
+    regs_.SP.assign(lanes, power_on.SP);
+    regs_.P.assign(lanes, power_on.P);
+    regs_.PC.assign(lanes, power_on.PC);
+    running_.assign(lanes, 1);
+    mask_.assign(lanes, 0);
+    instruction_counts_.assign(lanes, 0);
+}
+
+CPUState BatchCPU::state(size_t lane) const {
+    CPUState s;
+    s.A = regs_.A[lane];
+    s.X = regs_.X[lane];
+    s.Y = regs_.Y[lane];
+    s.SP = regs_.SP[lane];
+    s.P = regs_.P[lane];
+    s.PC = regs_.PC[lane];
+    return s;
+}
+
+void BatchCPU::set_state(size_t lane, const CPUState &state) {
+    regs_.A[lane] = state.A;
+    regs_.X[lane] = state.X;
+    regs_.Y[lane] = state.Y;
+    regs_.SP[lane] = state.SP;
+    regs_.P[lane] = state.P;
+    regs_.PC[lane] = state.PC;
+}
+
+bool BatchCPU::step() {
+    size_t leader = 0;
+    while (leader < running_.size() && !running_[leader]) {
+        leader++;
+    }
+    if (leader == running_.size()) {
+        return false;
+    }
+
+    // Decode once, from the leader
+    Bus &lead = *buses_[leader];
+    const uint16_t pc = regs_.PC[leader];
+    const uint8_t opcode = lead.read(pc);
+    const uint16_t length = lockstep_length(opcode);
+    if (length != 0) {
+        const uint8_t lo = length > 1 ? lead.read(static_cast<uint16_t>(pc + 1)) : 0;
+        const uint8_t hi = length > 2 ? lead.read(static_cast<uint16_t>(pc + 2)) : 0;
+        const size_t group = select_group(leader, pc, length);
+        execute_lockstep(opcode, lo, hi);
+        lockstep_instructions_ += group;
+    } else {
+        std::fill(mask_.begin(), mask_.end(), 0);
+    }
+
+    // Everyone else: diverged lanes and non-lockstep opcodes
+    bool any_running = false;
+    for (size_t i = 0; i < running_.size(); ++i) {
+        if (running_[i] && !mask_[i]) {
+            step_scalar(i);
+        }
+        any_running = any_running || running_[i];
+    }
+    return any_running;
+}
+
+void BatchCPU::run(uint64_t max_steps) {
+    for (uint64_t steps = 0; steps < max_steps && step(); ++steps) {
+    }
+}
+
+size_t BatchCPU::select_group(size_t leader, uint16_t pc, uint16_t length) {
+    Bus &lead = *buses_[leader];
+    const auto first_page = static_cast<uint8_t>(pc >> 8);
+    const auto last_page = static_cast<uint8_t>((pc + length - 1) >> 8);
+
+    // Unwritten pages still hold the image, so their bytes need no compare
+    auto unwritten = [first_page, last_page](const Bus &bus) {
+        return bus.page_generation(first_page) == 0 && bus.page_generation(last_page) == 0;
+    };
+    const bool leader_unwritten = unwritten(lead);
+
+    size_t group = 0;
+    for (size_t i = 0; i < running_.size(); ++i) {
+        bool member = running_[i] && regs_.PC[i] == pc;
+        if (member && i != leader && !(leader_unwritten && unwritten(*buses_[i]))) {
+            for (uint16_t k = 0; k < length && member; ++k) {
+                const auto addr = static_cast<uint16_t>(pc + k);
+                member = buses_[i]->read(addr) == lead.read(addr);
+            }
+        }
+        mask_[i] = member ? 0xFF : 0x00;
+        if (member) {
+            instruction_counts_[i]++;
+            group++;
+        }
+    }
+    return group;
+}
+
+bool BatchCPU::execute_lockstep(uint8_t opcode, uint8_t lo, uint8_t hi) {
+    const auto addr = static_cast<uint16_t>(lo | (hi << 8));
+    const auto offset = static_cast<int8_t>(lo);
+    const size_t n = mask_.size();
+
+    // Memory operands are per lane; visit the group's lanes in order
+    auto each_lane = [this, n](auto body) {
+        for (size_t i = 0; i < n; ++i) {
+            if (mask_[i]) {
+                body(i, *buses_[i]);
+            }
+        }
+    };
+    auto load = [&](std::vector<uint8_t> &reg, uint16_t from, uint16_t length) {
+        each_lane([&](size_t i, Bus &bus) {
+            reg[i] = bus.read(from);
+            regs_.P[i] = with_nz(regs_.P[i], reg[i]);
+            regs_.PC[i] = static_cast<uint16_t>(regs_.PC[i] + length);
+        });
+    };
+    auto store = [&](const std::vector<uint8_t> &reg, uint16_t to, uint16_t length) {
+        each_lane([&](size_t i, Bus &bus) {
+            bus.write(to, reg[i]);
+            regs_.PC[i] = static_cast<uint16_t>(regs_.PC[i] + length);
+        });
+    };
+
+    switch (opcode) {
+    case 0xEA: // NOP
+        apply(regs_, mask_, 1, [](uint8_t &, uint8_t &, uint8_t &, uint8_t &, uint8_t &) {});
+        break;
+    case 0xAA: // TAX
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &x, uint8_t &, uint8_t &, uint8_t &p) {
+            x = a;
+            p = with_nz(p, x);
+        });
+        break;
+    case 0xA8: // TAY
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &, uint8_t &y, uint8_t &, uint8_t &p) {
+            y = a;
+            p = with_nz(p, y);
+        });
+        break;
+    case 0x8A: // TXA
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &x, uint8_t &, uint8_t &, uint8_t &p) {
+            a = x;
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x98: // TYA
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &, uint8_t &y, uint8_t &, uint8_t &p) {
+            a = y;
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x9A: // TXS
+        apply(regs_, mask_, 1,
+              [](uint8_t &, uint8_t &x, uint8_t &, uint8_t &sp, uint8_t &) { sp = x; });
+        break;
+    case 0xBA: // TSX
+        apply(regs_, mask_, 1, [](uint8_t &, uint8_t &x, uint8_t &, uint8_t &sp, uint8_t &p) {
+            x = sp;
+            p = with_nz(p, x);
+        });
+        break;
+    case 0xE8: // INX
+        apply(regs_, mask_, 1, [](uint8_t &, uint8_t &x, uint8_t &, uint8_t &, uint8_t &p) {
+            x++;
+            p = with_nz(p, x);
+        });
+        break;
+    case 0xC8: // INY
+        apply(regs_, mask_, 1, [](uint8_t &, uint8_t &, uint8_t &y, uint8_t &, uint8_t &p) {
+            y++;
+            p = with_nz(p, y);
+        });
+        break;
+    case 0xCA: // DEX
+        apply(regs_, mask_, 1, [](uint8_t &, uint8_t &x, uint8_t &, uint8_t &, uint8_t &p) {
+            x--;
+            p = with_nz(p, x);
+        });
+        break;
+    case 0x88: // DEY
+        apply(regs_, mask_, 1, [](uint8_t &, uint8_t &, uint8_t &y, uint8_t &, uint8_t &p) {
+            y--;
+            p = with_nz(p, y);
+        });
+        break;
+    case 0x18: // CLC
+    case 0x38: // SEC
+    case 0x58: // CLI
+    case 0x78: // SEI
+    case 0xB8: // CLV
+    case 0xD8: // CLD
+    case 0xF8: { // SED
+        const uint8_t flag = opcode == 0x18 || opcode == 0x38   ? C
+                             : opcode == 0x58 || opcode == 0x78 ? I
+                             : opcode == 0xB8                   ? V
+                                                                : D;
+        const bool set = opcode == 0x38 || opcode == 0x78 || opcode == 0xF8;
+        apply(regs_, mask_, 1, [flag, set](uint8_t &, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            p = with_flag(p, flag, set);
+        });
+        break;
+    }
+    case 0x0A: // ASL A
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            p = with_flag(p, C, (a & 0x80) != 0);
+            a = static_cast<uint8_t>(a << 1);
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x4A: // LSR A
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            p = with_flag(p, C, (a & 0x01) != 0);
+            a = static_cast<uint8_t>(a >> 1);
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x2A: // ROL A
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            const uint8_t carry_in = p & C;
+            p = with_flag(p, C, (a & 0x80) != 0);
+            a = static_cast<uint8_t>((a << 1) | carry_in);
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x6A: // ROR A
+        apply(regs_, mask_, 1, [](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            const uint8_t carry_in = static_cast<uint8_t>((p & C) << 7);
+            p = with_flag(p, C, (a & 0x01) != 0);
+            a = static_cast<uint8_t>((a >> 1) | carry_in);
+            p = with_nz(p, a);
+        });
+        break;
+
+    case 0xA9: // LDA #
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            a = lo;
+            p = with_nz(p, a);
+        });
+        break;
+    case 0xA2: // LDX #
+        apply(regs_, mask_, 2, [lo](uint8_t &, uint8_t &x, uint8_t &, uint8_t &, uint8_t &p) {
+            x = lo;
+            p = with_nz(p, x);
+        });
+        break;
+    case 0xA0: // LDY #
+        apply(regs_, mask_, 2, [lo](uint8_t &, uint8_t &, uint8_t &y, uint8_t &, uint8_t &p) {
+            y = lo;
+            p = with_nz(p, y);
+        });
+        break;
+    case 0x69: // ADC #
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            const uint16_t result = static_cast<uint16_t>(a + lo + (p & C));
+            p = with_flag(p, C, result > 0xFF);
+            p = with_flag(p, V, (~(a ^ lo) & (a ^ result) & 0x80) != 0);
+            a = static_cast<uint8_t>(result);
+            p = with_nz(p, a);
+        });
+        break;
+    case 0xE9: // SBC # (carry acts as "not borrow")
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            const int16_t result = static_cast<int16_t>(a - lo - ((p & C) ? 0 : 1));
+            p = with_flag(p, C, result >= 0);
+            p = with_flag(p, V, ((a ^ lo) & (a ^ result) & 0x80) != 0);
+            a = static_cast<uint8_t>(result);
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x29: // AND #
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            a &= lo;
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x09: // ORA #
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            a |= lo;
+            p = with_nz(p, a);
+        });
+        break;
+    case 0x49: // EOR #
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            a ^= lo;
+            p = with_nz(p, a);
+        });
+        break;
+    case 0xC9: // CMP #
+        apply(regs_, mask_, 2, [lo](uint8_t &a, uint8_t &, uint8_t &, uint8_t &, uint8_t &p) {
+            p = with_flag(p, C, a >= lo);
+            p = with_nz(p, static_cast<uint8_t>(a - lo));
+        });
+        break;
+    case 0xE0: // CPX #
+        apply(regs_, mask_, 2, [lo](uint8_t &, uint8_t &x, uint8_t &, uint8_t &, uint8_t &p) {
+            p = with_flag(p, C, x >= lo);
+            p = with_nz(p, static_cast<uint8_t>(x - lo));
+        });
+        break;
+    case 0xC0: // CPY #
+        apply(regs_, mask_, 2, [lo](uint8_t &, uint8_t &, uint8_t &y, uint8_t &, uint8_t &p) {
+            p = with_flag(p, C, y >= lo);
+            p = with_nz(p, static_cast<uint8_t>(y - lo));
+        });
+        break;
+
+    case 0xA5: // LDA zp
+        load(regs_.A, lo, 2);
+        break;
+    case 0xA6: // LDX zp
+        load(regs_.X, lo, 2);
+        break;
+    case 0xA4: // LDY zp
+        load(regs_.Y, lo, 2);
+        break;
+    case 0xAD: // LDA abs
+        load(regs_.A, addr, 3);
+        break;
+    case 0xAE: // LDX abs
+        load(regs_.X, addr, 3);
+        break;
+    case 0xAC: // LDY abs
+        load(regs_.Y, addr, 3);
+        break;
+    case 0x85: // STA zp
+        store(regs_.A, lo, 2);
+        break;
+    case 0x86: // STX zp
+        store(regs_.X, lo, 2);
+        break;
+    case 0x84: // STY zp
+        store(regs_.Y, lo, 2);
+        break;
+    case 0x8D: // STA abs
+        store(regs_.A, addr, 3);
+        break;
+    case 0x8E: // STX abs
+        store(regs_.X, addr, 3);
+        break;
+    case 0x8C: // STY abs
+        store(regs_.Y, addr, 3);
+        break;
+
+    case 0x10: // BPL
+        branch(regs_, mask_, N, false, offset);
+        break;
+    case 0x30: // BMI
+        branch(regs_, mask_, N, true, offset);
+        break;
+    case 0x50: // BVC
+        branch(regs_, mask_, V, false, offset);
+        break;
+    case 0x70: // BVS
+        branch(regs_, mask_, V, true, offset);
+        break;
+    case 0x90: // BCC
+        branch(regs_, mask_, C, false, offset);
+        break;
+    case 0xB0: // BCS
+        branch(regs_, mask_, C, true, offset);
+        break;
+    case 0xD0: // BNE
+        branch(regs_, mask_, Z, false, offset);
+        break;
+    case 0xF0: // BEQ
+        branch(regs_, mask_, Z, true, offset);
+        break;
+
+    case 0x4C: // JMP abs
+        for (size_t i = 0; i < n; ++i) {
+            regs_.PC[i] = mask_[i] ? addr : regs_.PC[i];
+        }
+        break;
+    case 0x20: // JSR abs: push the address of its last byte, high byte first
+        each_lane([&](size_t i, Bus &bus) {
+            const auto ret = static_cast<uint16_t>(regs_.PC[i] + 2);
+            bus.write(STACK_BASE | regs_.SP[i], static_cast<uint8_t>(ret >> 8));
+            regs_.SP[i]--;
+            bus.write(STACK_BASE | regs_.SP[i], static_cast<uint8_t>(ret & 0xFF));
+            regs_.SP[i]--;
+            regs_.PC[i] = addr;
+        });
+        break;
+    case 0x60: // RTS
+        each_lane([&](size_t i, Bus &bus) {
+            regs_.SP[i]++;
+            const uint8_t ret_lo = bus.read(STACK_BASE | regs_.SP[i]);
+            regs_.SP[i]++;
+            const uint8_t ret_hi = bus.read(STACK_BASE | regs_.SP[i]);
+            regs_.PC[i] = static_cast<uint16_t>((ret_lo | (ret_hi << 8)) + 1);
+        });
+        break;
+
+    default:
+        return false;
+    }
+    return true;
+}
+
+void BatchCPU::step_scalar(size_t lane) {
+    CPU &cpu = cpus_[lane];
+    cpu.state() = state(lane);
+    const uint64_t before = cpu.instruction_count();
+    if (!cpu.step()) {
+        running_[lane] = 0;
+    }
+    const uint64_t executed = cpu.instruction_count() - before;
+    instruction_counts_[lane] += executed;
+    scalar_instructions_ += executed;
+    set_state(lane, cpu.state());
+}
+
+} // namespace edasm
@@ -17,9 +17,53 @@ Bus::Bus() {
     reset();
 }
 
+Bus::Bus(std::shared_ptr<const MemorySnapshot> base) : base_(std::move(base)) {
+    for (size_t page = 0; page < POOL_PAGES; ++page) {
+        read_pages_[page] = base_->memory.data() + page * PAGE_SIZE;
+        write_pages_[page] = nullptr;
+    }
+    read_bank_offsets_ = base_->read_bank_offsets;
+    write_bank_offsets_ = base_->write_bank_offsets;
+}
+
+std::shared_ptr<const MemorySnapshot> Bus::snapshot() const {
+    auto snap = std::make_shared<MemorySnapshot>();
+    for (size_t page = 0; page < POOL_PAGES; ++page) {
+        std::copy_n(read_pages_[page], PAGE_SIZE, snap->memory.data() + page * PAGE_SIZE);
+    }
+    snap->read_bank_offsets = read_bank_offsets_;
+    snap->write_bank_offsets = write_bank_offsets_;
+    return snap;
+}
+
+size_t Bus::private_pages() const {
+    return arena_ ? POOL_PAGES : copied_pages_.size();
+}
+
+// First write to a page shared with base_: give this bus its own copy
+uint8_t *Bus::copy_page(size_t page) {
+    auto copy = std::make_unique_for_overwrite<uint8_t[]>(PAGE_SIZE);
+    std::copy_n(read_pages_[page], PAGE_SIZE, copy.get());
+    read_pages_[page] = copy.get();
+    write_pages_[page] = copy.get();
+    copied_pages_.push_back(std::move(copy));
+    return write_pages_[page];
+}
+
 void Bus::reset() {
-    // Fill entire memory pool with trap opcode
-    memory_.fill(TRAP_OPCODE);
+    // Back the whole pool privately again (dropping any snapshot) and fill
+    // it with trap opcode
+    if (!arena_) {
+        arena_ = std::make_unique_for_overwrite<uint8_t[]>(TOTAL_MEMORY_SIZE);
+    }
+    base_.reset();
+    copied_pages_.clear();
+    for (size_t page = 0; page < POOL_PAGES; ++page) {
+        read_pages_[page] = arena_.get() + page * PAGE_SIZE;
+        write_pages_[page] = arena_.get() + page * PAGE_SIZE;
+    }
+    std::fill_n(arena_.get(), TOTAL_MEMORY_SIZE, TRAP_OPCODE);
+    bump_generations(0, MEMORY_SIZE);
 
     // Initialize bank mappings to default (power-on state)
     reset_bank_mappings();
@@ -31,91 +75,72 @@ void Bus::reset() {
 
 std::vector<ReadMemoryRange> Bus::translate_read_range(uint16_t start_addr, size_t length) const {
     std::vector<ReadMemoryRange> ranges;
-    if (length == 0) {
-        return ranges;
-    }
-
-    uint16_t current_addr = start_addr;
-    size_t remaining = length;
-
-    while (remaining > 0) {
-        // Calculate which bank this address falls in
-        uint8_t bank_index = current_addr / BANK_SIZE;
-        uint32_t offset_in_bank = current_addr % BANK_SIZE;
-        uint32_t physical_offset = read_bank_offsets_[bank_index] + offset_in_bank;
-
-        // How many bytes can we read from this bank before crossing to next?
-        size_t bytes_in_this_bank = BANK_SIZE - offset_in_bank;
-        size_t bytes_to_read = std::min(remaining, bytes_in_this_bank);
-
-        // Check if this continues the previous range or starts a new one
-        if (!ranges.empty() &&
-            ranges.back().data() + ranges.back().size() == memory_.data() + physical_offset) {
-            // Extend the previous range by creating a new span from the start
-            const uint8_t *start = ranges.back().data();
-            size_t new_size = ranges.back().size() + bytes_to_read;
-            ranges.back() = std::span<const uint8_t>(start, new_size);
-        } else {
-            // Start a new range
-            ranges.push_back(
-                std::span<const uint8_t>(memory_.data() + physical_offset, bytes_to_read));
-        }
+    for_each_read_span(start_addr, length,
+                       [&ranges](ReadMemoryRange range) { ranges.push_back(range); });
+    return ranges;
+}
 
-        // Handle address wraparound at 64KB boundary
-        current_addr = static_cast<uint16_t>(current_addr + bytes_to_read);
-        remaining -= bytes_to_read;
+std::vector<WriteMemoryRange> Bus::translate_write_range(uint16_t start_addr, size_t length) {
+    std::vector<WriteMemoryRange> ranges;
+    for_each_write_span(start_addr, length,
+                        [&ranges](WriteMemoryRange range) { ranges.push_back(range); });
+    return ranges;
+}
 
-        // If we wrapped around to 0, we've covered the entire address space
-        if (current_addr == 0 && remaining > 0) {
-            // Continue from address 0 for remaining bytes
+bool Bus::overlaps_read_trap(uint16_t start_addr, size_t length) const {
+    const size_t end = start_addr + length - 1;
+    for (const auto &range : read_trap_ranges_) {
+        if (range.start <= end && range.end >= start_addr) {
+            return true;
         }
     }
-
-    return ranges;
+    return false;
 }
 
-std::vector<WriteMemoryRange> Bus::translate_write_range(uint16_t start_addr, size_t length) {
-    std::vector<WriteMemoryRange> ranges;
-    if (length == 0) {
-        return ranges;
+bool Bus::overlaps_write_trap(uint16_t start_addr, size_t length) const {
+    const size_t end = start_addr + length - 1;
+    for (const auto &range : write_trap_ranges_) {
+        if (range.start <= end && range.end >= start_addr) {
+            return true;
+        }
     }
+    return false;
+}
 
-    uint16_t current_addr = start_addr;
-    size_t remaining = length;
-
-    while (remaining > 0) {
-        // Calculate which bank this address falls in
-        uint8_t bank_index = current_addr / BANK_SIZE;
-        uint32_t offset_in_bank = current_addr % BANK_SIZE;
-        uint32_t physical_offset = write_bank_offsets_[bank_index] + offset_in_bank;
-
-        // How many bytes can we write to this bank before crossing to next?
-        size_t bytes_in_this_bank = BANK_SIZE - offset_in_bank;
-        size_t bytes_to_write = std::min(remaining, bytes_in_this_bank);
-
-        // Check if this continues the previous range or starts a new one
-        if (!ranges.empty() &&
-            ranges.back().data() + ranges.back().size() == memory_.data() + physical_offset) {
-            // Extend the previous range by creating a new span from the start
-            uint8_t *start = ranges.back().data();
-            size_t new_size = ranges.back().size() + bytes_to_write;
-            ranges.back() = std::span<uint8_t>(start, new_size);
-        } else {
-            // Start a new range
-            ranges.push_back(std::span<uint8_t>(memory_.data() + physical_offset, bytes_to_write));
+void Bus::read_block(uint16_t addr, std::span<uint8_t> out) const {
+    if (out.empty()) {
+        return;
+    }
+    if (addr + out.size() > MEMORY_SIZE || overlaps_read_trap(addr, out.size())) {
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = read(static_cast<uint16_t>(addr + i));
         }
+        return;
+    }
 
-        // Handle address wraparound at 64KB boundary
-        current_addr = static_cast<uint16_t>(current_addr + bytes_to_write);
-        remaining -= bytes_to_write;
+    uint8_t *dest = out.data();
+    for_each_read_span(addr, out.size(), [&dest](ReadMemoryRange range) {
+        dest = std::copy(range.begin(), range.end(), dest);
+    });
+}
 
-        // If we wrapped around to 0, we've covered the entire address space
-        if (current_addr == 0 && remaining > 0) {
-            // Continue from address 0 for remaining bytes
+void Bus::write_block(uint16_t addr, std::span<const uint8_t> data) {
+    if (data.empty()) {
+        return;
+    }
+    if (addr + data.size() > MEMORY_SIZE || overlaps_write_trap(addr, data.size())) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            write(static_cast<uint16_t>(addr + i), data[i]);
         }
+        return;
     }
 
-    return ranges;
+    const uint8_t *src = data.data();
+    for_each_write_span(addr, data.size(), [&src](WriteMemoryRange range) {
+        std::copy(src, src + range.size(), range.begin());
+        src += range.size();
+    });
+    bump_generations(addr, data.size());
 }
 
 void Bus::reset_bank_mappings() {
@@ -175,7 +200,7 @@ uint8_t Bus::read(uint16_t addr) const {
     uint32_t offset_in_bank = addr % BANK_SIZE; // Offset within the bank
     uint32_t physical_offset = read_bank_offsets_[bank_index] + offset_in_bank;
 
-    return memory_[physical_offset];
+    return *read_pointer(physical_offset);
 }
 
 void Bus::write(uint16_t addr, uint8_t value) {
@@ -192,7 +217,18 @@ void Bus::write(uint16_t addr, uint8_t value) {
     uint32_t offset_in_bank = addr % BANK_SIZE; // Offset within the bank
     uint32_t physical_offset = write_bank_offsets_[bank_index] + offset_in_bank;
 
-    memory_[physical_offset] = value;
+    *write_pointer(physical_offset) = value;
+    page_generations_[addr >> 8]++;
+}
+
+void Bus::bump_generations(uint16_t start_addr, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    const size_t last = std::min<size_t>(start_addr + length - 1, MEMORY_SIZE - 1);
+    for (size_t page = start_addr >> 8; page <= (last >> 8); ++page) {
+        page_generations_[page]++;
+    }
 }
 
 uint16_t Bus::read_word(uint16_t addr) const {
@@ -216,16 +252,15 @@ bool Bus::write_memory_dump(const std::string &filename) const {
         return false;
     }
 
-    // Use translate_read_range to get the proper memory ranges for the entire 64KB address space
-    auto ranges = translate_read_range(0, MEMORY_SIZE);
-
-    // Write each range to file
-    for (const auto &range : ranges) {
-        file.write(reinterpret_cast<const char *>(range.data()), range.size());
-        if (!file) {
-            std::cerr << "Error: Failed to write memory dump" << std::endl;
-            return false;
+    // Write the entire 64KB address space as currently mapped for reads, span by span
+    for_each_read_span(0, MEMORY_SIZE, [&file](ReadMemoryRange range) {
+        if (file) {
+            file.write(reinterpret_cast<const char *>(range.data()), range.size());
         }
+    });
+    if (!file) {
+        std::cerr << "Error: Failed to write memory dump" << std::endl;
+        return false;
     }
 
     file.close();
@@ -249,8 +284,9 @@ bool Bus::initialize_memory(uint16_t addr, const std::vector<uint8_t> &data) {
     for (size_t i = 0; i < data.size(); ++i) {
         uint16_t target_addr = static_cast<uint16_t>(addr + i);
         uint32_t physical_offset = MAIN_RAM_OFFSET + target_addr;
-        memory_[physical_offset] = data[i];
+        *write_pointer(physical_offset) = data[i];
     }
+    bump_generations(addr, data.size());
 
     return true;
 }
@@ -266,15 +302,13 @@ bool Bus::write_binary_data(uint16_t addr, const std::vector<uint8_t> &data) {
 
     // Use write translation to handle bank switching correctly
     // This respects the bank mapping but bypasses traps
-    auto ranges = translate_write_range(addr, static_cast<uint16_t>(data.size()));
-
-    size_t data_offset = 0;
-    for (auto &range : ranges) {
+    auto src = data.begin();
+    for_each_write_span(addr, data.size(), [&src](WriteMemoryRange range) {
         // Copy this portion of data to the physical memory location
-        std::copy(data.begin() + data_offset, data.begin() + data_offset + range.size(),
-                  range.begin());
-        data_offset += range.size();
-    }
+        std::copy(src, src + range.size(), range.begin());
+        src += range.size();
+    });
+    bump_generations(addr, data.size());
 
     return true;
 }
@@ -9,14 +9,17 @@
 #include "edasm/emulator/cpu.hpp"
 #include "edasm/constants.hpp"
 #include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/lockstep.hpp"
+#include "edasm/emulator/ram_bus.hpp"
 
 namespace edasm {
 
-CPU::CPU(Bus &bus) : bus_(bus), instruction_count_(0) {
+template <typename BusT>
+BasicCPU<BusT>::BasicCPU(BusT &bus) : bus_(bus), instruction_count_(0) {
     reset();
 }
 
-void CPU::reset() {
+template <typename BusT> void BasicCPU<BusT>::reset() {
     state_ = CPUState();
     instruction_count_ = 0;
 
@@ -25,16 +28,16 @@ void CPU::reset() {
     state_.PC = 0x2000;
 }
 
-void CPU::set_trap_handler(TrapHandler handler) {
+template <typename BusT> void BasicCPU<BusT>::set_trap_handler(BasicTrapHandler<BusT> handler) {
     trap_handler_ = handler;
 }
 
-bool CPU::step() {
+template <typename BusT> bool BasicCPU<BusT>::step() {
     // Fetch opcode
     uint8_t opcode = fetch_byte();
 
     // Check for trap opcode ($02)
-    if (opcode == Bus::TRAP_OPCODE) {
+    if (opcode == BusT::TRAP_OPCODE) {
         if (trap_handler_) {
             // Call trap handler, return its result (true = continue, false = halt)
             return trap_handler_(state_, bus_, state_.PC - 1);
@@ -50,40 +53,40 @@ bool CPU::step() {
     return result;
 }
 
-uint8_t CPU::fetch_byte() {
+template <typename BusT> uint8_t BasicCPU<BusT>::fetch_byte() {
     uint8_t value = bus_.read(state_.PC);
     state_.PC++;
     return value;
 }
 
-uint16_t CPU::fetch_word() {
+template <typename BusT> uint16_t BasicCPU<BusT>::fetch_word() {
     uint8_t lo = fetch_byte();
     uint8_t hi = fetch_byte();
     return static_cast<uint16_t>(lo) | (static_cast<uint16_t>(hi) << 8);
 }
 
-void CPU::push_byte(uint8_t value) {
+template <typename BusT> void BasicCPU<BusT>::push_byte(uint8_t value) {
     bus_.write(STACK_BASE | state_.SP, value);
     state_.SP--;
 }
 
-uint8_t CPU::pull_byte() {
+template <typename BusT> uint8_t BasicCPU<BusT>::pull_byte() {
     state_.SP++;
     return bus_.read(STACK_BASE | state_.SP);
 }
 
-void CPU::push_word(uint16_t value) {
+template <typename BusT> void BasicCPU<BusT>::push_word(uint16_t value) {
     push_byte(static_cast<uint8_t>((value >> 8) & 0xFF)); // High byte first
     push_byte(static_cast<uint8_t>(value & 0xFF));        // Low byte second
 }
 
-uint16_t CPU::pull_word() {
+template <typename BusT> uint16_t BasicCPU<BusT>::pull_word() {
     uint8_t lo = pull_byte();
     uint8_t hi = pull_byte();
     return static_cast<uint16_t>(lo) | (static_cast<uint16_t>(hi) << 8);
 }
 
-void CPU::set_flag(uint8_t flag, bool value) {
+template <typename BusT> void BasicCPU<BusT>::set_flag(uint8_t flag, bool value) {
     if (value) {
         state_.P |= flag;
     } else {
@@ -91,16 +94,16 @@ void CPU::set_flag(uint8_t flag, bool value) {
     }
 }
 
-bool CPU::get_flag(uint8_t flag) const {
+template <typename BusT> bool BasicCPU<BusT>::get_flag(uint8_t flag) const {
     return (state_.P & flag) != 0;
 }
 
-void CPU::update_nz(uint8_t value) {
+template <typename BusT> void BasicCPU<BusT>::update_nz(uint8_t value) {
     set_flag(StatusFlags::Z, value == 0);
     set_flag(StatusFlags::N, (value & 0x80) != 0);
 }
 
-bool CPU::execute_instruction(uint8_t opcode) {
+template <typename BusT> bool BasicCPU<BusT>::execute_instruction(uint8_t opcode) {
     // Minimal instruction set implementation
     // This is a skeleton that will be expanded as needed
 
@@ -1485,4 +1488,9 @@ bool CPU::execute_instruction(uint8_t opcode) {
     return true; // Continue execution
 }
 
+template class BasicCPU<Bus>;
+template class BasicCPU<FlatBus>;
+template class BasicCPU<BankedBus>;
+template class BasicCPU<LockstepBus>;
+
 } // namespace edasm
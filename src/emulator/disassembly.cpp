@@ -8,6 +8,7 @@
 
 #include "edasm/emulator/disassembly.hpp"
 #include "edasm/constants.hpp"
+#include "edasm/files/symbol_database.hpp"
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -23,10 +24,25 @@ std::unordered_map<uint16_t, std::string> &symbol_table() {
     return table;
 }
 
+const SymbolDatabase *&symbol_database() {
+    static const SymbolDatabase *database = nullptr;
+    return database;
+}
+
 void append_symbol(std::ostringstream &oss, uint16_t address, uint8_t opcode) {
     const auto &table = symbol_table();
     auto it = table.find(address);
     if (it == table.end()) {
+        if (const SymbolDatabase *database = symbol_database()) {
+            if (auto match = database->lookup(address)) {
+                oss << " <" << match->symbol.name;
+                if (match->offset != 0) {
+                    oss << "+$" << std::hex << std::uppercase << match->offset;
+                }
+                oss << ">";
+                return;
+            }
+        }
         if (opcode == 0x02)
             oss << " ; No symbol found for address $" << std::hex << std::uppercase << std::setw(4)
                 << std::setfill('0') << address;
@@ -419,6 +435,25 @@ const std::string *lookup_disassembly_symbol(uint16_t address) {
     return &it->second;
 }
 
+void set_disassembly_symbol_database(const SymbolDatabase *database) {
+    symbol_database() = database;
+}
+
+std::string disassembly_address_name(uint16_t address) {
+    if (const std::string *symbol = lookup_disassembly_symbol(address)) {
+        return *symbol;
+    }
+    if (const SymbolDatabase *database = symbol_database()) {
+        std::string name = database->symbolize(address);
+        if (!name.empty()) {
+            return name;
+        }
+    }
+    std::ostringstream oss;
+    oss << "$" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << address;
+    return oss.str();
+}
+
 void register_default_disassembly_symbols() {
 #define EDASM_REGISTER_SYMBOL(name) register_disassembly_symbol(name, #name)
     // Memory layout symbols
@@ -8,6 +8,7 @@
 
 #include "edasm/emulator/host_shims.hpp"
 #include "edasm/constants.hpp"
+#include "edasm/emulator/log.hpp"
 #include "edasm/emulator/traps.hpp"
 
 #include <iomanip>
@@ -29,32 +30,14 @@ void HostShims::install_io_traps() {
         KBD, 0xC7FF,
         [this](uint16_t addr, uint8_t value) { return this->handle_io_write(addr, value); }, "I/O");
 
-    // Install write trap for text page 1 ($0400-$07FF)
-    bus_.set_write_trap_range(
-        TEXT1_LINE1, 0x07FF,
-        [this](uint16_t addr, uint8_t value) {
-            // Record screen write statistics
-            TrapStatistics::record_trap("SCREEN", addr, TrapKind::WRITE);
-
-            // Mark screen as dirty but allow normal write to proceed
-            screen_dirty_ = true;
-
-            // Check if writing to first character position ($0400)
-            // Strip high bit and check for 'E' (handles normal, inverse, and flashing text)
-            if (addr == TEXT1_LINE1) {
-                // Check for 'E' by masking high bit (handles all Apple II text modes)
-                char ch = static_cast<char>(value & 0x7F);
-                if (ch == 'E' || ch == 'e') {
-                    std::cout << "\n[HostShims] First screen character set to 'E' - logging and "
-                                 "stopping\n"
-                              << std::endl;
-                    dump_and_stop("First screen character set to 'E'");
-                }
-            }
-
-            return false;
-        },
-        "SCREEN");
+    // Text page 1 ($0400-$07FF) is deliberately not trapped: screen stores
+    // stay on the bus fast path and are detected afterwards from the bus
+    // page generations (see sync_screen() and should_stop())
+    for (size_t i = 0; i < screen_generations_.size(); ++i) {
+        screen_generations_[i] = bus_.page_generation(static_cast<uint8_t>((TEXT1_LINE1 >> 8) + i));
+    }
+    stop_check_generation_ = screen_generations_[0];
+    stop_check_char_ = bus_.read(TEXT1_LINE1);
 
     // NOTE: Language card window ($D000-$FFFF) no longer uses traps
     // It's now handled via bank mapping in Bus::set_bank_mapping()
@@ -91,7 +74,23 @@ char HostShims::get_next_char() {
     return ch;
 }
 
+void HostShims::sync_screen() {
+    for (size_t i = 0; i < screen_generations_.size(); ++i) {
+        const auto page = static_cast<uint8_t>((TEXT1_LINE1 >> 8) + i);
+        const uint32_t generation = bus_.page_generation(page);
+        if (generation != screen_generations_[i]) {
+            // Counters wrap, so the difference is the store count
+            TrapStatistics::record_trap("SCREEN", static_cast<uint16_t>(page << 8),
+                                        TrapKind::WRITE, "", false,
+                                        generation - screen_generations_[i]);
+            screen_generations_[i] = generation;
+            screen_dirty_ = true;
+        }
+    }
+}
+
 bool HostShims::handle_kbd_read(uint16_t addr, uint8_t &value) {
+    sync_screen();
     if (screen_dirty_) {
         dump_text_screen(bus_, page2_, "screen_dirty_");
         screen_dirty_ = false;
@@ -128,223 +127,206 @@ bool HostShims::handle_kbd_read(uint16_t addr, uint8_t &value) {
     }
 
     // Return current keyboard value
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "[I/O] Keyboard read at $" << std::hex << std::uppercase << std::setw(4)
-                  << std::setfill('0') << addr << " = $" << std::setw(2)
-                  << static_cast<int>(kbd_value_) << std::endl;
-    }
+    EDASM_LOG(TRACE, IO,
+              "[I/O] Keyboard read at $" << std::hex << std::uppercase << std::setw(4)
+                                         << std::setfill('0') << addr << " = $" << std::setw(2)
+                                         << static_cast<int>(kbd_value_));
     value = kbd_value_;
     return true; // Trap handled
 }
 
 bool HostShims::handle_kbdstrb_read(uint16_t addr, uint8_t &value) {
     // Reading KBDSTROBE clears the keyboard strobe by clearing the high bit
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "[I/O] Keyboard strobe read at $" << std::hex << std::uppercase << std::setw(4)
-                  << std::setfill('0') << addr << " (clearing strobe)" << std::endl;
-    }
+    EDASM_LOG(TRACE, IO,
+              "[I/O] Keyboard strobe read at $" << std::hex << std::uppercase << std::setw(4)
+                                                << std::setfill('0') << addr
+                                                << " (clearing strobe)");
     value = 0;
     kbd_value_ = kbd_value_ & 0x7F; // Clear high bit
 
     return true; // Trap handled
 }
 
-bool HostShims::handle_io_read(uint16_t addr, uint8_t &value) {
-    // Record I/O read statistics (except for language card which has its own recording)
-    if (addr < 0xC080 || addr > 0xC08F) {
-        TrapStatistics::record_trap("I/O", addr, TrapKind::READ);
-    }
+// Build the $C0xx read table, one 16-byte soft-switch group at a time
+constexpr std::array<HostShims::ReadHandler, 256> HostShims::build_read_dispatch() {
+    std::array<ReadHandler, 256> table;
+    table.fill(&HostShims::io_read_unhandled); // $C020-$C02F, $C040-$C04F, $C070-$C07F, $C090-$C0FF
 
-    // Dispatch to specific handlers based on address
+    auto fill = [&table](uint8_t first, uint8_t last, ReadHandler handler) {
+        for (unsigned i = first; i <= last; ++i) {
+            table[i] = handler;
+        }
+    };
+    fill(0x00, 0x0F, &HostShims::io_read_kbd); // Keyboard and game I/O
+    fill(0x10, 0x1F, &HostShims::io_read_zero); // Soft switch status
+    table[KBDSTROBE & 0xFF] = &HostShims::io_read_kbdstrb; // Keyboard strobe
+    fill(0x30, 0x3F, &HostShims::io_read_speaker); // Speaker toggle
+    fill(0x50, 0x5F, &HostShims::io_read_graphics); // Graphics mode switches
+    fill(0x60, 0x6F, &HostShims::io_read_zero); // Buttons (not pressed)
+    fill(0x80, 0x8F, &HostShims::handle_language_control_read); // Language card
+    return table;
+}
 
-    // $C000-$C00F: Keyboard and game I/O
-    if (addr >= KBD && addr <= 0xC00F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        return handle_kbd_read(addr, value);
-    }
+constexpr std::array<HostShims::WriteHandler, 256> HostShims::build_write_dispatch() {
+    std::array<WriteHandler, 256> table;
+    table.fill(&HostShims::io_write_unhandled); // $C020-$C02F, $C060-$C07F, $C090-$C0FF
 
-    // $C010-$C01F: Keyboard strobe and soft switches
-    if (addr >= KBDSTROBE && addr <= 0xC01F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        if (addr == KBDSTROBE) {
-            return handle_kbdstrb_read(addr, value);
+    auto fill = [&table](uint8_t first, uint8_t last, WriteHandler handler) {
+        for (unsigned i = first; i <= last; ++i) {
+            table[i] = handler;
         }
-        // Other addresses in this range: return 0
-        value = 0;
-        return true;
-    }
-
-    // $C020-$C02F: Cassette and misc I/O
-    if (addr >= 0xC020 && addr <= 0xC02F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        value = 0;
-        report_unhandled_io(addr, false, value);
-        return true;
-    }
+    };
+    fill(0x00, 0x0F, &HostShims::io_write_80col); // CLR80VID/SET80VID
+    fill(0x10, 0x1F, &HostShims::io_write_ignore); // Soft switches
+    table[KBDSTROBE & 0xFF] = &HostShims::io_write_kbdstrb; // Keyboard strobe
+    fill(0x30, 0x3F, &HostShims::io_write_speaker); // Speaker toggle
+    fill(0x40, 0x4F, &HostShims::io_write_ignore); // Utility strobe
+    fill(0x50, 0x5F, &HostShims::io_write_graphics); // Graphics (write = read)
+    fill(0x80, 0x8F, &HostShims::handle_language_control_write); // Language card
+    return table;
+}
 
-    // $C030-$C03F: Speaker toggle
-    if (addr >= 0xC030 && addr <= 0xC03F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        return handle_speaker_toggle(addr, value);
-    }
+constinit const std::array<HostShims::ReadHandler, 256> HostShims::read_dispatch_ =
+    HostShims::build_read_dispatch();
+constinit const std::array<HostShims::WriteHandler, 256> HostShims::write_dispatch_ =
+    HostShims::build_write_dispatch();
 
-    // $C040-$C04F: Utility strobe (not used much)
-    if (addr >= 0xC040 && addr <= 0xC04F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        value = 0;
-        report_unhandled_io(addr, false, value);
-        return true;
+bool HostShims::handle_io_read(uint16_t addr, uint8_t &value) {
+    if (addr > 0xC0FF) {
+        return handle_slot_read(addr, value);
     }
+    const uint8_t index = addr & 0xFF;
+    io_read_counts_[index]++;
+    return (this->*read_dispatch_[index])(addr, value);
+}
 
-    // $C050-$C05F: Graphics mode switches
-    if (addr >= 0xC050 && addr <= 0xC05F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        return handle_graphics_switches(addr, value, false);
+bool HostShims::handle_io_write(uint16_t addr, uint8_t value) {
+    if (addr > 0xC0FF) {
+        return handle_slot_write(addr, value);
     }
+    const uint8_t index = addr & 0xFF;
+    io_write_counts_[index]++;
+    return (this->*write_dispatch_[index])(addr, value);
+}
 
-    // $C060-$C06F: Game paddles/buttons
-    if (addr >= 0xC060 && addr <= 0xC06F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        // Return high bit clear (button not pressed)
-        value = 0x00;
-        return true;
-    }
+bool HostShims::io_read_kbd(uint16_t addr, uint8_t &value) {
+    clear_lc_pending();
+    return handle_kbd_read(addr, value);
+}
 
-    // $C070-$C07F: Game paddle triggers
-    if (addr >= 0xC070 && addr <= 0xC07F) {
-        // Clear language card pending state for non-LC accesses
-        lc_.write_enable_pending = false;
-        lc_.last_control_addr = 0xFFFF;
-        value = 0;
-        report_unhandled_io(addr, false, value);
-        return true;
-    }
+bool HostShims::io_read_kbdstrb(uint16_t addr, uint8_t &value) {
+    clear_lc_pending();
+    return handle_kbdstrb_read(addr, value);
+}
 
-    // $C080-$C08F: Language card bank switching (IIe/IIc)
-    if (addr >= 0xC080 && addr <= 0xC08F) {
-        return handle_language_control_read(addr, value);
-    }
+bool HostShims::io_read_zero(uint16_t /*addr*/, uint8_t &value) {
+    clear_lc_pending();
+    value = 0;
+    return true;
+}
 
-    // $C090-$C7FF: Expansion slots and additional I/O
-    // Each slot occupies 16 bytes: $C0n0-$C0nF (where n is slot 1-7)
+bool HostShims::io_read_speaker(uint16_t addr, uint8_t &value) {
+    clear_lc_pending();
+    return handle_speaker_toggle(addr, value);
+}
 
-    // Pascal 1.1 Firmware Protocol signature bytes ($Cx0B, $Cx0C for slots 1-7)
-    // Return actual memory content for these addresses
-    if ((addr & 0xF0FF) == 0xC00B || (addr & 0xF0FF) == 0xC00C) {
-        // Check if it's in valid slot range (1-7)
-        uint8_t slot = (addr >> 8) & 0x0F;
-        if (slot >= 1 && slot <= 7) {
-            // Read directly from memory using translation to avoid recursion through trap handler
-            auto ranges = bus_.translate_read_range(addr, 1);
-            if (!ranges.empty()) {
-                value = ranges[0][0];
-                return true;
-            }
-        }
-    }
+bool HostShims::io_read_graphics(uint16_t addr, uint8_t &value) {
+    clear_lc_pending();
+    return handle_graphics_switches(addr, value, false);
+}
 
-    // For other undefined I/O, return 0
-    // Clear language card pending state for non-LC accesses
-    lc_.write_enable_pending = false;
-    lc_.last_control_addr = 0xFFFF;
+bool HostShims::io_read_unhandled(uint16_t addr, uint8_t &value) {
+    clear_lc_pending();
     value = 0;
     report_unhandled_io(addr, false, value);
     return true;
 }
 
-bool HostShims::handle_io_write(uint16_t addr, uint8_t value) {
-    // Record I/O write statistics (except for language card which has its own recording)
-    if (addr < 0xC080 || addr > 0xC08F) {
-        TrapStatistics::record_trap("I/O", addr, TrapKind::WRITE);
+bool HostShims::io_write_80col(uint16_t addr, uint8_t /*value*/) {
+    if (addr == CLR80VID) { // CLR80VID - clear 80-column mode
+        eighty_col_enabled_ = false;
+    } else if (addr == static_cast<uint16_t>(CLR80VID + 1)) { // SET80VID - set 80-column mode
+        eighty_col_enabled_ = true;
     }
+    // Unknown writes: ignore but do not stop the emulator
+    return true;
+}
 
-    // Dispatch to specific handlers based on address
+bool HostShims::io_write_kbdstrb(uint16_t /*addr*/, uint8_t /*value*/) {
+    // Writing to KBDSTROBE also clears strobe (clear high bit)
+    kbd_value_ = kbd_value_ & 0x7F;
+    return true;
+}
 
-    // $C000-$C00F: Keyboard/game I/O (typically read-only)
-    if (addr >= KBD && addr <= 0xC00F) {
-        // Handle known soft-switches gracefully
-        if (addr == CLR80VID) { // CLR80VID - clear 80-column mode
-            eighty_col_enabled_ = false;
-            return true;
-        }
-        if (addr == static_cast<uint16_t>(CLR80VID + 1)) { // SET80VID - set 80-column mode
-            eighty_col_enabled_ = true;
-            return true;
-        }
-        // Unknown writes: ignore but do not stop the emulator
-        return true;
-    }
+bool HostShims::io_write_ignore(uint16_t /*addr*/, uint8_t /*value*/) {
+    return true;
+}
 
-    // $C010-$C01F: Keyboard strobe and soft switches
-    if (addr >= KBDSTROBE && addr <= 0xC01F) {
-        if (addr == KBDSTROBE) {
-            // Writing to KBDSTROBE also clears strobe (clear high bit)
-            kbd_value_ = kbd_value_ & 0x7F;
-        }
-        return true;
-    }
+bool HostShims::io_write_speaker(uint16_t addr, uint8_t /*value*/) {
+    uint8_t dummy;
+    return handle_speaker_toggle(addr, dummy);
+}
 
-    // $C020-$C02F: Cassette output and misc
-    if (addr >= 0xC020 && addr <= 0xC02F) {
-        report_unhandled_io(addr, true, value);
-        return true; // Ignore
-    }
+bool HostShims::io_write_graphics(uint16_t addr, uint8_t /*value*/) {
+    uint8_t dummy;
+    return handle_graphics_switches(addr, dummy, true);
+}
 
-    // $C030-$C03F: Speaker toggle
-    if (addr >= 0xC030 && addr <= 0xC03F) {
-        uint8_t dummy;
-        return handle_speaker_toggle(addr, dummy);
-    }
+bool HostShims::io_write_unhandled(uint16_t addr, uint8_t value) {
+    report_unhandled_io(addr, true, value);
+    return true; // Ignore
+}
 
-    // $C040-$C04F: Utility strobe
-    if (addr >= 0xC040 && addr <= 0xC04F) {
-        return true; // Ignore
-    }
+// $C100-$C7FF: slot ROM space
+bool HostShims::handle_slot_read(uint16_t addr, uint8_t &value) {
+    TrapStatistics::record_trap("I/O", addr, TrapKind::READ);
 
-    // $C050-$C05F: Graphics mode switches (write = read)
-    if (addr >= 0xC050 && addr <= 0xC05F) {
-        uint8_t dummy;
-        return handle_graphics_switches(addr, dummy, true);
+    // Pascal 1.1 Firmware Protocol signature bytes ($Cx0B, $Cx0C for slots 1-7)
+    // Return actual memory content for these addresses
+    if ((addr & 0xF0FF) == 0xC00B || (addr & 0xF0FF) == 0xC00C) {
+        // Read directly from memory using translation to avoid recursion through trap handler
+        bus_.for_each_read_span(addr, 1, [&value](ReadMemoryRange range) { value = range[0]; });
+        return true;
     }
 
-    // $C060-$C07F: Game I/O (typically read-only)
-    if (addr >= 0xC060 && addr <= 0xC07F) {
-        report_unhandled_io(addr, true, value);
-        return true; // Ignore writes
-    }
+    // For other undefined I/O, return 0
+    clear_lc_pending();
+    value = 0;
+    report_unhandled_io(addr, false, value);
+    return true;
+}
 
-    // $C080-$C08F: Language card bank switching
-    if (addr >= 0xC080 && addr <= 0xC08F) {
-        return handle_language_control_write(addr, value);
-    }
+bool HostShims::handle_slot_write(uint16_t addr, uint8_t value) {
+    TrapStatistics::record_trap("I/O", addr, TrapKind::WRITE);
 
-    // $C090-$C7FF: Expansion slots and additional I/O
     // Ignore writes to undefined I/O
     report_unhandled_io(addr, true, value);
     return true;
 }
 
+void HostShims::flush_statistics() {
+    sync_screen();
+    for (size_t i = 0; i < io_read_counts_.size(); ++i) {
+        const auto addr = static_cast<uint16_t>(KBD + i);
+        if (io_read_counts_[i] != 0 && (addr < 0xC080 || addr > 0xC08F)) {
+            TrapStatistics::record_trap("I/O", addr, TrapKind::READ, "", false,
+                                        io_read_counts_[i]);
+        }
+        if (io_write_counts_[i] != 0 && (addr < 0xC080 || addr > 0xC08F)) {
+            TrapStatistics::record_trap("I/O", addr, TrapKind::WRITE, "", false,
+                                        io_write_counts_[i]);
+        }
+    }
+    io_read_counts_.fill(0);
+    io_write_counts_.fill(0);
+}
+
 bool HostShims::handle_speaker_toggle(uint16_t addr, uint8_t &value) {
     // Speaker toggle: any access to $C030 toggles speaker
     // We don't actually produce sound, just acknowledge the access
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "[I/O] Speaker toggle at $" << std::hex << std::uppercase << std::setw(4)
-                  << std::setfill('0') << addr << std::endl;
-    }
+    EDASM_LOG(TRACE, IO,
+              "[I/O] Speaker toggle at $" << std::hex << std::uppercase << std::setw(4)
+                                          << std::setfill('0') << addr);
     value = 0;
     return true;
 }
@@ -400,12 +382,12 @@ bool HostShims::handle_graphics_switches(uint16_t addr, uint8_t &value, bool is_
         break;
     }
 
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "[I/O] Graphics switch at $" << std::hex << std::uppercase << std::setw(4)
-                  << std::setfill('0') << addr << " -> text=" << std::boolalpha << text_mode_
-                  << " mixed=" << mixed_mode_ << " page2=" << page2_ << " hires=" << hires_
-                  << std::noboolalpha << std::endl;
-    }
+    EDASM_LOG(TRACE, IO,
+              "[I/O] Graphics switch at $" << std::hex << std::uppercase << std::setw(4)
+                                           << std::setfill('0') << addr << " -> text="
+                                           << std::boolalpha << text_mode_ << " mixed="
+                                           << mixed_mode_ << " page2=" << page2_
+                                           << " hires=" << hires_);
 
     return true;
 }
@@ -413,6 +395,7 @@ bool HostShims::handle_graphics_switches(uint16_t addr, uint8_t &value, bool is_
 // Static utility to dump text screen
 void HostShims::dump_text_screen(const Bus &bus, bool page2, const std::string &label) {
     const uint16_t base = page2 ? TEXT2_LINE1 : TEXT1_LINE1;
+    Log::flush();
 
     if (!label.empty()) {
         std::cout << "[HostShims] Text screen snapshot (page " << (page2 ? 2 : 1) << ") " << label
@@ -441,6 +424,7 @@ void HostShims::dump_text_screen(const Bus &bus, bool page2, const std::string &
 
 // Dump screen and memory, then request stop
 void HostShims::dump_and_stop(const std::string &reason) {
+    Log::flush(); // Keep the record that led here ahead of the dump
     std::cout << "\n[HostShims] Stopping: " << reason << std::endl;
     dump_text_screen(bus_, page2_, reason);
     TrapManager::write_memory_dump(bus_, "memory_dump.bin");
@@ -449,10 +433,12 @@ void HostShims::dump_and_stop(const std::string &reason) {
 
 // Report unimplemented I/O access and request emulator stop
 void HostShims::report_unhandled_io(uint16_t addr, bool is_write, uint8_t value) {
-    std::cerr << "[HostShims] UNIMPLEMENTED I/O " << (is_write ? "WRITE" : "READ") << " at $"
-              << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << addr
-              << " value=$" << std::setw(2) << static_cast<int>(value) << " - stopping"
-              << std::endl;
+    EDASM_LOG(ERROR, IO,
+              "[HostShims] UNIMPLEMENTED I/O " << (is_write ? "WRITE" : "READ") << " at $"
+                                               << std::hex << std::uppercase << std::setw(4)
+                                               << std::setfill('0') << addr << " value=$"
+                                               << std::setw(2) << static_cast<int>(value)
+                                               << " - stopping");
     dump_and_stop("UNIMPLEMENTED I/O access");
 }
 
@@ -543,17 +529,14 @@ bool HostShims::handle_language_control_read(uint16_t addr, uint8_t &value) {
     lc_.power_on_rom_active =
         (mode == LCBankMode::READ_ROM_ONLY || mode == LCBankMode::READ_ROM_WRITE_RAM);
 
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "[HostShims] Language Card control read at $" << std::hex << std::uppercase
-                  << std::setw(4) << std::setfill('0') << addr << " -> HW Bank " << std::dec
-                  << static_cast<int>(hw_bank) << " (idx=" << static_cast<int>(bank)
-                  << ") mode=" << static_cast<int>(mode);
-        if (write_enable_requested) {
-            std::cout << (write_actually_enabled ? " [2nd read - write enabled]"
-                                                 : " [1st read - pending]");
-        }
-        std::cout << std::endl;
-    }
+    EDASM_LOG(TRACE, LC,
+              "[HostShims] Language Card control read at $"
+                  << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << addr
+                  << " -> HW Bank " << std::dec << static_cast<int>(hw_bank)
+                  << " (idx=" << static_cast<int>(bank) << ") mode=" << static_cast<int>(mode)
+                  << (!write_enable_requested   ? ""
+                      : write_actually_enabled ? " [2nd read - write enabled]"
+                                               : " [1st read - pending]"));
 
     // Update bank mappings for D000-FFFF (banks 26-31)
     update_lc_bank_mappings();
@@ -567,11 +550,11 @@ bool HostShims::handle_language_control_write(uint16_t addr, uint8_t value) {
     // They also count toward the double-access requirement
     uint8_t dummy;
     bool ok = handle_language_control_read(addr, dummy);
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "[HostShims] Language Card control write at $" << std::hex << std::uppercase
-                  << std::setw(4) << std::setfill('0') << addr << " value=$" << std::setw(2)
-                  << static_cast<int>(value) << " (same effect as read)" << std::endl;
-    }
+    EDASM_LOG(TRACE, LC,
+              "[HostShims] Language Card control write at $"
+                  << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << addr
+                  << " value=$" << std::setw(2) << static_cast<int>(value)
+                  << " (same effect as read)");
     return ok;
 }
 
@@ -649,7 +632,27 @@ void HostShims::update_lc_bank_mappings() {
     }
 }
 
-bool HostShims::should_stop() const {
+bool HostShims::should_stop() {
+    const uint32_t generation = bus_.page_generation(TEXT1_LINE1 >> 8);
+    if (generation != stop_check_generation_ && !stop_requested_) {
+        stop_check_generation_ = generation;
+
+        // Only a new value at $0400 counts: other stores to page $04 leave
+        // an 'E' that was already there alone
+        const uint8_t value = bus_.read(TEXT1_LINE1);
+        if (value == stop_check_char_) {
+            return stop_requested_;
+        }
+        stop_check_char_ = value;
+
+        // Check for 'E' by masking high bit (handles normal, inverse, and flashing text)
+        char ch = static_cast<char>(value & 0x7F);
+        if (ch == 'E' || ch == 'e') {
+            EDASM_LOG(INFO, TRAP,
+                      "[HostShims] First screen character set to 'E' - logging and stopping");
+            dump_and_stop("First screen character set to 'E'");
+        }
+    }
     return stop_requested_;
 }
 
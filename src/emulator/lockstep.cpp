@@ -0,0 +1,190 @@
+/**
+ * @file lockstep.cpp
+ * @brief Lockstep comparison of CPU/Bus against a reference trace
+ */
+
+#include "edasm/emulator/lockstep.hpp"
+#include "edasm/emulator/disassembly.hpp"
+#include "edasm/emulator/traps.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace edasm {
+
+namespace {
+
+// Take the reference registers; P bits outside mask keep this CPU's convention
+void adopt_registers(CPUState &state, const CPUState &reference, uint8_t mask) {
+    const uint8_t p = static_cast<uint8_t>((reference.P & mask) | (state.P & ~mask));
+    state = reference;
+    state.P = p;
+}
+
+bool registers_match(const CPUState &expected, const CPUState &actual, uint8_t mask) {
+    return expected.PC == actual.PC && expected.A == actual.A && expected.X == actual.X &&
+           expected.Y == actual.Y && expected.SP == actual.SP &&
+           ((expected.P ^ actual.P) & mask) == 0;
+}
+
+// Comma-separated "NAME: trace $xx, emulator $yy" for each register that differs
+std::string register_differences(const CPUState &expected, const CPUState &actual,
+                                 uint8_t mask) {
+    std::ostringstream oss;
+    oss << std::hex << std::uppercase << std::setfill('0');
+    auto field = [&oss](const char *name, unsigned expected_value, unsigned actual_value,
+                        int width) {
+        if (expected_value == actual_value) {
+            return;
+        }
+        if (oss.tellp() > 0) {
+            oss << ", ";
+        }
+        oss << name << ": trace $" << std::setw(width) << expected_value << ", emulator $"
+            << std::setw(width) << actual_value;
+    };
+    field("PC", expected.PC, actual.PC, 4);
+    field("A", expected.A, actual.A, 2);
+    field("X", expected.X, actual.X, 2);
+    field("Y", expected.Y, actual.Y, 2);
+    field("SP", expected.SP, actual.SP, 2);
+    field("P", expected.P & mask, actual.P & mask, 2);
+    return oss.str();
+}
+
+// Collapse back-to-back writes to one address into the last; returns the count
+size_t fold_writes(std::span<TraceWrite> writes) {
+    size_t count = 0;
+    for (const TraceWrite &write : writes) {
+        if (count > 0 && writes[count - 1].address == write.address) {
+            writes[count - 1] = write;
+        } else {
+            writes[count++] = write;
+        }
+    }
+    return count;
+}
+
+void print_writes(std::ostream &out, const char *label, std::span<const TraceWrite> writes) {
+    out << label;
+    if (writes.empty()) {
+        out << " (none)";
+    }
+    for (const TraceWrite &write : writes) {
+        out << " $" << std::setw(4) << write.address << "=$" << std::setw(2)
+            << static_cast<int>(write.value);
+    }
+    out << std::endl;
+}
+
+} // namespace
+
+LockstepResult run_lockstep(ReferenceTrace &trace, Bus &bus, const LockstepOptions &options) {
+    LockstepResult result;
+    const std::span<const uint8_t> image = trace.memory_image();
+    bus.initialize_memory(0, std::vector<uint8_t>(image.begin(), image.end()));
+
+    LockstepBus lockstep_bus(bus);
+    BasicCPU<LockstepBus> cpu(lockstep_bus);
+    CPUState &state = cpu.state();
+
+    // Ring of the last options.context records (index, registers)
+    std::vector<std::pair<uint64_t, CPUState>> ring(options.context);
+    TraceRecord record{};
+    std::array<TraceWrite, LockstepBus::MAX_WRITES> actual_writes{};
+
+    auto diverge = [&](uint64_t index, std::string reason) {
+        result.diverged = true;
+        result.index = index;
+        result.reason = std::move(reason);
+        result.expected = record;
+        const size_t kept = std::min<uint64_t>(index, ring.size());
+        for (uint64_t i = index - kept; i < index; ++i) {
+            result.history.push_back(ring[i % ring.size()]);
+        }
+    };
+
+    trace.rewind();
+    uint64_t index = 0;
+    for (; options.max_records == 0 || index < options.max_records; ++index) {
+        if (!trace.next(record)) {
+            break;
+        }
+
+        if (index == 0) {
+            adopt_registers(state, record.state, options.flag_mask);
+        } else if (!registers_match(record.state, state, options.flag_mask)) {
+            if (!options.sync_io_reads || !lockstep_bus.io_read() ||
+                state.PC != record.state.PC) {
+                result.actual = state;
+                diverge(index, "registers differ after the previous instruction: " +
+                                   register_differences(record.state, state, options.flag_mask));
+                break;
+            }
+            adopt_registers(state, record.state, options.flag_mask);
+            result.io_syncs++;
+        }
+
+        result.actual = state;
+        lockstep_bus.begin_instruction();
+        if (!cpu.step()) {
+            diverge(index, "emulator halted (trap opcode with no handler)");
+            break;
+        }
+
+        const std::span<const TraceWrite> made = lockstep_bus.writes();
+        std::copy(made.begin(), made.end(), actual_writes.begin());
+        const size_t actual_count = fold_writes({actual_writes.data(), made.size()});
+        record.write_count =
+            static_cast<uint8_t>(fold_writes({record.writes.data(), record.write_count}));
+        if (!std::equal(actual_writes.begin(), actual_writes.begin() + actual_count,
+                        record.writes.begin(), record.writes.begin() + record.write_count)) {
+            result.actual_writes.assign(actual_writes.begin(),
+                                        actual_writes.begin() + actual_count);
+            diverge(index, "memory writes differ");
+            break;
+        }
+
+        if (!ring.empty()) {
+            ring[index % ring.size()] = {index, record.state};
+        }
+    }
+
+    result.records = index;
+    result.truncated = trace.truncated();
+    return result;
+}
+
+void print_lockstep_report(std::ostream &out, const LockstepResult &result, const Bus &bus) {
+    if (!result.diverged) {
+        out << std::dec << "Lockstep: " << result.records << " instructions matched ("
+            << result.io_syncs << " register syncs after I/O reads)" << std::endl;
+        if (result.truncated) {
+            out << "Warning: the trace ends in a partial record" << std::endl;
+        }
+        return;
+    }
+
+    out << std::dec << "Divergence at instruction " << result.index << ": " << result.reason
+        << std::endl;
+    out << std::endl << "Trace before the divergence:" << std::endl;
+    for (const auto &[index, state] : result.history) {
+        out << std::dec << "  [" << index << "] " << TrapManager::dump_cpu_state(state) << "    "
+            << format_disassembly(bus, state.PC) << std::endl;
+    }
+    out << std::dec << "  [" << result.index << "] "
+        << TrapManager::dump_cpu_state(result.expected.state) << "    "
+        << format_disassembly(bus, result.expected.state.PC) << std::endl;
+
+    out << std::endl << "Emulator: " << TrapManager::dump_cpu_state(result.actual) << std::endl;
+    if (!result.actual_writes.empty() || result.expected.write_count != 0) {
+        out << std::hex << std::uppercase << std::setfill('0');
+        print_writes(out, "Trace writes:   ", result.expected.write_span());
+        print_writes(out, "Emulator writes:", result.actual_writes);
+        out << std::dec << std::setfill(' ');
+    }
+}
+
+} // namespace edasm
@@ -0,0 +1,209 @@
+/**
+ * @file log.cpp
+ * @brief Emulator logging implementation
+ *
+ * The ring holds QUEUE_CAPACITY records. The producer owns tail_ and the
+ * consumer owns head_; both are free-running 32-bit counters (the capacity
+ * divides 2^32, so wraparound is harmless). The writer sleeps on wake_ with
+ * std::atomic::wait when the ring is empty, and flush() sleeps on written_.
+ */
+
+#include "edasm/emulator/log.hpp"
+
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+namespace edasm {
+
+namespace {
+
+constexpr uint32_t QUEUE_CAPACITY = 4096;
+
+struct Record {
+    LogLevel level;
+    LogCategory category;
+    std::string message;
+};
+
+constexpr const char *CATEGORY_NAMES[] = {"cpu", "trap", "mli", "io", "lc"};
+static_assert(std::size(CATEGORY_NAMES) == static_cast<size_t>(LogCategory::COUNT));
+
+std::ostream &stream_for(LogLevel level) {
+    return level >= LogLevel::WARNING ? std::cerr : std::cout;
+}
+
+class AsyncWriter {
+  public:
+    ~AsyncWriter() {
+        if (running()) {
+            stop();
+        }
+    }
+
+    void start() {
+        stopping_.store(false);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        stopping_.store(true);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    bool running() const {
+        return thread_.joinable();
+    }
+
+    // Producer: never blocks; a full ring drops the record
+    void push(Record &&record) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == QUEUE_CAPACITY) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        slots_[tail % QUEUE_CAPACITY] = std::move(record);
+        tail_.store(tail + 1, std::memory_order_release);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+    }
+
+    void flush() {
+        const uint32_t target = tail_.load(std::memory_order_relaxed);
+        for (uint32_t done = written_.load(std::memory_order_acquire); done != target;
+             done = written_.load(std::memory_order_acquire)) {
+            written_.wait(done, std::memory_order_acquire);
+        }
+    }
+
+    uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::array<Record, QUEUE_CAPACITY> slots_;
+    alignas(64) std::atomic<uint32_t> head_{0};
+    alignas(64) std::atomic<uint32_t> tail_{0};
+    alignas(64) std::atomic<uint32_t> wake_{0};
+    std::atomic<uint32_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+
+    void run() {
+        for (;;) {
+            const uint32_t wake = wake_.load(std::memory_order_acquire);
+            uint32_t head = head_.load(std::memory_order_relaxed);
+            const uint32_t tail = tail_.load(std::memory_order_acquire);
+            if (head != tail) {
+                for (; head != tail; ++head) {
+                    Record &record = slots_[head % QUEUE_CAPACITY];
+                    stream_for(record.level) << record.message << '\n';
+                    record.message = std::string();
+                    head_.store(head + 1, std::memory_order_release);
+                }
+                std::cout.flush();
+                std::cerr.flush();
+                written_.store(tail, std::memory_order_release);
+                written_.notify_all();
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire)) {
+                return;
+            }
+            wake_.wait(wake, std::memory_order_acquire);
+        }
+    }
+};
+
+AsyncWriter &writer() {
+    static AsyncWriter instance;
+    return instance;
+}
+
+} // namespace
+
+void Log::write(LogLevel level, LogCategory category, std::string message) {
+    AsyncWriter &async = writer();
+    if (async.running()) {
+        async.push(Record{level, category, std::move(message)});
+        return;
+    }
+    stream_for(level) << message << std::endl;
+}
+
+void Log::set_category_enabled(LogCategory category, bool enabled) {
+    const uint32_t bit = 1u << static_cast<unsigned>(category);
+    s_categories = enabled ? (s_categories | bit) : (s_categories & ~bit);
+}
+
+bool Log::set_categories(const std::string &list) {
+    uint32_t categories = 0;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) {
+            comma = list.size();
+        }
+        const std::string name = list.substr(pos, comma - pos);
+        if (name == "all") {
+            categories = ~0u;
+        } else {
+            size_t i = 0;
+            while (i < std::size(CATEGORY_NAMES) && name != CATEGORY_NAMES[i]) {
+                i++;
+            }
+            if (i == std::size(CATEGORY_NAMES)) {
+                return false;
+            }
+            categories |= 1u << i;
+        }
+        pos = comma + 1;
+    }
+    s_categories = categories;
+    return true;
+}
+
+const char *Log::category_name(LogCategory category) {
+    const auto index = static_cast<size_t>(category);
+    return index < std::size(CATEGORY_NAMES) ? CATEGORY_NAMES[index] : "?";
+}
+
+void Log::start_async() {
+    if (!writer().running()) {
+        std::cout.flush();
+        writer().start();
+    }
+}
+
+void Log::stop_async() {
+    AsyncWriter &async = writer();
+    if (!async.running()) {
+        return;
+    }
+    async.flush();
+    async.stop();
+    if (async.dropped() != 0) {
+        std::cerr << async.dropped() << " log records dropped (queue full)" << std::endl;
+    }
+}
+
+bool Log::is_async() {
+    return writer().running();
+}
+
+void Log::flush() {
+    if (writer().running()) {
+        writer().flush();
+    }
+}
+
+uint64_t Log::dropped() {
+    return writer().dropped();
+}
+
+} // namespace edasm
@@ -10,6 +10,7 @@
 
 #include "edasm/emulator/mli.hpp"
 #include "edasm/constants.hpp"
+#include "edasm/emulator/log.hpp"
 #include "edasm/emulator/traps.hpp"
 #include "edasm/files/file_types.hpp"
 #include <algorithm>
@@ -84,15 +85,19 @@ std::string prodos_path_to_host(const std::string &prodos_path) {
 }
 
 void dump_file_table() {
-    std::cerr << "=== FILE TABLE DUMP ===" << std::endl;
+    if (!Log::enabled(LogLevel::WARNING, LogCategory::MLI)) {
+        return;
+    }
+    std::ostringstream oss;
+    oss << "=== FILE TABLE DUMP ===\n";
     for (size_t i = 0; i < s_file_table.size(); ++i) {
         const auto &entry = s_file_table[i];
-        std::cerr << "  [" << i << "] used=" << entry.used << " fp=" << std::hex
-                  << reinterpret_cast<uintptr_t>(entry.fp) << std::dec << " host_path=\""
-                  << entry.host_path << "\" mark=" << entry.mark << " size=" << entry.file_size
-                  << std::endl;
+        oss << "  [" << i << "] used=" << entry.used << " fp=" << std::hex
+            << reinterpret_cast<uintptr_t>(entry.fp) << std::dec << " host_path=\""
+            << entry.host_path << "\" mark=" << entry.mark << " size=" << entry.file_size << "\n";
     }
-    std::cerr << "=======================\n" << std::endl;
+    oss << "=======================\n";
+    EDASM_LOG(WARNING, MLI, oss.str());
 }
 
 int alloc_refnum() {
@@ -101,21 +106,22 @@ int alloc_refnum() {
             return static_cast<int>(i);
         }
     }
-    std::cerr << "alloc_refnum: No free file slots available" << std::endl;
+    EDASM_LOG(WARNING, MLI, "alloc_refnum: No free file slots available");
     dump_file_table();
     return -1;
 }
 
 FileEntry *get_refnum(uint8_t refnum) {
     if (refnum == 0 || refnum >= s_file_table.size()) {
-        std::cerr << "get_refnum: Invalid refnum " << static_cast<int>(refnum)
-                  << " (valid range: 1-" << (s_file_table.size() - 1) << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "get_refnum: Invalid refnum " << static_cast<int>(refnum) << " (valid range: 1-"
+                      << (s_file_table.size() - 1) << ")");
         dump_file_table();
         return nullptr;
     }
     if (!s_file_table[refnum].used) {
-        std::cerr << "get_refnum: Refnum " << static_cast<int>(refnum) << " is not in use"
-                  << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "get_refnum: Refnum " << static_cast<int>(refnum) << " is not in use");
         dump_file_table();
         return nullptr;
     }
@@ -632,8 +638,9 @@ void MLIHandler::write_output_params(Bus &bus, uint16_t param_list_addr,
     }
 
     if (values.size() != expected_outputs) {
-        std::cerr << "Warning: Parameter count mismatch in write_output_params - expected "
-                  << expected_outputs << " got " << values.size() << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "Warning: Parameter count mismatch in write_output_params - expected "
+                      << expected_outputs << " got " << values.size());
         // Continue but be defensive: only process as many as provided
     }
 
@@ -762,8 +769,8 @@ ProDOSError MLIHandler::handle_set_prefix(Bus &bus, const std::vector<MLIParamVa
     }
 
     if (prodos_path.length() > 64) {
-        std::cerr << "SET_PREFIX ($C6): path too long (" << prodos_path.length() << " > 64)"
-                  << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "SET_PREFIX ($C6): path too long (" << prodos_path.length() << " > 64)");
         return ProDOSError::INVALID_PATH_SYNTAX;
     }
 
@@ -774,13 +781,14 @@ ProDOSError MLIHandler::handle_set_prefix(Bus &bus, const std::vector<MLIParamVa
     std::filesystem::path verify =
         ec ? (std::filesystem::path(current_prefix()) / target) : canonical;
     if (!std::filesystem::is_directory(verify)) {
-        std::cerr << "SET_PREFIX ($C6): directory does not exist: " << verify.string() << std::endl;
+        EDASM_LOG(WARNING, MLI, "SET_PREFIX ($C6): directory does not exist: " << verify.string());
         return ProDOSError::PATH_NOT_FOUND;
     }
 
     if (::chdir(target.c_str()) != 0) {
-        std::cerr << "SET_PREFIX ($C6): chdir failed: " << ::strerror(errno) << " (path='"
-                  << target.string() << "')" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "SET_PREFIX ($C6): chdir failed: " << ::strerror(errno) << " (path='"
+                                                     << target.string() << "')");
         return ProDOSError::PATH_NOT_FOUND;
     }
 
@@ -796,7 +804,7 @@ ProDOSError MLIHandler::handle_get_prefix(Bus &bus, const std::vector<MLIParamVa
 
     char cwd_buf[PATH_MAX] = {0};
     if (!::getcwd(cwd_buf, sizeof(cwd_buf))) {
-        std::cerr << "GET_PREFIX: getcwd failed: " << ::strerror(errno) << std::endl;
+        EDASM_LOG(WARNING, MLI, "GET_PREFIX: getcwd failed: " << ::strerror(errno));
         return ProDOSError::IO_ERROR;
     }
 
@@ -809,8 +817,9 @@ ProDOSError MLIHandler::handle_get_prefix(Bus &bus, const std::vector<MLIParamVa
     }
 
     if (prefix_str.length() > 64) {
-        std::cerr << "GET_PREFIX: prefix too long (" << prefix_str.length()
-                  << " chars exceeds 64 byte limit)" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "GET_PREFIX: prefix too long (" << prefix_str.length()
+                                                  << " chars exceeds 64 byte limit)");
         return ProDOSError::INVALID_PATH_SYNTAX;
     }
 
@@ -835,7 +844,7 @@ ProDOSError MLIHandler::handle_open(Bus &bus, const std::vector<MLIParamValue> &
 
     int ref = alloc_refnum();
     if (ref < 0) {
-        std::cerr << "OPEN ($C8): too many files open" << std::endl;
+        EDASM_LOG(WARNING, MLI, "OPEN ($C8): too many files open");
         return ProDOSError::FCB_FULL;
     }
 
@@ -844,7 +853,7 @@ ProDOSError MLIHandler::handle_open(Bus &bus, const std::vector<MLIParamValue> &
         fp = std::fopen(host_path.c_str(), "rb");
     }
     if (!fp) {
-        std::cerr << "OPEN ($C8): file not found: " << host_path << std::endl;
+        EDASM_LOG(WARNING, MLI, "OPEN ($C8): file not found: " << host_path);
         return ProDOSError::FILE_NOT_FOUND;
     }
 
@@ -871,28 +880,29 @@ ProDOSError MLIHandler::handle_read(Bus &bus, const std::vector<MLIParamValue> &
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "READ ($CA): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")"
-                  << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "READ ($CA): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")");
         outputs.push_back(uint16_t(0)); // trans_count = 0 on error
         return ProDOSError::INVALID_REF_NUM;
     }
 
     if (data_buffer + request_count > Bus::MEMORY_SIZE) {
-        std::cerr << "READ ($CA): buffer overflow (data_buffer=$" << std::hex << std::uppercase
-                  << std::setw(4) << std::setfill('0') << data_buffer
-                  << ", request_count=" << std::dec << request_count << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "READ ($CA): buffer overflow (data_buffer=$" << std::hex << std::uppercase
+                      << std::setw(4) << std::setfill('0') << data_buffer << ", request_count="
+                      << std::dec << request_count << ")");
         outputs.push_back(uint16_t(0)); // trans_count = 0 on error
         return ProDOSError::BAD_BUFFER_ADDR;
     }
 
     if (!entry->fp) {
-        std::cerr << "READ ($CA): file not open" << std::endl;
+        EDASM_LOG(WARNING, MLI, "READ ($CA): file not open");
         outputs.push_back(uint16_t(0)); // trans_count = 0 on error
         return ProDOSError::INVALID_REF_NUM;
     }
 
     if (std::fseek(entry->fp, static_cast<long>(entry->mark), SEEK_SET) != 0) {
-        std::cerr << "READ ($CA): fseek failed" << std::endl;
+        EDASM_LOG(WARNING, MLI, "READ ($CA): fseek failed");
         outputs.push_back(uint16_t(0)); // trans_count = 0 on error
         return ProDOSError::IO_ERROR;
     }
@@ -913,27 +923,20 @@ ProDOSError MLIHandler::handle_read(Bus &bus, const std::vector<MLIParamValue> &
         actual_read = static_cast<uint16_t>(n);
 
         // Check for newline character if newline mode is enabled
-        bool newline_found = false;
         if (entry->newline_enable_mask != 0x00) {
             for (uint16_t i = 0; i < actual_read; ++i) {
-                uint8_t ch = buffer[i];
-                bus.write(static_cast<uint16_t>(data_buffer + i), ch);
-
                 // Check if this character matches the newline char (after masking)
-                if ((ch & entry->newline_enable_mask) == entry->newline_char) {
+                if ((buffer[i] & entry->newline_enable_mask) == entry->newline_char) {
                     // Found newline - terminate read after this character
                     actual_read = i + 1;
-                    newline_found = true;
                     break;
                 }
             }
-        } else {
-            // Newline mode disabled - just copy all bytes
-            for (uint16_t i = 0; i < actual_read; ++i) {
-                bus.write(static_cast<uint16_t>(data_buffer + i), buffer[i]);
-            }
         }
 
+        // Copy the transferred bytes into 6502 memory in one block
+        bus.write_block(data_buffer, std::span<const uint8_t>(buffer.data(), actual_read));
+
         entry->mark += actual_read;
     }
 
@@ -953,33 +956,32 @@ ProDOSError MLIHandler::handle_write(Bus &bus, const std::vector<MLIParamValue>
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "WRITE ($CB): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")"
-                  << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "WRITE ($CB): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
 
     if (data_buffer + request_count > Bus::MEMORY_SIZE) {
-        std::cerr << "WRITE ($CB): buffer overflow (data_buffer=$" << std::hex << std::uppercase
-                  << std::setw(4) << std::setfill('0') << data_buffer
-                  << ", request_count=" << std::dec << request_count << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "WRITE ($CB): buffer overflow (data_buffer=$" << std::hex << std::uppercase
+                      << std::setw(4) << std::setfill('0') << data_buffer << ", request_count="
+                      << std::dec << request_count << ")");
         return ProDOSError::BAD_BUFFER_ADDR;
     }
 
     if (!entry->fp) {
-        std::cerr << "WRITE ($CB): file not open" << std::endl;
+        EDASM_LOG(WARNING, MLI, "WRITE ($CB): file not open");
         return ProDOSError::INVALID_REF_NUM;
     }
 
     if (std::fseek(entry->fp, static_cast<long>(entry->mark), SEEK_SET) != 0) {
-        std::cerr << "WRITE ($CB): fseek failed" << std::endl;
+        EDASM_LOG(WARNING, MLI, "WRITE ($CB): fseek failed");
         return ProDOSError::IO_ERROR;
     }
 
     // Read data from bus memory into buffer
     std::vector<uint8_t> buffer(request_count);
-    for (uint16_t i = 0; i < request_count; ++i) {
-        buffer[i] = bus.read(static_cast<uint16_t>(data_buffer + i));
-    }
+    bus.read_block(data_buffer, buffer);
 
     size_t actual_written = std::fwrite(buffer.data(), 1, request_count, entry->fp);
     uint16_t trans_count = static_cast<uint16_t>(actual_written);
@@ -1012,8 +1014,8 @@ ProDOSError MLIHandler::handle_close(Bus &bus, const std::vector<MLIParamValue>
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "CLOSE ($CC): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")"
-                  << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "CLOSE ($CC): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
 
@@ -1036,8 +1038,8 @@ ProDOSError MLIHandler::handle_flush(Bus &bus, const std::vector<MLIParamValue>
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "FLUSH ($CD): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")"
-                  << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "FLUSH ($CD): invalid refnum (" << std::dec << static_cast<int>(refnum) << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
 
@@ -1055,8 +1057,9 @@ ProDOSError MLIHandler::handle_set_mark(Bus &bus, const std::vector<MLIParamValu
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "SET_MARK ($CE): invalid refnum (" << std::dec << static_cast<int>(refnum)
-                  << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "SET_MARK ($CE): invalid refnum (" << std::dec << static_cast<int>(refnum)
+                                                     << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
     entry->mark = std::min<uint32_t>(new_mark, entry->file_size);
@@ -1069,8 +1072,9 @@ ProDOSError MLIHandler::handle_get_mark(Bus &bus, const std::vector<MLIParamValu
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "GET_MARK ($CF): invalid refnum (" << std::dec << static_cast<int>(refnum)
-                  << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "GET_MARK ($CF): invalid refnum (" << std::dec << static_cast<int>(refnum)
+                                                     << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
 
@@ -1084,8 +1088,9 @@ ProDOSError MLIHandler::handle_get_eof(Bus &bus, const std::vector<MLIParamValue
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "GET_EOF ($D1): invalid refnum (" << std::dec << static_cast<int>(refnum)
-                  << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "GET_EOF ($D1): invalid refnum (" << std::dec << static_cast<int>(refnum)
+                                                    << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
 
@@ -1102,8 +1107,9 @@ ProDOSError MLIHandler::handle_get_file_info(Bus &bus, const std::vector<MLIPara
     std::error_code ec;
     bool exists = std::filesystem::exists(host_path, ec);
     if (!exists || ec) {
-        std::cerr << "GET_FILE_INFO ($C4): file not found: " << host_path
-                  << " (error: " << ec.message() << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "GET_FILE_INFO ($C4): file not found: " << host_path
+                                                          << " (error: " << ec.message() << ")");
         // Push zero placeholders for all 10 output parameters
         outputs.push_back(uint8_t(0));  // access
         outputs.push_back(uint8_t(0));  // file_type
@@ -1155,8 +1161,9 @@ ProDOSError MLIHandler::handle_get_file_info(Bus &bus, const std::vector<MLIPara
         // Regular file handling
         auto file_size = std::filesystem::file_size(host_path, ec);
         if (ec) {
-            std::cerr << "GET_FILE_INFO ($C4): cannot get file size: " << host_path
-                      << " (error: " << ec.message() << ")" << std::endl;
+            EDASM_LOG(WARNING, MLI,
+                      "GET_FILE_INFO ($C4): cannot get file size: " << host_path << " (error: "
+                          << ec.message() << ")");
             // Push zero placeholders for all 10 output parameters
             outputs.push_back(uint8_t(0));  // access
             outputs.push_back(uint8_t(0));  // file_type
@@ -1200,31 +1207,31 @@ ProDOSError MLIHandler::handle_get_file_info(Bus &bus, const std::vector<MLIPara
 
 ProDOSError MLIHandler::handle_alloc_interrupt(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                                std::vector<MLIParamValue> &outputs) {
-    std::cerr << "ALLOC_INTERRUPT ($40): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "ALLOC_INTERRUPT ($40): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_dealloc_interrupt(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                                  std::vector<MLIParamValue> &outputs) {
-    std::cerr << "DEALLOC_INTERRUPT ($41): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "DEALLOC_INTERRUPT ($41): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_quit(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                     std::vector<MLIParamValue> &outputs) {
-    std::cerr << "QUIT ($65): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "QUIT ($65): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_read_block(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                           std::vector<MLIParamValue> &outputs) {
-    std::cerr << "READ_BLOCK ($80): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "READ_BLOCK ($80): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_write_block(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                            std::vector<MLIParamValue> &outputs) {
-    std::cerr << "WRITE_BLOCK ($81): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "WRITE_BLOCK ($81): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
@@ -1270,13 +1277,13 @@ ProDOSError MLIHandler::handle_create(Bus &bus, const std::vector<MLIParamValue>
 
 ProDOSError MLIHandler::handle_destroy(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                        std::vector<MLIParamValue> &outputs) {
-    std::cerr << "DESTROY ($C1): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "DESTROY ($C1): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_rename(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                       std::vector<MLIParamValue> &outputs) {
-    std::cerr << "RENAME ($C2): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "RENAME ($C2): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
@@ -1302,7 +1309,7 @@ ProDOSError MLIHandler::handle_set_file_info(Bus &bus, const std::vector<MLIPara
 
     // Check if file exists
     if (!std::filesystem::exists(host_path)) {
-        std::cerr << "SET_FILE_INFO ($C3): file not found: " << host_path << std::endl;
+        EDASM_LOG(WARNING, MLI, "SET_FILE_INFO ($C3): file not found: " << host_path);
         return ProDOSError::FILE_NOT_FOUND;
     }
 
@@ -1315,22 +1322,18 @@ ProDOSError MLIHandler::handle_set_file_info(Bus &bus, const std::vector<MLIPara
     // and returns success. This allows ProDOS programs that call SET_FILE_INFO
     // to continue running without errors.
 
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "SET_FILE_INFO ($C3): " << prodos_path 
-                  << " (access=$" << std::hex << std::setw(2) << std::setfill('0') 
-                  << static_cast<int>(access)
-                  << ", type=$" << std::hex << std::setw(2) << std::setfill('0')
-                  << static_cast<int>(file_type)
-                  << ", aux=$" << std::hex << std::setw(4) << std::setfill('0')
-                  << aux_type << ")" << std::endl;
-    }
+    EDASM_LOG(TRACE, MLI,
+              "SET_FILE_INFO ($C3): " << prodos_path << " (access=$" << std::hex << std::setw(2)
+                                      << std::setfill('0') << static_cast<int>(access)
+                                      << ", type=$" << std::setw(2) << static_cast<int>(file_type)
+                                      << ", aux=$" << std::setw(4) << aux_type << ")");
 
     return ProDOSError::NO_ERROR;
 }
 
 ProDOSError MLIHandler::handle_online(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                       std::vector<MLIParamValue> &outputs) {
-    std::cerr << "ONLINE ($C5): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "ONLINE ($C5): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
@@ -1340,18 +1343,18 @@ ProDOSError MLIHandler::handle_newline(Bus &bus, const std::vector<MLIParamValue
     uint8_t enable_mask = std::get<uint8_t>(inputs[1]);
     uint8_t newline_char = std::get<uint8_t>(inputs[2]);
 
-    if (TrapManager::is_trace_enabled()) {
-        std::cout << "NEWLINE ($C9): refnum=" << std::dec << static_cast<int>(refnum)
-                  << ", enable_mask=$" << std::hex << std::uppercase << std::setw(2)
-                  << std::setfill('0') << static_cast<int>(enable_mask) << ", newline_char=$"
-                  << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
-                  << static_cast<int>(newline_char) << std::endl;
-    }
+    EDASM_LOG(TRACE, MLI,
+              "NEWLINE ($C9): refnum=" << std::dec << static_cast<int>(refnum)
+                                       << ", enable_mask=$" << std::hex << std::uppercase
+                                       << std::setw(2) << std::setfill('0')
+                                       << static_cast<int>(enable_mask) << ", newline_char=$"
+                                       << std::setw(2) << static_cast<int>(newline_char));
 
     FileEntry *entry = get_refnum(refnum);
     if (!entry) {
-        std::cerr << "NEWLINE ($C9): invalid refnum (" << std::dec << static_cast<int>(refnum)
-                  << ")" << std::endl;
+        EDASM_LOG(WARNING, MLI,
+                  "NEWLINE ($C9): invalid refnum (" << std::dec << static_cast<int>(refnum)
+                                                    << ")");
         return ProDOSError::INVALID_REF_NUM;
     }
 
@@ -1359,15 +1362,14 @@ ProDOSError MLIHandler::handle_newline(Bus &bus, const std::vector<MLIParamValue
     entry->newline_enable_mask = enable_mask;
     entry->newline_char = newline_char;
 
-    if (TrapManager::is_trace_enabled()) {
-        if (enable_mask == 0x00) {
-            std::cout << "NEWLINE ($C9): newline mode DISABLED" << std::endl;
-        } else {
-            std::cout << "NEWLINE ($C9): newline mode ENABLED, char=$" << std::hex << std::uppercase
-                      << std::setw(2) << std::setfill('0') << static_cast<int>(newline_char)
-                      << ", mask=$" << std::hex << std::uppercase << std::setw(2)
-                      << std::setfill('0') << static_cast<int>(enable_mask) << std::endl;
-        }
+    if (enable_mask == 0x00) {
+        EDASM_LOG(TRACE, MLI, "NEWLINE ($C9): newline mode DISABLED");
+    } else {
+        EDASM_LOG(TRACE, MLI,
+                  "NEWLINE ($C9): newline mode ENABLED, char=$"
+                      << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+                      << static_cast<int>(newline_char) << ", mask=$" << std::setw(2)
+                      << static_cast<int>(enable_mask));
     }
 
     return ProDOSError::NO_ERROR;
@@ -1375,19 +1377,19 @@ ProDOSError MLIHandler::handle_newline(Bus &bus, const std::vector<MLIParamValue
 
 ProDOSError MLIHandler::handle_set_eof(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                        std::vector<MLIParamValue> &outputs) {
-    std::cerr << "SET_EOF ($D0): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "SET_EOF ($D0): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_set_buf(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                        std::vector<MLIParamValue> &outputs) {
-    std::cerr << "SET_BUF ($D2): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "SET_BUF ($D2): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
 ProDOSError MLIHandler::handle_get_buf(Bus &bus, const std::vector<MLIParamValue> &inputs,
                                        std::vector<MLIParamValue> &outputs) {
-    std::cerr << "GET_BUF ($D3): not implemented" << std::endl;
+    EDASM_LOG(WARNING, MLI, "GET_BUF ($D3): not implemented");
     return ProDOSError::BAD_CALL_NUMBER;
 }
 
@@ -1566,7 +1568,7 @@ std::string get_error_message(ProDOSError error) {
 // Log input parameters (first line)
 void log_mli_input(const MLICallDescriptor &desc, const std::vector<MLIParamValue> &inputs,
                    const Bus &bus, uint16_t param_list_addr) {
-    if (!TrapManager::is_trace_enabled())
+    if (!Log::enabled(LogLevel::TRACE, LogCategory::MLI))
         return;
 
     std::ostringstream oss;
@@ -1575,7 +1577,7 @@ void log_mli_input(const MLICallDescriptor &desc, const std::vector<MLIParamValu
 
     // Special case: GET_TIME has no parameter list
     if (desc.call_number == 0x82) {
-        std::cout << oss.str() << std::endl;
+        EDASM_LOG(TRACE, MLI, oss.str());
         return;
     }
 
@@ -1682,13 +1684,13 @@ void log_mli_input(const MLICallDescriptor &desc, const std::vector<MLIParamValu
     next_param:;
     }
 
-    std::cout << oss.str() << std::endl;
+    EDASM_LOG(TRACE, MLI, oss.str());
 }
 
 // Log output parameters and result (second line)
 void log_mli_output(const MLICallDescriptor &desc, const std::vector<MLIParamValue> &outputs,
                     ProDOSError error, const Bus &bus, uint16_t param_list_addr) {
-    if (!TrapManager::is_trace_enabled())
+    if (!Log::enabled(LogLevel::TRACE, LogCategory::MLI))
         return;
 
     // Special case: GET_TIME - log the ProDOS system date-time from the system page
@@ -1699,7 +1701,7 @@ void log_mli_output(const MLICallDescriptor &desc, const std::vector<MLIParamVal
 
         std::ostringstream oss;
         oss << "  Result: success datetime=" << prodos_datetime_to_iso8601(date_word, time_word);
-        std::cout << oss.str() << std::endl;
+        EDASM_LOG(TRACE, MLI, oss.str());
         return;
     }
 
@@ -1795,7 +1797,7 @@ void log_mli_output(const MLICallDescriptor &desc, const std::vector<MLIParamVal
         }
     }
 
-    std::cout << oss.str() << std::endl;
+    EDASM_LOG(TRACE, MLI, oss.str());
 }
 
 } // anonymous namespace
@@ -1846,6 +1848,7 @@ bool MLIHandler::prodos_mli_trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_
         }
 
         call_details_logged = true;
+        Log::flush();
 
         std::cout << std::endl;
         std::cout << "=== PRODOS MLI CALL DETECTED at PC=$BF00 ===" << std::endl;
@@ -2008,12 +2011,6 @@ bool MLIHandler::prodos_mli_trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_
         set_success(cpu);
     } else {
         // Log the error, dump memory, and halt
-        std::cout << "\n=== MLI CALL FAILED ===" << std::endl;
-        std::cout << "Call: $" << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
-                  << static_cast<int>(call_num) << " (" << desc->name << ")" << std::endl;
-        std::cout << "Error code: $" << std::hex << std::uppercase << std::setw(2)
-                  << std::setfill('0') << static_cast<int>(error) << std::endl;
-
         // Map error code to descriptive message
         const char *error_msg = "Unknown error";
         switch (error) {
@@ -2084,7 +2081,11 @@ bool MLIHandler::prodos_mli_trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_
             break;
         }
 
-        std::cout << "Message: " << error_msg << std::endl;
+        EDASM_LOG(INFO, MLI,
+                  "\n=== MLI CALL FAILED ===\nCall: $"
+                      << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+                      << static_cast<int>(call_num) << " (" << desc->name << ")\nError code: $"
+                      << std::setw(2) << static_cast<int>(error) << "\nMessage: " << error_msg);
 
         set_error(cpu, error);
 
@@ -0,0 +1,171 @@
+/**
+ * @file profiler.cpp
+ * @brief Call-graph profiler implementation
+ */
+
+#include "edasm/emulator/profiler.hpp"
+#include "edasm/assembler/opcode_specs.hpp"
+#include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/disassembly.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+namespace edasm {
+
+namespace {
+
+// 65C02 opcodes missing from the NMOS table cost the common 2 cycles
+constexpr uint8_t DEFAULT_CYCLES = 2;
+
+constexpr std::array<uint8_t, 256> build_cycle_table() {
+    std::array<uint8_t, 256> table{};
+    table.fill(DEFAULT_CYCLES);
+    for (const OpcodeSpec &spec : kOpcodeSpecs) {
+        table[spec.code] = spec.cycles;
+    }
+    table[Bus::TRAP_OPCODE] = 0;
+    return table;
+}
+
+} // namespace
+
+uint8_t CallProfiler::base_cycles(uint8_t opcode) {
+    static constexpr std::array<uint8_t, 256> table = build_cycle_table();
+    return table[opcode];
+}
+
+CallProfiler::CallProfiler(uint16_t root_pc) : total_cycles_(0) {
+    nodes_.push_back({root_pc, 0, 1, 0});
+    stack_.push_back({0, 0xFF});
+}
+
+uint32_t CallProfiler::child(uint32_t parent, uint16_t entry) {
+    const uint64_t key = (static_cast<uint64_t>(parent) << 16) | entry;
+    auto [it, inserted] = children_.try_emplace(key, static_cast<uint32_t>(nodes_.size()));
+    if (inserted) {
+        nodes_.push_back({entry, parent, 0, 0});
+    }
+    return it->second;
+}
+
+void CallProfiler::record(const CPUState &before, uint8_t opcode, const CPUState &after) {
+    // The instruction belongs to the routine it ran in, even JSR and RTS
+    const uint8_t cycles = base_cycles(opcode);
+    nodes_[stack_.back().node].self_cycles += cycles;
+    total_cycles_ += cycles;
+
+    // Return addresses above the stack pointer are gone: those frames returned
+    while (stack_.size() > 1 && after.SP > stack_.back().sp) {
+        stack_.pop_back();
+    }
+
+    const bool call = (opcode == 0x20 || opcode == 0x00) && after.SP < before.SP;
+    if (call) {
+        const uint32_t node = child(stack_.back().node, after.PC);
+        nodes_[node].calls++;
+        stack_.push_back({node, after.SP});
+    }
+}
+
+std::vector<CallProfiler::RoutineStats> CallProfiler::routines() const {
+    // Subtree totals: children always follow their parent in nodes_
+    std::vector<uint64_t> subtree(nodes_.size());
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        subtree[i] += nodes_[i].self_cycles;
+        if (i != 0) {
+            subtree[nodes_[i].parent] += subtree[i];
+        }
+    }
+
+    std::unordered_map<uint16_t, RoutineStats> by_entry;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const Node &node = nodes_[i];
+        RoutineStats &stats = by_entry.try_emplace(node.entry, RoutineStats{node.entry, 0, 0, 0})
+                                  .first->second;
+        stats.calls += node.calls;
+        stats.exclusive_cycles += node.self_cycles;
+
+        // A recursive call's subtree is already inside the outermost one
+        bool outermost = true;
+        for (size_t up = i; up != 0 && outermost;) {
+            up = nodes_[up].parent;
+            outermost = nodes_[up].entry != node.entry;
+        }
+        if (outermost) {
+            stats.inclusive_cycles += subtree[i];
+        }
+    }
+
+    std::vector<RoutineStats> result;
+    result.reserve(by_entry.size());
+    for (const auto &[entry, stats] : by_entry) {
+        result.push_back(stats);
+    }
+    std::sort(result.begin(), result.end(), [](const RoutineStats &a, const RoutineStats &b) {
+        return a.inclusive_cycles != b.inclusive_cycles ? a.inclusive_cycles > b.inclusive_cycles
+                                                        : a.entry < b.entry;
+    });
+    return result;
+}
+
+void CallProfiler::write_folded(std::ostream &out) const {
+    std::unordered_map<uint16_t, std::string> names;
+    auto name = [&names](uint16_t entry) -> const std::string & {
+        auto it = names.find(entry);
+        if (it == names.end()) {
+            it = names.emplace(entry, disassembly_address_name(entry)).first;
+        }
+        return it->second;
+    };
+
+    std::vector<uint32_t> path;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].self_cycles == 0) {
+            continue;
+        }
+        path.clear();
+        for (uint32_t at = static_cast<uint32_t>(i);; at = nodes_[at].parent) {
+            path.push_back(at);
+            if (at == 0) {
+                break;
+            }
+        }
+        for (size_t k = path.size(); k-- > 0;) {
+            out << name(nodes_[path[k]].entry) << (k != 0 ? ";" : " ");
+        }
+        out << std::dec << nodes_[i].self_cycles << "\n";
+    }
+}
+
+void CallProfiler::print_report(std::ostream &out, size_t limit) const {
+    const std::vector<RoutineStats> stats = routines();
+
+    out << std::dec << std::setfill(' ');
+    out << "\n=== CALL PROFILE (" << total_cycles_ << " cycles) ===" << std::endl;
+    out << std::left << std::setw(24) << "Routine"
+        << " " << std::right << std::setw(8) << "Calls"
+        << " " << std::setw(12) << "Inclusive"
+        << " " << std::setw(7) << "Incl%"
+        << " " << std::setw(12) << "Exclusive"
+        << " " << std::setw(7) << "Excl%" << std::endl;
+    out << std::string(75, '-') << std::endl;
+
+    auto percent = [this](uint64_t cycles) {
+        return total_cycles_ ? 100.0 * static_cast<double>(cycles) / total_cycles_ : 0.0;
+    };
+    for (size_t i = 0; i < stats.size() && i < limit; ++i) {
+        const RoutineStats &s = stats[i];
+        out << std::left << std::setw(24) << disassembly_address_name(s.entry) << " "
+            << std::right << std::setw(8) << s.calls << " " << std::setw(12) << s.inclusive_cycles
+            << " " << std::setw(6) << std::fixed << std::setprecision(1)
+            << percent(s.inclusive_cycles) << "% " << std::setw(12) << s.exclusive_cycles << " "
+            << std::setw(6) << percent(s.exclusive_cycles) << "%" << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+} // namespace edasm
@@ -0,0 +1,295 @@
+/**
+ * @file reference_trace.cpp
+ * @brief Binary instruction traces from a reference emulator (MAME)
+ *
+ * See reference_trace.hpp for the file format.
+ */
+
+#include "edasm/emulator/reference_trace.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <istream>
+#include <ostream>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace edasm {
+
+namespace {
+
+constexpr char kMagic[4] = {'E', 'D', 'T', 'R'};
+constexpr size_t kRecordSize = 8;
+constexpr size_t kWriteSize = 3;
+constexpr size_t kWriterBufferSize = 1 << 20;
+
+void fail(std::string *error, std::string message) {
+    if (error) {
+        *error = std::move(message);
+    }
+}
+
+uint16_t get_u16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void put_u16(std::vector<char> &out, uint16_t v) {
+    out.push_back(static_cast<char>(v & 0xFF));
+    out.push_back(static_cast<char>(v >> 8));
+}
+
+// Parse exactly fields.size() whitespace-separated hex numbers
+bool parse_hex_fields(std::string_view text, std::span<unsigned long> fields) {
+    size_t pos = 0;
+    for (unsigned long &field : fields) {
+        pos = text.find_first_not_of(" \t", pos);
+        if (pos == std::string_view::npos) {
+            return false;
+        }
+        const char *end = text.data() + text.size();
+        const auto [ptr, ec] = std::from_chars(text.data() + pos, end, field, 16);
+        if (ec != std::errc() || (ptr != end && *ptr != ' ' && *ptr != '\t' && *ptr != '\r')) {
+            return false;
+        }
+        pos = static_cast<size_t>(ptr - text.data());
+    }
+    return true;
+}
+
+} // namespace
+
+// =========================================
+// ReferenceTrace
+// =========================================
+
+std::optional<ReferenceTrace> ReferenceTrace::open(const std::string &path, std::string *error) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail(error, "Cannot open file: " + path);
+        return std::nullopt;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize + kImageSize) {
+        ::close(fd);
+        fail(error, "Not a reference trace: " + path);
+        return std::nullopt;
+    }
+
+    void *mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        fail(error, "Cannot map file: " + path);
+        return std::nullopt;
+    }
+    // Records are read once, front to back: read ahead aggressively
+    ::madvise(mapping, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    ReferenceTrace trace;
+    trace.mapping_ = mapping;
+    trace.data_ = static_cast<const uint8_t *>(mapping);
+    trace.data_size_ = static_cast<size_t>(st.st_size);
+    if (!trace.attach(error)) {
+        return std::nullopt;
+    }
+    return trace;
+}
+
+std::optional<ReferenceTrace> ReferenceTrace::from_bytes(std::span<const uint8_t> data,
+                                                         std::string *error) {
+    ReferenceTrace trace;
+    trace.bytes_.assign(data.begin(), data.end());
+    trace.data_ = trace.bytes_.data();
+    trace.data_size_ = trace.bytes_.size();
+    if (!trace.attach(error)) {
+        return std::nullopt;
+    }
+    return trace;
+}
+
+bool ReferenceTrace::attach(std::string *error) {
+    if (data_size_ < kHeaderSize + kImageSize ||
+        !std::equal(std::begin(kMagic), std::end(kMagic), data_)) {
+        fail(error, "Not a reference trace");
+        return false;
+    }
+    if (get_u16(data_ + 4) != kFormatVersion) {
+        fail(error, "Unsupported reference trace version " + std::to_string(get_u16(data_ + 4)));
+        return false;
+    }
+    rewind();
+    return true;
+}
+
+ReferenceTrace::ReferenceTrace(ReferenceTrace &&other) noexcept {
+    *this = std::move(other);
+}
+
+ReferenceTrace &ReferenceTrace::operator=(ReferenceTrace &&other) noexcept {
+    if (this != &other) {
+        release();
+        // A moved vector keeps its buffer, so data_ stays valid
+        data_ = other.data_;
+        data_size_ = other.data_size_;
+        mapping_ = other.mapping_;
+        bytes_ = std::move(other.bytes_);
+        position_ = other.position_;
+        truncated_ = other.truncated_;
+        other.mapping_ = nullptr;
+        other.data_ = nullptr;
+        other.data_size_ = 0;
+        other.position_ = 0;
+    }
+    return *this;
+}
+
+ReferenceTrace::~ReferenceTrace() {
+    release();
+}
+
+void ReferenceTrace::release() {
+    if (mapping_) {
+        ::munmap(mapping_, data_size_);
+        mapping_ = nullptr;
+    }
+}
+
+bool ReferenceTrace::next(TraceRecord &record) {
+    const size_t remaining = data_size_ - position_;
+    if (remaining == 0) {
+        return false;
+    }
+    const uint8_t *p = data_ + position_;
+    if (remaining < kRecordSize || remaining < kRecordSize + p[7] * kWriteSize) {
+        truncated_ = true;
+        return false;
+    }
+
+    record.state.PC = get_u16(p);
+    record.state.A = p[2];
+    record.state.X = p[3];
+    record.state.Y = p[4];
+    record.state.SP = p[5];
+    record.state.P = p[6];
+    record.write_count = p[7];
+    const uint8_t *w = p + kRecordSize;
+    for (size_t i = 0; i < record.write_count; ++i, w += kWriteSize) {
+        record.writes[i] = TraceWrite{get_u16(w), w[2]};
+    }
+    position_ += kRecordSize + record.write_count * kWriteSize;
+    return true;
+}
+
+// =========================================
+// TraceWriter
+// =========================================
+
+TraceWriter::TraceWriter(std::ostream &out, std::span<const uint8_t> memory_image)
+    : out_(out), records_(0) {
+    buffer_.reserve(kWriterBufferSize);
+    buffer_.insert(buffer_.end(), std::begin(kMagic), std::end(kMagic));
+    put_u16(buffer_, ReferenceTrace::kFormatVersion);
+    put_u16(buffer_, 0);
+    std::array<uint8_t, ReferenceTrace::kImageSize> image{};
+    std::copy_n(memory_image.begin(), std::min(memory_image.size(), image.size()), image.begin());
+    buffer_.insert(buffer_.end(), image.begin(), image.end());
+}
+
+TraceWriter::~TraceWriter() {
+    flush();
+}
+
+void TraceWriter::add(const CPUState &state, std::span<const TraceWrite> writes) {
+    const size_t count = std::min<size_t>(writes.size(), 255);
+    put_u16(buffer_, state.PC);
+    const uint8_t fields[] = {state.A, state.X, state.Y, state.SP, state.P,
+                              static_cast<uint8_t>(count)};
+    buffer_.insert(buffer_.end(), std::begin(fields), std::end(fields));
+    for (size_t i = 0; i < count; ++i) {
+        put_u16(buffer_, writes[i].address);
+        buffer_.push_back(static_cast<char>(writes[i].value));
+    }
+    records_++;
+    if (buffer_.size() >= kWriterBufferSize) {
+        flush();
+    }
+}
+
+void TraceWriter::flush() {
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+// =========================================
+// MAME trace log conversion
+// =========================================
+
+bool convert_mame_trace(std::istream &log, std::span<const uint8_t> memory_image,
+                        std::ostream &out, std::string *error) {
+    TraceWriter writer(out, memory_image);
+    std::optional<CPUState> pending;
+    std::vector<TraceWrite> writes;
+
+    std::string text;
+    for (size_t line_number = 1; std::getline(log, text); ++line_number) {
+        const size_t start = text.find_first_not_of(" \t");
+        if (start == std::string::npos || start + 1 >= text.size() ||
+            (text[start] != 'S' && text[start] != 'W') ||
+            (text[start + 1] != ' ' && text[start + 1] != '\t')) {
+            continue; // MAME's disassembly and other output
+        }
+        const std::string_view fields = std::string_view(text).substr(start + 1);
+        auto malformed = [&]() {
+            fail(error, "Malformed trace line " + std::to_string(line_number) + ": " + text);
+            return false;
+        };
+
+        if (text[start] == 'S') {
+            std::array<unsigned long, 6> f{};
+            if (!parse_hex_fields(fields, f)) {
+                return malformed();
+            }
+            if (pending) {
+                writer.add(*pending, writes);
+            }
+            writes.clear();
+            CPUState state;
+            state.PC = static_cast<uint16_t>(f[0]);
+            state.A = static_cast<uint8_t>(f[1]);
+            state.X = static_cast<uint8_t>(f[2]);
+            state.Y = static_cast<uint8_t>(f[3]);
+            state.SP = static_cast<uint8_t>(f[4]); // MAME prints the stack pointer as $01xx
+            state.P = static_cast<uint8_t>(f[5]);
+            pending = state;
+        } else {
+            std::array<unsigned long, 2> f{};
+            if (!parse_hex_fields(fields, f)) {
+                return malformed();
+            }
+            if (!pending) {
+                continue; // Written before the first traced instruction
+            }
+            if (writes.size() == 255) {
+                fail(error, "More than 255 writes by one instruction at line " +
+                                std::to_string(line_number));
+                return false;
+            }
+            writes.push_back(TraceWrite{static_cast<uint16_t>(f[0]), static_cast<uint8_t>(f[1])});
+        }
+    }
+    if (pending) {
+        writer.add(*pending, writes);
+    }
+    writer.flush();
+    if (!out) {
+        fail(error, "Cannot write trace");
+        return false;
+    }
+    return true;
+}
+
+} // namespace edasm
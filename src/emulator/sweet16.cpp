@@ -0,0 +1,314 @@
+/**
+ * @file sweet16.cpp
+ * @brief Host-native SWEET16 interpreter implementation
+ *
+ * Follows the 6502 interpreter operation by operation, including its side
+ * effects on R14H (prior result register index * 2, carry in bit 0) and on
+ * R15, which points at the last byte fetched.
+ */
+
+#include "edasm/emulator/sweet16.hpp"
+#include "edasm/emulator/traps.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace edasm {
+
+namespace {
+
+// Zero page locations used by the 6502 interpreter
+constexpr uint16_t R14H = 0x1D;
+constexpr uint16_t R15 = 0x1E;
+constexpr uint16_t SAVE_ACC = 0x45; // SAVE: A, X, Y, P, S
+constexpr uint16_t SAVE_XREG = 0x46;
+constexpr uint16_t SAVE_YREG = 0x47;
+constexpr uint16_t SAVE_STATUS = 0x48;
+constexpr uint16_t SAVE_SPNT = 0x49;
+
+constexpr uint8_t RESULT_R0 = 0x00;
+constexpr uint8_t RESULT_R13 = 0x1A; // CPR result register * 2
+
+// Register n lives at $00 + 2n (low byte first). Every access goes to Bus
+// memory, in the order the 6502 version makes it, so bytecode that
+// addresses the registers (or R15) through a pointer behaves the same.
+class Registers {
+  public:
+    explicit Registers(Bus &bus) : bus_(bus) {}
+
+    uint16_t get(uint8_t n) const {
+        return bus_.read_word(static_cast<uint16_t>(n * 2));
+    }
+
+    void set(uint8_t n, uint16_t value) {
+        bus_.write_word(static_cast<uint16_t>(n * 2), value);
+    }
+
+    void set_low(uint8_t n, uint8_t value) {
+        bus_.write(static_cast<uint16_t>(n * 2), value);
+    }
+
+    void set_high(uint8_t n, uint8_t value) {
+        bus_.write(static_cast<uint16_t>(n * 2 + 1), value);
+    }
+
+    uint8_t low(uint8_t n) const {
+        return bus_.read(static_cast<uint16_t>(n * 2));
+    }
+
+    uint8_t high(uint8_t n) const {
+        return bus_.read(static_cast<uint16_t>(n * 2 + 1));
+    }
+
+    // Byte at the address held in Rn
+    uint8_t load(uint8_t n) const {
+        return bus_.read(get(n));
+    }
+
+    void store(uint8_t n, uint8_t value) {
+        bus_.write(get(n), value);
+    }
+
+    void inc(uint8_t n) {
+        set(n, static_cast<uint16_t>(get(n) + 1));
+    }
+
+    void dec(uint8_t n) {
+        set(n, static_cast<uint16_t>(get(n) - 1));
+    }
+
+    void set_result(uint8_t r14h) {
+        bus_.write(R14H, r14h);
+    }
+
+    uint8_t result() const {
+        return bus_.read(R14H);
+    }
+
+  private:
+    Bus &bus_;
+};
+
+} // namespace
+
+Sweet16::Sweet16(Bus &bus) : bus_(bus), calls_(0), instructions_(0) {}
+
+void Sweet16::install(uint16_t entry) {
+    // ROM addresses are only writable through the physical image
+    if (entry >= 0xD000) {
+        bus_.initialize_memory(entry, {Bus::TRAP_OPCODE});
+    } else {
+        bus_.write_binary_data(entry, {Bus::TRAP_OPCODE});
+    }
+    TrapManager::install_address_handler(
+        entry,
+        [this](CPUState &cpu, Bus &bus, uint16_t trap_pc) {
+            return this->trap_handler(cpu, bus, trap_pc);
+        },
+        "SWEET16");
+}
+
+bool Sweet16::trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_pc) {
+    TrapStatistics::record_trap("SWEET16", trap_pc, TrapKind::CALL);
+    calls_++;
+    if (!run(cpu, bus, &instructions_)) {
+        std::ostringstream oss;
+        oss << "SWEET16 BK at $" << std::hex << std::uppercase << std::setw(4)
+            << std::setfill('0') << static_cast<uint16_t>(bus.read_word(R15) - 1);
+        return TrapManager::halt_and_dump(oss.str(), cpu, bus, trap_pc);
+    }
+    return true;
+}
+
+bool Sweet16::run(CPUState &cpu, Bus &bus, uint64_t *instructions) {
+    Registers reg(bus);
+
+    // SAVE: the 6502 version preserves A, X, Y, P and S (after its own JSR)
+    bus.write(SAVE_ACC, cpu.A);
+    bus.write(SAVE_XREG, cpu.X);
+    bus.write(SAVE_YREG, cpu.Y);
+    bus.write(SAVE_STATUS, static_cast<uint8_t>(cpu.P | StatusFlags::B | StatusFlags::U));
+    bus.write(SAVE_SPNT, static_cast<uint8_t>(cpu.SP - 2));
+
+    // Pop the caller's return address (the JSR's last byte) into R15
+    cpu.SP = static_cast<uint8_t>(cpu.SP + 1);
+    uint16_t pc = bus.read(STACK_BASE | cpu.SP);
+    cpu.SP = static_cast<uint8_t>(cpu.SP + 1);
+    pc = static_cast<uint16_t>(pc | (bus.read(STACK_BASE | cpu.SP) << 8));
+
+    reg.set(15, pc);
+
+    uint64_t count = 0;
+    for (;;) {
+        // R15 points at the last byte fetched
+        reg.inc(15);
+        const uint8_t byte = bus.read(reg.get(15));
+        const uint8_t n = byte & 0x0F;
+        const uint8_t op = byte >> 4;
+        count++;
+
+        if (op != 0) {
+            // Register operations: Rn becomes the prior result register
+            reg.set_result(static_cast<uint8_t>(n * 2));
+            switch (op) {
+            case 0x1: { // SET Rn,const (then R15 += 2, even for SET R15)
+                const uint16_t at = reg.get(15);
+                reg.set_high(n, bus.read(static_cast<uint16_t>(at + 2)));
+                reg.set_low(n, bus.read(static_cast<uint16_t>(at + 1)));
+                reg.set(15, static_cast<uint16_t>(reg.get(15) + 2));
+                break;
+            }
+            case 0x2: // LD Rn
+                reg.set_low(0, reg.low(n));
+                reg.set_high(0, reg.high(n));
+                break;
+            case 0x3: // ST Rn
+                reg.set_low(n, reg.low(0));
+                reg.set_high(n, reg.high(0));
+                break;
+            case 0x4: // LD @Rn
+                reg.set_low(0, reg.load(n));
+                reg.set_high(0, 0);
+                reg.set_result(RESULT_R0);
+                reg.inc(n);
+                break;
+            case 0x5: // ST @Rn
+                reg.store(n, reg.low(0));
+                reg.set_result(RESULT_R0);
+                reg.inc(n);
+                break;
+            case 0x6: // LDD @Rn
+                reg.set_low(0, reg.load(n));
+                reg.set_high(0, 0);
+                reg.set_result(RESULT_R0);
+                reg.inc(n);
+                reg.set_high(0, reg.load(n));
+                reg.inc(n);
+                break;
+            case 0x7: // STD @Rn
+                reg.store(n, reg.low(0));
+                reg.set_result(RESULT_R0);
+                reg.inc(n);
+                reg.store(n, reg.high(0));
+                reg.inc(n);
+                break;
+            case 0x8: // POP @Rn
+                reg.dec(n);
+                reg.set_low(0, reg.load(n));
+                reg.set_high(0, 0);
+                reg.set_result(RESULT_R0);
+                break;
+            case 0x9: // STP @Rn
+                reg.dec(n);
+                reg.store(n, reg.low(0));
+                reg.set_result(RESULT_R0);
+                break;
+            case 0xA: { // ADD Rn
+                const uint32_t sum = static_cast<uint32_t>(reg.get(0)) + reg.get(n);
+                reg.set(0, static_cast<uint16_t>(sum));
+                reg.set_result(static_cast<uint8_t>(RESULT_R0 | (sum >> 16)));
+                break;
+            }
+            case 0xB:   // SUB Rn
+            case 0xD: { // CPR Rn (difference to R13)
+                const uint16_t a = reg.get(0);
+                const uint16_t b = reg.get(n);
+                const uint8_t target = op == 0xB ? RESULT_R0 : RESULT_R13;
+                reg.set(target / 2, static_cast<uint16_t>(a - b));
+                reg.set_result(static_cast<uint8_t>(target | (a >= b ? 1 : 0)));
+                break;
+            }
+            case 0xC: { // POPD @Rn
+                reg.dec(n);
+                const uint8_t hi = reg.load(n);
+                reg.dec(n);
+                reg.set_low(0, reg.load(n));
+                reg.set_high(0, hi);
+                reg.set_result(RESULT_R0);
+                break;
+            }
+            case 0xE: // INR Rn
+                reg.inc(n);
+                break;
+            case 0xF: // DCR Rn
+                reg.dec(n);
+                break;
+            }
+            continue;
+        }
+
+        // Non-register operations step R15 to a second byte (the branch
+        // displacement, ignored by RTN, RS and the no-ops)
+        reg.inc(15);
+        const uint8_t result = reg.result();
+        const bool carry = result & 1;
+        const uint16_t value = reg.get(static_cast<uint8_t>(result >> 1));
+        bool taken = false;
+
+        switch (n) {
+        case 0x0: // RTN: RESTORE leaves A, X, Y and P as saved
+            cpu.PC = reg.get(15);
+            if (instructions) {
+                *instructions += count;
+            }
+            return true;
+        case 0x1: // BR
+            taken = true;
+            break;
+        case 0x2: // BNC
+            taken = !carry;
+            break;
+        case 0x3: // BC
+            taken = carry;
+            break;
+        case 0x4: // BP
+            taken = (value & 0x8000) == 0;
+            break;
+        case 0x5: // BM
+            taken = (value & 0x8000) != 0;
+            break;
+        case 0x6: // BZ
+            taken = value == 0;
+            break;
+        case 0x7: // BNZ
+            taken = value != 0;
+            break;
+        case 0x8: // BM1
+            taken = value == 0xFFFF;
+            break;
+        case 0x9: // BNM1
+            taken = value != 0xFFFF;
+            break;
+        case 0xA: // BK
+            if (instructions) {
+                *instructions += count;
+            }
+            return false;
+        case 0xB: // RS: pop the return address through R12
+            reg.dec(12);
+            reg.set_high(15, reg.load(12));
+            reg.dec(12);
+            reg.set_low(15, reg.load(12));
+            break;
+        case 0xC: // BS: push R15 through R12, then branch
+            reg.store(12, reg.low(15));
+            reg.set_result(RESULT_R0);
+            reg.inc(12);
+            reg.store(12, reg.high(15));
+            reg.set_result(RESULT_R0);
+            reg.inc(12);
+            taken = true;
+            break;
+        default: // NUL
+            break;
+        }
+
+        if (taken) {
+            const uint16_t at = reg.get(15);
+            const auto displacement = static_cast<int8_t>(bus.read(at));
+            reg.set(15, static_cast<uint16_t>(at + displacement));
+        }
+    }
+}
+
+} // namespace edasm
@@ -10,6 +10,7 @@
 #include "edasm/constants.hpp"
 #include "edasm/emulator/disassembly.hpp"
 #include "edasm/emulator/host_shims.hpp"
+#include "edasm/emulator/log.hpp"
 #include "edasm/emulator/mli.hpp"
 #include <algorithm>
 #include <cstdio>
@@ -29,6 +30,7 @@ bool TrapManager::s_trace_enabled = false;
 
 void TrapManager::set_trace(bool enabled) {
     s_trace_enabled = enabled;
+    Log::set_level(enabled ? LogLevel::TRACE : LogLevel::INFO);
 }
 
 bool TrapManager::is_trace_enabled() {
@@ -81,8 +83,9 @@ bool TrapManager::general_trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_pc
         return ret;
     }
 
-    std::cerr << "Unknown CALL_TRAP address " << std::hex << std::uppercase << std::setw(4)
-              << std::setfill('0') << trap_pc << std::endl;
+    EDASM_LOG(WARNING, TRAP,
+              "Unknown CALL_TRAP address " << std::hex << std::uppercase << std::setw(4)
+                                           << std::setfill('0') << trap_pc);
     // Fall back to default handler (which will also record statistics)
     return default_trap_handler(cpu, bus, trap_pc);
 }
@@ -91,8 +94,9 @@ bool TrapManager::default_trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_pc
     // Record trap statistic for unhandled traps
     TrapStatistics::record_trap("UNHANDLED", trap_pc, TrapKind::CALL);
 
-    std::cerr << "=== UNHANDLED TRAP at PC=$" << std::hex << std::uppercase << std::setw(4)
-              << std::setfill('0') << trap_pc << " ===" << std::endl;
+    EDASM_LOG(ERROR, TRAP,
+              "=== UNHANDLED TRAP at PC=$" << std::hex << std::uppercase << std::setw(4)
+                                           << std::setfill('0') << trap_pc << " ===");
     log_cpu_state(cpu, bus, trap_pc);
     log_memory_window(bus, trap_pc, 32);
 
@@ -108,19 +112,20 @@ bool TrapManager::default_trap_handler(CPUState &cpu, Bus &bus, uint16_t trap_pc
 
 TrapHandler TrapManager::create_logging_handler(const std::string &name) {
     return [name](CPUState &cpu, Bus &bus, uint16_t trap_pc) -> bool {
-        std::cout << "[TRAP:" << name << "] PC=$" << std::hex << std::uppercase << std::setw(4)
-                  << std::setfill('0') << trap_pc << std::endl;
+        EDASM_LOG(INFO, TRAP,
+                  "[TRAP:" << name << "] PC=$" << std::hex << std::uppercase << std::setw(4)
+                           << std::setfill('0') << trap_pc);
         log_cpu_state(cpu, bus, trap_pc);
         return halt_and_dump("Logging trap: " + name, cpu, bus, trap_pc);
     };
 }
 
 void TrapManager::log_cpu_state(const CPUState &cpu, const Bus &bus, uint16_t pc) {
-    std::cerr << dump_cpu_state(cpu) << std::endl;
+    EDASM_LOG(ERROR, TRAP, dump_cpu_state(cpu));
 }
 
 void TrapManager::log_memory_window(const Bus &bus, uint16_t addr, size_t size) {
-    std::cerr << dump_memory(bus, addr, size) << std::endl;
+    EDASM_LOG(ERROR, TRAP, dump_memory(bus, addr, size));
 }
 
 std::string TrapManager::dump_cpu_state(const CPUState &cpu) {
@@ -195,16 +200,15 @@ bool TrapManager::write_memory_dump(const Bus &bus, const std::string &filename)
         return false;
     }
 
-    // Use translate_read_range to get the proper memory ranges for the entire 64KB address space
-    auto ranges = bus.translate_read_range(0, Bus::MEMORY_SIZE);
-
-    // Write each range to file
-    for (const auto &range : ranges) {
-        file.write(reinterpret_cast<const char *>(range.data()), range.size());
-        if (!file) {
-            std::cerr << "Error: Failed to write memory dump" << std::endl;
-            return false;
+    // Write the entire 64KB address space as currently mapped for reads, span by span
+    bus.for_each_read_span(0, Bus::MEMORY_SIZE, [&file](ReadMemoryRange range) {
+        if (file) {
+            file.write(reinterpret_cast<const char *>(range.data()), range.size());
         }
+    });
+    if (!file) {
+        std::cerr << "Error: Failed to write memory dump" << std::endl;
+        return false;
     }
 
     file.close();
@@ -214,6 +218,7 @@ bool TrapManager::write_memory_dump(const Bus &bus, const std::string &filename)
 }
 
 bool TrapManager::halt_and_dump(const std::string &reason, CPUState &cpu, Bus &bus, uint16_t pc) {
+    Log::flush();
     std::cout << "\n=== HALTING: " << reason << " ===" << std::endl;
     std::cout << dump_cpu_state(cpu) << std::endl;
     std::cout << "PC=$" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << pc
@@ -259,14 +264,15 @@ std::vector<TrapStatistic> &TrapStatistics::get_statistics() {
 }
 
 void TrapStatistics::record_trap(const std::string &name, uint16_t address, TrapKind kind,
-                                 const std::string &mli_call, bool is_second_read) {
+                                 const std::string &mli_call, bool is_second_read,
+                                 uint64_t count) {
     auto &stats = get_statistics();
 
     // Find existing entry with matching characteristics
     for (auto &stat : stats) {
         if (stat.address == address && stat.kind == kind && stat.name == name &&
             stat.mli_call == mli_call && stat.is_second_read == is_second_read) {
-            stat.count++;
+            stat.count += count;
             return;
         }
     }
@@ -275,7 +281,7 @@ void TrapStatistics::record_trap(const std::string &name, uint16_t address, Trap
     TrapStatistic new_stat(name, address, kind);
     new_stat.mli_call = mli_call;
     new_stat.is_second_read = is_second_read;
-    new_stat.count = 1;
+    new_stat.count = count;
     stats.push_back(new_stat);
 }
 
@@ -19,12 +19,17 @@
 #include "edasm/emulator/cpu.hpp"
 #include "edasm/emulator/disassembly.hpp"
 #include "edasm/emulator/host_shims.hpp"
+#include "edasm/emulator/log.hpp"
 #include "edasm/emulator/mli.hpp"
+#include "edasm/emulator/profiler.hpp"
+#include "edasm/emulator/sweet16.hpp"
 #include "edasm/emulator/traps.hpp"
+#include "edasm/files/symbol_database.hpp"
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -60,6 +65,10 @@ int main(int argc, char *argv[]) {
     uint16_t entry_point = 0x0000; // will follow hardware reset vector
     size_t max_instructions = 1000;
     bool trace = false;
+    std::string symbols_path;
+    std::string profile_path;
+    std::string log_categories;
+    std::optional<uint16_t> sweet16_entry;
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -73,6 +82,14 @@ int main(int argc, char *argv[]) {
             max_instructions = std::stoul(argv[++i]);
         } else if (arg == "--input-file" && i + 1 < argc) {
             input_file_path = argv[++i];
+        } else if (arg == "--symbols" && i + 1 < argc) {
+            symbols_path = argv[++i];
+        } else if (arg == "--sweet16" && i + 1 < argc) {
+            sweet16_entry = static_cast<uint16_t>(std::stoul(argv[++i], nullptr, 16));
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (arg == "--log" && i + 1 < argc) {
+            log_categories = argv[++i];
         } else if (arg == "--trace") {
             trace = true;
         } else if (arg == "--help") {
@@ -87,18 +104,46 @@ int main(int argc, char *argv[]) {
                       << std::endl;
             std::cout << "  --input-file <path>  Text file with input lines (one per line)"
                       << std::endl;
+            std::cout << "  --symbols <path>     Symbol database (from the linker or assembler)"
+                      << std::endl;
+            std::cout << "  --sweet16 <addr>     Run SWEET16 natively at this entry point in hex "
+                         "(ROM: F689)"
+                      << std::endl;
+            std::cout << "  --profile <path>     Profile calls; write folded stacks for flamegraphs"
+                      << std::endl;
             std::cout << "  --trace              Enable instruction tracing" << std::endl;
+            std::cout << "  --log <list>         Log categories to show (cpu,trap,mli,io,lc or "
+                         "all; default: all)"
+                      << std::endl;
             std::cout << "  --help               Show this help" << std::endl;
             return 0;
         }
     }
 
+    if (!log_categories.empty() && !Log::set_categories(log_categories)) {
+        std::cerr << "Unknown log category in: " << log_categories << std::endl;
+        return 1;
+    }
+
     register_default_disassembly_symbols();
 
+    std::optional<SymbolDatabase> symbols;
+    if (!symbols_path.empty()) {
+        std::string error;
+        symbols = SymbolDatabase::open(symbols_path, &error);
+        if (!symbols) {
+            std::cerr << "Cannot load symbol database: " << error << std::endl;
+            return 1;
+        }
+        set_disassembly_symbol_database(&*symbols);
+        std::cout << "  Symbols: " << symbols->size() << " from " << symbols_path << std::endl;
+    }
+
     // Initialize emulator
     Bus bus;
     CPU cpu(bus);
     HostShims shims(bus);
+    Sweet16 sweet16(bus);
 
     // Load and queue input file if provided
     if (!input_file_path.empty()) {
@@ -179,6 +224,11 @@ int main(int argc, char *argv[]) {
     cpu.set_trap_handler(TrapManager::general_trap_handler);
     std::cout << "  General trap handler installed with ProDOS MLI at $BF00" << std::endl;
     std::cout << "  Monitor ROM SETNORM handler installed at $FE84" << std::endl;
+    if (sweet16_entry) {
+        sweet16.install(*sweet16_entry);
+        std::cout << "  Native SWEET16 installed at $" << std::hex << std::uppercase << std::setw(4)
+                  << std::setfill('0') << *sweet16_entry << std::endl;
+    }
 
     std::cout << std::endl << "Starting execution..." << std::endl;
     std::cout << "Maximum instructions: " << std::dec << max_instructions << std::endl;
@@ -187,20 +237,33 @@ int main(int argc, char *argv[]) {
     }
     std::cout << std::endl;
 
-    // Run emulator
+    std::optional<CallProfiler> profiler;
+    if (!profile_path.empty()) {
+        profiler.emplace(cpu.state().PC);
+    }
+
+    // Run emulator; diagnostics are written by the log thread meanwhile
     size_t count = 0;
     bool running = true;
+    Log::start_async();
 
     while (running && count < max_instructions) {
-        if (trace) {
-            std::cout << "[" << std::dec << count << "] "
-                      << TrapManager::dump_cpu_state(cpu.state());
-            std::cout << "    " << format_disassembly(bus, cpu.state().PC) << std::endl;
-        }
+        EDASM_LOG(TRACE, CPU,
+                  "[" << std::dec << count << "] " << TrapManager::dump_cpu_state(cpu.state())
+                      << "    " << format_disassembly(bus, cpu.state().PC));
 
-        running = cpu.step();
-        if (!running)
+        if (profiler) {
+            const CPUState before = cpu.state();
+            const uint8_t opcode = bus.read(before.PC);
+            running = cpu.step();
+            profiler->record(before, opcode, cpu.state());
+        } else {
+            running = cpu.step();
+        }
+        if (!running) {
+            Log::flush();
             std::cout << "\nEmulator stopped by cpu.step()" << std::endl;
+        }
         count++;
 
         // Check if HostShims requested a stop (e.g., first screen char is 'E')
@@ -209,15 +272,33 @@ int main(int argc, char *argv[]) {
             running = false;
         }
     }
+    Log::stop_async();
 
     std::cout << std::endl;
     std::cout << "Execution stopped after " << std::dec << count << " instructions" << std::endl;
     std::cout << "Final CPU state:" << std::endl;
     std::cout << TrapManager::dump_cpu_state(cpu.state()) << std::endl;
 
-    // Print trap statistics
+    if (sweet16_entry) {
+        std::cout << "SWEET16: " << std::dec << sweet16.calls() << " calls, "
+                  << sweet16.instructions() << " bytecodes run natively" << std::endl;
+    }
+
+    // Print trap statistics (screen and soft-switch accesses are counted lazily)
+    shims.flush_statistics();
     TrapStatistics::print_statistics();
 
+    if (profiler) {
+        profiler->print_report(std::cout);
+        std::ofstream folded(profile_path);
+        profiler->write_folded(folded);
+        if (folded) {
+            std::cout << "Folded call stacks written to " << profile_path << std::endl;
+        } else {
+            std::cerr << "Error: Failed to write profile: " << profile_path << std::endl;
+        }
+    }
+
     if (running) {
         std::cout << std::endl << "Reached maximum instruction limit" << std::endl;
         return 1;
@@ -0,0 +1,347 @@
+/**
+ * @file symbol_database.cpp
+ * @brief Binary symbol database for symbolizing emulator addresses
+ *
+ * No EDASM.SRC counterpart; see symbol_database.hpp for the file format.
+ */
+
+#include "edasm/files/symbol_database.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace edasm {
+
+namespace {
+
+constexpr char kMagic[4] = {'E', 'D', 'S', 'D'};
+constexpr size_t kHeaderSize = 20;
+constexpr size_t kSymbolSize = 16;
+constexpr size_t kModuleSize = 8;
+
+void fail(std::string *error, std::string message) {
+    if (error) {
+        *error = std::move(message);
+    }
+}
+
+void put_u16(std::vector<uint8_t> &out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v & 0xFF));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put_u32(std::vector<uint8_t> &out, uint32_t v) {
+    put_u16(out, static_cast<uint16_t>(v & 0xFFFF));
+    put_u16(out, static_cast<uint16_t>(v >> 16));
+}
+
+uint16_t get_u16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | (static_cast<uint32_t>(get_u16(p + 2)) << 16);
+}
+
+} // namespace
+
+// =========================================
+// Builder
+// =========================================
+
+uint16_t SymbolDatabase::Builder::add_module(std::string_view name, uint16_t start,
+                                             uint16_t length) {
+    modules_.push_back(PendingModule{std::string(name), start, length});
+    return static_cast<uint16_t>(modules_.size() - 1);
+}
+
+void SymbolDatabase::Builder::add_symbol(std::string_view name, uint16_t address,
+                                         uint16_t module, uint32_t line) {
+    symbols_.push_back(PendingSymbol{std::string(name), address, module, line});
+}
+
+std::vector<uint8_t> SymbolDatabase::Builder::build() const {
+    std::vector<const PendingSymbol *> sorted;
+    sorted.reserve(symbols_.size());
+    for (const auto &sym : symbols_) {
+        sorted.push_back(&sym);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const PendingSymbol *a, const PendingSymbol *b) {
+        return a->address != b->address ? a->address < b->address : a->name < b->name;
+    });
+
+    // String table: module names, then symbol names
+    std::vector<uint8_t> strings;
+    auto add_string = [&strings](const std::string &s) {
+        const auto offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), s.begin(), s.end());
+        strings.push_back(0);
+        return offset;
+    };
+
+    std::vector<uint8_t> out(std::begin(kMagic), std::end(kMagic));
+    put_u16(out, kFormatVersion);
+    put_u16(out, 0);
+    put_u32(out, static_cast<uint32_t>(sorted.size()));
+    put_u32(out, static_cast<uint32_t>(modules_.size()));
+    const size_t strings_size_at = out.size();
+    put_u32(out, 0);
+
+    std::vector<uint32_t> module_names;
+    for (const auto &module : modules_) {
+        module_names.push_back(add_string(module.name));
+    }
+
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const PendingSymbol &sym = *sorted[i];
+
+        // Inside a module's code the range runs to the next symbol at a
+        // higher address (or the module's end); elsewhere it is one address
+        uint32_t size = 1;
+        for (const auto &module : modules_) {
+            const uint32_t end = static_cast<uint32_t>(module.start) + module.length;
+            if (sym.address >= module.start && sym.address < end) {
+                size_t next = i + 1;
+                while (next < sorted.size() && sorted[next]->address == sym.address) {
+                    next++;
+                }
+                const uint32_t limit = next < sorted.size() ? std::min<uint32_t>(
+                                                                  sorted[next]->address, end)
+                                                            : end;
+                size = std::min<uint32_t>(limit - sym.address, 0xFFFF);
+                break;
+            }
+        }
+
+        put_u16(out, sym.address);
+        put_u16(out, static_cast<uint16_t>(size));
+        put_u32(out, add_string(sym.name));
+        put_u16(out, sym.module < modules_.size() ? sym.module : kNoModule);
+        put_u16(out, 0);
+        put_u32(out, sym.line);
+    }
+
+    for (size_t i = 0; i < modules_.size(); ++i) {
+        put_u32(out, module_names[i]);
+        put_u16(out, modules_[i].start);
+        put_u16(out, modules_[i].length);
+    }
+
+    const auto strings_size = static_cast<uint32_t>(strings.size());
+    for (int b = 0; b < 4; ++b) {
+        out[strings_size_at + b] = static_cast<uint8_t>(strings_size >> (8 * b));
+    }
+    out.insert(out.end(), strings.begin(), strings.end());
+    return out;
+}
+
+// =========================================
+// Opening
+// =========================================
+
+std::optional<SymbolDatabase> SymbolDatabase::open(const std::string &path, std::string *error) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail(error, "Cannot open file: " + path);
+        return std::nullopt;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        fail(error, "Not a symbol database: " + path);
+        return std::nullopt;
+    }
+
+    void *mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        fail(error, "Cannot map file: " + path);
+        return std::nullopt;
+    }
+
+    SymbolDatabase db;
+    db.mapping_ = mapping;
+    db.data_ = static_cast<const uint8_t *>(mapping);
+    db.data_size_ = static_cast<size_t>(st.st_size);
+    if (!db.attach(error)) {
+        return std::nullopt;
+    }
+    return db;
+}
+
+std::optional<SymbolDatabase> SymbolDatabase::from_bytes(std::span<const uint8_t> data,
+                                                         std::string *error) {
+    SymbolDatabase db;
+    db.bytes_.assign(data.begin(), data.end());
+    db.data_ = db.bytes_.data();
+    db.data_size_ = db.bytes_.size();
+    if (!db.attach(error)) {
+        return std::nullopt;
+    }
+    return db;
+}
+
+bool SymbolDatabase::save(const std::string &path, std::span<const uint8_t> data) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+// Validate the header and locate the sections; names are checked to be
+// NUL-terminated within the string table so lookups never read past it
+bool SymbolDatabase::attach(std::string *error) {
+    if (data_size_ < kHeaderSize || !std::equal(std::begin(kMagic), std::end(kMagic), data_)) {
+        fail(error, "Not a symbol database");
+        return false;
+    }
+    if (get_u16(data_ + 4) != kFormatVersion) {
+        fail(error, "Unsupported symbol database version " + std::to_string(get_u16(data_ + 4)));
+        return false;
+    }
+
+    symbol_count_ = get_u32(data_ + 8);
+    module_count_ = get_u32(data_ + 12);
+    strings_size_ = get_u32(data_ + 16);
+    const uint64_t expected = kHeaderSize + uint64_t{symbol_count_} * kSymbolSize +
+                              uint64_t{module_count_} * kModuleSize + strings_size_;
+    if (expected != data_size_ || (strings_size_ > 0 && data_[data_size_ - 1] != 0)) {
+        fail(error, "Truncated symbol database");
+        return false;
+    }
+
+    symbols_ = data_ + kHeaderSize;
+    modules_ = symbols_ + size_t{symbol_count_} * kSymbolSize;
+    strings_ = reinterpret_cast<const char *>(modules_ + size_t{module_count_} * kModuleSize);
+
+    for (uint32_t i = 0; i < symbol_count_; ++i) {
+        const uint8_t *rec = symbols_ + size_t{i} * kSymbolSize;
+        const uint16_t module = get_u16(rec + 8);
+        if (get_u32(rec + 4) >= strings_size_ || get_u16(rec + 2) == 0 ||
+            (module != kNoModule && module >= module_count_)) {
+            fail(error, "Corrupt symbol database");
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < module_count_; ++i) {
+        if (get_u32(modules_ + size_t{i} * kModuleSize) >= strings_size_) {
+            fail(error, "Corrupt symbol database");
+            return false;
+        }
+    }
+    return true;
+}
+
+SymbolDatabase::SymbolDatabase(SymbolDatabase &&other) noexcept {
+    *this = std::move(other);
+}
+
+SymbolDatabase &SymbolDatabase::operator=(SymbolDatabase &&other) noexcept {
+    if (this != &other) {
+        release();
+        // A moved vector keeps its buffer, so the section pointers stay valid
+        data_ = other.data_;
+        data_size_ = other.data_size_;
+        mapping_ = other.mapping_;
+        bytes_ = std::move(other.bytes_);
+        symbol_count_ = other.symbol_count_;
+        module_count_ = other.module_count_;
+        symbols_ = other.symbols_;
+        modules_ = other.modules_;
+        strings_ = other.strings_;
+        strings_size_ = other.strings_size_;
+        other.mapping_ = nullptr;
+        other.data_ = nullptr;
+        other.data_size_ = 0;
+        other.symbol_count_ = 0;
+        other.module_count_ = 0;
+    }
+    return *this;
+}
+
+SymbolDatabase::~SymbolDatabase() {
+    release();
+}
+
+void SymbolDatabase::release() {
+    if (mapping_) {
+        ::munmap(mapping_, data_size_);
+        mapping_ = nullptr;
+    }
+}
+
+// =========================================
+// Lookup
+// =========================================
+
+SymbolDatabase::Symbol SymbolDatabase::symbol(size_t index) const {
+    const uint8_t *rec = symbols_ + index * kSymbolSize;
+    Symbol sym;
+    sym.address = get_u16(rec);
+    sym.size = get_u16(rec + 2);
+    sym.name = strings_ + get_u32(rec + 4);
+    const uint16_t module = get_u16(rec + 8);
+    if (module != kNoModule) {
+        sym.module = strings_ + get_u32(modules_ + size_t{module} * kModuleSize);
+        sym.module_index = module;
+    }
+    sym.line = get_u32(rec + 12);
+    return sym;
+}
+
+std::optional<SymbolDatabase::Match> SymbolDatabase::lookup(uint16_t address) const {
+    // First record with a higher address; the candidate is the first record
+    // of the run just before it (records at one address share a range)
+    size_t lo = 0;
+    size_t hi = symbol_count_;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (get_u16(symbols_ + mid * kSymbolSize) <= address) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return std::nullopt;
+    }
+
+    size_t index = lo - 1;
+    const uint16_t start = get_u16(symbols_ + index * kSymbolSize);
+    while (index > 0 && get_u16(symbols_ + (index - 1) * kSymbolSize) == start) {
+        index--;
+    }
+
+    const Symbol sym = symbol(index);
+    const uint16_t offset = static_cast<uint16_t>(address - sym.address);
+    if (offset >= sym.size) {
+        return std::nullopt;
+    }
+    return Match{sym, offset};
+}
+
+std::string SymbolDatabase::symbolize(uint16_t address) const {
+    const auto match = lookup(address);
+    if (!match) {
+        return {};
+    }
+    std::string text(match->symbol.name);
+    if (match->offset != 0) {
+        std::ostringstream oss;
+        oss << "+$" << std::hex << std::uppercase << match->offset;
+        text += oss.str();
+    }
+    return text;
+}
+
+} // namespace edasm
@@ -0,0 +1,163 @@
+/**
+ * @file trace_lockstep.cpp
+ * @brief Compare the 65C02 emulator against MAME reference traces
+ *
+ * Replays a binary reference trace (see reference_trace.hpp) on CPU/Bus and
+ * stops at the first instruction whose registers or memory writes differ,
+ * printing the instructions that led up to it.
+ *
+ * Traces are captured under MAME with MAME_Stuff/emulator/
+ * trace_capture.lua, which writes a debugger trace log and a memory image;
+ * --convert turns the pair into a binary trace once, which can then be
+ * compared after every emulator change.
+ */
+
+#include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/disassembly.hpp"
+#include "edasm/emulator/host_shims.hpp"
+#include "edasm/emulator/lockstep.hpp"
+#include "edasm/emulator/reference_trace.hpp"
+#include "edasm/files/symbol_database.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace edasm;
+
+namespace {
+
+void print_usage(const char *program) {
+    std::cout << "Usage: " << program << " [options] <trace.edtr>" << std::endl;
+    std::cout << "       " << program << " --convert <mame_trace.log> <memory.bin> <trace.edtr>"
+              << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --context <n>        Instructions shown before a divergence (default: 16)"
+              << std::endl;
+    std::cout << "  --max <n>            Compare at most n instructions (default: all)"
+              << std::endl;
+    std::cout << "  --flag-mask <hex>    Status register bits compared (default: CF)"
+              << std::endl;
+    std::cout << "  --no-io-sync         Compare registers after $C0xx reads too" << std::endl;
+    std::cout << "  --io-traps           Install the host I/O shims (soft switches, language "
+                 "card)"
+              << std::endl;
+    std::cout << "  --symbols <path>     Symbol database for the disassembly" << std::endl;
+    std::cout << "  --help               Show this help" << std::endl;
+}
+
+int convert(const std::string &log_path, const std::string &memory_path,
+            const std::string &trace_path) {
+    std::ifstream log(log_path);
+    if (!log) {
+        std::cerr << "Cannot open trace log: " << log_path << std::endl;
+        return 1;
+    }
+    std::ifstream memory_file(memory_path, std::ios::binary);
+    if (!memory_file) {
+        std::cerr << "Cannot open memory image: " << memory_path << std::endl;
+        return 1;
+    }
+    const std::vector<uint8_t> memory((std::istreambuf_iterator<char>(memory_file)),
+                                      std::istreambuf_iterator<char>());
+    if (memory.size() != ReferenceTrace::kImageSize) {
+        std::cerr << "Memory image must be 64KB: " << memory_path << std::endl;
+        return 1;
+    }
+    std::ofstream out(trace_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Cannot create trace: " << trace_path << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    if (!convert_mame_trace(log, memory, out, &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << trace_path << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::cout << "C-EDASM Trace Lockstep" << std::endl;
+    std::cout << "======================" << std::endl << std::endl;
+
+    LockstepOptions options;
+    bool io_traps = false;
+    std::string symbols_path;
+    std::string trace_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--convert" && i + 3 < argc) {
+            return convert(argv[i + 1], argv[i + 2], argv[i + 3]);
+        } else if (arg == "--context" && i + 1 < argc) {
+            options.context = std::stoul(argv[++i]);
+        } else if (arg == "--max" && i + 1 < argc) {
+            options.max_records = std::stoull(argv[++i]);
+        } else if (arg == "--flag-mask" && i + 1 < argc) {
+            options.flag_mask = static_cast<uint8_t>(std::stoul(argv[++i], nullptr, 16));
+        } else if (arg == "--no-io-sync") {
+            options.sync_io_reads = false;
+        } else if (arg == "--io-traps") {
+            io_traps = true;
+        } else if (arg == "--symbols" && i + 1 < argc) {
+            symbols_path = argv[++i];
+        } else if (arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            trace_path = arg;
+        }
+    }
+
+    if (trace_path.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    register_default_disassembly_symbols();
+
+    std::optional<SymbolDatabase> symbols;
+    if (!symbols_path.empty()) {
+        std::string error;
+        symbols = SymbolDatabase::open(symbols_path, &error);
+        if (!symbols) {
+            std::cerr << "Cannot load symbol database: " << error << std::endl;
+            return 1;
+        }
+        set_disassembly_symbol_database(&*symbols);
+    }
+
+    std::string error;
+    std::optional<ReferenceTrace> trace = ReferenceTrace::open(trace_path, &error);
+    if (!trace) {
+        std::cerr << "Cannot load trace: " << error << std::endl;
+        return 1;
+    }
+
+    Bus bus;
+    HostShims shims(bus);
+    if (io_traps) {
+        shims.install_io_traps();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const LockstepResult result = run_lockstep(*trace, bus, options);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    print_lockstep_report(std::cout, result, bus);
+    if (elapsed.count() > 0) {
+        std::cout << std::dec << "Replayed " << trace->position() / (1024 * 1024) << " MB in "
+                  << elapsed.count() << " s ("
+                  << static_cast<uint64_t>(result.records / elapsed.count())
+                  << " instructions/s)" << std::endl;
+    }
+    return result.diverged || result.truncated ? 1 : 0;
+}
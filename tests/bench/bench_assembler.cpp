@@ -0,0 +1,296 @@
+/**
+ * @file bench_assembler.cpp
+ * @brief Assembler throughput benchmark
+ *
+ * Runs the assembler over synthetic sources (see source_generator.hpp) of
+ * increasing size and over the real sources in tests/fixtures, reporting
+ * lines per second for each phase recorded in Assembler::Result::profile,
+ * allocation counts and the process peak RSS.
+ *
+ * Usage: bench_assembler [--sizes N,N,...] [--iterations N] [--seed N]
+ *                        [--fixtures DIR] [--no-fixtures] [--no-synthetic]
+ *                        [--no-rel] [--listing] [--work-dir DIR] [--csv]
+ */
+
+#include "edasm/assembler/assembler.hpp"
+#include "source_generator.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef EDASM_FIXTURE_DIR
+#define EDASM_FIXTURE_DIR "tests/fixtures"
+#endif
+
+using edasm::AssemblyProfile;
+using edasm::PhaseProfile;
+
+namespace {
+
+struct BenchOptions {
+    std::vector<size_t> sizes{1000, 10000, 100000};
+    int iterations{3};
+    uint32_t seed{1};
+    std::string fixture_dir{EDASM_FIXTURE_DIR};
+    std::string work_dir{"bench_tmp"};
+    bool fixtures{true};
+    bool synthetic{true};
+    bool rel{true};
+    bool listing{false};
+    bool csv{false};
+};
+
+struct Workload {
+    std::string name;
+    std::string source;
+    int repeat{1}; // Assemblies per measured iteration (small fixtures)
+};
+
+struct Measurement {
+    AssemblyProfile profile; // Best iteration, summed over repeats
+    bool success{true};
+    size_t errors{0};
+    long peak_rss_kb{0};
+};
+
+// Fixtures are tiny; repeat them so each iteration covers this many lines
+constexpr size_t kMinFixtureLines = 50000;
+
+void print_usage(const char *prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --sizes N,N,...   Synthetic source sizes in lines (default 1000,10000,100000)\n"
+              << "  --iterations N    Iterations per workload, best is reported (default 3)\n"
+              << "  --seed N          Generator seed (default 1)\n"
+              << "  --fixtures DIR    Directory of fixture sources (default tests/fixtures)\n"
+              << "  --no-fixtures     Skip fixture workloads\n"
+              << "  --no-synthetic    Skip synthetic workloads\n"
+              << "  --no-rel          Generate sources without REL/ENT/EXT\n"
+              << "  --listing         Also generate listings\n"
+              << "  --work-dir DIR    Where generated INCLUDE files go (default bench_tmp)\n"
+              << "  --csv             Machine-readable output\n";
+}
+
+bool parse_args(int argc, char **argv, BenchOptions &opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--sizes") {
+            opts.sizes.clear();
+            std::stringstream ss(next());
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                opts.sizes.push_back(std::strtoull(item.c_str(), nullptr, 10));
+            }
+        } else if (arg == "--iterations") {
+            opts.iterations = std::max(1, std::atoi(next().c_str()));
+        } else if (arg == "--seed") {
+            opts.seed = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+        } else if (arg == "--fixtures") {
+            opts.fixture_dir = next();
+        } else if (arg == "--no-fixtures") {
+            opts.fixtures = false;
+        } else if (arg == "--no-synthetic") {
+            opts.synthetic = false;
+        } else if (arg == "--no-rel") {
+            opts.rel = false;
+        } else if (arg == "--listing") {
+            opts.listing = true;
+        } else if (arg == "--work-dir") {
+            opts.work_dir = next();
+        } else if (arg == "--csv") {
+            opts.csv = true;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+long peak_rss_kb() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kilobytes on Linux
+}
+
+void accumulate(PhaseProfile &into, const PhaseProfile &from) {
+    into.wall_ms += from.wall_ms;
+    into.allocations += from.allocations;
+    into.bytes_allocated += from.bytes_allocated;
+}
+
+void accumulate(AssemblyProfile &into, const AssemblyProfile &from) {
+    accumulate(into.tokenize, from.tokenize);
+    accumulate(into.includes, from.includes);
+    accumulate(into.pass1, from.pass1);
+    accumulate(into.pass2, from.pass2);
+    accumulate(into.rel_build, from.rel_build);
+    accumulate(into.listing, from.listing);
+    into.lines += from.lines;
+    into.symbols = from.symbols;
+    into.expression_evaluations += from.expression_evaluations;
+}
+
+Measurement run_workload(const Workload &work, const BenchOptions &opts) {
+    Measurement m;
+    edasm::Assembler assembler;
+    edasm::Assembler::Options asm_opts;
+    asm_opts.collect_profile = true;
+    asm_opts.generate_listing = opts.listing;
+
+    bool have_best = false;
+    for (int iter = 0; iter < opts.iterations; ++iter) {
+        AssemblyProfile sum;
+        for (int r = 0; r < work.repeat; ++r) {
+            auto result = assembler.assemble(work.source, asm_opts);
+            if (!result.success) {
+                m.success = false;
+                m.errors = result.errors.size();
+            }
+            accumulate(sum, result.profile);
+        }
+        if (!have_best || sum.total().wall_ms < m.profile.total().wall_ms) {
+            m.profile = sum;
+            have_best = true;
+        }
+    }
+    m.peak_rss_kb = peak_rss_kb();
+    return m;
+}
+
+std::string rate(size_t lines, const PhaseProfile &phase) {
+    if (phase.wall_ms <= 0.0 || lines == 0) {
+        return "-";
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.0f", lines / (phase.wall_ms / 1000.0));
+    return buf;
+}
+
+void print_header(bool csv) {
+    if (csv) {
+        std::cout << "workload,lines,ok,tokenize_lps,include_lps,pass1_lps,pass2_lps,rel_lps,"
+                     "listing_lps,total_lps,total_ms,allocations,bytes,peak_rss_kb\n";
+        return;
+    }
+    std::printf("%-26s %9s %3s %11s %11s %11s %11s %11s %11s %11s %10s %10s %9s\n", "workload",
+                "lines", "ok", "tokenize/s", "include/s", "pass1/s", "pass2/s", "rel/s",
+                "listing/s", "total/s", "total ms", "allocs", "rss KB");
+}
+
+void print_row(const std::string &name, const Measurement &m, bool csv) {
+    const auto &p = m.profile;
+    const PhaseProfile total = p.total();
+    const char *ok = m.success ? "yes" : "no";
+    if (csv) {
+        std::cout << name << ',' << p.lines << ',' << ok << ',' << rate(p.lines, p.tokenize) << ','
+                  << rate(p.lines, p.includes) << ',' << rate(p.lines, p.pass1) << ','
+                  << rate(p.lines, p.pass2) << ',' << rate(p.lines, p.rel_build) << ','
+                  << rate(p.lines, p.listing) << ',' << rate(p.lines, total) << ','
+                  << total.wall_ms << ',' << total.allocations << ',' << total.bytes_allocated
+                  << ',' << m.peak_rss_kb << '\n';
+        return;
+    }
+    std::printf("%-26s %9zu %3s %11s %11s %11s %11s %11s %11s %11s %10.2f %10llu %9ld\n",
+                name.c_str(), p.lines, ok, rate(p.lines, p.tokenize).c_str(),
+                rate(p.lines, p.includes).c_str(), rate(p.lines, p.pass1).c_str(),
+                rate(p.lines, p.pass2).c_str(), rate(p.lines, p.rel_build).c_str(),
+                rate(p.lines, p.listing).c_str(), rate(p.lines, total).c_str(), total.wall_ms,
+                static_cast<unsigned long long>(total.allocations), m.peak_rss_kb);
+}
+
+std::vector<Workload> fixture_workloads(const std::string &dir) {
+    std::vector<Workload> workloads;
+    std::error_code ec;
+    std::vector<std::filesystem::path> paths;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.path().extension() == ".src") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    for (const auto &path : paths) {
+        std::ifstream file(path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        Workload work;
+        work.name = path.stem().string();
+        work.source = buffer.str();
+        size_t lines =
+            std::max<size_t>(1, std::count(work.source.begin(), work.source.end(), '\n'));
+        work.repeat = static_cast<int>(std::max<size_t>(1, kMinFixtureLines / lines));
+        workloads.push_back(std::move(work));
+    }
+    return workloads;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions opts;
+    if (!parse_args(argc, argv, opts)) {
+        return 1;
+    }
+
+    bool all_ok = true;
+    print_header(opts.csv);
+
+    if (opts.fixtures) {
+        auto workloads = fixture_workloads(opts.fixture_dir);
+        if (workloads.empty()) {
+            std::cerr << "No fixtures found in " << opts.fixture_dir << std::endl;
+        }
+        for (const auto &work : workloads) {
+            auto m = run_workload(work, opts);
+            print_row("fixture:" + work.name, m, opts.csv);
+        }
+    }
+
+    if (opts.synthetic) {
+        std::sort(opts.sizes.begin(), opts.sizes.end());
+        for (size_t size : opts.sizes) {
+            edasm::bench::GeneratorOptions gen;
+            gen.target_lines = size;
+            gen.seed = opts.seed;
+            gen.use_rel = opts.rel;
+            gen.include_dir = opts.work_dir;
+            auto generated = edasm::bench::generate_source(gen);
+
+            Workload work;
+            work.name = "synthetic:" + std::to_string(size);
+            work.source = std::move(generated.text);
+            auto m = run_workload(work, opts);
+            print_row(work.name, m, opts.csv);
+            if (!m.success) {
+                // Generated sources must always assemble
+                std::cerr << work.name << ": " << m.errors << " assembly errors" << std::endl;
+                all_ok = false;
+            }
+
+            for (const auto &path : generated.include_files) {
+                std::filesystem::remove(path);
+            }
+        }
+    }
+
+    if (opts.synthetic) {
+        std::error_code ec;
+        std::filesystem::remove(opts.work_dir, ec); // Only succeeds if empty
+    }
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,656 @@
+/**
+ * @file bench_corpus.cpp
+ * @brief End-to-end corpus benchmark and performance regression gate
+ *
+ * Assembles the EDASM-style sources in tests/bench/corpus (an INCLUDE of
+ * shared equates, three REL modules and a BIN program), links the REL
+ * modules and runs the BIN program on the emulator, both on the full Apple II
+ * bus ("emulate") and on the trap-free flat bus ("emulate.flat", the CPU's
+ * native speed). Each phase is timed
+ * (best of several iterations) and written as JSON; with --baseline the
+ * results are compared against a checked-in baseline and any phase
+ * allocating more than its tolerance (or, when enabled, slower than its
+ * tolerance) fails the run.
+ *
+ * Allocations are gated per unit of work (allocations per line, linked byte
+ * or instruction) and work units are deterministic: both are always gated,
+ * on any machine. Wall times depend on the machine the baseline was
+ * recorded on, so by default they are only reported; --gate-wall or
+ * EDASM_PERF_GATE_WALL=1 gates them too. The baseline holds one set of
+ * phases per build type, and wall times are only ever gated against the set
+ * recorded with the same build type (an unoptimized build is not compared
+ * against a release baseline).
+ *
+ * Usage: bench_corpus [--corpus DIR] [--work-dir DIR] [--iterations N]
+ *                     [--output FILE] [--baseline FILE] [--tolerance X]
+ *                     [--build-type NAME] [--gate-wall] [--update-baseline]
+ *
+ * The wall-time tolerance (0.5 = 50% slower) comes from the baseline and
+ * can be overridden with --tolerance or EDASM_PERF_TOLERANCE.
+ */
+
+#include "edasm/assembler/assembler.hpp"
+#include "edasm/assembler/linker.hpp"
+#include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/cpu.hpp"
+#include "edasm/emulator/ram_bus.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef EDASM_CORPUS_DIR
+#define EDASM_CORPUS_DIR "tests/bench/corpus"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// REL modules linked in this order; sieve.src is the emulation program
+const std::vector<std::string> kModules = {"main", "util", "tables"};
+const std::string kProgram = "sieve";
+constexpr uint16_t kProgramOrigin = 0x0800;
+constexpr uint64_t kMaxInstructions = 100000000;
+
+// The corpus is small; repeat assembly and linking so each iteration
+// runs long enough to time
+constexpr int kAssembleRepeat = 200;
+constexpr int kLinkRepeat = 200;
+
+struct BenchOptions {
+    std::string corpus_dir{EDASM_CORPUS_DIR};
+    std::string work_dir{"bench_corpus_tmp"};
+    std::string output{"bench_corpus.json"};
+    std::string baseline;
+    std::string build_type{"default"};
+    std::optional<double> tolerance;
+    int iterations{5};
+    bool gate_wall{false}; // Fail on wall-time regressions (machine dependent)
+    bool update_baseline{false};
+};
+
+struct Phase {
+    double wall_ms{0.0};
+    int64_t allocations{-1}; // -1: not measured
+    int64_t units{0};        // Work done (lines, bytes, instructions)
+};
+
+struct Results {
+    std::string build_type;
+    std::map<std::string, Phase> phases;
+};
+
+struct Baseline {
+    std::map<std::string, Results> builds; // By build type
+    double wall_tolerance{0.5};
+    double alloc_tolerance{0.1}; // Allowed growth in allocations per unit
+    double min_wall_ms{1.0};     // Faster phases are too noisy to gate
+    std::map<std::string, double> phase_tolerance;
+};
+
+void print_usage(const char *prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --corpus DIR       Corpus sources (default tests/bench/corpus)\n"
+              << "  --work-dir DIR     Where linked REL modules go (default bench_corpus_tmp)\n"
+              << "  --iterations N     Iterations per phase, best is kept (default 5)\n"
+              << "  --output FILE      Results JSON (default bench_corpus.json)\n"
+              << "  --baseline FILE    Compare against this baseline; exit 1 on regression\n"
+              << "  --tolerance X      Wall-time tolerance (0.5 = 50% slower allowed)\n"
+              << "  --build-type NAME  Build type recorded with the results\n"
+              << "  --gate-wall        Fail on wall-time regressions, not just report them\n"
+              << "  --update-baseline  Write the results to the baseline file instead\n";
+}
+
+bool parse_args(int argc, char **argv, BenchOptions &opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--corpus") {
+            opts.corpus_dir = next();
+        } else if (arg == "--work-dir") {
+            opts.work_dir = next();
+        } else if (arg == "--iterations") {
+            opts.iterations = std::max(1, std::atoi(next().c_str()));
+        } else if (arg == "--output") {
+            opts.output = next();
+        } else if (arg == "--baseline") {
+            opts.baseline = next();
+        } else if (arg == "--tolerance") {
+            opts.tolerance = std::strtod(next().c_str(), nullptr);
+        } else if (arg == "--build-type") {
+            opts.build_type = next();
+            if (opts.build_type.empty()) {
+                opts.build_type = "default";
+            }
+        } else if (arg == "--gate-wall") {
+            opts.gate_wall = true;
+        } else if (arg == "--update-baseline") {
+            opts.update_baseline = true;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    if (!opts.tolerance) {
+        if (const char *env = std::getenv("EDASM_PERF_TOLERANCE")) {
+            opts.tolerance = std::strtod(env, nullptr);
+        }
+    }
+    if (const char *env = std::getenv("EDASM_PERF_GATE_WALL")) {
+        opts.gate_wall = opts.gate_wall || (env[0] != '\0' && std::string(env) != "0");
+    }
+    if (opts.update_baseline && opts.baseline.empty()) {
+        std::cerr << "--update-baseline needs --baseline FILE" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::optional<std::string> read_file(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// =========================================
+// Workloads
+// =========================================
+
+// Keep the faster of two measurements of the same phase
+void keep_best(std::map<std::string, Phase> &phases, const std::string &name, const Phase &p) {
+    auto it = phases.find(name);
+    if (it == phases.end() || p.wall_ms < it->second.wall_ms) {
+        phases[name] = p;
+    }
+}
+
+bool run_assemble(const BenchOptions &opts, Results &results) {
+    std::vector<std::string> sources;
+    for (const auto &name : kModules) {
+        auto text = read_file(std::filesystem::path(opts.corpus_dir) / (name + ".src"));
+        if (!text) {
+            std::cerr << "Missing corpus source: " << name << ".src" << std::endl;
+            return false;
+        }
+        sources.push_back(std::move(*text));
+    }
+
+    edasm::Assembler assembler;
+    edasm::Assembler::Options asm_opts;
+    asm_opts.collect_profile = true;
+
+    for (int iter = 0; iter < opts.iterations; ++iter) {
+        edasm::AssemblyProfile sum;
+        for (int r = 0; r < kAssembleRepeat; ++r) {
+            for (const auto &source : sources) {
+                auto result = assembler.assemble(source, asm_opts);
+                if (!result.success) {
+                    std::cerr << "Corpus assembly failed: " << result.errors.front() << std::endl;
+                    return false;
+                }
+                const auto &p = result.profile;
+                for (auto [into, from] : {std::pair{&sum.tokenize, &p.tokenize},
+                                          std::pair{&sum.includes, &p.includes},
+                                          std::pair{&sum.pass1, &p.pass1},
+                                          std::pair{&sum.pass2, &p.pass2},
+                                          std::pair{&sum.rel_build, &p.rel_build}}) {
+                    into->wall_ms += from->wall_ms;
+                    into->allocations += from->allocations;
+                }
+                sum.lines += p.lines;
+            }
+        }
+
+        const auto lines = static_cast<int64_t>(sum.lines);
+        auto phase = [lines](const edasm::PhaseProfile &p) {
+            return Phase{p.wall_ms, static_cast<int64_t>(p.allocations), lines};
+        };
+        keep_best(results.phases, "assemble.tokenize", phase(sum.tokenize));
+        keep_best(results.phases, "assemble.includes", phase(sum.includes));
+        keep_best(results.phases, "assemble.pass1", phase(sum.pass1));
+        keep_best(results.phases, "assemble.pass2", phase(sum.pass2));
+        keep_best(results.phases, "assemble.rel_build", phase(sum.rel_build));
+        keep_best(results.phases, "assemble.total", phase(sum.total()));
+    }
+    return true;
+}
+
+bool run_link(const BenchOptions &opts, Results &results) {
+    std::filesystem::create_directories(opts.work_dir);
+    std::vector<std::string> rel_files;
+    for (const auto &name : kModules) {
+        auto text = read_file(std::filesystem::path(opts.corpus_dir) / (name + ".src"));
+        edasm::Assembler assembler;
+        auto result = assembler.assemble(*text);
+        if (!result.success || !result.is_rel_file) {
+            std::cerr << "Corpus module is not REL: " << name << ".src" << std::endl;
+            return false;
+        }
+        const auto path = (std::filesystem::path(opts.work_dir) / (name + ".rel")).string();
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(result.rel_file_data.data()),
+                   static_cast<std::streamsize>(result.rel_file_data.size()));
+        rel_files.push_back(path);
+    }
+
+    edasm::Linker::Options link_opts;
+    link_opts.generate_map = true;
+    for (int iter = 0; iter < opts.iterations; ++iter) {
+        Phase phase;
+        const auto start = Clock::now();
+        for (int r = 0; r < kLinkRepeat; ++r) {
+            edasm::Linker linker;
+            auto result = linker.link(rel_files, link_opts);
+            if (!result.success) {
+                std::cerr << "Corpus link failed: " << result.errors.front() << std::endl;
+                return false;
+            }
+            phase.units += static_cast<int64_t>(result.output_data.size());
+        }
+        phase.wall_ms = elapsed_ms(start);
+        keep_best(results.phases, "link", phase);
+    }
+
+    for (const auto &path : rel_files) {
+        std::filesystem::remove(path);
+    }
+    std::error_code ec;
+    std::filesystem::remove(opts.work_dir, ec); // Only succeeds if empty
+    return true;
+}
+
+// Run the program on a fresh BusT until the trap opcode at DONE halts the CPU
+template <typename BusT> bool emulate_once(const std::vector<uint8_t> &code, Phase &phase) {
+    BusT bus;
+    edasm::BasicCPU<BusT> cpu(bus);
+    bus.write_binary_data(kProgramOrigin, code);
+    cpu.reset();
+    cpu.state().PC = kProgramOrigin;
+
+    const auto start = Clock::now();
+    while (cpu.step() && cpu.instruction_count() < kMaxInstructions) {
+    }
+    phase.wall_ms = elapsed_ms(start);
+    phase.units = static_cast<int64_t>(cpu.instruction_count());
+    if (cpu.instruction_count() >= kMaxInstructions) {
+        std::cerr << "Corpus program did not halt" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool run_emulate(const BenchOptions &opts, Results &results) {
+    auto text = read_file(std::filesystem::path(opts.corpus_dir) / (kProgram + ".src"));
+    if (!text) {
+        std::cerr << "Missing corpus source: " << kProgram << ".src" << std::endl;
+        return false;
+    }
+    edasm::Assembler assembler;
+    auto program = assembler.assemble(*text);
+    if (!program.success) {
+        std::cerr << "Corpus program failed to assemble" << std::endl;
+        return false;
+    }
+
+    for (int iter = 0; iter < opts.iterations; ++iter) {
+        Phase full;
+        Phase flat;
+        if (!emulate_once<edasm::Bus>(program.code, full) ||
+            !emulate_once<edasm::FlatBus>(program.code, flat)) {
+            return false;
+        }
+        keep_best(results.phases, "emulate", full);
+        keep_best(results.phases, "emulate.flat", flat);
+    }
+    return true;
+}
+
+// =========================================
+// JSON
+// =========================================
+
+// Results and baselines share one layout: a "builds" object keyed by build
+// type; tolerances are only written for a baseline
+std::string to_json(const Baseline &baseline, bool with_tolerances) {
+    std::ostringstream out;
+    out << "{\n";
+    if (with_tolerances) {
+        out << "  \"wall_tolerance\": " << baseline.wall_tolerance << ",\n";
+        out << "  \"alloc_tolerance\": " << baseline.alloc_tolerance << ",\n";
+        out << "  \"min_wall_ms\": " << baseline.min_wall_ms << ",\n";
+    }
+    out << "  \"builds\": {\n";
+    size_t b = 0;
+    for (const auto &[build_type, results] : baseline.builds) {
+        out << "    \"" << build_type << "\": {\n";
+        size_t n = 0;
+        for (const auto &[name, phase] : results.phases) {
+            char wall[32];
+            std::snprintf(wall, sizeof(wall), "%.3f", phase.wall_ms);
+            out << "      \"" << name << "\": {\"wall_ms\": " << wall;
+            if (phase.allocations >= 0) {
+                out << ", \"allocations\": " << phase.allocations;
+            }
+            out << ", \"units\": " << phase.units;
+            if (with_tolerances) {
+                auto it = baseline.phase_tolerance.find(name);
+                if (it != baseline.phase_tolerance.end()) {
+                    out << ", \"wall_tolerance\": " << it->second;
+                }
+            }
+            out << "}" << (++n < results.phases.size() ? "," : "") << "\n";
+        }
+        out << "    }" << (++b < baseline.builds.size() ? "," : "") << "\n";
+    }
+    out << "  }\n";
+    out << "}\n";
+    return out.str();
+}
+
+// Minimal reader for the JSON written above: objects, strings and numbers
+class JsonReader {
+  public:
+    explicit JsonReader(const std::string &text) : text_(text) {}
+
+    // Calls on_value(path, number) and on_string(path, text) for each leaf;
+    // path joins the object keys with '/'
+    template <typename OnNumber, typename OnString>
+    bool read(OnNumber on_number, OnString on_string) {
+        return value("", on_number, on_string) && (skip_space(), pos_ == text_.size());
+    }
+
+  private:
+    void skip_space() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+    }
+
+    bool expect(char c) {
+        skip_space();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<std::string> string() {
+        if (!expect('"')) {
+            return std::nullopt;
+        }
+        const size_t end = text_.find('"', pos_);
+        if (end == std::string::npos) {
+            return std::nullopt;
+        }
+        std::string s = text_.substr(pos_, end - pos_);
+        pos_ = end + 1;
+        return s;
+    }
+
+    template <typename OnNumber, typename OnString>
+    bool value(const std::string &path, OnNumber &on_number, OnString &on_string) {
+        skip_space();
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        if (text_[pos_] == '{') {
+            pos_++;
+            if (expect('}')) {
+                return true;
+            }
+            do {
+                auto key = string();
+                if (!key || !expect(':')) {
+                    return false;
+                }
+                if (!value(path.empty() ? *key : path + "/" + *key, on_number, on_string)) {
+                    return false;
+                }
+            } while (expect(','));
+            return expect('}');
+        }
+        if (text_[pos_] == '"') {
+            auto s = string();
+            if (s) {
+                on_string(path, *s);
+            }
+            return s.has_value();
+        }
+        const char *begin = text_.c_str() + pos_;
+        char *end = nullptr;
+        const double number = std::strtod(begin, &end);
+        if (end == begin) {
+            return false;
+        }
+        pos_ += static_cast<size_t>(end - begin);
+        on_number(path, number);
+        return true;
+    }
+
+    const std::string &text_;
+    size_t pos_{0};
+};
+
+std::optional<Baseline> load_baseline(const std::string &path) {
+    auto text = read_file(path);
+    if (!text) {
+        std::cerr << "Cannot read baseline: " << path << std::endl;
+        return std::nullopt;
+    }
+
+    Baseline baseline;
+    auto on_number = [&baseline](const std::string &key, double number) {
+        if (key == "wall_tolerance") {
+            baseline.wall_tolerance = number;
+        } else if (key == "alloc_tolerance") {
+            baseline.alloc_tolerance = number;
+        } else if (key == "min_wall_ms") {
+            baseline.min_wall_ms = number;
+        } else if (key.rfind("builds/", 0) == 0) {
+            // builds/<build type>/<phase>/<field>
+            const size_t type_end = key.find('/', 7);
+            const size_t slash = key.rfind('/');
+            if (type_end == std::string::npos || slash == type_end) {
+                return;
+            }
+            const std::string build_type = key.substr(7, type_end - 7);
+            const std::string phase = key.substr(type_end + 1, slash - type_end - 1);
+            const std::string field = key.substr(slash + 1);
+            Results &results = baseline.builds[build_type];
+            results.build_type = build_type;
+            Phase &p = results.phases[phase];
+            if (field == "wall_ms") {
+                p.wall_ms = number;
+            } else if (field == "allocations") {
+                p.allocations = static_cast<int64_t>(number);
+            } else if (field == "units") {
+                p.units = static_cast<int64_t>(number);
+            } else if (field == "wall_tolerance") {
+                baseline.phase_tolerance[phase] = number;
+            }
+        }
+    };
+    auto on_string = [](const std::string &, const std::string &) {};
+    if (!JsonReader(*text).read(on_number, on_string)) {
+        std::cerr << "Malformed baseline: " << path << std::endl;
+        return std::nullopt;
+    }
+    return baseline;
+}
+
+bool write_file(const std::string &path, const std::string &text) {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+    return static_cast<bool>(file);
+}
+
+// =========================================
+// Comparison
+// =========================================
+
+// Allocations per unit of work, or -1 if not measured
+double allocations_per_unit(const Phase &phase) {
+    if (phase.allocations < 0) {
+        return -1.0;
+    }
+    return static_cast<double>(phase.allocations) /
+           static_cast<double>(std::max<int64_t>(1, phase.units));
+}
+
+// Print one row per phase; returns the number of regressions
+int compare(const Results &current, const Baseline &baseline, const BenchOptions &opts) {
+    if (baseline.builds.empty()) {
+        std::cout << "Baseline has no recorded builds\n";
+        return 1;
+    }
+    // Without a baseline for this build type, gate allocations and work
+    // against another one and only report wall times
+    auto build = baseline.builds.find(current.build_type);
+    const bool same_build = build != baseline.builds.end();
+    if (!same_build) {
+        build = baseline.builds.begin();
+        std::cout << "No baseline for build type '" << current.build_type
+                  << "': wall times compared with '" << build->first
+                  << "', not gated (record one with --update-baseline)\n";
+    } else if (!opts.gate_wall) {
+        std::cout << "Wall times reported, not gated (--gate-wall or EDASM_PERF_GATE_WALL=1 "
+                     "gates them)\n";
+    }
+    const bool gate_wall = same_build && opts.gate_wall;
+
+    std::printf("%-20s %11s %11s %8s %10s %10s  %s\n", "phase", "base ms", "ms", "change",
+                "base a/u", "a/u", "status");
+    int regressions = 0;
+    for (const auto &[name, base] : build->second.phases) {
+        auto it = current.phases.find(name);
+        if (it == current.phases.end()) {
+            std::printf("%-20s %11s %11s %8s %10s %10s  %s\n", name.c_str(), "-", "-", "-", "-",
+                        "-", "MISSING");
+            regressions++;
+            continue;
+        }
+        const Phase &cur = it->second;
+
+        double tolerance = opts.tolerance.value_or(baseline.wall_tolerance);
+        if (!opts.tolerance) {
+            auto pt = baseline.phase_tolerance.find(name);
+            if (pt != baseline.phase_tolerance.end()) {
+                tolerance = pt->second;
+            }
+        }
+
+        const double base_per_unit = allocations_per_unit(base);
+        const double cur_per_unit = allocations_per_unit(cur);
+        std::string status = "ok";
+        if (cur.units != base.units) {
+            status = "WORK CHANGED (" + std::to_string(base.units) + " -> " +
+                     std::to_string(cur.units) + " units), update the baseline";
+        } else if (base_per_unit >= 0.0 &&
+                   cur_per_unit > base_per_unit * (1.0 + baseline.alloc_tolerance)) {
+            status = "ALLOCATION REGRESSION";
+        } else if (base.wall_ms < baseline.min_wall_ms) {
+            status = "ok (too fast to gate)";
+        } else if (cur.wall_ms > base.wall_ms * (1.0 + tolerance)) {
+            status = gate_wall ? "REGRESSION" : "slower (not gated)";
+        }
+        if (status.rfind("ok", 0) != 0 && status.find("not gated") == std::string::npos) {
+            regressions++;
+        }
+
+        auto per_unit = [](double value) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.3f", value);
+            return value >= 0.0 ? std::string(buf) : std::string("-");
+        };
+        const double change = base.wall_ms > 0.0 ? (cur.wall_ms / base.wall_ms - 1.0) * 100.0
+                                                 : 0.0;
+        std::printf("%-20s %11.3f %11.3f %+7.1f%% %10s %10s  %s\n", name.c_str(), base.wall_ms,
+                    cur.wall_ms, change, per_unit(base_per_unit).c_str(),
+                    per_unit(cur_per_unit).c_str(), status.c_str());
+    }
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions opts;
+    if (!parse_args(argc, argv, opts)) {
+        return 2;
+    }
+
+    Results results;
+    results.build_type = opts.build_type;
+    if (!run_assemble(opts, results) || !run_link(opts, results) ||
+        !run_emulate(opts, results)) {
+        return 2;
+    }
+
+    Baseline measured;
+    measured.builds[results.build_type] = results;
+    if (!write_file(opts.output, to_json(measured, false))) {
+        std::cerr << "Cannot write results: " << opts.output << std::endl;
+        return 2;
+    }
+    std::cout << "Results written to " << opts.output << "\n";
+
+    if (opts.baseline.empty()) {
+        std::cout << to_json(measured, false);
+        return 0;
+    }
+
+    if (opts.update_baseline) {
+        // Replace this build type's phases; keep the other build types and
+        // the tolerances of an existing baseline
+        Baseline updated;
+        if (std::filesystem::exists(opts.baseline)) {
+            auto existing = load_baseline(opts.baseline);
+            if (existing) {
+                updated = *existing;
+            }
+        }
+        updated.builds[results.build_type] = results;
+        if (!write_file(opts.baseline, to_json(updated, true))) {
+            std::cerr << "Cannot write baseline: " << opts.baseline << std::endl;
+            return 2;
+        }
+        std::cout << "Baseline updated: " << opts.baseline << "\n";
+        return 0;
+    }
+
+    auto baseline = load_baseline(opts.baseline);
+    if (!baseline) {
+        return 2;
+    }
+    const int regressions = compare(results, *baseline, opts);
+    if (regressions > 0) {
+        std::cout << regressions << " phase(s) regressed against " << opts.baseline << "\n";
+        return 1;
+    }
+    std::cout << "No regressions against " << opts.baseline << "\n";
+    return 0;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file source_generator.cpp
+ * @brief Synthetic EDASM source generator for assembler benchmarks
+ */
+
+#include "source_generator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace edasm::bench {
+
+namespace {
+
+constexpr size_t kExternCount = 64;        // REL symbol numbers are 8-bit
+constexpr size_t kIncludeEquates = 256;    // Equates per INCLUDE file
+constexpr size_t kLinesPerInclude = 20000; // One INCLUDE file per this many lines
+
+// Line writer that keeps a line count
+class Writer {
+  public:
+    explicit Writer(size_t reserve_lines) {
+        text_.reserve(reserve_lines * 24);
+    }
+
+    // Instruction or directive without label
+    void op(const char *mnem, const std::string &operand = {}) {
+        labeled({}, mnem, operand);
+    }
+
+    void labeled(const std::string &label, const char *mnem, const std::string &operand = {}) {
+        text_ += label;
+        text_.append(label.size() < 8 ? 8 - label.size() : 1, ' ');
+        text_ += mnem;
+        if (!operand.empty()) {
+            text_ += ' ';
+            text_ += operand;
+        }
+        text_ += '\n';
+        ++lines_;
+    }
+
+    void comment(const std::string &text) {
+        text_ += "* ";
+        text_ += text;
+        text_ += '\n';
+        ++lines_;
+    }
+
+    size_t lines() const {
+        return lines_;
+    }
+
+    std::string take() {
+        return std::move(text_);
+    }
+
+  private:
+    std::string text_;
+    size_t lines_{0};
+};
+
+std::string hex(unsigned value, int digits) {
+    char buf[8];
+    std::snprintf(buf, sizeof(buf), "$%0*X", digits, value);
+    return buf;
+}
+
+std::string name(char prefix, size_t index) {
+    return prefix + std::to_string(index);
+}
+
+// Write one INCLUDE file of equates plus a small subroutine
+size_t write_include(const std::filesystem::path &path, size_t file_index, std::mt19937 &rng) {
+    Writer w(kIncludeEquates + 16);
+    w.comment("Generated equates file " + std::to_string(file_index));
+    const std::string prefix = "Q" + std::to_string(file_index) + "_";
+    for (size_t i = 0; i < kIncludeEquates; ++i) {
+        w.labeled(prefix + std::to_string(i), "EQU", hex(rng() & 0xFFFF, 4));
+    }
+    w.labeled("SUB" + std::to_string(file_index), "LDA", "#<" + prefix + "0");
+    w.op("STA", prefix + "1");
+    w.op("LDX", "#>" + prefix + "2");
+    w.op("RTS");
+
+    std::ofstream out(path, std::ios::binary);
+    std::string text = w.take();
+    out << text;
+    return w.lines();
+}
+
+// Emit one block (55-59 lines) of code and data
+void emit_block(Writer &w, size_t i, bool last, bool use_rel, size_t include_count,
+                std::mt19937 &rng) {
+    const std::string blk = name('B', i);
+    const std::string loop = name('L', i);
+    const std::string skip = name('S', i);
+    const std::string table = name('T', i);
+    const std::string vec = name('V', i);
+    const std::string msg = name('M', i);
+    const std::string dci = name('D', i);
+    const std::string eq = name('E', i);
+    const std::string next = last ? std::string("B0") : name('B', i + 1); // forward ref
+
+    w.comment("Block " + std::to_string(i));
+    w.op("ORG", "$1000");
+    if (use_rel && i % 8 == 0) {
+        w.op("ENT", blk);
+    }
+
+    // Dense equates, later ones built from earlier ones
+    w.labeled(eq + "A", "EQU", hex(rng() & 0xFFFF, 4));
+    w.labeled(eq + "B", "EQU", eq + "A+" + std::to_string(rng() % 200));
+    w.labeled(eq + "C", "EQU", eq + "B*2");
+    w.labeled(eq + "D", "EQU", eq + "A^$0FF0|$8000");
+
+    // Loop body: immediate, absolute and indexed forms
+    w.labeled(blk, "LDX", "#" + std::to_string(1 + rng() % 15));
+    w.labeled(loop, "LDA", table + ",X");
+    w.op("CLC");
+    w.op("ADC", "#<" + eq + "B");
+    w.op("STA", eq + "C,Y");
+    w.op("LDA", eq + "A+" + std::to_string(rng() % 16) + ",X");
+    w.op("AND", "#>" + eq + "D");
+    w.op("EOR", "#%1010" + std::string(rng() % 2 ? "1" : "0"));
+    w.op("ORA", "#" + std::to_string(rng() % 256));
+    w.op("CMP", "#" + eq + "A!$FF");
+    w.op("DEX");
+    w.op("BNE", loop);
+    w.op("BEQ", skip);
+    w.op("NOP");
+    w.labeled(skip, "LDY", "#0");
+
+    // Conditional assembly
+    w.op("DO", i % 3 ? "FLAGON" : "FLAGOFF");
+    w.op("LDA", "#1");
+    w.op("STA", eq + "A");
+    w.op("ELSE");
+    w.op("LDA", "#2");
+    w.op("STA", eq + "B");
+    w.op("FIN");
+
+    // Calls: forward reference, include subroutine, external
+    w.op("JSR", next);
+    if (include_count > 0) {
+        w.op("JSR", "SUB" + std::to_string(i % include_count));
+        w.op("LDA", "Q" + std::to_string(i % include_count) + "_" +
+                        std::to_string(rng() % kIncludeEquates));
+    }
+    if (use_rel) {
+        w.op("JSR", name('X', i % kExternCount));
+    }
+    w.op("INX");
+    w.op("INY");
+    w.op("PHA");
+    w.op("PLA");
+    w.op("TAX");
+    w.op("TXA");
+    w.op("SEC");
+    w.op("SBC", "#1");
+    w.op("BIT", eq + "A");
+    w.op("INC", eq + "B");
+    w.op("DEC", eq + "C,X");
+
+    // Zero page, indirect and accumulator forms
+    w.op("LDA", hex(rng() & 0xFF, 2));
+    w.op("STA", hex(rng() & 0xFF, 2) + ",X");
+    w.op("LDX", hex(rng() & 0xFF, 2) + ",Y");
+    w.op("LDA", "(" + hex(rng() & 0xFE, 2) + ",X)");
+    w.op("STA", "(" + hex(rng() & 0xFE, 2) + "),Y");
+    w.op("ASL", "A");
+    w.op("ROR", "A");
+    w.op("JMP", "(" + vec + ")");
+
+    // Data tables
+    std::string bytes;
+    for (int b = 0; b < 16; ++b) {
+        if (b) {
+            bytes += ',';
+        }
+        bytes += hex(rng() & 0xFF, 2);
+    }
+    w.labeled(table, "DB", bytes);
+    w.op("DFB", bytes);
+    w.labeled(vec, "DW", blk + "," + loop + "+1," + skip + "," + next);
+    w.op("DA", table + "," + msg);
+    w.labeled(msg, "ASC", "\"SYNTHETIC BLOCK " + std::to_string(i) + "\"");
+    w.labeled(dci, "DCI", "\"END\"");
+    w.op("DS", std::to_string(1 + rng() % 8));
+}
+
+} // namespace
+
+GeneratedSource generate_source(const GeneratorOptions &opts) {
+    GeneratedSource out;
+    std::mt19937 rng(opts.seed);
+    Writer w(opts.target_lines);
+
+    w.comment("Synthetic EDASM benchmark source");
+    w.comment("Target lines: " + std::to_string(opts.target_lines));
+    w.op("ORG", "$0800");
+    if (opts.use_rel) {
+        w.op("REL");
+        for (size_t e = 0; e < kExternCount; ++e) {
+            w.op("EXT", name('X', e));
+        }
+    }
+    w.labeled("FLAGON", "EQU", "1");
+    w.labeled("FLAGOFF", "EQU", "0");
+
+    size_t include_count = 0;
+    if (!opts.include_dir.empty()) {
+        std::filesystem::path dir = std::filesystem::absolute(opts.include_dir);
+        std::filesystem::create_directories(dir);
+        include_count = std::max<size_t>(1, opts.target_lines / kLinesPerInclude);
+        for (size_t f = 0; f < include_count; ++f) {
+            auto path = dir / ("equates" + std::to_string(f) + ".src");
+            out.include_lines += write_include(path, f, rng);
+            out.include_files.push_back(path.string());
+            w.op("INCLUDE", path.string());
+        }
+    }
+
+    // Blocks are 55-58 lines each (plus an ENT line every 8th block in REL mode)
+    const size_t block_lines = 55 + (include_count > 0 ? 2 : 0) + (opts.use_rel ? 1 : 0);
+    const size_t used = w.lines() + 1; // header + END
+    const size_t remaining = opts.target_lines > used ? opts.target_lines - used : 0;
+    const size_t blocks = std::max<size_t>(1, remaining / block_lines);
+    for (size_t block = 0; block < blocks; ++block) {
+        emit_block(w, block, block + 1 == blocks, opts.use_rel, include_count, rng);
+    }
+    w.op("END");
+
+    out.lines = w.lines();
+    out.text = w.take();
+    return out;
+}
+
+} // namespace edasm::bench
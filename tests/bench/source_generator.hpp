@@ -0,0 +1,51 @@
+/**
+ * @file source_generator.hpp
+ * @brief Synthetic EDASM source generator for assembler benchmarks
+ *
+ * Produces deterministic, assemblable EDASM sources of any size (1k to 1M+
+ * lines) exercising the whole front end: every 6502 addressing mode, dense
+ * equates, forward references, INCLUDE files, DO/ELSE/FIN blocks,
+ * REL/ENT/EXT and large DB/DW/ASC/DCI tables.
+ *
+ * Each block starts with its own ORG, so block sizes (and the branch
+ * offsets inside a block) do not depend on the random operands of the
+ * blocks before it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace edasm::bench {
+
+/**
+ * @brief Generator settings
+ */
+struct GeneratorOptions {
+    size_t target_lines{1000}; ///< Approximate number of source lines
+    uint32_t seed{1};          ///< RNG seed (same seed -> same source)
+    bool use_rel{true};        ///< Emit REL/ENT/EXT
+    std::string include_dir;   ///< Directory for INCLUDE files (empty: none)
+};
+
+/**
+ * @brief Generated source plus the INCLUDE files it references
+ */
+struct GeneratedSource {
+    std::string text;                       ///< Main source text
+    std::vector<std::string> include_files; ///< Absolute paths written
+    size_t lines{0};                        ///< Lines in text
+    size_t include_lines{0};                ///< Lines across all include files
+};
+
+/**
+ * @brief Generate a synthetic source (writes include files if requested)
+ * @param opts Generator settings
+ * @return GeneratedSource Source text and metadata
+ */
+GeneratedSource generate_source(const GeneratorOptions &opts);
+
+} // namespace edasm::bench
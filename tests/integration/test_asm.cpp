@@ -6,7 +6,7 @@
 
 int main(int argc, char **argv) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <source_file>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <source_file> [--profile]" << std::endl;
         return 1;
     }
 
@@ -21,9 +21,16 @@ int main(int argc, char **argv) {
     buffer << file.rdbuf();
     std::string source = buffer.str();
 
+    edasm::Assembler::Options opts;
+    for (int i = 2; i < argc; ++i) {
+        if (std::string(argv[i]) == "--profile") {
+            opts.collect_profile = true;
+        }
+    }
+
     // Assemble
     edasm::Assembler assembler;
-    auto result = assembler.assemble(source);
+    auto result = assembler.assemble(source, opts);
 
     // Report results
     std::cout << "Assembly ";
@@ -78,5 +85,11 @@ int main(int argc, char **argv) {
         }
     }
 
+    // Print phase profile
+    if (result.profile.enabled) {
+        std::cout << "\nProfile:" << std::endl;
+        std::cout << std::dec << result.profile.to_string();
+    }
+
     return result.success ? 0 : 1;
 }
@@ -1,11 +1,23 @@
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <span>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "edasm/assembler/assembler.hpp"
+#include "edasm/assembler/char_scanner.hpp"
+#include "edasm/assembler/constexpr_assembler.hpp"
+#include "edasm/assembler/linker.hpp"
+#include "edasm/assembler/name_interner.hpp"
+#include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/disassembly.hpp"
+#include "edasm/files/symbol_database.hpp"
 
 using namespace edasm;
 
@@ -20,6 +32,18 @@ void ensure_tmp_dir() {
     std::filesystem::create_directories("tmp");
 }
 
+// Helper to assemble a REL module and write it for the linker; returns the
+// REL image
+std::vector<uint8_t> write_rel_module(const std::string &path, const std::string &source) {
+    Assembler assembler;
+    auto rel = assembler.assemble(source);
+    assert(rel.success && rel.is_rel_file);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(rel.rel_file_data.data()),
+               static_cast<std::streamsize>(rel.rel_file_data.size()));
+    return rel.rel_file_data;
+}
+
 // Helper to print errors
 void print_errors(const Assembler::Result &result) {
     if (!result.errors.empty()) {
@@ -528,6 +552,959 @@ void test_chn_from_include_error() {
     std::cout << "  ✓ CHN from INCLUDE error test passed" << std::endl;
 }
 
+// Upstream resource that tracks outstanding bytes handed to the arena
+class CountingResource : public std::pmr::memory_resource {
+  public:
+    size_t outstanding{0};
+    size_t allocations{0};
+
+  private:
+    void *do_allocate(size_t bytes, size_t align) override {
+        outstanding += bytes;
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t align) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void test_arena_reuse() {
+    std::cout << "Testing per-assembly arena reuse..." << std::endl;
+
+    std::string source = R"(
+        ORG $1000
+        REL
+        EXT PRINT
+        ENT START
+START   LDA #<MSG
+        JSR PRINT
+        RTS
+MSG     ASC "HELLO"
+        END
+)";
+
+    CountingResource upstream;
+    std::vector<uint8_t> first_code;
+    std::vector<uint8_t> first_rel;
+    {
+        Assembler assembler(&upstream);
+        Assembler::Options opts;
+        opts.generate_listing = true;
+
+        auto first = assembler.assemble(source, opts);
+        print_errors(first);
+        assert(first.success);
+        assert(upstream.allocations > 0);
+        first_code = first.code;
+        first_rel = first.rel_file_data;
+
+        // Symbols stay valid until the next assembly
+        assert(assembler.symbols().lookup("START") != nullptr);
+        assert(assembler.symbols().lookup("MSG")->value == 0x1006);
+
+        // Second run on the same assembler reuses the released arena
+        auto second = assembler.assemble(source, opts);
+        assert(second.success);
+        assert(second.code == first_code);
+        assert(second.rel_file_data == first_rel);
+        assert(second.listing == first.listing);
+
+        // reset() hands every block back to the upstream resource
+        assembler.reset();
+        assert(upstream.outstanding == 0);
+    }
+
+    // Results are plain heap data that outlive the assembler
+    assert(!first_code.empty());
+    assert(first_rel.size() > first_code.size());
+    assert(upstream.outstanding == 0);
+
+    std::cout << "  ✓ Arena reuse test passed" << std::endl;
+}
+
+void test_assembly_profile() {
+    std::cout << "Testing assembly profile..." << std::endl;
+
+    std::string source = R"(
+        ORG $1000
+        REL
+        ENT START
+COUNT   EQU 3
+START   LDX #COUNT
+LOOP    DEX
+        BNE LOOP
+        RTS
+TABLE   DW START,LOOP
+        END
+)";
+
+    Assembler assembler;
+    Assembler::Options opts;
+    auto plain = assembler.assemble(source, opts);
+    assert(plain.success);
+    assert(!plain.profile.enabled);
+
+    opts.collect_profile = true;
+    opts.generate_listing = true;
+    auto result = assembler.assemble(source, opts);
+    print_errors(result);
+    assert(result.success);
+    assert(result.code == plain.code);
+
+    const auto &profile = result.profile;
+    assert(profile.enabled);
+    assert(profile.lines == 11);
+    assert(profile.symbols == 4);
+    assert(profile.expression_evaluations > 0);
+    assert(profile.tokenize.allocations > 0);
+    assert(profile.pass1.allocations > 0);
+    assert(profile.rel_build.allocations > 0);
+    assert(profile.total().bytes_allocated >= profile.tokenize.bytes_allocated);
+    assert(profile.total().wall_ms >= 0.0);
+
+    auto lines = profile.format_lines();
+    assert(lines.size() == 9);
+    assert(lines[1].rfind("tokenize", 0) == 0);
+    assert(profile.to_string().find("Symbols: 4") != std::string::npos);
+
+    std::cout << "  ✓ Assembly profile test passed" << std::endl;
+}
+
+void test_sorted_symbol_views() {
+    std::cout << "Testing cached sorted symbol views..." << std::endl;
+
+    // Large enough to take the multi-threaded sort path, which is opt-in
+    SymbolTable table;
+    table.set_sort_threads(4);
+    const size_t count = SymbolTable::kParallelSortThreshold * 3 + 7;
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t value = static_cast<uint16_t>((i * 7919) % 4096);
+        table.define("S" + std::to_string((i * 104729) % 1000003), value);
+    }
+
+    auto by_name = table.by_name();
+    assert(by_name.size() == table.size());
+    for (size_t i = 1; i < by_name.size(); ++i) {
+        assert(by_name[i - 1]->name < by_name[i]->name);
+    }
+
+    auto by_value = table.by_value();
+    assert(by_value.size() == table.size());
+    for (size_t i = 1; i < by_value.size(); ++i) {
+        const Symbol *a = by_value[i - 1];
+        const Symbol *b = by_value[i];
+        assert(a->value < b->value || (a->value == b->value && a->name < b->name));
+    }
+
+    // Views are cached (same storage) until the table changes
+    assert(table.by_name().data() == by_name.data());
+    assert(table.by_value().data() == by_value.data());
+
+    table.define("AAAA", 0xFFFF);
+    assert(!by_name.valid() && !by_value.valid());
+    auto renamed = table.by_name();
+    assert(renamed.valid());
+    assert(renamed.size() == count + 1);
+    assert(renamed.front()->name == "AAAA");
+    assert(table.by_value().back()->name == "AAAA");
+
+    // Copying API still agrees with the views
+    auto copies = table.sorted_by_name();
+    assert(copies.size() == renamed.size());
+    assert(copies[1].name == renamed[1]->name);
+
+    std::cout << "  ✓ Sorted symbol view test passed" << std::endl;
+}
+
+void test_lazy_conditional_skip() {
+    std::cout << "Testing lazy tokenization of skipped conditional blocks..." << std::endl;
+
+    // Lower-case directives inside the skipped block must still be found
+    std::string source = R"(
+        ORG $1000
+VARIANT EQU 0
+        DO VARIANT
+        LDA #$01
+        STA $2000
+        JMP $3000
+        else
+        LDA #$02
+        DO 0
+        NOP
+        NOP
+        fin
+        RTS
+)";
+
+    Assembler assembler;
+    Assembler::Options opts;
+    opts.collect_profile = true;
+    opts.generate_listing = true;
+    auto result = assembler.assemble(source, opts);
+    print_errors(result);
+    assert(result.success);
+    std::vector<uint8_t> expected = {0xA9, 0x02, 0x60};
+    assert(result.code == expected);
+
+    // The three instructions under DO VARIANT and the two NOPs are never tokenized
+    const auto &profile = result.profile;
+    assert(profile.lines == 14);
+    assert(profile.tokenized_lines == profile.lines - 5);
+
+    // Skipped lines are listed from their raw text, with no address or bytes,
+    // and conditional directives are listed the same way
+    assert(result.listing.find("0006                             STA $2000\n") !=
+           std::string::npos);
+    assert(result.listing.find("0008                             else\n") != std::string::npos);
+    assert(result.listing.find("0009  1000  A9 02                LDA #$02\n") !=
+           std::string::npos);
+    assert(result.listing.find("0011                             NOP\n"
+                               "0012                             NOP\n"
+                               "0013                             fin\n"
+                               "0014  1002  60                   RTS\n") != std::string::npos);
+
+    std::cout << "  ✓ Lazy conditional skip test passed" << std::endl;
+}
+
+void test_symbol_snapshot_include() {
+    std::cout << "Testing precompiled symbol snapshot for INCLUDE..." << std::endl;
+
+    ensure_tmp_dir();
+
+    const std::string equates = "* Shared equates\n"
+                                "COUT    EQU $FDED\n"
+                                "HOME    EQU $FC58\n"
+                                "CR      EQU $8D\n"
+                                "TWO_CR  EQU CR*2\n";
+    {
+        std::ofstream file("tmp/test_snapshot_equs.src");
+        file << equates;
+    }
+
+    std::string error;
+    auto built = SymbolSnapshot::build(equates, "tmp/test_snapshot_equs.src", &error);
+    assert(built.has_value());
+    assert(built->entries().size() == 4);
+    bool saved = built->save("tmp/test_snapshot_equs.sym");
+    assert(saved);
+
+    auto snapshot = SymbolSnapshot::load("tmp/test_snapshot_equs.sym", &error);
+    assert(snapshot.has_value());
+    assert(snapshot->source_hash() == SymbolSnapshot::content_hash(equates));
+    assert(snapshot->source_path() == "tmp/test_snapshot_equs.src");
+    assert(snapshot->serialize() == built->serialize());
+
+    std::string source = R"(
+        ORG $1000
+        INCLUDE "tmp/test_snapshot_equs.src"
+        LDA #CR
+        JSR HOME
+        JMP COUT
+)";
+
+    Assembler assembler;
+    Assembler::Options opts;
+    auto from_text = assembler.assemble(source, opts);
+    print_errors(from_text);
+    assert(from_text.success);
+
+    opts.collect_profile = true;
+    opts.generate_listing = true;
+    opts.symbol_snapshots.push_back(&*snapshot);
+    auto from_snapshot = assembler.assemble(source, opts);
+    print_errors(from_snapshot);
+    assert(from_snapshot.success);
+    assert(from_snapshot.code == from_text.code);
+    // Only the main file's lines were tokenized
+    assert(from_snapshot.profile.lines == 5);
+    // The INCLUDE itself is listed in place of the file's lines
+    assert(from_snapshot.listing.find("0003                             INCLUDE "
+                                      "\"tmp/test_snapshot_equs.src\"  [SNAPSHOT]\n"
+                                      "0004  1000  A9 8D") != std::string::npos);
+
+    const Symbol *two_cr = assembler.symbols().lookup("TWO_CR");
+    assert(two_cr && two_cr->value == 0x11A && two_cr->line_defined == 5);
+    assert(two_cr->is_unreferenced());
+    assert(!assembler.symbols().lookup("COUT")->is_unreferenced());
+
+    // A snapshot symbol the source already defined is reported, not overwritten
+    auto duplicate = assembler.assemble("CR      EQU $0D\n" + source, opts);
+    assert(!duplicate.success);
+    assert(duplicate.errors.size() == 1);
+    assert(duplicate.errors[0] == "Line 4: DUPLICATE SYMBOL: CR");
+    assert(assembler.symbols().lookup("CR")->value == 0x0D);
+
+    // Editing the file changes its hash, so the stale snapshot is ignored
+    {
+        std::ofstream file("tmp/test_snapshot_equs.src");
+        file << equates << "EXTRA   EQU $01\n";
+    }
+    auto edited = assembler.assemble(source, opts);
+    assert(edited.success);
+    assert(edited.profile.lines == 11);
+    assert(assembler.symbols().lookup("EXTRA") != nullptr);
+
+    // Files with code or PC-relative labels cannot be snapshotted
+    assert(!SymbolSnapshot::build("START   LDA #1\n", "code.src", &error));
+    assert(!SymbolSnapshot::build("        INCLUDE \"X\"\n", "inc.src", &error));
+    assert(!SymbolSnapshot::deserialize(std::vector<uint8_t>{'E', 'D', 'S', 'Y', 1}, &error));
+
+    std::cout << "  ✓ Symbol snapshot test passed" << std::endl;
+}
+
+void test_rel_output_writer() {
+    std::cout << "Testing presized code and streamed REL output..." << std::endl;
+
+    std::string source = R"(
+        ORG $1000
+        REL
+        ENT START
+        EXT PRINTER_ROUTINE
+START   LDA #$01
+        JSR PRINTER_ROUTINE
+        JMP START
+TABLE   DW START,TABLE
+        DS 8
+        RTS
+)";
+
+    Assembler assembler;
+    Assembler::Options opts;
+    auto result = assembler.assemble(source, opts);
+    print_errors(result);
+    assert(result.success);
+    assert(result.is_rel_file);
+
+    // Pass 1's estimate covers the emitted code, so the buffer never regrew
+    assert(result.code.capacity() >= result.code.size());
+    assert(result.code.capacity() <= result.code.size() + 16);
+
+    // Streaming produces exactly the in-memory image
+    std::ostringstream streamed;
+    bool written = assembler.write_rel_file(streamed, result);
+    assert(written);
+    const std::string &bytes = streamed.str();
+    assert(bytes == std::string(result.rel_file_data.begin(), result.rel_file_data.end()));
+
+    // Image can be skipped entirely when the caller streams it
+    opts.build_rel_image = false;
+    auto lean = assembler.assemble(source, opts);
+    assert(lean.success && lean.is_rel_file && lean.rel_file_data.empty());
+    std::ostringstream lean_stream;
+    written = assembler.write_rel_file(lean_stream, lean);
+    assert(written);
+    assert(lean_stream.str() == bytes);
+
+    // Parsing the image returns the same records
+    std::vector<uint8_t> code;
+    std::vector<RLDEntry> rld;
+    std::vector<ESDEntry> esd;
+    bool parsed = RELFileBuilder::parse(result.rel_file_data, code, rld, esd);
+    assert(parsed);
+    assert(code == result.code);
+    assert(!rld.empty());
+    assert(esd.size() == 2);
+
+    std::cout << "  ✓ REL output writer test passed" << std::endl;
+}
+
+void test_char_scanner() {
+    std::cout << "Testing block character-class scanner..." << std::endl;
+
+    // Reference: first offset >= pos where pred holds, else size
+    auto reference = [](std::string_view text, size_t pos, auto pred) {
+        while (pos < text.size() && !pred(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        return pos;
+    };
+    auto blank = [](unsigned char c) { return c == ' ' || c == '\t'; };
+    auto label = [](unsigned char c) { return std::isalnum(c) || c == '_' || c == '@'; };
+
+    // Random text over a small alphabet (including high-bit bytes) so every
+    // class boundary lands at varied offsets inside and across 16-byte blocks
+    const std::string alphabet = "aZ09_@ \t;\n$#,.*[{`\x80\xff";
+    uint32_t seed = 12345;
+    for (int iter = 0; iter < 2000; ++iter) {
+        std::string text;
+        seed = seed * 1103515245 + 12345;
+        const size_t len = (seed >> 16) % 70;
+        for (size_t i = 0; i < len; ++i) {
+            seed = seed * 1103515245 + 12345;
+            // Long runs of one character exercise whole-block skips
+            const char c = alphabet[(seed >> 16) % alphabet.size()];
+            const size_t run = (seed >> 8) % 4 == 0 ? 20 : 1;
+            text.append(run, c);
+        }
+        for (size_t pos = 0; pos <= text.size(); pos += 1 + pos % 5) {
+            std::string_view t(text);
+            assert(CharScanner::find_newline(t, pos) ==
+                   reference(t, pos, [](unsigned char c) { return c == '\n'; }));
+            assert(CharScanner::find_semicolon(t, pos) ==
+                   reference(t, pos, [](unsigned char c) { return c == ';'; }));
+            assert(CharScanner::find_blank_or_semicolon(t, pos) ==
+                   reference(t, pos, [&](unsigned char c) { return blank(c) || c == ';'; }));
+            assert(CharScanner::skip_blanks(t, pos) ==
+                   reference(t, pos, [&](unsigned char c) { return !blank(c); }));
+            assert(CharScanner::skip_label_chars(t, pos) ==
+                   reference(t, pos, [&](unsigned char c) { return !label(c); }));
+        }
+    }
+
+    // Fields longer than one block still tokenize correctly
+    auto line = Tokenizer::parse_line("A_VERY_LONG_LABEL_NAME_X    lda   "
+                                      "(SOME_LONG_ZERO_PAGE_NAME),Y    ; comment here",
+                                      1);
+    assert(line.label == "A_VERY_LONG_LABEL_NAME_X");
+    assert(line.mnemonic == "LDA");
+    assert(line.operand == "(SOME_LONG_ZERO_PAGE_NAME),Y");
+    assert(line.comment == "; comment here");
+
+    std::cout << "  ✓ Character scanner test passed (vectorized: "
+              << (CharScanner::vectorized() ? "yes" : "no") << ")" << std::endl;
+}
+
+// Test: compile-time assembler matches the runtime assembler, including
+// branches and zero-page operands ahead of the labels they move
+static constexpr char kConstexprSource[] = R"(
+* Compile-time fixture
+        ORG $0300
+PTR     EQU $06
+HOME    EQU $FC58
+START   JSR HOME
+        LDA #<MSG
+        STA PTR
+        LDA #>MSG
+        STA PTR+1
+        LDY #$00
+NEXT    LDA (PTR),Y      ; print until NUL
+        BEQ DONE
+        JSR $FDED
+        INY
+        BNE NEXT
+DONE    RTS
+        MSB ON
+MSG     ASC "HI"
+        DB $8D,0
+        DW START,DONE-START
+        DS 2
+)";
+
+void test_constexpr_assembler() {
+    std::cout << "Testing compile-time assembler..." << std::endl;
+
+    constexpr auto code = ct::assemble<kConstexprSource>();
+    static_assert(ct::origin<kConstexprSource>() == 0x0300);
+    static_assert(code.size() == 36);
+
+    auto result = assemble_source(kConstexprSource);
+    print_errors(result);
+    assert(result.success);
+    assert(result.code.size() == code.size());
+    assert(std::equal(code.begin(), code.end(), result.code.begin()));
+
+    // Same entry point usable at run time, reporting errors via the flag
+    uint8_t buffer[4] = {};
+    auto ok = ct::assemble_into(" LDA #1\n RTS\n", buffer, sizeof(buffer));
+    assert(ok.success && ok.size == 3 && buffer[0] == 0xA9 && buffer[2] == 0x60);
+    assert(!ct::assemble_into(" LDA UNDEFINED\n").success);
+    assert(!ct::assemble_into(" FOO $12\n").success);
+    assert(!ct::assemble_into("L BNE L\n DS 200\n BNE L\n").success);
+
+    // Line splitting and evaluation are the runtime code, run at compile time
+    constexpr LineFields fields = Tokenizer::split_fields("LOOP: lda ($10),y ; next");
+    static_assert(fields.label == "LOOP" && fields.mnemonic == "lda");
+    static_assert(fields.operand == "($10),y" && fields.comment == "; next");
+    auto no_symbols = [](std::string_view) -> std::optional<ExpressionSymbol> { return {}; };
+    static_assert(ExpressionEvaluator::evaluate_with(">$1234+(2*3)", 2, no_symbols).value == 0x12);
+    static_assert(ExpressionEvaluator::evaluate_with("LATER", 1, no_symbols).is_forward_ref);
+    static_assert(ExpressionEvaluator::evaluate_with("LATER", 2, no_symbols).error ==
+                  ExpressionError::UndefinedSymbol);
+
+    std::cout << "  ✓ Compile-time assembler test passed" << std::endl;
+}
+
+// Test: iterative sizing shrinks zero-page operands, including forward refs
+void test_zero_page_shrinking() {
+    std::cout << "Testing zero-page operand shrinking..." << std::endl;
+
+    const std::string source = R"(
+        ORG $0080
+SAVE    DS 1
+        ORG $0800
+START   LDA PTR          ; forward EQU in zero page
+        STA PTR+1,X
+        LDX COUNT
+        STY SAVE         ; backward zero-page label
+        LDA BIG          ; does not fit, stays absolute
+        JMP DONE
+DONE    RTS
+PTR     EQU $80
+COUNT   EQU $10
+BIG     EQU $1234
+)";
+
+    // Default: symbolic operands are absolute; pass 1 sizes match pass 2
+    auto plain = assemble_source(source);
+    print_errors(plain);
+    assert(plain.success);
+    const std::vector<uint8_t> absolute = {0x00, 0xAD, 0x80, 0x00, 0x9D, 0x81, 0x00, 0xAE,
+                                           0x10, 0x00, 0x8C, 0x80, 0x00, 0xAD, 0x34, 0x12,
+                                           0x4C, 0x12, 0x08, 0x60};
+    assert(plain.code == absolute);
+
+    Assembler assembler;
+    Assembler::Options opts;
+    opts.shrink_zero_page = true;
+    opts.generate_listing = true;
+    auto shrunk = assembler.assemble(source, opts);
+    print_errors(shrunk);
+    assert(shrunk.success);
+    const std::vector<uint8_t> zero_page = {0x00, 0xA5, 0x80, 0x95, 0x81, 0xA6, 0x10, 0x84,
+                                            0x80, 0xAD, 0x34, 0x12, 0x4C, 0x0E, 0x08, 0x60};
+    assert(shrunk.code == zero_page);
+    assert(assembler.symbols().lookup("DONE")->value == 0x080E);
+
+    // Each shrunk operand is annotated in the listing
+    size_t notes = 0;
+    for (size_t pos = shrunk.listing.find("[ZP]"); pos != std::string::npos;
+         pos = shrunk.listing.find("[ZP]", pos + 1)) {
+        notes++;
+    }
+    assert(notes == 4);
+    assert(shrunk.listing.find("LDA BIG          ; does not fit, stays absolute  [ZP]") ==
+           std::string::npos);
+
+    std::cout << "  ✓ Zero-page shrinking test passed" << std::endl;
+}
+
+// Test: pass 1 sizes instructions as pass 2 encodes them (default options)
+void test_pass1_instruction_sizing() {
+    std::cout << "Testing pass 1 instruction sizing..." << std::endl;
+
+    const std::string source = R"(
+        ORG $0800
+START   LDA $12          ; zero page: 2 bytes
+        BNE SKIP         ; branch: 2 bytes
+        ASL A            ; accumulator: 1 byte
+SKIP    LDA TAB,X
+        STA ($34,X)
+        LDA (PTR),Y
+        JMP (VEC)
+TAB     DB $AA
+VEC     DW START
+PTR     EQU $06
+)";
+
+    Assembler assembler;
+    auto result = assembler.assemble(source, Assembler::Options{});
+    print_errors(result);
+    assert(result.success);
+
+    // Labels after short instructions get the addresses pass 2 emits them at
+    assert(assembler.symbols().lookup("SKIP")->value == 0x0805);
+    assert(assembler.symbols().lookup("TAB")->value == 0x080F);
+    assert(assembler.symbols().lookup("VEC")->value == 0x0810);
+
+    // Indexed and indirect operands evaluate without their addressing syntax
+    const std::vector<uint8_t> expected = {0xA5, 0x12, 0xD0, 0x01, 0x0A, 0xBD, 0x0F, 0x08, 0x81,
+                                           0x34, 0xB1, 0x06, 0x6C, 0x10, 0x08, 0xAA, 0x00, 0x08};
+    assert(result.code == expected);
+
+    auto indexed = assemble_source(" LDA $12,X\n LDA TAB,Y\n STA ($34,X)\nTAB DB 0\n");
+    print_errors(indexed);
+    assert(indexed.success);
+    assert((indexed.code == std::vector<uint8_t>{0xB5, 0x12, 0xB9, 0x07, 0x08, 0x81, 0x34, 0x00}));
+
+    std::cout << "  ✓ Pass 1 instruction sizing test passed" << std::endl;
+}
+
+// Test: peephole optimizer rewrites and report
+void test_peephole_optimizer() {
+    std::cout << "Testing peephole optimizer..." << std::endl;
+
+    const std::string source = R"(
+        ORG $0800
+COUNT   EQU $1234
+START   LDA #$00         ; dead load
+        LDA VALUE
+        STA TEMP
+        LDA TEMP         ; reload, N/Z set again by LDA COUNT
+        CLC
+        LDA COUNT
+        ADC #1
+        STA COUNT
+        PLA
+        PLP
+        JSR PRINT
+        RTS
+PRINT   STA $C030        ; I/O: both stores kept
+        STA $C030
+        STX TEMP
+        STX TEMP
+        JMP NEXT
+NEXT    RTS
+TEMP    DS 1
+VALUE   DB 5
+)";
+    const std::string expected = R"(
+        ORG $0800
+COUNT   EQU $1234
+START   LDA VALUE
+        STA TEMP
+        INC COUNT
+        PLA
+        PLP
+PRINT   STA $C030
+        STA $C030
+        STX TEMP
+NEXT    RTS
+TEMP    DS 1
+VALUE   DB 5
+)";
+
+    Assembler assembler;
+    Assembler::Options opts;
+    opts.peephole = true;
+    opts.generate_listing = true;
+    auto result = assembler.assemble(source, opts);
+    print_errors(result);
+    assert(result.success);
+
+    auto reference = assemble_source(expected);
+    assert(reference.success);
+    assert(result.code == reference.code);
+    assert(assembler.symbols().lookup("START")->value == 0x0800);
+
+    // Six changes, then the new JMP PRINT falls through on the second round
+    assert(result.optimizations.size() == 7);
+    assert(result.optimizations[3] ==
+           "Line 14 $0816: JSR PRINT / RTS -> JMP PRINT (-1 bytes, -9 cycles)");
+    assert(result.optimizations[6] == "Line 14 $080B: JMP PRINT (next instruction) removed "
+                                      "(-3 bytes, -3 cycles)");
+    assert(result.listing.find("[PEEPHOLE]") != std::string::npos);
+
+    // Default: code untouched
+    auto plain = assemble_source(source);
+    assert(plain.success && plain.optimizations.empty());
+    assert(plain.code.size() == reference.code.size() + 21);
+
+    // Labels inside a pattern and relocated operands are boundaries
+    const std::string guarded = R"(
+        REL
+        EXT COUT
+        LDA #1
+SKIP    LDA #2
+        JSR COUT
+        RTS
+        BNE SKIP
+)";
+    auto kept = assembler.assemble(guarded, opts);
+    print_errors(kept);
+    assert(kept.success);
+    assert(kept.optimizations.empty());
+
+    std::cout << "  ✓ Peephole optimizer test passed" << std::endl;
+}
+
+void test_page_alignment() {
+    std::cout << "Testing ALIGN and page-aware linking..." << std::endl;
+
+    // Absolute code: crossings are reported with their cost
+    const std::string crossing = R"(
+        ORG $08F6
+START   LDX #$07
+LOOP    LDA TABLE,X
+        STA $0400,X
+        DEX
+        BPL LOOP
+        RTS
+TABLE   DB 1,2,3,4
+        DB 5,6,7,8
+)";
+    Assembler asm1;
+    auto result = asm1.assemble(crossing);
+    assert(result.success);
+    assert(result.page_crossings.size() == 1);
+    assert(result.page_crossings[0] ==
+           "Line 7 $08FF: BPL LOOP crosses a page ($0901 -> $08F8), +1 cycle when taken");
+
+    Assembler asm2;
+    result = asm2.assemble(R"(
+        ORG $08F2
+        LDX #$07
+LOOP    LDA TABLE,X
+        DEX
+        BPL LOOP
+        RTS
+TABLE   DB 1,2,3,4
+        DB 5,6,7,8
+)");
+    assert(result.success);
+    assert(result.page_crossings.size() == 1);
+    assert(result.page_crossings[0] == "Line 4 $08F4: LDA TABLE,X crosses a page "
+                                       "(table $08FB-$0902), +1 cycle past $08FF");
+
+    // ALIGN boundary,length pads only when the block would cross; plain
+    // ALIGN pads to the next page
+    Assembler asm3;
+    result = asm3.assemble(R"(
+        ORG $08F6
+SIZE    EQU 9
+START   LDX #$07
+        ALIGN $100,SIZE
+LOOP    LDA TABLE,X
+        STA $0400,X
+        DEX
+        BPL LOOP
+        ALIGN $100,1
+        RTS
+        ALIGN
+TABLE   DB 1,2,3,4,5,6,7,8
+)");
+    assert(result.success);
+    assert(result.page_crossings.empty());
+    assert(asm3.symbols().lookup("LOOP")->value == 0x0900);
+    assert(asm3.symbols().lookup("TABLE")->value == 0x0A00);
+    assert(result.code.size() == 2 + 8 + 9 + 1 + 0xF6 + 8);
+    assert(result.code[2] == 0x00 && result.code[10] == 0xBD);
+
+    Assembler asm4;
+    result = asm4.assemble("        ALIGN 3\n        ALIGN $10,$20\n        ALIGN LATER\n"
+                           "LATER   RTS\n");
+    assert(!result.success);
+    assert(result.errors.size() == 3);
+    assert(result.errors[0] == "Line 1: ALIGN: boundary must be a power of two up to $100");
+    assert(result.errors[1] == "Line 2: ALIGN: length exceeds boundary");
+    assert(result.errors[2] == "Line 3: ALIGN: Undefined symbol: LATER");
+
+    // REL modules carry ALIGN constraints and branch/table spans to the linker
+    ensure_tmp_dir();
+    write_rel_module("tmp/page_main.rel", "        REL\n        ORG $0000\n"
+                                          "        LDA #$01\n        STA $0400\n");
+    const auto looper = write_rel_module("tmp/page_loop.rel", R"(
+        REL
+        ORG $0000
+        LDX #$07
+LOOP    LDA TABLE,X
+        DEX
+        BPL LOOP
+        RTS
+        ALIGN $10
+TABLE   DB 1,2,3,4,5,6,7,8
+)");
+    write_rel_module("tmp/page_fill.rel", "        REL\n        ORG $0000\n"
+                                          "        LDA #$02\n        STA $0401\n        RTS\n");
+
+    std::vector<uint8_t> code;
+    std::vector<RLDEntry> rld;
+    std::vector<ESDEntry> esd;
+    std::vector<PageSpan> spans;
+    bool parsed = RELFileBuilder::parse(looper, code, rld, esd, &spans);
+    assert(parsed);
+    assert(code.size() == 24 && spans.size() == 3);
+    assert(spans[0].kind == PageSpan::KIND_INDEXED && spans[0].offset == 16 &&
+           spans[0].length == 8);
+    assert(spans[1].kind == PageSpan::KIND_BRANCH && spans[1].offset == 2 &&
+           spans[1].length == 7);
+    assert(spans[2].kind == PageSpan::KIND_ALIGN && spans[2].offset == 16 &&
+           spans[2].boundary == 0x10);
+
+    const std::vector<std::string> modules = {"tmp/page_main.rel", "tmp/page_loop.rel",
+                                              "tmp/page_fill.rel"};
+    Linker::Options opts;
+    opts.origin = 0x08F3;
+
+    // In order: the loop lands at $08F8, its branch crosses and ALIGN is unmet
+    Linker plain_linker;
+    auto plain = plain_linker.link(modules, opts);
+    assert(plain.success);
+    assert(plain.padding == 0 && plain.output_data.size() == 35);
+    assert(plain.warnings.size() == 1);
+    assert(plain.warnings[0] ==
+           "Linker warning: tmp/page_loop.rel: ALIGN $0010 at $0908 not honored");
+    assert(plain.page_crossings.size() == 1);
+    assert(plain.page_crossings[0] == "tmp/page_loop.rel: branch between $08FA and $0900 "
+                                      "crosses a page, +1 cycle when taken");
+
+    // Page layout: the loop moves to $0900 and the filler takes the gap
+    opts.page_layout = true;
+    Linker page_linker;
+    auto paged = page_linker.link(modules, opts);
+    assert(paged.success);
+    assert(paged.warnings.empty() && paged.page_crossings.empty());
+    assert(paged.padding == 2 && paged.output_data.size() == 0x25);
+    assert(paged.output_data[5] == 0xA9 && paged.output_data[6] == 0x02); // filler at $08F8
+    assert(paged.output_data[0x0D] == 0xA2);                              // loop at $0900
+    assert(paged.output_data[0x10] == 0x10 && paged.output_data[0x11] == 0x09); // TABLE
+    assert(paged.output_data[0x0B] == 0x00 && paged.output_data[0x0C] == 0x00);
+
+    std::cout << "  ✓ ALIGN and page-aware linking test passed" << std::endl;
+}
+
+void test_symbol_database() {
+    std::cout << "Testing symbol database..." << std::endl;
+    ensure_tmp_dir();
+
+    const std::string source = R"(
+        ORG $0900
+KBD     EQU $C000
+START   LDA KBD
+        BPL START
+LOOP    INX
+        BNE LOOP
+        RTS
+TABLE   DB 1,2,3
+)";
+    Assembler::Options opts;
+    opts.build_symbol_database = true;
+    opts.module_name = "TEST";
+    Assembler assembler;
+    auto result = assembler.assemble(source, opts);
+    assert(result.success);
+    bool saved = SymbolDatabase::save("tmp/test_symbols.sdb", result.symbol_database);
+    assert(saved);
+
+    std::string error;
+    auto database = SymbolDatabase::open("tmp/test_symbols.sdb", &error);
+    assert(database);
+    assert(database->size() == 4);
+
+    // Labels cover the code up to the next label; equates only their address
+    auto start = database->lookup(0x0900);
+    assert(start && start->symbol.name == "START" && start->offset == 0);
+    assert(start->symbol.module == "TEST" && start->symbol.line == 4 && start->symbol.size == 5);
+    assert(database->symbolize(0x0903) == "START+$3");
+    assert(database->symbolize(0x0905) == "LOOP");
+    assert(database->symbolize(0x090B) == "TABLE+$2");
+    assert(database->symbolize(0xC000) == "KBD");
+    assert(!database->lookup(0x090C) && !database->lookup(0xC001) && !database->lookup(0x0800));
+
+    // The disassembler falls back to the database for unregistered addresses
+    Bus bus;
+    bus.write(0x0A00, 0xAD); // LDA $0903
+    bus.write(0x0A01, 0x03);
+    bus.write(0x0A02, 0x09);
+    set_disassembly_symbol_database(&*database);
+    assert(format_disassembly(bus, 0x0A00).find("<START+$3>") != std::string::npos);
+    set_disassembly_symbol_database(nullptr);
+
+    const auto &bytes = result.symbol_database;
+    assert(!SymbolDatabase::from_bytes(std::span(bytes).first(bytes.size() - 1), &error));
+    assert(error == "Truncated symbol database");
+
+    // Each ORG segment is its own module, so ranges stop at the segment end
+    auto segmented = assembler.assemble("        ORG $0900\nMAIN    JSR SUB\n        RTS\n"
+                                        "        ORG $1000\nSUB     LDA #$01\n        RTS\n",
+                                        opts);
+    assert(segmented.success);
+    auto segments = SymbolDatabase::from_bytes(segmented.symbol_database, &error);
+    assert(segments && segments->size() == 2);
+    assert(segments->lookup(0x0900)->symbol.size == 4);
+    assert(segments->symbolize(0x0903) == "MAIN+$3");
+    assert(segments->symbolize(0x1002) == "SUB+$2");
+    assert(!segments->lookup(0x0904) && !segments->lookup(0x0FFF) && !segments->lookup(0x1003));
+
+    // Segments in descending address order: a symbol below a segment's
+    // start is not that segment's, and one outside every segment has none
+    auto descending = assembler.assemble("        ORG $2000\nHIGH    LDA #$01\n        RTS\n"
+                                         "        ORG $0800\nLOW     LDX #$02\n        RTS\n"
+                                         "KBD     EQU $C000\n",
+                                         opts);
+    assert(descending.success);
+    auto ordered = SymbolDatabase::from_bytes(descending.symbol_database, &error);
+    assert(ordered && ordered->size() == 3);
+    assert(ordered->lookup(0x2000)->symbol.module_index == 0);
+    assert(ordered->lookup(0x0800)->symbol.module_index == 1);
+    assert(ordered->symbolize(0x0802) == "LOW+$2");
+    auto equate = ordered->lookup(0xC000);
+    assert(equate->symbol.module_index == SymbolDatabase::kNoModule);
+    assert(equate->symbol.module.empty());
+
+    // Linker: module ranges and ENTRY symbols at their final addresses
+    write_rel_module("tmp/sdb_main.rel", "        REL\n        ORG $0000\nMAIN    ENT MAIN\n"
+                                         "        LDA #$01\n        RTS\n");
+    write_rel_module("tmp/sdb_helper.rel", "        REL\n        ORG $0000\nHELPER  ENT HELPER\n"
+                                           "        LDA #$02\n        STA $0400\n        RTS\n");
+
+    Linker::Options link_opts;
+    link_opts.generate_symbols = true;
+    Linker linker;
+    auto linked = linker.link({"tmp/sdb_main.rel", "tmp/sdb_helper.rel"}, link_opts);
+    assert(linked.success);
+    auto link_database = SymbolDatabase::from_bytes(linked.symbol_database, &error);
+    assert(link_database && link_database->size() == 2);
+    auto helper = link_database->lookup(0x0805);
+    assert(helper && helper->symbol.name == "HELPER" && helper->offset == 2);
+    assert(helper->symbol.module == "tmp/sdb_helper.rel" && helper->symbol.line == 0);
+    assert(link_database->symbolize(0x0801) == "MAIN+$1");
+    assert(!link_database->lookup(0x0809));
+
+    std::cout << "  ✓ Symbol database test passed" << std::endl;
+}
+
+void test_linker_name_interning() {
+    std::cout << "Testing linker name interning..." << std::endl;
+
+    std::pmr::monotonic_buffer_resource arena;
+    NameInterner names(&arena);
+    assert(names.find("HELPER") == NameInterner::kNone);
+    const auto helper_id = names.intern("HELPER");
+    const auto main_id = names.intern("MAIN");
+    const auto helper_again = names.intern("HELPER");
+    assert(helper_id == 0 && main_id == 1 && helper_again == helper_id);
+    assert(names.find("HELPER") == helper_id && names.name(1) == "MAIN");
+    // Growing the slot table keeps every ID
+    for (int i = 0; i < 200; ++i) {
+        const auto id = names.intern("SYM" + std::to_string(i));
+        assert(id == static_cast<NameInterner::Id>(i + 2));
+    }
+    assert(names.size() == 202 && names.find("SYM150") == 152 && names.name(201) == "SYM199");
+    names.reset();
+    assert(names.size() == 0 && names.find("MAIN") == NameInterner::kNone);
+
+    ensure_tmp_dir();
+    write_rel_module("tmp/intern_main.rel", "        REL\n        ORG $0000\n        EXT HELPER\n"
+                                            "        JSR HELPER\n        RTS\n");
+    write_rel_module("tmp/intern_helper.rel", "        REL\n        ORG $0000\nHELPER  ENT HELPER\n"
+                                              "        LDA #$02\n        RTS\n");
+    write_rel_module("tmp/intern_dup.rel", "        REL\n        ORG $0000\nHELPER  ENT HELPER\n"
+                                           "        NOP\n        EXT OTHER\n        JMP OTHER\n");
+
+    // The first definition wins; the duplicate is reported by name
+    Linker linker;
+    Linker::Options opts;
+    opts.output_type = Linker::Options::OutputType::REL;
+    auto linked = linker.link({"tmp/intern_main.rel", "tmp/intern_helper.rel",
+                               "tmp/intern_dup.rel"},
+                              opts);
+    assert(linked.success);
+    assert(linked.warnings.size() == 3);
+    assert(linked.warnings[0] == "Linker warning: Duplicate ENTRY symbol: HELPER");
+    assert(linked.warnings[1] == "Linker warning: Unresolved external: OTHER");
+    assert(linked.warnings[2] == "Linker warning: Could not resolve RLD external reference "
+                                 "(sym=1) at offset 2 in tmp/intern_dup.rel");
+
+    // Relinking with the same linker starts from an empty table
+    opts.output_type = Linker::Options::OutputType::BIN;
+    linked = linker.link({"tmp/intern_main.rel", "tmp/intern_helper.rel"}, opts);
+    assert(linked.success && linked.warnings.empty());
+    assert(linked.output_data.size() == 7);
+    assert(linked.output_data[1] == 0x04 && linked.output_data[2] == 0x08); // JSR $0804
+
+    linked = linker.link({"tmp/intern_dup.rel"}, opts);
+    assert(!linked.success);
+    assert(linked.errors.size() == 1 &&
+           linked.errors[0] == "Linker error: Unresolved external: OTHER");
+
+    std::cout << "  ✓ Linker name interning test passed" << std::endl;
+}
+
 int main() {
     std::cout << "Running Assembler Integration Tests\n";
     std::cout << "====================================\n\n";
@@ -543,6 +1520,20 @@ int main() {
         test_symbol_referenced_bit();
         test_chn_directive();
         test_chn_from_include_error();
+        test_arena_reuse();
+        test_assembly_profile();
+        test_sorted_symbol_views();
+        test_lazy_conditional_skip();
+        test_symbol_snapshot_include();
+        test_rel_output_writer();
+        test_char_scanner();
+        test_constexpr_assembler();
+        test_pass1_instruction_sizing();
+        test_zero_page_shrinking();
+        test_peephole_optimizer();
+        test_page_alignment();
+        test_symbol_database();
+        test_linker_name_interning();
 
         std::cout << "\n====================================\n";
         std::cout << "All tests PASSED! ✓\n";
@@ -1,7 +1,16 @@
+#include "../include/edasm/emulator/batch_cpu.hpp"
 #include "../include/edasm/emulator/bus.hpp"
 #include "../include/edasm/emulator/cpu.hpp"
+#include "../include/edasm/emulator/disassembly.hpp"
+#include "../include/edasm/emulator/profiler.hpp"
+#include "../include/edasm/emulator/ram_bus.hpp"
+#include "../include/edasm/emulator/sweet16.hpp"
+#include "../include/edasm/emulator/traps.hpp"
+#include "edasm/assembler/constexpr_assembler.hpp"
 #include <cassert>
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 using namespace edasm;
 
@@ -192,6 +201,252 @@ void test_cpu_jsr_rts() {
     std::cout << "✓ test_cpu_jsr_rts passed" << std::endl;
 }
 
+void test_cpu_constexpr_program() {
+    // Fixture assembled at compile time instead of hand-coded opcode bytes
+    static constexpr char kSource[] = R"(
+        ORG $2000
+COUNT   EQU 5
+        LDX #COUNT
+        LDA #$00
+        CLC
+LOOP    ADC TABLE-1,X   ; sum TABLE[0..COUNT-1]
+        DEX
+        BNE LOOP
+        STA RESULT
+        JMP DONE
+TABLE   DB 1,2,3,4,5
+RESULT  DS 1
+DONE    NOP
+)";
+    constexpr auto code = ct::assemble<kSource>();
+    constexpr uint16_t org = ct::origin<kSource>();
+    static_assert(org == 0x2000);
+    static_assert(code.size() == 24);
+    static_assert(code[0] == 0xA2 && code[1] == 0x05); // LDX #5
+    static_assert(code[5] == 0x7D && code[6] == 0x10 && code[7] == 0x20); // ADC $2010,X
+    static_assert(code[9] == 0xD0 && code[10] == 0xFA); // BNE LOOP
+
+    Bus bus;
+    CPU cpu(bus);
+    for (size_t i = 0; i < code.size(); ++i) {
+        bus.write(static_cast<uint16_t>(org + i), code[i]);
+    }
+
+    cpu.reset();
+    const uint16_t done = static_cast<uint16_t>(org + code.size() - 1);
+    for (int steps = 0; steps < 100 && cpu.state().PC != done; ++steps) {
+        cpu.step();
+    }
+
+    assert(cpu.state().PC == done);
+    assert(bus.read(0x2016) == 15); // RESULT
+
+    std::cout << "✓ test_cpu_constexpr_program passed" << std::endl;
+}
+
+// Run a JSR/stack/store fixture on any bus; returns the byte read back from $D000
+template <typename BusT> uint8_t run_bus_variant_program(BusT &bus) {
+    static constexpr char kSource[] = R"(
+        ORG $2000
+        LDA #$11
+        STA $D000       ; ROM area: write sink on the banked buses
+        JSR ADD
+        STA $10
+        JMP DONE
+ADD     CLC
+        ADC #$22
+        RTS
+DONE    NOP
+)";
+    constexpr auto code = ct::assemble<kSource>();
+    constexpr uint16_t org = ct::origin<kSource>();
+
+    BasicCPU<BusT> cpu(bus);
+    for (size_t i = 0; i < code.size(); ++i) {
+        bus.write(static_cast<uint16_t>(org + i), code[i]);
+    }
+
+    const uint16_t done = static_cast<uint16_t>(org + code.size() - 1);
+    for (int steps = 0; steps < 100 && cpu.state().PC != done; ++steps) {
+        const bool stepped = cpu.step();
+        assert(stepped);
+    }
+
+    assert(cpu.state().PC == done);
+    assert(cpu.state().SP == 0xFF);
+    assert(bus.read(0x0010) == 0x33);
+    return bus.read(0xD000);
+}
+
+void test_cpu_bus_variants() {
+    Bus bus;
+    FlatBus flat;
+    BankedBus banked;
+
+    // Same program, same results; only the flat bus has RAM at $D000
+    const uint8_t bus_d000 = run_bus_variant_program(bus);
+    const uint8_t banked_d000 = run_bus_variant_program(banked);
+    const uint8_t flat_d000 = run_bus_variant_program(flat);
+    assert(bus_d000 == Bus::TRAP_OPCODE);
+    assert(banked_d000 == Bus::TRAP_OPCODE);
+    assert(flat_d000 == 0x11);
+
+    // The trap opcode halts a CPU without a handler on every bus
+    BasicCPU<FlatBus> cpu(flat);
+    cpu.state().PC = 0x3000;
+    const bool stepped = cpu.step();
+    assert(!stepped);
+
+    std::cout << "✓ test_cpu_bus_variants passed" << std::endl;
+}
+
+void test_batch_cpu_lockstep() {
+    // Lanes branch on their own $30, run different loops, then rejoin for
+    // a subroutine that uses PHA/PLA (scalar opcodes) and stop on the trap
+    static constexpr char kSource[] = R"(
+        ORG $2000
+        LDA $30
+        CMP #$02
+        BCC SMALL
+        ASL A
+        STA $31
+        ADC #$05
+        JMP JOIN
+SMALL   LDX #$03
+LOOP    ROL A
+        DEX
+        BNE LOOP
+        STA $31
+JOIN    JSR SUB
+        STA $32
+        LDY $31
+        INY
+        STY $33
+        DB $02
+SUB     PHA
+        PLA
+        EOR #$FF
+        RTS
+)";
+    constexpr auto code = ct::assemble<kSource>();
+    constexpr uint16_t org = ct::origin<kSource>();
+
+    Bus bus;
+    bus.write_binary_data(org, std::vector<uint8_t>(code.begin(), code.end()));
+    auto image = bus.snapshot();
+
+    constexpr size_t kLanes = 5;
+    CPUState start;
+    start.PC = org;
+    BatchCPU batch(image, kLanes);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        batch.set_state(lane, start);
+        batch.bus(lane).write(0x30, static_cast<uint8_t>(lane * 0x41));
+    }
+    batch.run(1000);
+
+    // Every lane matches a scalar CPU on its own fork
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        Bus fork(image);
+        fork.write(0x30, static_cast<uint8_t>(lane * 0x41));
+        CPU cpu(fork);
+        cpu.state() = start;
+        for (int steps = 0; steps < 1000 && cpu.step(); ++steps) {
+        }
+
+        const CPUState got = batch.state(lane);
+        assert(batch.halted(lane));
+        assert(got.A == cpu.state().A && got.X == cpu.state().X && got.Y == cpu.state().Y);
+        assert(got.SP == cpu.state().SP && got.P == cpu.state().P && got.PC == cpu.state().PC);
+        assert(batch.instruction_count(lane) == cpu.instruction_count());
+        for (uint16_t addr = 0x30; addr <= 0x33; ++addr) {
+            assert(batch.bus(lane).read(addr) == fork.read(addr));
+        }
+        assert(batch.bus(lane).read(0x01FE) == fork.read(0x01FE));
+    }
+
+    uint64_t total = 0;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        total += batch.instruction_count(lane);
+    }
+    assert(batch.lockstep_instructions() > 0 && batch.scalar_instructions() > 0);
+    assert(batch.lockstep_instructions() + batch.scalar_instructions() == total);
+
+    std::cout << "✓ test_batch_cpu_lockstep passed" << std::endl;
+}
+
+void test_call_profiler() {
+    // The root calls OUTER twice, OUTER calls LEAF
+    static constexpr char kSource[] = R"(
+        ORG $2000
+        JSR OUTER
+        JSR OUTER
+        TSX
+        DB $02
+OUTER   JSR LEAF
+        NOP
+        RTS
+LEAF    PHA
+        PLA
+        RTS
+)";
+    constexpr auto code = ct::assemble<kSource>();
+    constexpr uint16_t org = ct::origin<kSource>();
+    constexpr uint16_t outer = org + 8;
+    constexpr uint16_t leaf = org + 13;
+
+    Bus bus;
+    bus.write_binary_data(org, std::vector<uint8_t>(code.begin(), code.end()));
+    CPU cpu(bus);
+    cpu.state().PC = org;
+
+    CallProfiler profiler(org);
+    for (int steps = 0; steps < 100; ++steps) {
+        const CPUState before = cpu.state();
+        const uint8_t opcode = bus.read(before.PC);
+        if (!cpu.step()) {
+            break;
+        }
+        profiler.record(before, opcode, cpu.state());
+    }
+
+    // JSR 6 + NOP 2 + RTS 6 in OUTER; PHA 3 + PLA 4 + RTS 6 in LEAF
+    assert(profiler.depth() == 1);
+    assert(profiler.total_cycles() == 2 * 6 + 2 + 2 * (14 + 13));
+    const auto routines = profiler.routines();
+    assert(routines.size() == 3);
+    assert(routines[0].entry == org && routines[0].inclusive_cycles == profiler.total_cycles());
+    assert(routines[1].entry == outer && routines[1].calls == 2);
+    assert(routines[1].inclusive_cycles == 2 * 27 && routines[1].exclusive_cycles == 2 * 14);
+    assert(routines[2].entry == leaf && routines[2].calls == 2);
+    assert(routines[2].inclusive_cycles == 26 && routines[2].exclusive_cycles == 26);
+
+    // Folded stacks name routines from the disassembly symbols
+    register_disassembly_symbol(outer, "OUTER");
+    std::ostringstream folded;
+    profiler.write_folded(folded);
+    assert(folded.str() == "$2000 14\n$2000;OUTER 28\n$2000;OUTER;$200D 26\n");
+
+    // A stack reset pops every frame above it
+    CallProfiler reset(org);
+    CPUState before;
+    CPUState after;
+    after.SP = 0xFD;
+    after.PC = outer;
+    reset.record(before, 0x20, after);
+    before = after;
+    after.SP = 0xFB;
+    after.PC = leaf;
+    reset.record(before, 0x20, after);
+    assert(reset.depth() == 3);
+    before = after;
+    after.SP = 0xFF;
+    reset.record(before, 0x9A, after); // TXS
+    assert(reset.depth() == 1);
+
+    std::cout << "✓ test_call_profiler passed" << std::endl;
+}
+
 void test_rom_loading_at_reset() {
     Bus bus;
 
@@ -246,6 +501,173 @@ void test_rom_write_protected() {
     std::cout << "✓ test_rom_write_protected passed" << std::endl;
 }
 
+void test_bus_span_visitor() {
+    Bus bus;
+
+    // Power-on mapping: reads of the whole address space are one main RAM span
+    size_t spans = 0;
+    bus.for_each_read_span(0, Bus::MEMORY_SIZE, [&spans](ReadMemoryRange range) {
+        assert(range.size() == Bus::MEMORY_SIZE);
+        spans++;
+    });
+    assert(spans == 1);
+
+    // Writes to $C800-$DFFF: main RAM, then each 2KB ROM bank in the write sink
+    std::vector<size_t> sizes;
+    bus.for_each_write_span(0xC800, 0x1800,
+                            [&sizes](WriteMemoryRange range) { sizes.push_back(range.size()); });
+    assert((sizes == std::vector<size_t>{0x800, 0x800, 0x800}));
+    assert(bus.translate_write_range(0xC800, 0x1800).size() == 3);
+
+    // Block copies across a page boundary bump both page generations
+    std::vector<uint8_t> data(0x20);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i + 1);
+    }
+    const uint32_t page2f = bus.page_generation(0x2F);
+    const uint32_t page30 = bus.page_generation(0x30);
+    bus.write_block(0x2FF0, data);
+    assert(bus.page_generation(0x2F) != page2f && bus.page_generation(0x30) != page30);
+
+    std::vector<uint8_t> back(data.size());
+    bus.read_block(0x2FF0, back);
+    assert(back == data);
+
+    // A trapped address inside the block goes through the trap
+    bus.set_write_trap_range(0x3000, 0x3000, [](uint16_t, uint8_t) { return true; });
+    std::vector<uint8_t> zeros(data.size(), 0);
+    bus.write_block(0x2FF0, zeros);
+    assert(bus.read(0x2FFF) == 0x00);
+    assert(bus.read(0x3000) == data[0x10]);
+    assert(bus.read(0x3001) == 0x00);
+
+    std::cout << "✓ test_bus_span_visitor passed" << std::endl;
+}
+
+void test_bus_copy_on_write() {
+    Bus bus;
+    bus.write_binary_data(0x2000, {0xA9, 0x42, 0x60});
+    bus.initialize_memory(0xF800, std::vector<uint8_t>(0x800, 0xEA));
+    assert(bus.private_pages() == Bus::POOL_PAGES);
+
+    auto snap = bus.snapshot();
+    Bus a(snap);
+    Bus b(snap);
+    assert(a.private_pages() == 0 && b.private_pages() == 0);
+    assert(a.read(0x2001) == 0x42 && a.read(0xF800) == 0xEA);
+
+    // The first write to a page copies only that page
+    a.write(0x2001, 0x99);
+    a.write(0x20FF, 0x01);
+    assert(a.private_pages() == 1);
+    assert(a.read(0x2001) == 0x99 && a.read(0x2000) == 0xA9);
+    assert(b.read(0x2001) == 0x42 && bus.read(0x2001) == 0x42);
+
+    // Writes keep their semantics: the ROM area still goes to the write sink
+    b.write(0xF800, 0x00);
+    assert(b.read(0xF800) == 0xEA);
+
+    // Spans see the copied page
+    std::vector<uint8_t> back(0x200);
+    a.read_block(0x2000, back);
+    assert(back[0x001] == 0x99 && back[0x100] == Bus::TRAP_OPCODE);
+
+    // A fork can be snapshotted and forked again, and reset to a private pool
+    Bus c(a.snapshot());
+    assert(c.read(0x2001) == 0x99);
+    a.reset();
+    assert(a.read(0x2001) == Bus::TRAP_OPCODE && a.private_pages() == Bus::POOL_PAGES);
+    assert(c.read(0x2001) == 0x99);
+
+    std::cout << "✓ test_bus_copy_on_write passed" << std::endl;
+}
+
+void test_sweet16_native() {
+    Bus bus;
+    CPU cpu(bus);
+    Sweet16 sweet16(bus);
+    sweet16.install(); // Trap at the ROM entry point ($F689)
+    assert(bus.read(SWEET16_ROM) == Bus::TRAP_OPCODE);
+
+    // 6502 caller with SWEET16 bytecode inline after the JSR
+    std::vector<uint8_t> code = {0xA9, 0x5A, 0xA2, 0x11, 0xA0, 0x22, 0x38, // LDA/LDX/LDY, SEC
+                                 0x20, 0x89, 0xF6};                         // JSR SW16
+    auto branch = [&code](uint8_t op, size_t target) {
+        code.push_back(op);
+        code.push_back(static_cast<uint8_t>(target - (code.size() + 1)));
+    };
+    code.insert(code.end(), {0x11, 0x00, 0x30,  // SET R1,$3000
+                             0x12, 0x00, 0x31,  // SET R2,$3100
+                             0x13, 0x05, 0x00}); // SET R3,5
+    const size_t loop = code.size();
+    code.insert(code.end(), {0x41, 0x52, 0xF3}); // LD @R1 / ST @R2 / DCR R3
+    branch(0x07, loop);                          // BNZ LOOP
+    code.insert(code.end(), {0x1C, 0x00, 0x03}); // SET R12,$0300 (return stack)
+    const size_t bs = code.size();
+    code.insert(code.end(), {0x0C, 0x00});       // BS SUB (patched below)
+    code.insert(code.end(), {0x14, 0x64, 0x00,   // SET R4,100
+                             0x24, 0xD5});       // LD R4 / CPR R5
+    const size_t bnc = code.size();
+    code.insert(code.end(), {0x02, 0x00, 0x0A, 0x00}); // BNC OK / BK
+    const size_t ok = code.size();
+    code[bnc + 1] = static_cast<uint8_t>(ok - (bnc + 2));
+    code.insert(code.end(), {0x00,              // RTN
+                             0x8D, 0x00, 0x32}); // STA $3200
+    const size_t done = code.size();
+    code.push_back(Bus::TRAP_OPCODE);
+    const size_t sub = code.size();
+    code[bs + 1] = static_cast<uint8_t>(sub - (bs + 2));
+    code.insert(code.end(), {0x15, 0xC8, 0x00, 0x0B, 0x00}); // SET R5,200 / RS
+
+    for (size_t i = 0; i < code.size(); ++i) {
+        bus.write(static_cast<uint16_t>(0x2000 + i), code[i]);
+    }
+    for (uint8_t i = 0; i < 5; ++i) {
+        bus.write(static_cast<uint16_t>(0x3000 + i), static_cast<uint8_t>('A' + i));
+    }
+
+    const auto done_pc = static_cast<uint16_t>(0x2000 + done);
+    TrapManager::install_address_handler(done_pc, [](CPUState &, Bus &, uint16_t) {
+        return false;
+    });
+    cpu.set_trap_handler(TrapManager::general_trap_handler);
+    cpu.reset();
+    while (cpu.step()) {
+    }
+
+    // Back in 6502 code after RTN with the caller's registers
+    assert(cpu.state().PC == done_pc + 1);
+    assert(cpu.state().A == 0x5A && cpu.state().X == 0x11 && cpu.state().Y == 0x22);
+    assert((cpu.state().P & StatusFlags::C) && cpu.state().SP == 0xFF);
+    assert(bus.read(0x3200) == 0x5A);
+    for (uint8_t i = 0; i < 5; ++i) {
+        assert(bus.read(static_cast<uint16_t>(0x3100 + i)) == 'A' + i);
+    }
+
+    // Registers and SAVE area as the 6502 interpreter leaves them
+    assert(bus.read_word(0x02) == 0x3005 && bus.read_word(0x04) == 0x3105);
+    assert(bus.read_word(0x06) == 0 && bus.read_word(0x18) == 0x0300);
+    assert(bus.read_word(0x1A) == static_cast<uint16_t>(100 - 200)); // R13 = CPR result
+    assert(bus.read(0x1D) == 0x1A);                                   // R14H: R13, no carry
+    assert(bus.read_word(0x1E) == static_cast<uint16_t>(0x2000 + ok + 1));
+    assert(bus.read(0x45) == 0x5A && bus.read(0x46) == 0x11 && bus.read(0x47) == 0x22);
+    assert(bus.read(0x49) == 0xFB);
+
+    assert(sweet16.calls() == 1);
+    assert(sweet16.instructions() == 32);
+
+    // BK stops native execution
+    CPUState state;
+    state.SP = 0xFD;
+    bus.write_word(0x01FE, 0x3FFF); // Bytecode at $4000
+    bus.write(0x4000, 0x0A);
+    const bool returned = Sweet16::run(state, bus);
+    assert(!returned);
+
+    TrapManager::clear_all_handlers();
+    std::cout << "✓ test_sweet16_native passed" << std::endl;
+}
+
 int main() {
     std::cout << "Running CPU/Bus unit tests..." << std::endl << std::endl;
 
@@ -261,6 +683,13 @@ int main() {
         test_cpu_jsr_rts();
         test_rom_loading_at_reset();
         test_rom_write_protected();
+        test_bus_span_visitor();
+        test_bus_copy_on_write();
+        test_cpu_constexpr_program();
+        test_cpu_bus_variants();
+        test_batch_cpu_lockstep();
+        test_call_profiler();
+        test_sweet16_native();
 
         std::cout << std::endl << "All tests passed! ✓" << std::endl;
         return 0;
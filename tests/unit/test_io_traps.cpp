@@ -184,23 +184,25 @@ bool test_stop_on_e_character() {
 
     // Write 'A' to first position - should not stop
     bus.write(TEXT1_LINE1, 'A');
+    const bool stopped_on_a = shims.should_stop();
     std::cout.rdbuf(old_buf);
 
-    if (shims.should_stop()) {
+    if (stopped_on_a) {
         std::cerr << "Unexpected stop after writing 'A' to first screen position" << std::endl;
         return false;
     }
 
-    // Now write 'E' to first position - should log and stop
+    // Now write 'E' to first position - the next stop check should log and stop
     oss.str("");
     oss.clear();
     old_buf = std::cout.rdbuf(oss.rdbuf());
     bus.write(TEXT1_LINE1, 'E');
+    const bool stopped_on_e = shims.should_stop();
     std::cout.rdbuf(old_buf);
 
     const std::string output = oss.str();
 
-    if (!shims.should_stop()) {
+    if (!stopped_on_e || !shims.should_stop()) {
         std::cerr << "Expected stop after writing 'E' to first screen position" << std::endl;
         return false;
     }
@@ -218,6 +220,85 @@ bool test_stop_on_e_character() {
     return true;
 }
 
+// Test that other page $04 stores do not stop while $0400 already holds 'E'
+bool test_stop_ignores_unrelated_page_writes() {
+    Bus bus;
+    bus.write(TEXT1_LINE1, 'E'); // Already on screen before the run
+    HostShims shims(bus);
+
+    shims.install_io_traps();
+
+    bus.write(TEXT1_LINE1 + 0x28, 'X');
+    const bool stopped_on_other = shims.should_stop();
+    if (stopped_on_other) {
+        std::cerr << "Unexpected stop after a store elsewhere on page $04" << std::endl;
+        return false;
+    }
+
+    // A new value at $0400 is still picked up
+    std::ostringstream oss;
+    std::streambuf *old_buf = std::cout.rdbuf(oss.rdbuf());
+    bus.write(TEXT1_LINE1, 'A');
+    const bool stopped_on_a = shims.should_stop();
+    bus.write(TEXT1_LINE1, 'E' | 0x80);
+    const bool stopped_on_e = shims.should_stop();
+    std::cout.rdbuf(old_buf);
+
+    if (stopped_on_a || !stopped_on_e) {
+        std::cerr << "Expected a stop only once $0400 changed to 'E'" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Test that text page stores bypass traps and are picked up from page generations
+bool test_screen_writes_untrapped() {
+    Bus bus;
+    HostShims shims(bus);
+
+    shims.install_io_traps();
+
+    const uint32_t page4 = bus.page_generation(0x04);
+    const uint32_t page7 = bus.page_generation(0x07);
+
+    // 'E' outside the first position must not stop; the stores only bump generations
+    bus.write(TEXT1_LINE1 + 1, 'E');
+    bus.write(TEXT1_LINE1 + 2, 'E');
+    bus.write(0x07F7, 'X');
+
+    if (bus.page_generation(0x04) != page4 + 2 || bus.page_generation(0x07) != page7 + 1) {
+        std::cerr << "Expected page generations to count screen stores" << std::endl;
+        return false;
+    }
+
+    if (bus.read(TEXT1_LINE1 + 1) != 'E' || bus.read(0x07F7) != 'X') {
+        std::cerr << "Expected screen stores to reach memory" << std::endl;
+        return false;
+    }
+
+    std::ostringstream oss;
+    std::streambuf *old_buf = std::cout.rdbuf(oss.rdbuf());
+    const bool stopped = shims.should_stop();
+
+    // The KBD read picks up the changed pages and logs the screen
+    uint8_t kbd = bus.read(KBD);
+    (void)kbd;
+    std::cout.rdbuf(old_buf);
+
+    if (stopped) {
+        std::cerr << "Unexpected stop without 'E' at first screen position" << std::endl;
+        return false;
+    }
+
+    if (oss.str().find("Text screen snapshot") == std::string::npos) {
+        std::cerr << "Expected screen log after untrapped screen stores" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 // Test full I/O range coverage
 bool test_full_io_range() {
     Bus bus;
@@ -304,6 +385,14 @@ int main() {
     print_test_result("test_stop_on_e_character", result);
     all_passed = all_passed && result;
 
+    result = test_stop_ignores_unrelated_page_writes();
+    print_test_result("test_stop_ignores_unrelated_page_writes", result);
+    all_passed = all_passed && result;
+
+    result = test_screen_writes_untrapped();
+    print_test_result("test_screen_writes_untrapped", result);
+    all_passed = all_passed && result;
+
     std::cout << std::endl;
     if (all_passed) {
         std::cout << "All tests passed! ✓" << std::endl;
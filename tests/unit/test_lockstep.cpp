@@ -0,0 +1,314 @@
+/**
+ * Test program for reference traces and the lockstep comparison
+ * Verifies the binary trace format, MAME log conversion and divergence reports
+ */
+
+#include "edasm/assembler/constexpr_assembler.hpp"
+#include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/cpu.hpp"
+#include "edasm/emulator/lockstep.hpp"
+#include "edasm/emulator/reference_trace.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace edasm;
+
+void print_test_result(const std::string &test_name, bool passed) {
+    std::cout << (passed ? "✓ " : "✗ ") << test_name << (passed ? " passed" : " FAILED")
+              << std::endl;
+}
+
+// Stores to zero page, a subroutine call and a read-modify-write
+static constexpr char kSource[] = R"(
+        ORG $2000
+        LDX #$05
+LOOP    TXA
+        STA $40,X
+        DEX
+        BNE LOOP
+        JSR SUB
+        INC $41
+        LDA $C000
+        STA $50
+        DB $02
+SUB     LDA #$7F
+        ADC #$01
+        RTS
+)";
+
+// Record this emulator running kSource as a reference trace (up to the trap)
+std::vector<uint8_t> record_own_trace() {
+    constexpr auto code = ct::assemble<kSource>();
+    constexpr uint16_t org = ct::origin<kSource>();
+
+    Bus bus;
+    bus.write_binary_data(org, std::vector<uint8_t>(code.begin(), code.end()));
+    std::vector<uint8_t> image(ReferenceTrace::kImageSize);
+    bus.read_block(0, image);
+
+    std::ostringstream out;
+    {
+        TraceWriter writer(out, image);
+        LockstepBus lockstep_bus(bus);
+        BasicCPU<LockstepBus> cpu(lockstep_bus);
+        cpu.state().PC = org;
+        for (;;) {
+            const CPUState before = cpu.state();
+            lockstep_bus.begin_instruction();
+            if (!cpu.step()) {
+                break;
+            }
+            writer.add(before, lockstep_bus.writes());
+        }
+    }
+    const std::string bytes = out.str();
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+// Offset of record `index` in a trace produced by record_own_trace()
+size_t record_offset(const std::vector<uint8_t> &bytes, size_t index) {
+    size_t offset = ReferenceTrace::kHeaderSize + ReferenceTrace::kImageSize;
+    for (size_t i = 0; i < index; ++i) {
+        offset += 8 + 3 * bytes[offset + 7];
+    }
+    return offset;
+}
+
+LockstepResult replay(const std::vector<uint8_t> &bytes, const LockstepOptions &options = {}) {
+    std::optional<ReferenceTrace> trace = ReferenceTrace::from_bytes(bytes);
+    Bus bus;
+    return run_lockstep(*trace, bus, options);
+}
+
+// Test that records written by TraceWriter decode back, and truncation is seen
+bool test_trace_round_trip() {
+    const std::vector<uint8_t> bytes = record_own_trace();
+    std::string error;
+    std::optional<ReferenceTrace> trace = ReferenceTrace::from_bytes(bytes, &error);
+    if (!trace || trace->memory_image()[0x2000] != 0xA2) {
+        std::cerr << "Expected a trace with the program in its image: " << error << std::endl;
+        return false;
+    }
+
+    TraceRecord record{};
+    if (!trace->next(record) || record.state.PC != 0x2000 || record.write_count != 0 ||
+        !trace->next(record) || record.state.PC != 0x2002 || record.state.X != 0x05) {
+        std::cerr << "Unexpected first records" << std::endl;
+        return false;
+    }
+    if (!trace->next(record) || record.write_count != 1 ||
+        record.writes[0] != TraceWrite{0x45, 0x05}) {
+        std::cerr << "Expected STA $40,X to write $05 to $0045" << std::endl;
+        return false;
+    }
+    size_t records = 3;
+    while (trace->next(record)) {
+        records++;
+    }
+    if (trace->truncated() || trace->position() != bytes.size() || records != 28) {
+        std::cerr << "Expected 28 complete records, got " << records << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> cut(bytes.begin(), bytes.end() - 1);
+    trace = ReferenceTrace::from_bytes(cut);
+    while (trace->next(record)) {
+    }
+    if (!trace->truncated()) {
+        std::cerr << "Expected a partial last record to be reported" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> bad = bytes;
+    bad[0] = 'X';
+    if (ReferenceTrace::from_bytes(bad, &error) || error != "Not a reference trace") {
+        std::cerr << "Expected a bad magic to be rejected" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Test conversion of MAME debugger trace lines
+bool test_mame_log_conversion() {
+    std::istringstream log("S 2000 00 00 00 1FF 24\n"
+                           "2000: lda #$7f\n"
+                           "S 2002 7F 00 00 1FF 24\n"
+                           "W 0300 7F\n"
+                           "2002: sta $0300\n"
+                           "  S 2005 7F 00 00 1FF 24\r\n");
+    std::vector<uint8_t> memory(ReferenceTrace::kImageSize);
+    memory[0x2000] = 0xA9;
+    std::ostringstream out;
+    std::string error;
+    if (!convert_mame_trace(log, memory, out, &error)) {
+        std::cerr << "Conversion failed: " << error << std::endl;
+        return false;
+    }
+
+    const std::string text = out.str();
+    const std::vector<uint8_t> bytes(text.begin(), text.end());
+    std::optional<ReferenceTrace> trace = ReferenceTrace::from_bytes(bytes);
+    TraceRecord first{};
+    TraceRecord second{};
+    TraceRecord third{};
+    if (!trace || trace->memory_image()[0x2000] != 0xA9 || !trace->next(first) ||
+        !trace->next(second) || !trace->next(third) || trace->next(third)) {
+        std::cerr << "Expected three records" << std::endl;
+        return false;
+    }
+    if (first.state.SP != 0xFF || first.state.P != 0x24 || first.write_count != 0 ||
+        second.state.A != 0x7F || second.write_count != 1 ||
+        second.writes[0] != TraceWrite{0x0300, 0x7F} || third.state.PC != 0x2005) {
+        std::cerr << "Unexpected converted records" << std::endl;
+        return false;
+    }
+
+    std::istringstream malformed("S 2000 00 00 00 1FF 24\nW 03ZZ 7F\n");
+    std::ostringstream discard;
+    if (convert_mame_trace(malformed, memory, discard, &error) ||
+        error.find("line 2") == std::string::npos) {
+        std::cerr << "Expected a malformed write line to be reported: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Test that the emulator matches its own trace, including NMOS double writes
+bool test_lockstep_matches() {
+    std::vector<uint8_t> bytes = record_own_trace();
+    LockstepResult result = replay(bytes);
+    if (result.diverged || result.records != 28 || result.io_syncs != 0) {
+        std::cerr << "Expected 28 matching instructions, got " << result.records << ": "
+                  << result.reason << std::endl;
+        return false;
+    }
+
+    // An NMOS 6502 writes the old value before the new one for INC $41
+    const size_t inc = record_offset(bytes, 25);
+    if (bytes[inc] != 0x0B || bytes[inc + 7] != 1) {
+        std::cerr << "Expected INC $41 at record 25" << std::endl;
+        return false;
+    }
+    const std::vector<uint8_t> dummy = {0x41, 0x00, 0x01};
+    bytes[inc + 7] = 2;
+    bytes.insert(bytes.begin() + static_cast<std::ptrdiff_t>(inc + 8), dummy.begin(),
+                 dummy.end());
+    result = replay(bytes);
+    if (result.diverged || result.records != 28) {
+        std::cerr << "Expected the dummy write to be folded: " << result.reason << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Test that register and write differences stop the replay with context
+bool test_lockstep_divergence() {
+    const std::vector<uint8_t> bytes = record_own_trace();
+
+    // Record 22 is LDA #$7F in SUB: claim the reference loaded $7E
+    std::vector<uint8_t> changed = bytes;
+    changed[record_offset(changed, 23) + 2] = 0x7E;
+    LockstepOptions options;
+    options.context = 4;
+    LockstepResult result = replay(changed, options);
+    if (!result.diverged || result.index != 23 || result.records != 23 ||
+        result.reason.find("A: trace $7E, emulator $7F") == std::string::npos) {
+        std::cerr << "Expected an A difference at 23: " << result.reason << std::endl;
+        return false;
+    }
+    if (result.history.size() != 4 || result.history.front().first != 19 ||
+        result.history.back().first != 22 || result.history.back().second.PC != 0x2013) {
+        std::cerr << "Expected records 19-22 as context" << std::endl;
+        return false;
+    }
+
+    // STA $40,X at record 2 wrote a different value
+    changed = bytes;
+    changed[record_offset(changed, 2) + 10] = 0x99;
+    result = replay(changed);
+    if (!result.diverged || result.index != 2 || result.reason != "memory writes differ" ||
+        result.actual_writes.size() != 1 || result.actual_writes[0] != TraceWrite{0x45, 0x05} ||
+        result.expected.write_span()[0] != TraceWrite{0x45, 0x99}) {
+        std::cerr << "Expected a write difference at 2: " << result.reason << std::endl;
+        return false;
+    }
+
+    std::ostringstream report;
+    Bus bus;
+    print_lockstep_report(report, result, bus);
+    if (report.str().find("Divergence at instruction 2: memory writes differ") ==
+            std::string::npos ||
+        report.str().find("$0045=$99") == std::string::npos) {
+        std::cerr << "Unexpected report:\n" << report.str() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Test that registers loaded from $C0xx are taken from the trace
+bool test_lockstep_io_sync() {
+    std::vector<uint8_t> bytes = record_own_trace();
+
+    // The reference keyboard had a key down: LDA $C000 read $C1, stored to $50
+    const size_t sta = record_offset(bytes, 27);
+    if (bytes[sta] != 0x10 || sta + 11 != bytes.size()) {
+        std::cerr << "Expected STA $50 as the last record" << std::endl;
+        return false;
+    }
+    bytes[sta + 2] = 0xC1;
+    bytes[sta + 6] |= StatusFlags::N;
+    bytes[sta + 10] = 0xC1;
+
+    LockstepResult result = replay(bytes);
+    if (result.diverged || result.io_syncs != 1) {
+        std::cerr << "Expected one register sync: " << result.reason << std::endl;
+        return false;
+    }
+
+    LockstepOptions strict;
+    strict.sync_io_reads = false;
+    result = replay(bytes, strict);
+    if (!result.diverged || result.index != 27) {
+        std::cerr << "Expected a difference at 27 without syncing" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "Testing lockstep trace comparison..." << std::endl;
+    std::cout << std::endl;
+
+    bool all_passed = true;
+
+    bool result = test_trace_round_trip();
+    print_test_result("test_trace_round_trip", result);
+    all_passed = all_passed && result;
+
+    result = test_mame_log_conversion();
+    print_test_result("test_mame_log_conversion", result);
+    all_passed = all_passed && result;
+
+    result = test_lockstep_matches();
+    print_test_result("test_lockstep_matches", result);
+    all_passed = all_passed && result;
+
+    result = test_lockstep_divergence();
+    print_test_result("test_lockstep_divergence", result);
+    all_passed = all_passed && result;
+
+    result = test_lockstep_io_sync();
+    print_test_result("test_lockstep_io_sync", result);
+    all_passed = all_passed && result;
+
+    std::cout << std::endl;
+    if (all_passed) {
+        std::cout << "All tests passed! ✓" << std::endl;
+        return 0;
+    } else {
+        std::cerr << "Some tests failed! ✗" << std::endl;
+        return 1;
+    }
+}
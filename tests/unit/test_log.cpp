@@ -0,0 +1,189 @@
+/**
+ * Test program for the emulator logging subsystem
+ * Verifies level and category filtering and the asynchronous writer
+ */
+
+#include "edasm/emulator/bus.hpp"
+#include "edasm/emulator/host_shims.hpp"
+#include "edasm/emulator/log.hpp"
+#include "edasm/emulator/traps.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace edasm;
+
+void print_test_result(const std::string &test_name, bool passed) {
+    std::cout << (passed ? "✓ " : "✗ ") << test_name << (passed ? " passed" : " FAILED")
+              << std::endl;
+}
+
+// Capture std::cout and std::cerr for the lifetime of the object
+class CaptureOutput {
+  public:
+    CaptureOutput()
+        : old_out_(std::cout.rdbuf(out_.rdbuf())), old_err_(std::cerr.rdbuf(err_.rdbuf())) {}
+    ~CaptureOutput() {
+        std::cout.rdbuf(old_out_);
+        std::cerr.rdbuf(old_err_);
+    }
+
+    std::string out() const {
+        return out_.str();
+    }
+    std::string err() const {
+        return err_.str();
+    }
+
+  private:
+    std::ostringstream out_;
+    std::ostringstream err_;
+    std::streambuf *old_out_;
+    std::streambuf *old_err_;
+};
+
+int count_evaluations(int &evaluations) {
+    return ++evaluations;
+}
+
+// Test level threshold, category enables and stream selection
+bool test_levels_and_categories() {
+    Log::set_level(LogLevel::INFO);
+    Log::set_categories("all");
+
+    int evaluations = 0;
+    std::string out;
+    std::string err;
+    {
+        CaptureOutput capture;
+        EDASM_LOG(INFO, MLI, "value=" << 42);
+        EDASM_LOG(TRACE, MLI, "hidden " << count_evaluations(evaluations));
+        EDASM_LOG(WARNING, IO, "warning");
+        Log::set_category_enabled(LogCategory::MLI, false);
+        EDASM_LOG(ERROR, MLI, "disabled " << count_evaluations(evaluations));
+        out = capture.out();
+        err = capture.err();
+    }
+
+    if (out != "value=42\n" || err != "warning\n") {
+        std::cerr << "Unexpected log output: '" << out << "' / '" << err << "'" << std::endl;
+        return false;
+    }
+    if (evaluations != 0) {
+        std::cerr << "Filtered log messages should not be formatted" << std::endl;
+        return false;
+    }
+
+    // Category lists replace the enables; an unknown name changes nothing
+    if (!Log::set_categories("io,lc") || Log::category_enabled(LogCategory::MLI) ||
+        !Log::category_enabled(LogCategory::LC)) {
+        std::cerr << "Expected only io and lc enabled" << std::endl;
+        return false;
+    }
+    if (Log::set_categories("io,bogus") || !Log::category_enabled(LogCategory::LC)) {
+        std::cerr << "Expected an unknown category to be rejected" << std::endl;
+        return false;
+    }
+
+    Log::set_categories("all");
+    return true;
+}
+
+// Test that the background writer keeps records in order and flush() waits for them
+bool test_async_writer() {
+    Log::set_level(LogLevel::INFO);
+    Log::set_categories("all");
+
+    constexpr int RECORDS = 1000;
+    std::string out;
+    {
+        CaptureOutput capture;
+        Log::start_async();
+        if (!Log::is_async()) {
+            std::cerr << "Expected the writer thread to be running" << std::endl;
+            return false;
+        }
+        for (int i = 0; i < RECORDS; ++i) {
+            EDASM_LOG(INFO, TRAP, "record " << i);
+        }
+        Log::flush();
+        out = capture.out();
+        Log::stop_async();
+    }
+
+    std::ostringstream expected;
+    for (int i = 0; i < RECORDS; ++i) {
+        expected << "record " << i << "\n";
+    }
+    if (out != expected.str() || Log::dropped() != 0) {
+        std::cerr << "Expected " << RECORDS << " records in order before flush() returned"
+                  << std::endl;
+        return false;
+    }
+    if (Log::is_async()) {
+        std::cerr << "Expected the writer thread to stop" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Test that trace mode enables the I/O trace records
+bool test_trace_enables_io_records() {
+    Bus bus;
+    HostShims shims(bus);
+    shims.install_io_traps();
+
+    std::string quiet;
+    std::string traced;
+    {
+        CaptureOutput capture;
+        bus.read(0xC030); // Speaker
+        quiet = capture.out();
+    }
+    TrapManager::set_trace(true);
+    {
+        CaptureOutput capture;
+        bus.read(0xC030);
+        traced = capture.out();
+    }
+    TrapManager::set_trace(false);
+
+    if (!quiet.empty() || traced != "[I/O] Speaker toggle at $C030\n") {
+        std::cerr << "Unexpected speaker trace: '" << quiet << "' / '" << traced << "'"
+                  << std::endl;
+        return false;
+    }
+    if (Log::level() != LogLevel::INFO) {
+        std::cerr << "Expected trace off to restore the INFO level" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "Testing emulator logging..." << std::endl;
+    std::cout << std::endl;
+
+    bool all_passed = true;
+
+    bool result = test_levels_and_categories();
+    print_test_result("test_levels_and_categories", result);
+    all_passed = all_passed && result;
+
+    result = test_async_writer();
+    print_test_result("test_async_writer", result);
+    all_passed = all_passed && result;
+
+    result = test_trace_enables_io_records();
+    print_test_result("test_trace_enables_io_records", result);
+    all_passed = all_passed && result;
+
+    std::cout << std::endl;
+    if (all_passed) {
+        std::cout << "All tests passed! ✓" << std::endl;
+        return 0;
+    } else {
+        std::cerr << "Some tests failed! ✗" << std::endl;
+        return 1;
+    }
+}